@@ -382,6 +382,7 @@ $(document).ready(function () {
                 console.log('🔍 Calculation completed successfully');
                 var sResult = createResult(jsonResult);
                 $("#resultDiv").html(sResult);
+                mountResultTables(jsonResult);
                 
                 // Cleanup is handled automatically by the class
                 calculator.destroy(); // Optional: explicitly destroy for immediate cleanup
@@ -571,25 +572,7 @@ function createResult(jsonResult) {
                     " of " + jsonResult.asteroids.summary.total_requested + " requested</small>";
         }
         
-        sHtml = sHtml + "<table class='myTable mt-2'><thead><tr><th>Asteroid</th><th>Longitude</th><th>Latitude</th><th>Distance (AU)</th><th>Speed</th></tr></thead>";
-        sHtml = sHtml + "<tbody>";
-        
-        for (var i = 0; i < jsonResult.asteroids.asteroids.length; i++) {
-            var asteroid = jsonResult.asteroids.asteroids[i];
-            sHtml = sHtml + "<tr>";
-            if (asteroid.error) {
-                sHtml = sHtml + "<td>" + asteroid.name + " (" + asteroid.index + ")</td>";
-                sHtml = sHtml + "<td colspan='4' class='text-danger'>Error: " + (asteroid.error_msg || "Calculation failed") + "</td>";
-            } else {
-                sHtml = sHtml + "<td>" + asteroid.name + " (" + asteroid.index + ")</td>";
-                sHtml = sHtml + "<td>" + asteroid.long_s + "</td>";
-                sHtml = sHtml + "<td>" + asteroid.lat.toFixed(4) + "°</td>";
-                sHtml = sHtml + "<td>" + asteroid.distance.toFixed(4) + "</td>";
-                sHtml = sHtml + "<td>" + asteroid.speed.toFixed(4) + "°/day</td>";
-            }
-            sHtml = sHtml + "</tr>";
-        }
-        sHtml = sHtml + "</tbody></table>";
+        sHtml = sHtml + "<div id='asteroidsTable' class='mt-2'></div>";
     }
 
     // Planetary nodes table (if available)
@@ -617,22 +600,22 @@ function createResult(jsonResult) {
         
         // Ascending nodes tab
         sHtml = sHtml + "<div class='tab-pane fade show active' id='ascending' role='tabpanel'>";
-        sHtml = sHtml + createNodesTable(jsonResult.nodes.nodes, 'ascending_node');
+        sHtml = sHtml + "<div id='nodesTable-ascending_node'></div>";
         sHtml = sHtml + "</div>";
 
         // Descending nodes tab
         sHtml = sHtml + "<div class='tab-pane fade' id='descending' role='tabpanel'>";
-        sHtml = sHtml + createNodesTable(jsonResult.nodes.nodes, 'descending_node');
+        sHtml = sHtml + "<div id='nodesTable-descending_node'></div>";
         sHtml = sHtml + "</div>";
 
         // Perihelion tab
         sHtml = sHtml + "<div class='tab-pane fade' id='perihelion' role='tabpanel'>";
-        sHtml = sHtml + createNodesTable(jsonResult.nodes.nodes, 'perihelion');
+        sHtml = sHtml + "<div id='nodesTable-perihelion'></div>";
         sHtml = sHtml + "</div>";
 
         // Aphelion tab
         sHtml = sHtml + "<div class='tab-pane fade' id='aphelion' role='tabpanel'>";
-        sHtml = sHtml + createNodesTable(jsonResult.nodes.nodes, 'aphelion');
+        sHtml = sHtml + "<div id='nodesTable-aphelion'></div>";
         sHtml = sHtml + "</div>";
 
         sHtml = sHtml + "</div>";
@@ -641,31 +624,133 @@ function createResult(jsonResult) {
     return sHtml;
 }
 
-function createNodesTable(nodes, nodeType) {
-    var sHtml = "";
-    sHtml = sHtml + "<table class='myTable mt-2'><thead><tr><th>Planet</th><th>Longitude</th><th>Latitude</th><th>Distance (AU)</th><th>Speed Long</th><th>Speed Lat</th></tr></thead>";
-    sHtml = sHtml + "<tbody>";
-    
-    for (var i = 0; i < nodes.length; i++) {
-        if (nodes[i].error) {
-            sHtml = sHtml + "<tr>";
-            sHtml = sHtml + "<td>" + nodes[i].name + "</td>";
-            sHtml = sHtml + "<td colspan='5' class='text-danger'>Error: " + (nodes[i].error_msg || "Calculation failed") + "</td>";
-            sHtml = sHtml + "</tr>";
-        } else {
+// Tables that can hold many rows (asteroids, nodes) are virtualised: only
+// the visible rows exist in the DOM, and they are reused while scrolling.
+// Row heights are fixed so that the scroll position gives the first row.
+var VTABLE_ROW_HEIGHT = 24;
+var VTABLE_MAX_ROWS = 20;
+
+function mountResultTables(jsonResult) {
+    if (jsonResult.asteroids && jsonResult.asteroids.asteroids && jsonResult.asteroids.asteroids.length > 0) {
+        var asteroids = jsonResult.asteroids.asteroids;
+        mountVirtualTable(document.getElementById("asteroidsTable"),
+            ["Asteroid", "Longitude", "Latitude", "Distance (AU)", "Speed"],
+            asteroids.length,
+            function (i) {
+                var asteroid = asteroids[i];
+                var name = asteroid.name + " (" + asteroid.index + ")";
+                if (asteroid.error) {
+                    return { error: true, cells: [name, "Error: " + (asteroid.error_msg || "Calculation failed")] };
+                }
+                return { cells: [name, asteroid.long_s, asteroid.lat.toFixed(4) + "°",
+                                 asteroid.distance.toFixed(4), asteroid.speed.toFixed(4) + "°/day"] };
+            });
+    }
+    if (jsonResult.nodes && jsonResult.nodes.nodes && jsonResult.nodes.nodes.length > 0) {
+        ["ascending_node", "descending_node", "perihelion", "aphelion"].forEach(function (nodeType) {
+            mountNodesTable(document.getElementById("nodesTable-" + nodeType), jsonResult.nodes.nodes, nodeType);
+        });
+    }
+}
+
+function mountNodesTable(container, nodes, nodeType) {
+    mountVirtualTable(container,
+        ["Planet", "Longitude", "Latitude", "Distance (AU)", "Speed Long", "Speed Lat"],
+        nodes.length,
+        function (i) {
+            if (nodes[i].error) {
+                return { error: true, cells: [nodes[i].name, "Error: " + (nodes[i].error_msg || "Calculation failed")] };
+            }
             var nodeData = nodes[i][nodeType];
-            sHtml = sHtml + "<tr>";
-            sHtml = sHtml + "<td>" + nodes[i].name + "</td>";
-            sHtml = sHtml + "<td>" + nodeData.long_s + "</td>";
-            sHtml = sHtml + "<td>" + nodeData.lat.toFixed(6) + "°</td>";
-            sHtml = sHtml + "<td>" + nodeData.distance.toFixed(6) + "</td>";
-            sHtml = sHtml + "<td>" + nodeData.speed_long.toFixed(6) + "°/day</td>";
-            sHtml = sHtml + "<td>" + nodeData.speed_lat.toFixed(6) + "°/day</td>";
-            sHtml = sHtml + "</tr>";
+            return { cells: [nodes[i].name, nodeData.long_s, nodeData.lat.toFixed(6) + "°",
+                             nodeData.distance.toFixed(6), nodeData.speed_long.toFixed(6) + "°/day",
+                             nodeData.speed_lat.toFixed(6) + "°/day"] };
+        });
+}
+
+// Rows of a virtual table to render at the scroll position scrollTop: a
+// pool of count rows starting at first, which stays within the table when
+// the viewport is overscrolled (scrollTop below 0 or past the end)
+function virtualRowWindow(scrollTop, rowCount) {
+    var count = Math.min(rowCount, VTABLE_MAX_ROWS + 1);
+    var first = Math.min(Math.floor(scrollTop / VTABLE_ROW_HEIGHT), rowCount - count);
+    return { first: Math.max(first, 0), count: count };
+}
+
+// Render rowCount rows into container. getRow(i) returns the cells of row i
+// as { cells: [...], error: bool }; it is called only for visible rows, so
+// numbers are formatted lazily.
+function mountVirtualTable(container, headers, rowCount, getRow) {
+    if (!container) {
+        return;
+    }
+    var npool = virtualRowWindow(0, rowCount).count;
+    var colgroup = "<colgroup>" + headers.map(function () { return "<col>"; }).join("") + "</colgroup>";
+    var fixed = "table-layout:fixed;";
+    var cell = "height:" + VTABLE_ROW_HEIGHT + "px;white-space:nowrap;overflow:hidden;text-overflow:ellipsis;";
+
+    container.innerHTML =
+        "<table class='myTable' style='" + fixed + "'>" + colgroup + "<thead><tr>" +
+        headers.map(function (h) { return "<th>" + h + "</th>"; }).join("") + "</tr></thead></table>" +
+        "<div style='position:relative;overflow-y:auto;height:" + Math.min(rowCount, VTABLE_MAX_ROWS) * VTABLE_ROW_HEIGHT + "px;'>" +
+        "<div style='height:" + rowCount * VTABLE_ROW_HEIGHT + "px;'></div>" +
+        "<table class='myTable' style='position:absolute;top:0;left:0;" + fixed + "'>" + colgroup + "<tbody></tbody></table>" +
+        "</div>";
+
+    var header = container.children[0];
+    var viewport = container.children[1];
+    var body = viewport.children[1];
+    var tbody = body.tBodies[0];
+    var rows = [];
+    for (var k = 0; k < npool; k++) {
+        var tr = document.createElement("tr");
+        for (var c = 0; c < headers.length; c++) {
+            var td = document.createElement("td");
+            td.style.cssText = cell;
+            tr.appendChild(td);
         }
+        tbody.appendChild(tr);
+        rows.push(tr);
     }
-    sHtml = sHtml + "</tbody></table>";
-    return sHtml;
+
+    var first = -1;
+    var pending = false;
+    function render() {
+        pending = false;
+        // align the header with the body, whose width excludes the scrollbar
+        if (viewport.clientWidth > 0) {
+            header.style.width = viewport.clientWidth + "px";
+            body.style.width = viewport.clientWidth + "px";
+        }
+        var start = virtualRowWindow(viewport.scrollTop, rowCount).first;
+        if (start === first) {
+            return;
+        }
+        first = start;
+        body.style.transform = "translateY(" + first * VTABLE_ROW_HEIGHT + "px)";
+        for (var k = 0; k < npool; k++) {
+            var row = getRow(first + k);
+            var cells = rows[k].children;
+            rows[k].className = row.error ? "text-danger" : "";
+            for (var c = 0; c < cells.length; c++) {
+                cells[c].textContent = c < row.cells.length ? row.cells[c] : "";
+            }
+        }
+    }
+    viewport.addEventListener("scroll", function () {
+        if (!pending) {
+            pending = true;
+            window.requestAnimationFrame(render);
+        }
+    });
+    // tables in hidden tabs have no width until the tab is shown
+    if (typeof ResizeObserver !== "undefined") {
+        new ResizeObserver(function () {
+            first = -1;
+            render();
+        }).observe(viewport);
+    }
+    render();
 }
 
 function getNodeMethodName(method) {
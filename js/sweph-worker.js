@@ -125,12 +125,49 @@ class SwissEphemeris {
 
     /**
      * Get current memory and loading status
+     *
+     * `heap` holds the statistics of the loaded module (see getHeapStats()
+     * in lib/src/astro.c): heap size and bytes in use, peak footprint,
+     * memory growths, allocation counts, result strings not yet released,
+     * and the bytes held by ephemeris segments, file caches, asteroid
+     * elements and star tables. It is null while the module is not loaded.
      * @returns {Promise<Object>} Status information
      */
     async getStatus() {
         return this._sendWorkerCommand('status');
     }
 
+    /**
+     * Read ephemeris files that are not embedded from a server by HTTP
+     * Range requests (see setRemoteEphemeris() in lib/src/astro.c)
+     *
+     * The worker keeps the setting and applies it again when the module is
+     * loaded after unload(). An empty URL disables the remote source.
+     * @param {string} baseUrl - URL of the directory holding the files, e.g. '/eph'
+     * @param {Object} [options] - { blockSize, cacheBlocks }, defaults 65536 and 64
+     * @returns {Promise<Object>} The settings in effect
+     */
+    async setRemoteEphemeris(baseUrl, options = {}) {
+        const result = await this._sendWorkerCommand('setRemoteEphemeris', {
+            url: baseUrl || '',
+            blockSize: options.blockSize || 0,
+            cacheBlocks: options.cacheBlocks || 0
+        });
+        if (!result.success) {
+            throw new Error(`Remote ephemeris failed: ${result.error}`);
+        }
+        return result.remote;
+    }
+
+    /**
+     * Transfer counters of the remote ephemeris source
+     * @returns {Promise<Object|null>} Requests, bytes and cache counters, null while the module is not loaded
+     */
+    async getRemoteEphemerisStats() {
+        const result = await this._sendWorkerCommand('remoteStats');
+        return result.stats;
+    }
+
     /**
      * Unload WASM module to free memory
      * @returns {Promise<void>}
@@ -375,6 +412,7 @@ var pendingData = null;
 var isModuleLoaded = false;
 var isModuleLoading = false;
 var moduleLoadPromise = null;
+var remoteEphemeris = null;   // { url, blockSize, cacheBlocks } of setRemoteEphemeris
 
 console.log('🔧 Swiss Ephemeris Worker ready (WASM not loaded yet)');
 
@@ -630,10 +668,35 @@ function handleCommand(data) {
                 ...response,
                 isLoaded: isModuleLoaded,
                 isLoading: isModuleLoading,
-                hasPendingData: !!pendingData
+                hasPendingData: !!pendingData,
+                heap: readHeapStats()
             }));
             break;
             
+        case 'setRemoteEphemeris': {
+            console.log('📨 Received setRemoteEphemeris command');
+            const remote = { url: data.url || '', blockSize: data.blockSize || 0, cacheBlocks: data.cacheBlocks || 0 };
+            const wasLoaded = isModuleLoaded;
+            remoteEphemeris = remote;
+            loadModuleAsync().then(() => {
+                // a module loaded just now has applied the setting already
+                const result = (!wasLoaded && remote.result) || applyRemoteEphemeris();
+                if (result.error) {
+                    postMessage(JSON.stringify({ ...response, success: false, error: result.error_msg }));
+                } else {
+                    postMessage(JSON.stringify({ ...response, success: true, remote: result }));
+                }
+            }).catch((error) => {
+                postMessage(JSON.stringify({ ...response, success: false, error: error.message }));
+            });
+            break;
+        }
+
+        case 'remoteStats':
+            console.log('📨 Received remoteStats command');
+            postMessage(JSON.stringify({ ...response, success: true, stats: readRemoteStats() }));
+            break;
+
         case 'preload':
             console.log('📨 Received preload command');
             if (!isModuleLoaded && !isModuleLoading) {
@@ -682,6 +745,7 @@ function loadModuleAsync() {
                 console.log('✅ WASM Runtime initialized');
                 isModuleLoaded = true;
                 isModuleLoading = false;
+                applyRemoteEphemeris();
                 
                 // Process any pending data
                 if (pendingData) {
@@ -750,6 +814,76 @@ function loadModuleAsync() {
     return moduleLoadPromise;
 }
 
+// Convert a JSON result string of the module and release its memory
+function readResult(ptr) {
+    if (typeof ptr !== 'number') {
+        return ptr;
+    }
+    const text = Module.UTF8ToString(ptr);
+    if (typeof Module._freeMemory === 'function') {
+        Module._freeMemory(ptr);
+    }
+    return text;
+}
+
+// Set the remote ephemeris source of the loaded module from remoteEphemeris;
+// a setting that fails is dropped, so that a reload does not repeat it
+function applyRemoteEphemeris() {
+    const remote = remoteEphemeris;
+    if (!remote) {
+        return null;
+    }
+    if (typeof Module._setRemoteEphemeris !== 'function') {
+        remote.result = { error: true, error_msg: 'setRemoteEphemeris is not exported by this module' };
+    } else {
+        const strLen = Module.lengthBytesUTF8(remote.url) + 1;
+        const strPtr = Module._malloc(strLen);
+        Module.stringToUTF8(remote.url, strPtr, strLen);
+        try {
+            remote.result = JSON.parse(readResult(Module._setRemoteEphemeris(strPtr, remote.blockSize, remote.cacheBlocks)));
+        } finally {
+            Module._free(strPtr);
+        }
+    }
+    if (remote.result.error) {
+        remoteEphemeris = null;
+    }
+    return remote.result;
+}
+
+// Remote ephemeris counters of the module, null if it is not loaded
+function readRemoteStats() {
+    if (!isModuleLoaded || !self.Module || typeof Module._getRemoteEphemerisStats !== 'function') {
+        return null;
+    }
+    return JSON.parse(readResult(Module._getRemoteEphemerisStats()));
+}
+
+// Heap statistics of the module, null if it is not loaded
+function readHeapStats() {
+    if (!isModuleLoaded || !self.Module || typeof Module._getHeapStats !== 'function') {
+        return null;
+    }
+    try {
+        return JSON.parse(readResult(Module._getHeapStats()));
+    } catch (error) {
+        console.warn('⚠️ Heap statistics unavailable:', error);
+        return null;
+    }
+}
+
+// Log the heap after each request in debug builds of the module
+function logHeapStats() {
+    const heap = readHeapStats();
+    if (heap && heap.debug) {
+        console.log('📊 Heap:', heap.in_use, 'bytes in use, peak footprint', heap.peak_footprint,
+                    '- results live:', heap.results_live, '(' + heap.results_bytes + ' bytes)',
+                    '- growths:', heap.growth_events,
+                    '- ephemeris:', heap.ephemeris_segments + heap.file_caches,
+                    '- stars:', heap.star_tables);
+    }
+}
+
 // Function to process the calculation data
 function processData(data) {
     try {
@@ -764,7 +898,7 @@ function processData(data) {
         const resultPtr = Module._get(data[0], data[1], data[2], data[3], data[4], data[5], 
                                      data[6], data[7], data[8], data[9], data[10], data[11], 
                                      data[12], data[13], data[14]);
-        const result = typeof resultPtr === 'number' ? Module.UTF8ToString(resultPtr) : resultPtr;
+        const result = readResult(resultPtr);
         
         var mainResult = JSON.parse(result);
         console.log('🌍 Main calculation completed');
@@ -780,7 +914,7 @@ function processData(data) {
             try {
                 const nodesPtr = Module._getPlanetaryNodes(data[0], data[1], data[2], data[3], 
                                                           data[4], data[5], nodeMethod, 50000);
-                const nodesResult = typeof nodesPtr === 'number' ? Module.UTF8ToString(nodesPtr) : nodesPtr;
+                const nodesResult = readResult(nodesPtr);
                 mainResult.nodes = JSON.parse(nodesResult);
                 console.log('✅ Nodes calculated');
             } catch (error) {
@@ -804,7 +938,7 @@ function processData(data) {
                     const asteroidsPtr = Module._getAsteroids(data[0], data[1], data[2], data[3], 
                                                             data[4], data[5], asteroidData.start, 
                                                             asteroidData.end, 100000);
-                    asteroidsResult = typeof asteroidsPtr === 'number' ? Module.UTF8ToString(asteroidsPtr) : asteroidsPtr;
+                    asteroidsResult = readResult(asteroidsPtr);
                 } else if (asteroidData.mode === 'specific') {
                     console.log('📍 Specific asteroids:', asteroidData.list);
                     
@@ -818,7 +952,7 @@ function processData(data) {
                         const asteroidsPtr = Module._getSpecificAsteroids(data[0], data[1], data[2], 
                                                                          data[3], data[4], data[5], 
                                                                          strPtr, 100000);
-                        asteroidsResult = typeof asteroidsPtr === 'number' ? Module.UTF8ToString(asteroidsPtr) : asteroidsPtr;
+                        asteroidsResult = readResult(asteroidsPtr);
                     } finally {
                         Module._free(strPtr);
                     }
@@ -847,6 +981,7 @@ function processData(data) {
         
         // Optional: Cleanup after calculation to free memory
         performCleanup();
+        logHeapStats();
         
     } catch (error) {
         console.error('❌ Fatal error in processData:', error);
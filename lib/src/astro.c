@@ -28,6 +28,26 @@
  * - _getAsteroids(): Multiple asteroid positions by range
  * - _getSpecificAsteroids(): Specific asteroids by catalog numbers
  * - _getPlanet(): Single planet position
+ * - _getCrescentVisibility(): Lunar crescent visibility map (Yallop)
+ * - _getSkyBrightness(): Sky brightness and limiting magnitude over the whole sky
+ * - _getLimitingMagnitudeCurve(): Limiting magnitude in one direction over a period
+ * - _getAstrocartography(): Planetary MC/IC/ASC/DSC lines over the globe
+ * - _getParans(): Parans of planets and fixed stars by latitude
+ * - _getPrimaryDirections(): Primary directions table (Placidus/Regiomontanus)
+ * - _getPanchang(): Tithi, nakshatra, yoga and karana at sunrise for several cities
+ * - _getMoonExtremes(): True lunar perigees and apogees with syzygy coincidences
+ * - _getEclipses(): Next solar or lunar eclipses, from the eclipse database where it covers the dates
+ * - _getSarosSeries(): Eclipses of a Saros series from the eclipse database
+ * - _getDeclinationEvents(): Out-of-bounds periods, parallels and contraparallels
+ * - _getFixedStarConjunctions(): Planet conjunctions with fixed stars
+ * - _getChebyshevFit(): Apparent positions as compact Chebyshev segments
+ * - _getAsteroidsFromElements(): Positions of many numbered asteroids from an element catalogue
+ * - _getAsteroidsNearPoints(): Numbered asteroids within an orb of given ecliptic longitudes
+ * - _getWheelLayout(): Non-overlapping glyph angles with leader-line offsets for a chart wheel
+ * - _setRemoteEphemeris(): Fetch missing ephemeris files by HTTP Range requests
+ * - _getRemoteEphemerisStats(): Blocks and bytes transferred from the remote source
+ * - _prefetchEphemeris(): Read ahead the ephemeris segments of a time series
+ * - _getHeapStats(): Heap usage, allocation counters and memory held by ephemeris tables
  * - _getJulianDay(): Julian Day calculation
  * - _degreesToDMS(): Degrees to DMS format conversion
  * - _freeMemory(): Memory management for allocated strings
@@ -99,7 +119,9 @@
 #include <string.h>
 #include <time.h>
 #include <math.h>
+#include <malloc.h>
 #include <emscripten.h>
+#include <emscripten/heap.h>
 #include "swephexp.h"
 
 /**
@@ -124,6 +146,7 @@
 #define NODES_BUFFER_SIZE 50000     /**< Planetary nodes */
 #define ASTEROIDS_BUFFER_SIZE 100000 /**< Multiple asteroids */
 #define SINGLE_BUFFER_SIZE 1000     /**< Single object */
+#define PARAN_MAX_BODIES 200        /**< Planets plus fixed stars for parans */
 /** @} */
 
 /**
@@ -273,6 +296,61 @@ static char *format_degrees(double degrees, int format_flags)
     return result;
 }
 
+/**
+ * @defgroup heapstat Heap Telemetry
+ * @brief Counters of the allocations made in this file
+ *
+ * All malloc() and free() calls below go through heap_malloc() and
+ * heap_free(). Temporary buffers are freed before a function returns,
+ * so the allocations still live between calls are result strings that
+ * have not been released with freeMemory().
+ * @{
+ */
+static struct {
+    double allocations;       /**< malloc() calls */
+    double frees;             /**< free() calls */
+    double live_bytes;        /**< bytes in live allocations */
+    double peak_live_bytes;   /**< maximum of live_bytes */
+    double growth_events;     /**< WASM memory growths observed */
+    size_t heap_size;         /**< WASM memory size at the last check */
+} heap_stat;
+
+static void heap_check_growth(void)
+{
+    size_t size = emscripten_get_heap_size();
+    if (heap_stat.heap_size != 0 && size > heap_stat.heap_size) {
+        heap_stat.growth_events++;
+    }
+    heap_stat.heap_size = size;
+}
+
+static void *heap_malloc(size_t size)
+{
+    void *ptr = malloc(size);
+    if (ptr) {
+        heap_stat.allocations++;
+        heap_stat.live_bytes += malloc_usable_size(ptr);
+        if (heap_stat.live_bytes > heap_stat.peak_live_bytes) {
+            heap_stat.peak_live_bytes = heap_stat.live_bytes;
+        }
+        heap_check_growth();
+    }
+    return ptr;
+}
+
+static void heap_free(void *ptr)
+{
+    if (ptr) {
+        heap_stat.frees++;
+        heap_stat.live_bytes -= malloc_usable_size(ptr);
+        free(ptr);
+    }
+}
+
+#define malloc(size) heap_malloc(size)
+#define free(ptr) heap_free(ptr)
+/** @} */
+
 /**
  * @brief Calculate Julian Day from date/time components
  */
@@ -1027,6 +1105,1791 @@ const char *getPlanet(int planet_id, int year, int month, int day, int hour, int
     return buffer;
 }
 
+/**
+ * @brief Crescent visibility map (Yallop q-test) for the evening of a date
+ *
+ * Evaluates the visibility of the young lunar crescent on a world grid,
+ * at each site's local sunset of the given date. The conjunction, the
+ * Sun/Moon ephemeris and sidereal time are computed once for the whole
+ * map (see swe_heliacal_crescent_grid()), so a 1°×1° map takes well
+ * under a second.
+ *
+ * @param year Year
+ * @param month Month (1-12)
+ * @param day Day (1-31); the local evening of this date is used
+ * @param lat_step Latitude step in degrees (e.g. 1.0)
+ * @param lon_step Longitude step in degrees (e.g. 1.0)
+ * @param buflen Buffer length for output string; enlarged if too small
+ *
+ * @return JSON string containing:
+ *   - conjunction_jd_ut: Time of the preceding new moon
+ *   - grid: lat0, lat_step, lon0, lon_step, nlat, nlon (rows south to north)
+ *   - q: Yallop q values, row by row
+ *   - class: one character per site, 'A'..'F' or '-' if undefined
+ */
+EMSCRIPTEN_KEEPALIVE
+const char *getCrescentVisibility(int year, int month, int day, double lat_step, double lon_step, int buflen)
+{
+    char error_msg[AS_MAXCH];
+    double julian_day, dgrid[6], dret[2];
+    double *qgrid;
+    int32 *cgrid;
+    int nlat, nlon, nsites, length = 0;
+    char *buffer;
+
+    if (lat_step <= 0) lat_step = 1.0;
+    if (lon_step <= 0) lon_step = 1.0;
+    nlat = (int)(180.0 / lat_step) + 1;
+    nlon = (int)(360.0 / lon_step);
+    nsites = nlat * nlon;
+
+    // About 8 bytes per q value plus one class character per site
+    if (buflen < nsites * 10 + 1000) buflen = nsites * 10 + 1000;
+    buffer = malloc(buflen);
+    if (!buffer) return NULL;
+    qgrid = malloc(nsites * sizeof(double));
+    cgrid = malloc(nsites * sizeof(int32));
+    if (!qgrid || !cgrid) {
+        snprintf(buffer, buflen, "{ \"error\": true, \"error_msg\": \"out of memory for %d sites\" }", nsites);
+        free(qgrid);
+        free(cgrid);
+        return buffer;
+    }
+
+    swe_set_ephe_path("eph");
+    julian_day = calculate_julian_day(year, month, day, 0, 0, 0);
+
+    dgrid[0] = -90.0;
+    dgrid[1] = lat_step;
+    dgrid[2] = -180.0;
+    dgrid[3] = lon_step;
+    dgrid[4] = 0.0;
+    dgrid[5] = 0.0;
+
+    if (swe_heliacal_crescent_grid(julian_day, dgrid, nlat, nlon, SEFLG_SWIEPH,
+                                   qgrid, cgrid, dret, error_msg) == ERR) {
+        char escaped_error[500];
+        escape_json_string(error_msg, escaped_error, sizeof(escaped_error));
+        snprintf(buffer, buflen, "{ \"error\": true, \"error_msg\": \"%s\" }", escaped_error);
+        free(qgrid);
+        free(cgrid);
+        return buffer;
+    }
+
+    length += snprintf(buffer + length, buflen - length,
+        "{ \"initDate\": { \"year\": %d, \"month\": %d, \"day\": %d, \"jd_ut\": %.6f }, "
+        "\"conjunction_jd_ut\": %.6f, "
+        "\"grid\": { \"lat0\": %.4f, \"lat_step\": %.4f, \"lon0\": %.4f, \"lon_step\": %.4f, "
+        "\"nlat\": %d, \"nlon\": %d }, \"q\": [",
+        year, month, day, julian_day, dret[0],
+        dgrid[0], dgrid[1], dgrid[2], dgrid[3], nlat, nlon);
+
+    for (int i = 0; i < nsites; i++) {
+        length += snprintf(buffer + length, buflen - length, "%s%.3f", (i > 0) ? "," : "", qgrid[i]);
+    }
+
+    length += snprintf(buffer + length, buflen - length, "], \"class\": \"");
+    for (int i = 0; i < nsites; i++) {
+        buffer[length++] = (cgrid[i] == 0) ? '-' : (char)('A' + cgrid[i] - 1);
+    }
+    length += snprintf(buffer + length, buflen - length, "\", \"error\": false }");
+
+    free(qgrid);
+    free(cgrid);
+    return buffer;
+}
+
+/**
+ * @brief Sky brightness and limiting magnitude over the whole sky at one instant
+ *
+ * Evaluates Schaefer's sky brightness model on an altitude/azimuth grid
+ * from the horizon to the zenith. Sun and Moon, their extinction and the
+ * lunar phase are computed once, the altitude terms once per row (see
+ * swe_sky_brightness_grid()), so a 1°×1° sky takes a few ten milliseconds.
+ * Atmosphere and observer use the defaults of swe_vis_limit_mag().
+ *
+ * @param year Year
+ * @param month Month (1-12)
+ * @param day Day of month
+ * @param hour Hour (UT)
+ * @param minute Minute
+ * @param second Second
+ * @param lon Geographic longitude in degrees (east positive)
+ * @param lat Geographic latitude in degrees (north positive)
+ * @param alt_step Altitude step in degrees (e.g. 1.0)
+ * @param azi_step Azimuth step in degrees (e.g. 1.0)
+ * @param buflen Buffer length for output string; enlarged if too small
+ *
+ * @return JSON string containing:
+ *   - sun, moon: altitude and azimuth (from north over east)
+ *   - grid: alt0, alt_step, azi0, azi_step, nalt, nazi (rows from the horizon up)
+ *   - brightness: sky brightness in nanolamberts, row by row
+ *   - limiting_magnitude: faintest visible magnitude, row by row
+ */
+EMSCRIPTEN_KEEPALIVE
+const char *getSkyBrightness(int year, int month, int day, int hour, int minute, int second, double lon, double lat, double alt_step, double azi_step, int buflen)
+{
+    char error_msg[AS_MAXCH];
+    double julian_day, dgeo[3], datm[4] = {0, 0, 0, 0}, dobs[6] = {0, 0, 0, 0, 0, 0};
+    double dgrid[4], dret[4];
+    float *bgrid, *mgrid;
+    int nalt, nazi, ncells, length = 0;
+    char *buffer;
+
+    if (alt_step <= 0) alt_step = 1.0;
+    if (azi_step <= 0) azi_step = 1.0;
+    nalt = (int)(90.0 / alt_step) + 1;
+    nazi = (int)(360.0 / azi_step);
+    ncells = nalt * nazi;
+
+    // At most 11 bytes per brightness and 8 per magnitude
+    if (buflen < ncells * 20 + 1000) buflen = ncells * 20 + 1000;
+    buffer = malloc(buflen);
+    if (!buffer) return NULL;
+    bgrid = malloc(ncells * sizeof(float));
+    mgrid = malloc(ncells * sizeof(float));
+    if (!bgrid || !mgrid) {
+        snprintf(buffer, buflen, "{ \"error\": true, \"error_msg\": \"out of memory for %d grid cells\" }", ncells);
+        free(bgrid);
+        free(mgrid);
+        return buffer;
+    }
+
+    swe_set_ephe_path("eph");
+    julian_day = calculate_julian_day(year, month, day, hour, minute, second);
+
+    dgeo[0] = lon;
+    dgeo[1] = lat;
+    dgeo[2] = 0.0;
+    dgrid[0] = 0.0;
+    dgrid[1] = alt_step;
+    dgrid[2] = 0.0;
+    dgrid[3] = azi_step;
+
+    if (swe_sky_brightness_grid(julian_day, dgeo, datm, dobs, SEFLG_SWIEPH, dgrid, nalt, nazi,
+                                bgrid, mgrid, dret, error_msg) == ERR) {
+        char escaped_error[500];
+        escape_json_string(error_msg, escaped_error, sizeof(escaped_error));
+        snprintf(buffer, buflen, "{ \"error\": true, \"error_msg\": \"%s\" }", escaped_error);
+        free(bgrid);
+        free(mgrid);
+        return buffer;
+    }
+
+    length += snprintf(buffer + length, buflen - length,
+        "{ \"initDate\": { \"year\": %d, \"month\": %d, \"day\": %d, \"hour\": %d, \"minute\": %d, "
+        "\"second\": %d, \"jd_ut\": %.6f }, "
+        "\"sun\": { \"alt\": %.4f, \"azi\": %.4f }, \"moon\": { \"alt\": %.4f, \"azi\": %.4f }, "
+        "\"grid\": { \"alt0\": %.4f, \"alt_step\": %.4f, \"azi0\": %.4f, \"azi_step\": %.4f, "
+        "\"nalt\": %d, \"nazi\": %d }, \"brightness\": [",
+        year, month, day, hour, minute, second, julian_day,
+        dret[0], dret[1], dret[2], dret[3],
+        dgrid[0], dgrid[1], dgrid[2], dgrid[3], nalt, nazi);
+
+    for (int i = 0; i < ncells; i++) {
+        length += snprintf(buffer + length, buflen - length, "%s%.4g", (i > 0) ? "," : "", bgrid[i]);
+    }
+    length += snprintf(buffer + length, buflen - length, "], \"limiting_magnitude\": [");
+    for (int i = 0; i < ncells; i++) {
+        length += snprintf(buffer + length, buflen - length, "%s%.2f", (i > 0) ? "," : "", mgrid[i]);
+    }
+    length += snprintf(buffer + length, buflen - length, "], \"error\": false }");
+
+    free(bgrid);
+    free(mgrid);
+    return buffer;
+}
+
+/**
+ * @brief Limiting magnitude in one direction over a period, e.g. through a night
+ *
+ * @param year Year
+ * @param month Month (1-12)
+ * @param day Day of month
+ * @param hour Hour (UT) of the first value
+ * @param minute Minute
+ * @param second Second
+ * @param lon Geographic longitude in degrees (east positive)
+ * @param lat Geographic latitude in degrees (north positive)
+ * @param alt Altitude of the direction in degrees (90 = zenith)
+ * @param azi Azimuth of the direction in degrees (from north over east)
+ * @param step_minutes Time step in minutes
+ * @param count Number of values
+ * @param buflen Buffer length for output string; enlarged if too small
+ *
+ * @return JSON string with jd_ut, brightness (nL) and limiting_magnitude per step
+ */
+EMSCRIPTEN_KEEPALIVE
+const char *getLimitingMagnitudeCurve(int year, int month, int day, int hour, int minute, int second, double lon, double lat, double alt, double azi, double step_minutes, int count, int buflen)
+{
+    char error_msg[AS_MAXCH];
+    double julian_day, tstep, dgeo[3], datm[4] = {0, 0, 0, 0}, dobs[6] = {0, 0, 0, 0, 0, 0};
+    float *bret, *mret;
+    int length = 0;
+    char *buffer;
+
+    if (count <= 0) count = 1;
+    if (step_minutes <= 0) step_minutes = 10.0;
+    tstep = step_minutes / 1440.0;
+
+    // About 85 bytes per value
+    if (buflen < count * 120 + 1000) buflen = count * 120 + 1000;
+    buffer = malloc(buflen);
+    if (!buffer) return NULL;
+    bret = malloc(count * sizeof(float));
+    mret = malloc(count * sizeof(float));
+    if (!bret || !mret) {
+        snprintf(buffer, buflen, "{ \"error\": true, \"error_msg\": \"out of memory for %d values\" }", count);
+        free(bret);
+        free(mret);
+        return buffer;
+    }
+
+    swe_set_ephe_path("eph");
+    julian_day = calculate_julian_day(year, month, day, hour, minute, second);
+
+    dgeo[0] = lon;
+    dgeo[1] = lat;
+    dgeo[2] = 0.0;
+
+    if (swe_vis_limit_mag_series(julian_day, tstep, count, dgeo, datm, dobs, SEFLG_SWIEPH,
+                                 alt, azi, bret, mret, error_msg) == ERR) {
+        char escaped_error[500];
+        escape_json_string(error_msg, escaped_error, sizeof(escaped_error));
+        snprintf(buffer, buflen, "{ \"error\": true, \"error_msg\": \"%s\" }", escaped_error);
+        free(bret);
+        free(mret);
+        return buffer;
+    }
+
+    length += snprintf(buffer + length, buflen - length,
+        "{ \"initDate\": { \"year\": %d, \"month\": %d, \"day\": %d, \"hour\": %d, \"minute\": %d, "
+        "\"second\": %d, \"jd_ut\": %.6f }, \"alt\": %.4f, \"azi\": %.4f, \"values\": [",
+        year, month, day, hour, minute, second, julian_day, alt, azi);
+
+    for (int i = 0; i < count; i++) {
+        length += snprintf(buffer + length, buflen - length,
+            "%s{ \"jd_ut\": %.6f, \"brightness\": %.4g, \"limiting_magnitude\": %.2f }",
+            (i > 0) ? ", " : "", julian_day + i * tstep, bret[i], mret[i]);
+
+        // Check buffer space to prevent overflow
+        if (length > buflen - 1000) {
+            length += snprintf(buffer + length, buflen - length,
+                ", { \"warning\": \"Buffer limit reached, truncating results at value %d\" }", i);
+            break;
+        }
+    }
+    length += snprintf(buffer + length, buflen - length, "], \"error\": false }");
+
+    free(bret);
+    free(mret);
+    return buffer;
+}
+
+/**
+ * @brief Calculate astrocartography lines for Sun through Pluto
+ * @param year Year
+ * @param month Month (1-12)
+ * @param day Day of month
+ * @param hour Hour (UT)
+ * @param minute Minute
+ * @param second Second
+ * @param max_step Maximum spacing of ASC/DSC polyline points in degrees of arc
+ * @param buflen Size of output buffer (enlarged if too small)
+ * @return JSON string with MC/IC longitudes and ASC/DSC polylines per planet
+ */
+EMSCRIPTEN_KEEPALIVE
+const char *getAstrocartography(int year, int month, int day, int hour, int minute, int second, double max_step, int buflen)
+{
+    char planet_name[40], error_msg[AS_MAXCH];
+    double julian_day, dret[10];
+    double *xasc, *xdsc;
+    int32 nasc, ndsc;
+    int npmax, length = 0;
+    char *buffer;
+
+    if (max_step <= 0) max_step = 1.0;
+    npmax = (int)(360.0 / max_step) + 2;
+
+    // Two polylines of up to npmax points per planet, about 20 bytes per point
+    if (buflen < (SE_PLUTO + 1) * npmax * 40 + 10000) buflen = (SE_PLUTO + 1) * npmax * 40 + 10000;
+    buffer = malloc(buflen);
+    if (!buffer) return NULL;
+    xasc = malloc(2 * npmax * sizeof(double));
+    xdsc = malloc(2 * npmax * sizeof(double));
+    if (!xasc || !xdsc) {
+        snprintf(buffer, buflen, "{ \"error\": true, \"error_msg\": \"out of memory for %d points\" }", npmax);
+        free(xasc);
+        free(xdsc);
+        return buffer;
+    }
+
+    swe_set_ephe_path("eph");
+    julian_day = calculate_julian_day(year, month, day, hour, minute, second);
+
+    length += snprintf(buffer + length, buflen - length,
+        "{ \"initDate\": { \"year\": %d, \"month\": %d, \"day\": %d, "
+        "\"hour\": %d, \"minute\": %d, \"second\": %d, \"jd_ut\": %.6f }, "
+        "\"lines\": [ ",
+        year, month, day, hour, minute, second, julian_day);
+
+    for (int planet = SE_SUN; planet <= SE_PLUTO; planet++) {
+        const char *separator = (planet == SE_PLUTO) ? " " : ", ";
+        swe_get_planet_name(planet, planet_name);
+
+        if (swe_acg_lines(julian_day, planet, NULL, SEFLG_SWIEPH, 0, 85, max_step, npmax,
+                          dret, xasc, &nasc, xdsc, &ndsc, error_msg) == ERR) {
+            char escaped_error[500];
+            escape_json_string(error_msg, escaped_error, sizeof(escaped_error));
+            length += snprintf(buffer + length, buflen - length,
+                "{ \"id\": %d, \"name\": \"%s\", \"error\": true, \"error_msg\": \"%s\" }%s",
+                planet, planet_name, escaped_error, separator);
+            continue;
+        }
+
+        length += snprintf(buffer + length, buflen - length,
+            "{ \"id\": %d, \"name\": \"%s\", \"ra\": %.6f, \"dec\": %.6f, "
+            "\"mc\": %.4f, \"ic\": %.4f, \"asc\": [",
+            planet, planet_name, dret[2], dret[3], dret[0], dret[1]);
+        for (int i = 0; i < nasc; i++) {
+            length += snprintf(buffer + length, buflen - length, "%s[%.3f,%.3f]",
+                (i > 0) ? "," : "", xasc[2 * i], xasc[2 * i + 1]);
+        }
+        length += snprintf(buffer + length, buflen - length, "], \"dsc\": [");
+        for (int i = 0; i < ndsc; i++) {
+            length += snprintf(buffer + length, buflen - length, "%s[%.3f,%.3f]",
+                (i > 0) ? "," : "", xdsc[2 * i], xdsc[2 * i + 1]);
+        }
+        length += snprintf(buffer + length, buflen - length, "] }%s", separator);
+    }
+
+    length += snprintf(buffer + length, buflen - length, "], \"error\": false }");
+
+    free(xasc);
+    free(xdsc);
+    return buffer;
+}
+
+/**
+ * @brief Find parans of Sun through Pluto and fixed stars over a range of latitudes
+ * @param year Year
+ * @param month Month (1-12)
+ * @param day Day of month
+ * @param hour Hour (UT)
+ * @param minute Minute
+ * @param second Second
+ * @param lat_min Southernmost latitude
+ * @param lat_max Northernmost latitude
+ * @param lat_step Latitude step in degrees
+ * @param orb Maximum difference in sidereal time, degrees (1 degree = 4 minutes)
+ * @param star_list Comma-separated fixed star names (may be empty)
+ * @param buflen Size of output buffer (enlarged if too small)
+ * @return JSON string with the body list and the parans found; total is the
+ *         number found, of which count (at most 20000) are listed
+ *
+ * Fixed stars require sefstars.txt in the ephemeris directory.
+ */
+EMSCRIPTEN_KEEPALIVE
+const char *getParans(int year, int month, int day, int hour, int minute, int second,
+                      double lat_min, double lat_max, double lat_step, double orb,
+                      char *star_list, int buflen)
+{
+    static const char *event_names[9] = { "", "rise", "set", "", "culminate", "", "", "", "anticulminate" };
+    char error_msg[AS_MAXCH];
+    double julian_day, *dlat, *dpar;
+    int32 ipl[PARAN_MAX_BODIES], nbody = 0, npar, ntot;
+    char *star_names, *starname[PARAN_MAX_BODIES];
+    int nlat, npmax = 20000, length = 0;
+    char *buffer, *list_copy, *token;
+
+    if (lat_step <= 0) lat_step = 1.0;
+    if (lat_max < lat_min) lat_max = lat_min;
+    nlat = (int)((lat_max - lat_min) / lat_step + 1e-9) + 1;
+
+    star_names = malloc(PARAN_MAX_BODIES * SE_MAX_STNAME * 2);
+    list_copy = malloc(strlen(star_list) + 1);
+    dlat = malloc(nlat * sizeof(double));
+    dpar = malloc(7 * npmax * sizeof(double));
+    if (!star_names || !list_copy || !dlat || !dpar) {
+        free(star_names);
+        free(list_copy);
+        free(dlat);
+        free(dpar);
+        return NULL;
+    }
+    for (int planet = SE_SUN; planet <= SE_PLUTO; planet++) {
+        starname[nbody] = star_names + nbody * SE_MAX_STNAME * 2;
+        starname[nbody][0] = '\0';
+        ipl[nbody++] = planet;
+    }
+    strcpy(list_copy, star_list);
+    token = strtok(list_copy, ",");
+    while (token != NULL && nbody < PARAN_MAX_BODIES) {
+        while (*token == ' ') token++;
+        if (*token != '\0') {
+            starname[nbody] = star_names + nbody * SE_MAX_STNAME * 2;
+            snprintf(starname[nbody], SE_MAX_STNAME, "%s", token);
+            ipl[nbody++] = 0;
+        }
+        token = strtok(NULL, ",");
+    }
+    free(list_copy);
+
+    for (int i = 0; i < nlat; i++) {
+        dlat[i] = lat_min + i * lat_step;
+    }
+
+    swe_set_ephe_path("eph");
+    julian_day = calculate_julian_day(year, month, day, hour, minute, second);
+
+    npar = swe_parans(julian_day, nbody, ipl, starname, SEFLG_SWIEPH, 0, dlat, nlat, orb, 0,
+                      dpar, npmax, error_msg);
+    ntot = npar;
+    if (npar > npmax) npar = npmax;
+
+    // At most 122 bytes per paran record, and an escaped name per body
+    if (buflen < npar * 130 + nbody * (SE_MAX_STNAME * 2 + 4) + 1000)
+        buflen = npar * 130 + nbody * (SE_MAX_STNAME * 2 + 4) + 1000;
+    buffer = malloc(buflen);
+    if (!buffer) {
+        free(star_names);
+        free(dlat);
+        free(dpar);
+        return NULL;
+    }
+
+    if (npar == ERR) {
+        char escaped_error[500];
+        escape_json_string(error_msg, escaped_error, sizeof(escaped_error));
+        snprintf(buffer, buflen, "{ \"error\": true, \"error_msg\": \"%s\" }", escaped_error);
+        free(star_names);
+        free(dlat);
+        free(dpar);
+        return buffer;
+    }
+
+    length += snprintf(buffer + length, buflen - length,
+        "{ \"initDate\": { \"year\": %d, \"month\": %d, \"day\": %d, "
+        "\"hour\": %d, \"minute\": %d, \"second\": %d, \"jd_ut\": %.6f }, "
+        "\"orb\": %.4f, \"count\": %d, \"total\": %d, \"bodies\": [",
+        year, month, day, hour, minute, second, julian_day, orb, npar, ntot);
+
+    for (int i = 0; i < nbody; i++) {
+        char name[SE_MAX_STNAME * 2], escaped_name[SE_MAX_STNAME * 2];
+        if (starname[i][0] != '\0') {
+            strcpy(name, starname[i]);
+        } else {
+            swe_get_planet_name(ipl[i], name);
+        }
+        escape_json_string(name, escaped_name, sizeof(escaped_name));
+        length += snprintf(buffer + length, buflen - length, "%s\"%s\"", (i > 0) ? "," : "", escaped_name);
+    }
+
+    length += snprintf(buffer + length, buflen - length, "], \"parans\": [");
+    for (int i = 0; i < npar; i++) {
+        double *p = dpar + 7 * i;
+        if (length > buflen - 1000) {
+            length += snprintf(buffer + length, buflen - length,
+                "%s{ \"warning\": \"Buffer limit reached, truncating results at paran %d\" }",
+                (i > 0) ? "," : "", i);
+            break;
+        }
+        length += snprintf(buffer + length, buflen - length,
+            "%s{ \"lat\": %.2f, \"a\": %d, \"event_a\": \"%s\", \"b\": %d, \"event_b\": \"%s\", "
+            "\"ramc\": %.3f, \"orb\": %.3f }",
+            (i > 0) ? "," : "", p[0], (int)p[1], event_names[(int)p[2]],
+            (int)p[3], event_names[(int)p[4]], p[5], p[6]);
+    }
+    length += snprintf(buffer + length, buflen - length, "], \"error\": false }");
+
+    free(star_names);
+    free(dlat);
+    free(dpar);
+    return buffer;
+}
+
+/**
+ * @brief Calculate a table of primary directions
+ * @param year Year of birth
+ * @param month Month (1-12)
+ * @param day Day of month
+ * @param hour Hour (UT)
+ * @param minute Minute
+ * @param second Second
+ * @param lonG Longitude degrees
+ * @param lonM Longitude minutes
+ * @param lonS Longitude seconds
+ * @param lonEW "E" or "W"
+ * @param latG Latitude degrees
+ * @param latM Latitude minutes
+ * @param latS Latitude seconds
+ * @param latNS "N" or "S"
+ * @param iHouse "P" (Placidus semi-arcs) or "R" (Regiomontanus)
+ * @param zodiacal 0 = directions in mundo, 1 = in zodiaco
+ * @param key 0 = Ptolemy, 1 = Naibod, 2 = true solar arc
+ * @param max_arc Largest arc to return, degrees
+ * @param buflen Size of output buffer (enlarged if too small)
+ * @return JSON string with promissor, aspect, significator, arc and date of each direction
+ *
+ * Promissors are Sun through Pluto, significators are Sun through Pluto,
+ * Ascendant and MC; aspects are conjunction, sextiles, squares, trines
+ * and opposition. Positive arcs are direct, negative arcs converse.
+ */
+EMSCRIPTEN_KEEPALIVE
+const char *getPrimaryDirections(int year, int month, int day, int hour, int minute, int second,
+                                 int lonG, int lonM, int lonS, char *lonEW,
+                                 int latG, int latM, int latS, char *latNS, char *iHouse,
+                                 int zodiacal, int key, double max_arc, int buflen)
+{
+    static const double aspects[] = { 0, 60, -60, 90, -90, 120, -120, 180 };
+    const int npro = SE_PLUTO + 1, nsig = SE_PLUTO + 3, nasp = 8;
+    char error_msg[AS_MAXCH], names[SE_PLUTO + 3][40];
+    double julian_day, longitude, latitude, x[6];
+    double house_cusps[13], angles[10];
+    double xpro[2 * (SE_PLUTO + 1)], xsig[2 * (SE_PLUTO + 3)];
+    double darc[(SE_PLUTO + 1) * 8 * (SE_PLUTO + 3)], dtjd[(SE_PLUTO + 1) * 8 * (SE_PLUTO + 3)];
+    int length = 0, ndir = 0;
+    char *buffer;
+
+    // About 130 bytes per direction
+    if (buflen < npro * nasp * nsig * 130 + 1000) buflen = npro * nasp * nsig * 130 + 1000;
+    buffer = malloc(buflen);
+    if (!buffer) return NULL;
+
+    swe_set_ephe_path("eph");
+    julian_day = calculate_julian_day(year, month, day, hour, minute, second);
+    convert_coordinates(lonG, lonM, lonS, lonEW, &longitude);
+    convert_coordinates(latG, latM, latS, latNS, &latitude);
+
+    swe_houses_ex(julian_day, SEFLG_SWIEPH, latitude, longitude, (int)*iHouse, house_cusps, angles);
+    swe_calc_ut(julian_day, SE_ECL_NUT, 0, x, error_msg);
+
+    for (int planet = SE_SUN; planet <= SE_PLUTO; planet++) {
+        double xp[6];
+        if (swe_calc_ut(julian_day, planet, SEFLG_SWIEPH, xp, error_msg) < 0) {
+            char escaped_error[500];
+            escape_json_string(error_msg, escaped_error, sizeof(escaped_error));
+            snprintf(buffer, buflen, "{ \"error\": true, \"error_msg\": \"%s\" }", escaped_error);
+            return buffer;
+        }
+        xpro[2 * planet] = xsig[2 * planet] = xp[0];
+        xpro[2 * planet + 1] = xsig[2 * planet + 1] = xp[1];
+        swe_get_planet_name(planet, names[planet]);
+    }
+    xsig[2 * (SE_PLUTO + 1)] = angles[0];
+    xsig[2 * (SE_PLUTO + 1) + 1] = 0;
+    xsig[2 * (SE_PLUTO + 2)] = angles[1];
+    xsig[2 * (SE_PLUTO + 2) + 1] = 0;
+    strcpy(names[SE_PLUTO + 1], "Asc");
+    strcpy(names[SE_PLUTO + 2], "MC");
+
+    if (swe_primary_directions(angles[2], latitude, x[0], (int)*iHouse,
+                               zodiacal ? SE_PD_ZODIACAL : SE_PD_MUNDANE,
+                               xpro, npro, xsig, nsig, (double *)aspects, nasp, darc, error_msg) == ERR
+        || swe_primary_directions_dates(julian_day, SEFLG_SWIEPH, key, darc, npro * nasp * nsig,
+                                        dtjd, error_msg) == ERR) {
+        char escaped_error[500];
+        escape_json_string(error_msg, escaped_error, sizeof(escaped_error));
+        snprintf(buffer, buflen, "{ \"error\": true, \"error_msg\": \"%s\" }", escaped_error);
+        return buffer;
+    }
+
+    length += snprintf(buffer + length, buflen - length,
+        "{ \"initDate\": { \"year\": %d, \"month\": %d, \"day\": %d, "
+        "\"hour\": %d, \"minute\": %d, \"second\": %d, \"jd_ut\": %.6f }, "
+        "\"armc\": %.6f, \"directions\": [",
+        year, month, day, hour, minute, second, julian_day, angles[2]);
+
+    for (int ip = 0; ip < npro; ip++) {
+        for (int ia = 0; ia < nasp; ia++) {
+            for (int is = 0; is < nsig; is++) {
+                int k = (ip * nasp + ia) * nsig + is;
+                int dyear, dmonth, dday;
+                double dhour;
+                if (ip == is && aspects[ia] == 0) continue;
+                if (darc[k] == SE_PD_ARC_UNDEFINED || fabs(darc[k]) > max_arc) continue;
+                swe_revjul(dtjd[k], SE_GREG_CAL, &dyear, &dmonth, &dday, &dhour);
+                length += snprintf(buffer + length, buflen - length,
+                    "%s{ \"promissor\": \"%s\", \"aspect\": %.0f, \"significator\": \"%s\", "
+                    "\"arc\": %.4f, \"jd_ut\": %.2f, \"date\": \"%04d-%02d-%02d\" }",
+                    (ndir > 0) ? "," : "", names[ip], aspects[ia], names[is],
+                    darc[k], dtjd[k], dyear, dmonth, dday);
+                ndir++;
+            }
+        }
+    }
+
+    length += snprintf(buffer + length, buflen - length, "], \"error\": false }");
+    return buffer;
+}
+
+/**
+ * @brief Calculate the panchang (tithi, nakshatra, yoga, karana) for several days and cities
+ * @param year Year of first day
+ * @param month Month (1-12)
+ * @param day Day of month
+ * @param ndays Number of days
+ * @param locations Semicolon-separated list of "longitude,latitude" pairs in
+ *                  decimal degrees (east and north positive)
+ * @param buflen Size of output buffer (enlarged if too small)
+ * @return JSON string with sunrise and the elements in effect at sunrise, with their end times
+ *
+ * Sidereal positions use the Lahiri ayanamsha. Element numbers are 1-based:
+ * tithi 1-30, nakshatra 1-27, yoga 1-27, karana 1-60 within the lunar month.
+ */
+EMSCRIPTEN_KEEPALIVE
+const char *getPanchang(int year, int month, int day, int ndays, char *locations, int buflen)
+{
+    static const char *element_names[4] = { "tithi", "nakshatra", "yoga", "karana" };
+    char error_msg[AS_MAXCH];
+    double julian_day, *geopos, *dpan;
+    int nloc = 0, maxloc, length = 0;
+    char *buffer, *list_copy, *token;
+
+    if (ndays <= 0) ndays = 1;
+    maxloc = 1;
+    for (char *c = locations; *c != '\0'; c++) {
+        if (*c == ';') maxloc++;
+    }
+    geopos = malloc(3 * maxloc * sizeof(double));
+    list_copy = malloc(strlen(locations) + 1);
+    if (!geopos || !list_copy) {
+        free(geopos);
+        free(list_copy);
+        return NULL;
+    }
+    strcpy(list_copy, locations);
+    token = strtok(list_copy, ";");
+    while (token != NULL && nloc < maxloc) {
+        double lon, lat;
+        if (sscanf(token, "%lf,%lf", &lon, &lat) == 2) {
+            geopos[3 * nloc] = lon;
+            geopos[3 * nloc + 1] = lat;
+            geopos[3 * nloc + 2] = 0;
+            nloc++;
+        }
+        token = strtok(NULL, ";");
+    }
+    free(list_copy);
+
+    // About 260 bytes per location and day
+    if (buflen < nloc * ndays * 260 + 1000) buflen = nloc * ndays * 260 + 1000;
+    buffer = malloc(buflen);
+    if (!buffer) {
+        free(geopos);
+        return NULL;
+    }
+    dpan = malloc((nloc > 0 ? nloc : 1) * ndays * 9 * sizeof(double));
+    if (!dpan) {
+        snprintf(buffer, buflen, "{ \"error\": true, \"error_msg\": \"out of memory for %d days\" }", ndays);
+        free(geopos);
+        return buffer;
+    }
+
+    swe_set_ephe_path("eph");
+    swe_set_sid_mode(SE_SIDM_LAHIRI, 0, 0);
+    julian_day = calculate_julian_day(year, month, day, 0, 0, 0);
+
+    if (swe_panchang(julian_day, ndays, geopos, nloc, SEFLG_SWIEPH, dpan, error_msg) == ERR) {
+        char escaped_error[500];
+        escape_json_string(error_msg, escaped_error, sizeof(escaped_error));
+        snprintf(buffer, buflen, "{ \"error\": true, \"error_msg\": \"%s\" }", escaped_error);
+        free(geopos);
+        free(dpan);
+        return buffer;
+    }
+
+    length += snprintf(buffer + length, buflen - length,
+        "{ \"initDate\": { \"year\": %d, \"month\": %d, \"day\": %d, \"jd_ut\": %.6f }, "
+        "\"ndays\": %d, \"locations\": [",
+        year, month, day, julian_day, ndays);
+
+    for (int iloc = 0; iloc < nloc; iloc++) {
+        length += snprintf(buffer + length, buflen - length,
+            "%s{ \"lon\": %.4f, \"lat\": %.4f, \"days\": [",
+            (iloc > 0) ? "," : "", geopos[3 * iloc], geopos[3 * iloc + 1]);
+        for (int iday = 0; iday < ndays; iday++) {
+            double *p = dpan + (iloc * ndays + iday) * 9;
+            length += snprintf(buffer + length, buflen - length,
+                "%s{ \"sunrise\": %.6f", (iday > 0) ? "," : "", p[0]);
+            for (int k = 0; k < 4; k++) {
+                length += snprintf(buffer + length, buflen - length,
+                    ", \"%s\": %d, \"%s_end\": %.6f",
+                    element_names[k], (int)p[1 + 2 * k], element_names[k], p[2 + 2 * k]);
+            }
+            length += snprintf(buffer + length, buflen - length, " }");
+        }
+        length += snprintf(buffer + length, buflen - length, "] }");
+    }
+
+    length += snprintf(buffer + length, buflen - length, "], \"error\": false }");
+
+    free(geopos);
+    free(dpan);
+    return buffer;
+}
+
+/**
+ * @brief Find true lunar perigees and apogees over a range of years
+ * @param start_year First year (from January 1)
+ * @param end_year Last year (through December 31)
+ * @param buflen Size of output buffer (enlarged if too small)
+ * @return JSON string with time, distance and syzygy coincidence of each extremum;
+ *         total is the number found, of which count are listed
+ *
+ * An extremum is marked as coinciding with a new or full moon ("supermoon"
+ * at perigee) if the syzygy is less than one day away.
+ */
+EMSCRIPTEN_KEEPALIVE
+const char *getMoonExtremes(int start_year, int end_year, int buflen)
+{
+    char error_msg[AS_MAXCH];
+    double tjd_start, tjd_end, *dret;
+    int32 n, ntot, nmax;
+    int length = 0;
+    char *buffer;
+
+    if (end_year < start_year) end_year = start_year;
+    nmax = (end_year - start_year + 1) * 30;
+
+    // About 200 bytes per extremum
+    if (buflen < nmax * 200 + 1000) buflen = nmax * 200 + 1000;
+    buffer = malloc(buflen);
+    if (!buffer) return NULL;
+    dret = malloc(6 * nmax * sizeof(double));
+    if (!dret) {
+        snprintf(buffer, buflen, "{ \"error\": true, \"error_msg\": \"out of memory for %d extrema\" }", nmax);
+        return buffer;
+    }
+
+    swe_set_ephe_path("eph");
+    tjd_start = calculate_julian_day(start_year, 1, 1, 0, 0, 0);
+    tjd_end = calculate_julian_day(end_year + 1, 1, 1, 0, 0, 0);
+
+    n = swe_moon_extremes(tjd_start, tjd_end, SEFLG_SWIEPH | SEFLG_TRUEPOS, 1.0, dret, nmax, error_msg);
+    if (n == ERR) {
+        char escaped_error[500];
+        escape_json_string(error_msg, escaped_error, sizeof(escaped_error));
+        snprintf(buffer, buflen, "{ \"error\": true, \"error_msg\": \"%s\" }", escaped_error);
+        free(dret);
+        return buffer;
+    }
+
+    ntot = n;
+    if (n > nmax) n = nmax;
+    length += snprintf(buffer + length, buflen - length,
+        "{ \"start_year\": %d, \"end_year\": %d, \"count\": %d, \"total\": %d, \"extremes\": [",
+        start_year, end_year, n, ntot);
+
+    for (int i = 0; i < n; i++) {
+        double *p = dret + 6 * i;
+        int flags = (int)p[2];
+        int dyear, dmonth, dday;
+        double dhour;
+        const char *syzygy = "null";
+        if (flags & SE_MOON_AT_NEW) syzygy = "\"new\"";
+        if (flags & SE_MOON_AT_FULL) syzygy = "\"full\"";
+        swe_revjul(p[0], SE_GREG_CAL, &dyear, &dmonth, &dday, &dhour);
+        length += snprintf(buffer + length, buflen - length,
+            "%s{ \"type\": \"%s\", \"jd_ut\": %.6f, \"date\": \"%04d-%02d-%02d\", "
+            "\"distance_km\": %.1f, \"syzygy\": %s, \"syzygy_jd_ut\": %.6f, \"syzygy_distance_km\": %.1f }",
+            (i > 0) ? "," : "", (flags & SE_MOON_PERIGEE) ? "perigee" : "apogee",
+            p[0], dyear, dmonth, dday, p[1], syzygy, p[3], p[4]);
+    }
+
+    length += snprintf(buffer + length, buflen - length, "], \"error\": false }");
+
+    free(dret);
+    return buffer;
+}
+
+/* name of an eclipse type as returned by the eclipse functions */
+static const char *eclipse_type_name(int32 type)
+{
+    if (type & SE_ECL_ANNULAR_TOTAL) return "hybrid";
+    if (type & SE_ECL_TOTAL) return "total";
+    if (type & SE_ECL_ANNULAR) return "annular";
+    if (type & SE_ECL_PARTIAL) return "partial";
+    if (type & SE_ECL_PENUMBRAL) return "penumbral";
+    return "none";
+}
+
+/* appends one eclipse: tret and attr as of swe_eclipse_db_when();
+ * from_db = 0 for a searched eclipse, which has no gamma and Inex */
+static int print_eclipse(char *buffer, int buflen, int length, int first, int32 type,
+                         double *tret, double *attr, int from_db)
+{
+    int dyear, dmonth, dday, k;
+    double dhour;
+    char inex[32] = "null", saros[32] = "null", member[32] = "null", gamma[32] = "null";
+    swe_revjul(tret[0], SE_GREG_CAL, &dyear, &dmonth, &dday, &dhour);
+    if (attr[9] > -99999999) {
+        snprintf(saros, sizeof(saros), "%.0f", attr[9]);
+        snprintf(member, sizeof(member), "%.0f", attr[10]);
+        if (from_db) snprintf(inex, sizeof(inex), "%.0f", attr[11]);
+    }
+    if (from_db) snprintf(gamma, sizeof(gamma), "%.4f", attr[2]);
+    length += snprintf(buffer + length, buflen - length,
+        "%s{ \"type\": \"%s\", \"central\": %s, \"jd_ut\": %.6f, \"date\": \"%04d-%02d-%02d\", "
+        "\"magnitude\": %.4f, \"magnitude2\": %.4f, \"gamma\": %s, \"saros\": %s, "
+        "\"saros_member\": %s, \"inex\": %s, \"source\": \"%s\", \"contacts\": [",
+        first ? "" : ",", eclipse_type_name(type), (type & SE_ECL_CENTRAL) ? "true" : "false",
+        tret[0], dyear, dmonth, dday, attr[0], attr[1], gamma, saros, member, inex,
+        from_db ? "database" : "search");
+    for (k = 2; k < 8; k++)
+        length += snprintf(buffer + length, buflen - length, "%s%.6f", k > 2 ? "," : "", tret[k]);
+    length += snprintf(buffer + length, buflen - length, "] }");
+    return length;
+}
+
+/**
+ * @brief Find the next solar or lunar eclipses after a date
+ * @param year Year of start date
+ * @param month Month (1-12)
+ * @param day Day of month
+ * @param kind 0 = solar, 1 = lunar
+ * @param ifltype Eclipse types (SE_ECL_TOTAL, SE_ECL_PARTIAL etc.), 0 = all
+ * @param count Number of eclipses
+ * @param buflen Size of output buffer (enlarged if too small)
+ * @return JSON string with type, maximum, magnitude, gamma, Saros and Inex
+ *         series and contact times of each eclipse
+ *
+ * Eclipses are read from the eclipse database seecldb.bin where it covers
+ * the dates, and searched beyond it; "source" tells which. Searched
+ * eclipses have no gamma and Inex number.
+ */
+EMSCRIPTEN_KEEPALIVE
+const char *getEclipses(int year, int month, int day, int kind, int ifltype, int count, int buflen)
+{
+    char error_msg[AS_MAXCH];
+    double tjd, tret[10], attr[20], geopos[3] = {0, 0, 0};
+    int32 type;
+    int length = 0, from_db;
+    char *buffer;
+
+    if (count < 1) count = 1;
+    if (count > 1000) count = 1000;
+    kind = (kind == SE_ECLDB_LUNAR) ? SE_ECLDB_LUNAR : SE_ECLDB_SOLAR;
+    // About 400 bytes per eclipse
+    if (buflen < count * 400 + 1000) buflen = count * 400 + 1000;
+    buffer = malloc(buflen);
+    if (!buffer) return NULL;
+
+    swe_set_ephe_path("eph");
+    tjd = calculate_julian_day(year, month, day, 0, 0, 0);
+    length += snprintf(buffer + length, buflen - length,
+        "{ \"kind\": \"%s\", \"eclipses\": [", kind == SE_ECLDB_LUNAR ? "lunar" : "solar");
+
+    for (int i = 0; i < count; i++) {
+        type = swe_eclipse_db_when(tjd, kind, ifltype, tret, attr, 0, error_msg);
+        from_db = (type != ERR);
+        if (!from_db) {
+            if (kind == SE_ECLDB_SOLAR)
+                type = swe_sol_eclipse_when_glob(tjd, SEFLG_SWIEPH, ifltype, tret, 0, error_msg);
+            else
+                type = swe_lun_eclipse_when(tjd, SEFLG_SWIEPH, ifltype, tret, 0, error_msg);
+            if (type != ERR) {
+                if (kind == SE_ECLDB_SOLAR) {
+                    swe_sol_eclipse_where(tret[0], SEFLG_SWIEPH, geopos, attr, error_msg);
+                    attr[0] = attr[8];
+                } else {
+                    swe_lun_eclipse_how(tret[0], SEFLG_SWIEPH, geopos, attr, error_msg);
+                }
+            }
+        }
+        if (type == ERR) {
+            char escaped_error[500];
+            escape_json_string(error_msg, escaped_error, sizeof(escaped_error));
+            snprintf(buffer, buflen, "{ \"error\": true, \"error_msg\": \"%s\" }", escaped_error);
+            return buffer;
+        }
+        length = print_eclipse(buffer, buflen, length, i == 0, type, tret, attr, from_db);
+        tjd = tret[0] + 1;
+    }
+
+    length += snprintf(buffer + length, buflen - length, "], \"error\": false }");
+    return buffer;
+}
+
+/**
+ * @brief All eclipses of a Saros series in the eclipse database
+ * @param kind 0 = solar, 1 = lunar
+ * @param saros Saros series number
+ * @param buflen Size of output buffer (enlarged if too small)
+ * @return JSON string with the members of the series covered by seecldb.bin,
+ *         in the format of getEclipses()
+ */
+EMSCRIPTEN_KEEPALIVE
+const char *getSarosSeries(int kind, int saros, int buflen)
+{
+    char error_msg[AS_MAXCH];
+    double *tmax, tret[10], attr[20];
+    int32 n, type;
+    int length = 0, nout = 0;
+    char *buffer;
+
+    kind = (kind == SE_ECLDB_LUNAR) ? SE_ECLDB_LUNAR : SE_ECLDB_SOLAR;
+    swe_set_ephe_path("eph");
+    n = swe_eclipse_db_saros(kind, saros, NULL, 0, error_msg);
+    if (n < 0) n = 0;
+
+    if (buflen < n * 400 + 1000) buflen = n * 400 + 1000;
+    buffer = malloc(buflen);
+    if (!buffer) return NULL;
+    tmax = malloc((n + 1) * sizeof(double));
+    if (!tmax) {
+        snprintf(buffer, buflen, "{ \"error\": true, \"error_msg\": \"out of memory for %d eclipses\" }", n);
+        return buffer;
+    }
+
+    if (swe_eclipse_db_saros(kind, saros, tmax, n, error_msg) == ERR) {
+        char escaped_error[500];
+        escape_json_string(error_msg, escaped_error, sizeof(escaped_error));
+        snprintf(buffer, buflen, "{ \"error\": true, \"error_msg\": \"%s\" }", escaped_error);
+        free(tmax);
+        return buffer;
+    }
+
+    length += snprintf(buffer + length, buflen - length,
+        "{ \"kind\": \"%s\", \"saros\": %d, \"eclipses\": [",
+        kind == SE_ECLDB_LUNAR ? "lunar" : "solar", saros);
+    for (int i = 0; i < n; i++) {
+        // the member itself is the next eclipse of its kind after tmax - 1
+        type = swe_eclipse_db_when(tmax[i] - 1, kind, 0, tret, attr, 0, error_msg);
+        if (type == ERR) continue;
+        length = print_eclipse(buffer, buflen, length, nout++ == 0, type, tret, attr, 1);
+    }
+    length += snprintf(buffer + length, buflen - length, "], \"error\": false }");
+
+    free(tmax);
+    return buffer;
+}
+
+/**
+ * @brief Find declination events of Sun through Pluto
+ * @param year Year of start date
+ * @param month Month (1-12)
+ * @param day Day of month
+ * @param ndays Number of days to search
+ * @param buflen Size of output buffer (enlarged if too small)
+ * @return JSON string with out-of-bounds periods, parallels and contraparallels;
+ *         total is the number of events found, of which count are listed
+ *
+ * A body is out of bounds while its declination exceeds the obliquity of
+ * the ecliptic. An out-of-bounds period that begins before or ends after
+ * the search range has a jd of 0 at the open end.
+ */
+EMSCRIPTEN_KEEPALIVE
+const char *getDeclinationEvents(int year, int month, int day, int ndays, int buflen)
+{
+    static const char *event_names[9] = { "", "oob_begin", "oob_end", "", "parallel", "", "", "", "contraparallel" };
+    char error_msg[AS_MAXCH], names[SE_PLUTO + 1][40];
+    int32 ipl[SE_PLUTO + 1], n, ntot, nmax;
+    double tjd_start, *dret, oob_begin[SE_PLUTO + 1];
+    int length = 0, nper = 0;
+    char *buffer;
+
+    if (ndays <= 0) ndays = 1;
+    nmax = ndays * 4 + 100;
+
+    // About 150 bytes per event
+    if (buflen < nmax * 150 + 1000) buflen = nmax * 150 + 1000;
+    buffer = malloc(buflen);
+    if (!buffer) return NULL;
+    dret = malloc(5 * nmax * sizeof(double));
+    if (!dret) {
+        snprintf(buffer, buflen, "{ \"error\": true, \"error_msg\": \"out of memory for %d events\" }", nmax);
+        return buffer;
+    }
+
+    swe_set_ephe_path("eph");
+    tjd_start = calculate_julian_day(year, month, day, 0, 0, 0);
+    for (int planet = SE_SUN; planet <= SE_PLUTO; planet++) {
+        ipl[planet] = planet;
+        swe_get_planet_name(planet, names[planet]);
+    }
+
+    n = swe_decl_events(tjd_start, tjd_start + ndays, ipl, SE_PLUTO + 1, SEFLG_SWIEPH, 1, 0,
+                        dret, nmax, error_msg);
+    if (n == ERR) {
+        char escaped_error[500];
+        escape_json_string(error_msg, escaped_error, sizeof(escaped_error));
+        snprintf(buffer, buflen, "{ \"error\": true, \"error_msg\": \"%s\" }", escaped_error);
+        free(dret);
+        return buffer;
+    }
+
+    ntot = n;
+    if (n > nmax) n = nmax;
+    length += snprintf(buffer + length, buflen - length,
+        "{ \"initDate\": { \"year\": %d, \"month\": %d, \"day\": %d, \"jd_ut\": %.6f }, "
+        "\"ndays\": %d, \"count\": %d, \"total\": %d, \"events\": [",
+        year, month, day, tjd_start, ndays, n, ntot);
+
+    for (int i = 0; i < n; i++) {
+        double *p = dret + 5 * i;
+        length += snprintf(buffer + length, buflen - length,
+            "%s{ \"type\": \"%s\", \"jd_ut\": %.6f, \"body\": \"%s\", \"other\": %s%s%s, \"decl\": %.4f }",
+            (i > 0) ? "," : "", event_names[(int)p[1]], p[0], names[(int)p[2]],
+            (p[3] < 0) ? "" : "\"", (p[3] < 0) ? "null" : names[(int)p[3]], (p[3] < 0) ? "" : "\"", p[4]);
+    }
+
+    // Pair out-of-bounds begin and end events into periods
+    length += snprintf(buffer + length, buflen - length, "], \"oob_periods\": [");
+    for (int planet = SE_SUN; planet <= SE_PLUTO; planet++) {
+        oob_begin[planet] = -1;
+    }
+    for (int i = 0; i < n; i++) {
+        double *p = dret + 5 * i;
+        int b = (int)p[2];
+        if ((int)p[1] == SE_DECL_OOB_BEGIN) {
+            oob_begin[b] = p[0];
+        } else if ((int)p[1] == SE_DECL_OOB_END) {
+            length += snprintf(buffer + length, buflen - length,
+                "%s{ \"body\": \"%s\", \"begin_jd_ut\": %.6f, \"end_jd_ut\": %.6f }",
+                (nper++ > 0) ? "," : "", names[b], (oob_begin[b] < 0) ? 0 : oob_begin[b], p[0]);
+            oob_begin[b] = -1;
+        }
+    }
+    for (int planet = SE_SUN; planet <= SE_PLUTO; planet++) {
+        if (oob_begin[planet] >= 0) {
+            length += snprintf(buffer + length, buflen - length,
+                "%s{ \"body\": \"%s\", \"begin_jd_ut\": %.6f, \"end_jd_ut\": 0 }",
+                (nper++ > 0) ? "," : "", names[planet], oob_begin[planet]);
+        }
+    }
+
+    length += snprintf(buffer + length, buflen - length, "], \"error\": false }");
+
+    free(dret);
+    return buffer;
+}
+
+/**
+ * @brief Find conjunctions of Sun through Pluto with fixed stars
+ * @param year Year of start date
+ * @param month Month (1-12)
+ * @param day Day of month
+ * @param ndays Number of days to search
+ * @param maxmag Faintest star magnitude to include
+ * @param latorb Maximum difference in ecliptic latitude, degrees (0 = longitude only)
+ * @param buflen Size of output buffer (enlarged if too small)
+ * @return JSON string with time, planet, star and longitude of each conjunction;
+ *         total is the number found, of which count are listed
+ *
+ * Requires sefstars.txt in the ephemeris directory.
+ */
+EMSCRIPTEN_KEEPALIVE
+const char *getFixedStarConjunctions(int year, int month, int day, int ndays, double maxmag, double latorb, int buflen)
+{
+    char error_msg[AS_MAXCH], names[SE_PLUTO + 1][40];
+    int32 ipl[SE_PLUTO + 1], n, ntot, nmax;
+    double tjd_start, *dret;
+    int length = 0;
+    char *buffer;
+
+    if (ndays <= 0) ndays = 1;
+    nmax = ndays * 50 + 1000;
+    dret = malloc(5 * nmax * sizeof(double));
+    if (!dret) return NULL;
+
+    swe_set_ephe_path("eph");
+    tjd_start = calculate_julian_day(year, month, day, 0, 0, 0);
+    for (int planet = SE_SUN; planet <= SE_PLUTO; planet++) {
+        ipl[planet] = planet;
+        swe_get_planet_name(planet, names[planet]);
+    }
+
+    n = swe_fixstar_conjunctions(tjd_start, tjd_start + ndays, ipl, SE_PLUTO + 1, SEFLG_SWIEPH,
+                                 maxmag, latorb, dret, nmax, error_msg);
+    ntot = n;
+    if (n > nmax) n = nmax;
+
+    // About 160 bytes per conjunction, up to 250 with a long star name
+    if (buflen < n * 250 + 1000) buflen = n * 250 + 1000;
+    buffer = malloc(buflen);
+    if (!buffer) {
+        free(dret);
+        return NULL;
+    }
+
+    if (n == ERR) {
+        char escaped_error[500];
+        escape_json_string(error_msg, escaped_error, sizeof(escaped_error));
+        snprintf(buffer, buflen, "{ \"error\": true, \"error_msg\": \"%s\" }", escaped_error);
+        free(dret);
+        return buffer;
+    }
+
+    length += snprintf(buffer + length, buflen - length,
+        "{ \"initDate\": { \"year\": %d, \"month\": %d, \"day\": %d, \"jd_ut\": %.6f }, "
+        "\"ndays\": %d, \"count\": %d, \"total\": %d, \"conjunctions\": [",
+        year, month, day, tjd_start, ndays, n, ntot);
+
+    for (int i = 0; i < n; i++) {
+        double *p = dret + 5 * i;
+        char star[SE_MAX_STNAME * 2], escaped_star[SE_MAX_STNAME * 2];
+        double mag = 0;
+        if (length > buflen - 1000) {
+            length += snprintf(buffer + length, buflen - length,
+                "%s{ \"warning\": \"Buffer limit reached, truncating results at conjunction %d\" }",
+                (i > 0) ? "," : "", i);
+            break;
+        }
+        snprintf(star, sizeof(star), "%d", (int)p[2]);
+        swe_fixstar2_mag(star, &mag, error_msg);
+        escape_json_string(star, escaped_star, sizeof(escaped_star));
+        length += snprintf(buffer + length, buflen - length,
+            "%s{ \"jd_ut\": %.6f, \"planet\": \"%s\", \"star\": \"%s\", \"mag\": %.2f, "
+            "\"long\": %.4f, \"long_s\": \"%s\", \"lat_diff\": %.4f }",
+            (i > 0) ? "," : "", p[0], names[(int)p[1]], escaped_star, mag,
+            p[3], format_degrees(p[3], BIT_ZODIAC), p[4]);
+    }
+
+    length += snprintf(buffer + length, buflen - length, "], \"error\": false }");
+
+    free(dret);
+    return buffer;
+}
+
+/**
+ * @brief Fit apparent positions of a body by Chebyshev polynomial segments
+ * @param year Year of start date
+ * @param month Month (1-12)
+ * @param day Day of month
+ * @param ndays Length of the range in days
+ * @param planet Body number (SE_SUN = 0 ... SE_PLUTO = 9, asteroids as SE_AST_OFFSET + n)
+ * @param tol_arcsec Maximum error of longitude and latitude in arc seconds
+ * @param ncoe Coefficients per coordinate (2-32, e.g. 12)
+ * @param buflen Size of output buffer (enlarged if too small)
+ * @return JSON string with the segments
+ *
+ * Each segment holds t0, t1 (Julian day UT) and the coefficients of
+ * longitude, latitude and distance (AU). The client evaluates them with
+ * SwissEphemeris.evaluateChebyshev(), so a graph or animation needs no
+ * further WASM calls. Longitude is continuous within a segment.
+ */
+EMSCRIPTEN_KEEPALIVE
+const char *getChebyshevFit(int year, int month, int day, int ndays, int planet, double tol_arcsec, int ncoe, int buflen)
+{
+    char error_msg[AS_MAXCH], name[AS_MAXCH];
+    double tjd_start, *dseg;
+    int32 n, nmax, segsize;
+    int length = 0;
+    char *buffer;
+
+    if (ndays < 1) ndays = 1;
+    if (ncoe < 2 || ncoe > SE_CHEB_MAXCOE) ncoe = 12;
+    if (tol_arcsec <= 0) tol_arcsec = 1;
+    segsize = SE_CHEB_SEGSIZE(ncoe);
+    nmax = ndays * 2 + 16;
+
+    // About 22 bytes per coefficient
+    if (buflen < nmax * (segsize * 22 + 100) + 1000) buflen = nmax * (segsize * 22 + 100) + 1000;
+    buffer = malloc(buflen);
+    dseg = malloc(nmax * segsize * sizeof(double));
+    if (!buffer || !dseg) {
+        free(buffer);
+        free(dseg);
+        return NULL;
+    }
+
+    swe_set_ephe_path("eph");
+    tjd_start = calculate_julian_day(year, month, day, 0, 0, 0);
+
+    n = swe_cheb_fit(tjd_start, tjd_start + ndays, planet, SEFLG_SWIEPH, tol_arcsec / 3600.0, ncoe, dseg, nmax, error_msg);
+    if (n == ERR) {
+        char escaped_error[500];
+        escape_json_string(error_msg, escaped_error, sizeof(escaped_error));
+        snprintf(buffer, buflen, "{ \"error\": true, \"error_msg\": \"%s\" }", escaped_error);
+        free(dseg);
+        return buffer;
+    }
+
+    swe_get_planet_name(planet, name);
+    length += snprintf(buffer + length, buflen - length,
+        "{ \"planet\": %d, \"name\": \"%s\", \"jd_start\": %.6f, \"jd_end\": %.6f, "
+        "\"tolerance_arcsec\": %g, \"ncoe\": %d, \"segments\": [",
+        planet, name, tjd_start, tjd_start + ndays, tol_arcsec, ncoe);
+
+    for (int i = 0; i < n; i++) {
+        double *p = dseg + i * segsize;
+        length += snprintf(buffer + length, buflen - length,
+            "%s{ \"t0\": %.8f, \"t1\": %.8f", (i > 0) ? "," : "", p[0], p[1]);
+        for (int c = 0; c < 3; c++) {
+            static const char *coord[] = {"lon", "lat", "dist"};
+            length += snprintf(buffer + length, buflen - length, ", \"%s\": [", coord[c]);
+            for (int j = 0; j < ncoe; j++) {
+                length += snprintf(buffer + length, buflen - length,
+                    "%s%.14g", (j > 0) ? "," : "", p[2 + c * ncoe + j]);
+            }
+            length += snprintf(buffer + length, buflen - length, "]");
+        }
+        length += snprintf(buffer + length, buflen - length, " }");
+    }
+
+    length += snprintf(buffer + length, buflen - length, "], \"error\": false }");
+
+    free(dseg);
+    return buffer;
+}
+
+/**
+ * @brief Positions of numbered asteroids from the element catalogue seastel.bin
+ * @param year Year
+ * @param month Month (1-12)
+ * @param day Day of month
+ * @param hour Hour (UT)
+ * @param minute Minute
+ * @param first Index of the first asteroid in the catalogue (0 = lowest number)
+ * @param count Number of asteroids
+ * @param secular 1 = with secular perturbations of node and perihelion, 0 = two-body orbits
+ * @param buflen Size of output buffer (enlarged if too small)
+ * @return JSON string with MPC number, longitude, latitude and distance of each asteroid
+ *
+ * The catalogue is built from the MPC orbit database with the tool sweastel
+ * and placed in the eph directory. Asteroids without .se1 files are also
+ * computed from it by getPlanet() etc. The two-body orbits are good to
+ * about 1' within a year of the epoch of the elements, and drift by
+ * several arcminutes per year beyond.
+ */
+EMSCRIPTEN_KEEPALIVE
+const char *getAsteroidsFromElements(int year, int month, int day, int hour, int minute, int first, int count, int secular, int buflen)
+{
+    char error_msg[AS_MAXCH];
+    double tjd_ut, *xret;
+    int32 *anum, n, ncat;
+    int length = 0;
+    char *buffer;
+
+    swe_set_ephe_path("eph");
+    // No more than the catalogue holds from first on
+    ncat = swe_calc_ast_elements(0, SEFLG_SWIEPH, 0, 0, NULL, NULL, NULL);
+    if (ncat > first && count > ncat - first) count = ncat - first;
+    if (count < 1) count = 1;
+    // At most 48 bytes per asteroid for distances below 100000 AU
+    if (buflen < count * 60 + 1000) buflen = count * 60 + 1000;
+    buffer = malloc(buflen);
+    xret = malloc(count * 3 * sizeof(double));
+    anum = malloc(count * sizeof(int32));
+    if (!buffer || !xret || !anum) {
+        free(buffer);
+        free(xret);
+        free(anum);
+        return NULL;
+    }
+
+    swe_set_ast_elem_mode(secular ? SE_ASTEL_SECULAR : 0);
+    tjd_ut = calculate_julian_day(year, month, day, hour, minute, 0);
+
+    n = swe_calc_ast_elements(tjd_ut, SEFLG_SWIEPH, first, count, xret, anum, error_msg);
+    if (n == ERR) {
+        char escaped_error[500];
+        escape_json_string(error_msg, escaped_error, sizeof(escaped_error));
+        snprintf(buffer, buflen, "{ \"error\": true, \"error_msg\": \"%s\" }", escaped_error);
+        free(xret);
+        free(anum);
+        return buffer;
+    }
+
+    length += snprintf(buffer + length, buflen - length,
+        "{ \"jd_ut\": %.6f, \"first\": %d, \"count\": %d, \"asteroids\": [", tjd_ut, first, n);
+    for (int i = 0; i < n; i++) {
+        if (length > buflen - 1000) {
+            length += snprintf(buffer + length, buflen - length,
+                "%s{ \"warning\": \"Buffer limit reached, truncating results at asteroid %d\" }",
+                (i > 0) ? "," : "", i);
+            break;
+        }
+        length += snprintf(buffer + length, buflen - length,
+            "%s[%d,%.5f,%.5f,%.6f]", (i > 0) ? "," : "",
+            anum[i], xret[3 * i], xret[3 * i + 1], xret[3 * i + 2]);
+    }
+    length += snprintf(buffer + length, buflen - length, "], \"error\": false }");
+
+    free(xret);
+    free(anum);
+    return buffer;
+}
+
+/**
+ * @brief Numbered asteroids of the element catalogue near given ecliptic longitudes
+ * @param year Year
+ * @param month Month (1-12)
+ * @param day Day of month
+ * @param hour Hour (UT)
+ * @param minute Minute
+ * @param second Second
+ * @param point_list Comma-separated ecliptic longitudes in degrees (e.g. natal planets and angles)
+ * @param orb Maximum difference in longitude in degrees (up to 30)
+ * @param buflen Size of output buffer (enlarged if too small)
+ * @return JSON string with the matches, sorted by point and closeness; "total"
+ *         is the number found, more than "count" if the list was truncated
+ *
+ * Searches all asteroids of seastel.bin (see getAsteroidsFromElements()).
+ * A coarse longitude index is built on the first query for a date and 
+ * reused for other queries in the same 8-day period, which then take milliseconds.
+ */
+EMSCRIPTEN_KEEPALIVE
+const char *getAsteroidsNearPoints(int year, int month, int day, int hour, int minute, int second, char *point_list, double orb, int buflen)
+{
+    char error_msg[AS_MAXCH];
+    double tjd_ut, points[100], *dret;
+    int32 n, ntot, npoints = 0, nmax = 100000;
+    int length = 0;
+    char *buffer, *list_copy, *token;
+
+    list_copy = malloc(strlen(point_list) + 1);
+    dret = malloc(nmax * 6 * sizeof(double));
+    if (!list_copy || !dret) {
+        free(list_copy);
+        free(dret);
+        return NULL;
+    }
+    strcpy(list_copy, point_list);
+    token = strtok(list_copy, ",");
+    while (token != NULL && npoints < 100) {
+        points[npoints++] = atof(token);
+        token = strtok(NULL, ",");
+    }
+    free(list_copy);
+
+    swe_set_ephe_path("eph");
+    tjd_ut = calculate_julian_day(year, month, day, hour, minute, second);
+    ntot = n = swe_ast_elem_near(tjd_ut, SEFLG_SWIEPH, points, npoints, orb, dret, nmax, error_msg);
+    if (n > nmax) n = nmax;
+
+    // About 115 bytes per match
+    if (n > 0 && buflen < n * 140 + 1000) buflen = n * 140 + 1000;
+    if (buflen < 1000) buflen = 1000;
+    buffer = malloc(buflen);
+    if (!buffer) {
+        free(dret);
+        return NULL;
+    }
+    if (n == ERR) {
+        char escaped_error[500];
+        escape_json_string(error_msg, escaped_error, sizeof(escaped_error));
+        snprintf(buffer, buflen, "{ \"error\": true, \"error_msg\": \"%s\" }", escaped_error);
+        free(dret);
+        return buffer;
+    }
+
+    length += snprintf(buffer + length, buflen - length,
+        "{ \"jd_ut\": %.6f, \"orb\": %g, \"count\": %d, \"total\": %d, \"matches\": [",
+        tjd_ut, orb, n, ntot);
+    for (int i = 0; i < n; i++) {
+        double *dp = dret + 6 * i;
+        length += snprintf(buffer + length, buflen - length,
+            "%s{ \"number\": %.0f, \"point\": %.0f, \"long\": %.5f, \"lat\": %.5f, \"distance\": %.6f, \"diff\": %.5f }",
+            (i > 0) ? "," : "", dp[0], dp[1], dp[2], dp[3], dp[4], dp[5]);
+
+        // Check buffer space to prevent overflow
+        if (length > buflen - 1000) {
+            length += snprintf(buffer + length, buflen - length,
+                ", { \"warning\": \"Buffer limit reached, truncating results at match %d\" }", i);
+            break;
+        }
+    }
+    length += snprintf(buffer + length, buflen - length, "], \"error\": false }");
+
+    free(dret);
+    return buffer;
+}
+
+/**
+ * @brief Object of the chart wheel layout, sorted by longitude
+ */
+struct wheel_item {
+    double lon;
+    int index;      /**< position in the input list */
+};
+
+/**
+ * @brief Run of neighbouring glyphs spaced by the glyph width
+ */
+struct wheel_cluster {
+    int first;      /**< first object, index into the unwrapped longitudes */
+    int count;
+    double sum;     /**< sum of unwrapped longitudes */
+};
+
+static int wheel_compare(const void *a, const void *b)
+{
+    double d = ((const struct wheel_item *) a)->lon - ((const struct wheel_item *) b)->lon;
+    return (d > 0) - (d < 0);
+}
+
+/* a cluster is centred on the mean longitude of its objects, which gives
+ * the smallest sum of squared leader lines for a rigid run of glyphs */
+static double wheel_left(const struct wheel_cluster *c, double width)
+{
+    return c->sum / c->count - (c->count - 1) * width / 2;
+}
+
+static double wheel_right(const struct wheel_cluster *c, double width)
+{
+    return c->sum / c->count + (c->count - 1) * width / 2;
+}
+
+/**
+ * @brief Non-overlapping display angles for glyphs around the wheel
+ *
+ * The objects are sorted and unwrapped starting after the largest gap.
+ * A sweep adds them one by one; when a cluster overlaps its left
+ * neighbour the two are merged and re-centred, which may cascade. Then
+ * the first and last clusters are relaxed across 0 degrees: while they
+ * overlap, the first cluster is moved to the end and the sweep repeated.
+ *
+ * @param lon Longitudes of n objects
+ * @param n Number of objects
+ * @param width Glyph width in degrees; at most 360 / n
+ * @param angle Output: display angle of each object
+ * @return Number of clusters
+ */
+static int wheel_layout(const double *lon, int n, double width, double *angle)
+{
+    struct wheel_item *item = malloc(n * sizeof(struct wheel_item));
+    struct wheel_cluster *cl = malloc(2 * n * sizeof(struct wheel_cluster));
+    double *u = malloc(2 * n * sizeof(double));
+    double gap, maxgap = -1;
+    int i, j, k, start = 0, head = 0, tail = 0, nclusters = 0;
+    if (!item || !cl || !u) {
+        free(item);
+        free(cl);
+        free(u);
+        return -1;
+    }
+    for (i = 0; i < n; i++) {
+        item[i].lon = swe_degnorm(lon[i]);
+        item[i].index = i;
+    }
+    qsort(item, n, sizeof(struct wheel_item), wheel_compare);
+    for (i = 0; i < n; i++) {
+        gap = (i + 1 < n) ? item[i + 1].lon - item[i].lon : item[0].lon + 360 - item[i].lon;
+        if (gap > maxgap) {
+            maxgap = gap;
+            start = (i + 1) % n;
+        }
+    }
+    for (j = 0; j < n; j++) {
+        u[j] = item[(start + j) % n].lon;
+        if (j > 0 && u[j] < u[j - 1]) u[j] += 360;
+    }
+    for (j = 0; j < n; j++) {
+        u[j + n] = u[j] + 360;
+    }
+    /* cl[head..tail-1] is the list of clusters */
+    for (j = 0; j < n; j++) {
+        cl[tail].first = j;
+        cl[tail].count = 1;
+        cl[tail].sum = u[j];
+        tail++;
+        while (tail - head > 1 && wheel_left(&cl[tail - 1], width) - wheel_right(&cl[tail - 2], width) < width) {
+            cl[tail - 2].count += cl[tail - 1].count;
+            cl[tail - 2].sum += cl[tail - 1].sum;
+            tail--;
+        }
+    }
+    while (tail - head > 1
+           && wheel_left(&cl[head], width) + 360 - wheel_right(&cl[tail - 1], width) < width) {
+        cl[tail].first = cl[head].first + n;
+        cl[tail].count = cl[head].count;
+        cl[tail].sum = cl[head].sum + 360.0 * cl[head].count;
+        head++;
+        tail++;
+        while (tail - head > 1 && wheel_left(&cl[tail - 1], width) - wheel_right(&cl[tail - 2], width) < width) {
+            cl[tail - 2].count += cl[tail - 1].count;
+            cl[tail - 2].sum += cl[tail - 1].sum;
+            tail--;
+        }
+    }
+    for (i = head; i < tail; i++) {
+        double left = wheel_left(&cl[i], width);
+        for (k = 0; k < cl[i].count; k++) {
+            j = (cl[i].first + k) % n;
+            angle[item[(start + j) % n].index] = swe_degnorm(left + k * width);
+        }
+        nclusters++;
+    }
+    free(item);
+    free(cl);
+    free(u);
+    return nclusters;
+}
+
+/**
+ * @brief Layout of glyphs on a chart wheel without overlaps
+ *
+ * Spreads objects whose glyphs would overlap so that neighbours are at
+ * least glyph_width apart, moving them as little as possible. Each
+ * object gets a display angle and the offset from its true longitude,
+ * for a leader line. 1000 objects take well under a millisecond.
+ *
+ * @param lon_list Comma-separated longitudes in degrees, e.g. from getSpecificAsteroids()
+ * @param glyph_width Angular width of a glyph in degrees (reduced to 360 / count if larger)
+ * @param buflen Size of output buffer (enlarged if too small)
+ * @return JSON string with [longitude, angle, offset] per object, in input order
+ */
+EMSCRIPTEN_KEEPALIVE
+const char *getWheelLayout(char *lon_list, double glyph_width, int buflen)
+{
+    double *lon, *angle, maxoff = 0;
+    int i, n = 1, nclusters = 0;
+    int length = 0;
+    char *buffer, *list_copy, *token;
+
+    for (const char *sp = lon_list; *sp != '\0'; sp++) {
+        if (*sp == ',') n++;
+    }
+    list_copy = malloc(strlen(lon_list) + 1);
+    lon = malloc(n * sizeof(double));
+    angle = malloc(n * sizeof(double));
+    if (!list_copy || !lon || !angle) {
+        free(list_copy);
+        free(lon);
+        free(angle);
+        return NULL;
+    }
+    strcpy(list_copy, lon_list);
+    n = 0;
+    token = strtok(list_copy, ",");
+    while (token != NULL) {
+        lon[n++] = atof(token);
+        token = strtok(NULL, ",");
+    }
+    free(list_copy);
+
+    if (glyph_width < 0) glyph_width = 0;
+    if (n > 0 && glyph_width * n > 360) glyph_width = 360.0 / n;
+    if (n > 0) nclusters = wheel_layout(lon, n, glyph_width, angle);
+
+    // About 40 bytes per object
+    if (buflen < n * 40 + 1000) buflen = n * 40 + 1000;
+    buffer = malloc(buflen);
+    if (!buffer || nclusters < 0) {
+        free(buffer);
+        free(lon);
+        free(angle);
+        return NULL;
+    }
+    for (i = 0; i < n; i++) {
+        double off = swe_difdeg2n(angle[i], lon[i]);
+        if (fabs(off) > maxoff) maxoff = fabs(off);
+    }
+    length += snprintf(buffer + length, buflen - length,
+        "{ \"count\": %d, \"width\": %.5f, \"clusters\": %d, \"max_offset\": %.4f, \"items\": [",
+        n, glyph_width, nclusters, maxoff);
+    for (i = 0; i < n; i++) {
+        length += snprintf(buffer + length, buflen - length, "%s[%.4f,%.4f,%.4f]",
+            (i > 0) ? "," : "", swe_degnorm(lon[i]), angle[i], swe_difdeg2n(angle[i], lon[i]));
+    }
+    length += snprintf(buffer + length, buflen - length, "], \"error\": false }");
+
+    free(lon);
+    free(angle);
+    return buffer;
+}
+
+/**
+ * @brief Heap statistics of the module
+ *
+ * Reports the WASM memory, the allocator state, the allocations made by
+ * the exported functions and the bytes held by the ephemeris tables and
+ * caches. results_live counts result strings not yet released with
+ * freeMemory(); if it grows from call to call, a caller leaks results.
+ * The string returned by this function is not counted.
+ *
+ * @return JSON string with the statistics (sizes in bytes)
+ */
+EMSCRIPTEN_KEEPALIVE
+const char *getHeapStats(void)
+{
+    struct mallinfo mi = mallinfo();
+    double dmem[SE_MEM_NSTAT];
+    double allocations, frees, live_bytes;
+    char *buffer;
+    int debug = 1;
+#ifdef NDEBUG
+    debug = 0;
+#endif
+
+    heap_check_growth();
+    swe_get_memory_stats(dmem);
+    /* before the result buffer is allocated */
+    allocations = heap_stat.allocations;
+    frees = heap_stat.frees;
+    live_bytes = heap_stat.live_bytes;
+    buffer = malloc(SINGLE_BUFFER_SIZE);
+    if (!buffer) return NULL;
+
+    snprintf(buffer, SINGLE_BUFFER_SIZE,
+        "{ \"heap_size\": %.0f, \"in_use\": %.0f, \"free\": %.0f, \"footprint\": %.0f, "
+        "\"peak_footprint\": %.0f, \"growth_events\": %.0f, \"allocations\": %.0f, "
+        "\"frees\": %.0f, \"results_live\": %.0f, \"results_bytes\": %.0f, "
+        "\"peak_results_bytes\": %.0f, \"ephemeris_segments\": %.0f, \"file_caches\": %.0f, "
+        "\"asteroid_elements\": %.0f, \"star_tables\": %.0f, \"nutation_tables\": %.0f, "
+        "\"eclipse_database\": %.0f, \"debug\": %s, \"error\": false }",
+        (double) heap_stat.heap_size, (double) mi.uordblks, (double) mi.fordblks,
+        (double) mi.arena, (double) mi.usmblks, heap_stat.growth_events, allocations,
+        frees, allocations - frees, live_bytes, heap_stat.peak_live_bytes,
+        dmem[SE_MEM_SEGMENTS], dmem[SE_MEM_FILECACHE], dmem[SE_MEM_ASTELEM],
+        dmem[SE_MEM_STARS], dmem[SE_MEM_NUTATION], dmem[SE_MEM_ECLDB], debug ? "true" : "false");
+    return buffer;
+}
+
+/**
+ * @brief Read a byte range of a remote ephemeris file (swe_set_ephe_remote() reader)
+ *
+ * Uses a synchronous XMLHttpRequest with a Range header, which is only
+ * permitted in a Web Worker. The total file size is taken from the
+ * Content-Range header; a server that ignores Range and answers 200 still
+ * works, but then transfers the whole file on every block.
+ *
+ * @return Number of bytes stored in buf, or -1 if the file is not available
+ */
+EM_JS(int, remote_range_read, (const char *url, double offset, int nbytes, char *buf, double *fsize), {
+    try {
+        var xhr = new XMLHttpRequest();
+        xhr.open('GET', UTF8ToString(url), false);
+        xhr.responseType = 'arraybuffer';
+        xhr.setRequestHeader('Range', 'bytes=' + offset + '-' + (offset + nbytes - 1));
+        xhr.send(null);
+        if (xhr.status !== 206 && xhr.status !== 200) return -1;
+        var data = new Uint8Array(xhr.response);
+        var total = data.length;
+        if (xhr.status === 206) {
+            var m = /\/(\d+)\s*$/.exec(xhr.getResponseHeader('Content-Range') || '');
+            total = m ? Number(m[1]) : offset + data.length;
+        } else {
+            data = data.subarray(offset, offset + nbytes);
+        }
+        var n = Math.min(nbytes, data.length);
+        HEAPU8.set(data.subarray(0, n), buf);
+        HEAPF64[fsize >> 3] = total;
+        return n;
+    } catch (e) {
+        return -1;
+    }
+});
+
+/**
+ * @brief Fetch ephemeris files that are not embedded from a remote URL
+ *
+ * Files missing from the embedded "eph" directory (e.g. a JPL file such as
+ * de431.eph, or additional asteroid files) are read from base_url in blocks
+ * by HTTP Range requests. Only the blocks actually touched by a calculation
+ * are transferred; they are kept in an in-memory LRU cache. Must be called
+ * from the worker. An empty URL disables the remote source.
+ *
+ * @param base_url URL of the directory holding the files (e.g. "/eph")
+ * @param block_size Block size in bytes (0 = 65536)
+ * @param cache_blocks Number of cached blocks (0 = 64)
+ * @return JSON string with the settings or an error
+ */
+EMSCRIPTEN_KEEPALIVE
+const char *setRemoteEphemeris(const char *base_url, int block_size, int cache_blocks)
+{
+    char error_msg[AS_MAXCH] = "";
+    char escaped[2 * AS_MAXCH];
+    char *buffer = malloc(SINGLE_BUFFER_SIZE);
+    if (!buffer) return NULL;
+
+    if (swe_set_ephe_remote((char *) base_url, block_size, cache_blocks, remote_range_read, error_msg) < 0) {
+        escape_json_string(error_msg, escaped, sizeof(escaped));
+        snprintf(buffer, SINGLE_BUFFER_SIZE, "{ \"error\": true, \"error_msg\": \"%s\" }", escaped);
+        return buffer;
+    }
+    escape_json_string(base_url ? base_url : "", escaped, sizeof(escaped));
+    snprintf(buffer, SINGLE_BUFFER_SIZE,
+        "{ \"url\": \"%s\", \"block_size\": %d, \"cache_blocks\": %d, \"error\": false }",
+        escaped, block_size > 0 ? block_size : 65536, cache_blocks > 0 ? cache_blocks : 64);
+    return buffer;
+}
+
+/**
+ * @brief Transfer statistics of the remote ephemeris source
+ * @return JSON string with request, byte and cache counters
+ */
+EMSCRIPTEN_KEEPALIVE
+const char *getRemoteEphemerisStats(void)
+{
+    double dstat[SE_REMOTE_NSTAT];
+    int nfiles = swe_get_ephe_remote_stats(dstat);
+    char *buffer = malloc(SINGLE_BUFFER_SIZE);
+    if (!buffer) return NULL;
+
+    snprintf(buffer, SINGLE_BUFFER_SIZE,
+        "{ \"files\": %d, \"requests\": %.0f, \"bytes\": %.0f, \"cache_hits\": %.0f, "
+        "\"cache_misses\": %.0f, \"cached_blocks\": %.0f, \"prefetched\": %.0f, "
+        "\"prefetch_hits\": %.0f, \"error\": false }",
+        nfiles, dstat[SE_REMOTE_STAT_REQUESTS], dstat[SE_REMOTE_STAT_BYTES],
+        dstat[SE_REMOTE_STAT_HITS], dstat[SE_REMOTE_STAT_MISSES], dstat[SE_REMOTE_STAT_CACHED],
+        dstat[SE_REMOTE_STAT_PREFETCH], dstat[SE_REMOTE_STAT_PREFETCH_HITS]);
+    return buffer;
+}
+
+/**
+ * @brief Prefetch ephemeris segments for a time series
+ *
+ * Reads the segments the given planets use from the start date over the
+ * following days, so that a time series over remote files does not wait
+ * for a transfer at each new segment. Also sets how many segments are
+ * prefetched ahead while a time series steps through a file.
+ *
+ * @param year Start year
+ * @param month Start month (1-12)
+ * @param day Start day (1-31)
+ * @param days Length of the time series in days
+ * @param planet_list Comma-separated planet numbers (e.g. "0,1,4")
+ * @param nahead Segments to prefetch ahead (0 = off, max 64)
+ * @return JSON string with the number of prefetched segments or an error
+ */
+EMSCRIPTEN_KEEPALIVE
+const char *prefetchEphemeris(int year, int month, int day, int days, const char *planet_list, int nahead)
+{
+    char error_msg[AS_MAXCH] = "";
+    char escaped[AS_MAXCH * 2];
+    int32 ipl[SE_NPLANETS];
+    int nbody = 0;
+    int32 nseg;
+    double tjd;
+    char *token, *list_copy;
+    char *buffer = malloc(SINGLE_BUFFER_SIZE);
+    if (!buffer) return NULL;
+
+    list_copy = malloc(strlen(planet_list) + 1);
+    if (!list_copy) {
+        free(buffer);
+        return NULL;
+    }
+    strcpy(list_copy, planet_list);
+    token = strtok(list_copy, ",");
+    while (token != NULL && nbody < SE_NPLANETS) {
+        int planet = atoi(token);
+        if (planet >= SE_SUN && planet < SE_NPLANETS) {
+            ipl[nbody++] = planet;
+        }
+        token = strtok(NULL, ",");
+    }
+    free(list_copy);
+
+    swe_set_ephe_path("eph");
+    swe_set_ephe_prefetch(nahead);
+    tjd = calculate_julian_day(year, month, day, 0, 0, 0);
+    tjd += swe_deltat_ex(tjd, SEFLG_SWIEPH, NULL);
+    nseg = swe_ephe_prefetch(tjd, tjd + days, ipl, nbody, SEFLG_SWIEPH | SEFLG_SPEED, error_msg);
+    if (nseg < 0) {
+        escape_json_string(error_msg, escaped, sizeof(escaped));
+        snprintf(buffer, SINGLE_BUFFER_SIZE, "{ \"error\": true, \"error_msg\": \"%s\" }", escaped);
+        return buffer;
+    }
+    snprintf(buffer, SINGLE_BUFFER_SIZE,
+        "{ \"bodies\": %d, \"segments\": %d, \"nahead\": %d, \"error\": false }",
+        nbody, nseg, nahead < 0 ? 0 : (nahead > 64 ? 64 : nahead));
+    return buffer;
+}
+
 /**
  * @brief Free memory allocated by other functions
  */
@@ -0,0 +1,194 @@
+/*
+
+  sweastel.c	Builds the element catalogue of numbered minor planets
+		(seastel.bin) from the MPC orbit database MPCORB.DAT.
+
+  Usage:  sweastel [-v] MPCORB.DAT seastel.bin
+  	If MPCORB.DAT is "-", the orbits are read from stdin.
+	Only numbered objects are taken. The catalogue is found by the 
+	Swiss Ephemeris in the ephemeris path like any other file, and
+	numbered asteroids without an ephemeris file are computed from 
+	it. The format is described in swemplan.c, see swi_ast_elem_load().
+
+  The code of sweastel.c is in the public domain.
+  (But not the code of the library functions called by it.)
+
+**************************************************************/
+
+
+#include "swephexp.h"
+
+#define ASTEL_MAGIC	"SEASTEL1"
+#define ASTEL_HDRSIZE	16
+#define ASTEL_RECSIZE	40
+#define J2000		2451545.0
+
+struct orbit {
+  int32 num;
+  int32 pos;	/* line order in the input, to keep the first duplicate */
+  float val[9];	/* epoch - J2000, M, a, e, peri, node, incl, H, G */
+};
+
+static void put_uint32(unsigned char *c, uint32 u)
+{
+  c[0] = (unsigned char) (u & 0xff);
+  c[1] = (unsigned char) ((u >> 8) & 0xff);
+  c[2] = (unsigned char) ((u >> 16) & 0xff);
+  c[3] = (unsigned char) ((u >> 24) & 0xff);
+}
+
+static void put_float(unsigned char *c, float f)
+{
+  uint32 u;
+  memcpy((void *) &u, (void *) &f, sizeof(float));
+  put_uint32(c, u);
+}
+
+static int orbit_compare(const void *a, const void *b)
+{
+  const struct orbit *oa = (const struct orbit *) a, *ob = (const struct orbit *) b;
+  if (oa->num != ob->num)
+    return (oa->num > ob->num) - (oa->num < ob->num);
+  /* qsort() is not stable */
+  return (oa->pos > ob->pos) - (oa->pos < ob->pos);
+}
+
+/* field of columns i0..i1 (1-based, inclusive) */
+static double column(char *s, int i0, int i1)
+{
+  char f[32];
+  int n = i1 - i0 + 1;
+  memcpy(f, s + i0 - 1, (size_t) n);
+  f[n] = '\0';
+  return atof(f);
+}
+
+/* packed digit: 1..9, A = 10 .. V = 31 */
+static int unpack_digit(char c)
+{
+  if (c >= '0' && c <= '9') return c - '0';
+  if (c >= 'A' && c <= 'V') return c - 'A' + 10;
+  return -1;
+}
+
+/* packed epoch, e.g. K24AH = 2024 Oct 17; returns JD (TT) or 0 */
+static double unpack_epoch(char *s)
+{
+  int y, m, d;
+  if (*s < 'I' || *s > 'L' || !isdigit((int) s[1]) || !isdigit((int) s[2]))
+    return 0;
+  y = (*s - 'I' + 18) * 100 + (s[1] - '0') * 10 + (s[2] - '0');
+  m = unpack_digit(s[3]);
+  d = unpack_digit(s[4]);
+  if (m < 1 || m > 12 || d < 1)
+    return 0;
+  return swe_julday(y, m, d, 0, SE_GREG_CAL);
+}
+
+/* orbit of a numbered minor planet, or ERR */
+static int parse_orbit(char *s, struct orbit *o)
+{
+  double tjd0, ecce;
+  char *sp;
+  if (strlen(s) < 168 || s[166] != '(')
+    return ERR;
+  o->num = (int32) strtol(s + 167, &sp, 10);
+  if (o->num <= 0 || *sp != ')')
+    return ERR;
+  if ((tjd0 = unpack_epoch(s + 20)) == 0)
+    return ERR;
+  ecce = column(s, 71, 79);
+  if (ecce >= 1)	/* elliptic orbits only */
+    return ERR;
+  o->val[0] = (float) (tjd0 - J2000);
+  o->val[1] = (float) column(s, 27, 35);
+  o->val[2] = (float) column(s, 93, 103);
+  o->val[3] = (float) ecce;
+  o->val[4] = (float) column(s, 38, 46);
+  o->val[5] = (float) column(s, 49, 57);
+  o->val[6] = (float) column(s, 60, 68);
+  o->val[7] = (float) column(s, 9, 13);
+  o->val[8] = (float) column(s, 15, 19);
+  return OK;
+}
+
+int main(int argc, char *argv[])
+{
+  int i, j, k, n = 0, nalloc = 0, nskip = 0, verbose = 0;
+  char *infile = NULL, *outfile = NULL, s[AS_MAXCH];
+  unsigned char hdr[ASTEL_HDRSIZE], rec[ASTEL_RECSIZE];
+  struct orbit *orb = NULL, o;
+  FILE *fp, *fin;
+  for (i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "-v") == 0)
+      verbose = 1;
+    else if (infile == NULL)
+      infile = argv[i];
+    else if (outfile == NULL)
+      outfile = argv[i];
+  }
+  if (outfile == NULL) {
+    fprintf(stderr, "usage: sweastel [-v] MPCORB.DAT seastel.bin\n");
+    return 1;
+  }
+  if (strcmp(infile, "-") == 0) {
+    fin = stdin;
+  } else if ((fin = fopen(infile, "r")) == NULL) {
+    fprintf(stderr, "sweastel: cannot open %s\n", infile);
+    return 1;
+  }
+  while (fgets(s, AS_MAXCH, fin) != NULL) {
+    if (parse_orbit(s, &o) != OK) {
+      nskip++;
+      continue;
+    }
+    if (n >= nalloc) {
+      nalloc = (nalloc == 0) ? 65536 : nalloc * 2;
+      if ((orb = (struct orbit *) realloc(orb, (size_t) nalloc * sizeof(struct orbit))) == NULL) {
+	fprintf(stderr, "sweastel: out of memory\n");
+	return 1;
+      }
+    }
+    o.pos = n;
+    orb[n++] = o;
+  }
+  if (fin != stdin)
+    fclose(fin);
+  if (n == 0) {
+    fprintf(stderr, "sweastel: no numbered orbits found\n");
+    return 1;
+  }
+  /* sorted by number; of several orbits of the same object, the first one is kept */
+  qsort((void *) orb, (size_t) n, sizeof(struct orbit), orbit_compare);
+  for (i = 1, j = 0; i < n; i++) {
+    if (orb[i].num == orb[j].num)
+      continue;
+    orb[++j] = orb[i];
+  }
+  n = j + 1;
+  if ((fp = fopen(outfile, BFILE_W_CREATE)) == NULL) {
+    fprintf(stderr, "sweastel: cannot create %s\n", outfile);
+    return 1;
+  }
+  memset((void *) hdr, 0, ASTEL_HDRSIZE);
+  memcpy(hdr, ASTEL_MAGIC, 8);
+  put_uint32(hdr + 8, (uint32) n);
+  fwrite((void *) hdr, ASTEL_HDRSIZE, 1, fp);
+  for (i = 0; i < n; i++) {
+    put_uint32(rec, (uint32) orb[i].num);
+    for (k = 0; k < 9; k++)
+      put_float(rec + 4 + 4 * k, orb[i].val[k]);
+    if (fwrite((void *) rec, ASTEL_RECSIZE, 1, fp) != 1) {
+      fprintf(stderr, "sweastel: write error on %s\n", outfile);
+      fclose(fp);
+      remove(outfile);
+      return 1;
+    }
+    if (verbose)
+      printf("%d\t%.1f\t%.5f\t%.7f\n", orb[i].num, orb[i].val[0] + J2000, 
+	  orb[i].val[2], orb[i].val[3]);
+  }
+  fclose(fp);
+  printf("%s: %d orbits, %d lines skipped\n", outfile, n, nskip);
+  return 0;
+}
@@ -0,0 +1,213 @@
+/*
+
+  swebench.c	Benchmark of the Swiss Ephemeris with a representative
+  		workload, also used to train profile-guided builds.
+
+  Usage:  swebench [-eDIR] [-nSCALE] [-l] [-q]
+	-eDIR	ephemeris path, default SE_EPHE_PATH
+	-nSCALE	multiplies the amount of work, default 1
+	-l	light-time in one step, swe_set_light_time_mode(SE_LTIME_ONESTEP);
+		this changes the checksum
+	-q	quiet, no output (training run of make pgo)
+
+  Workloads:
+	charts	 birth charts: planets, nodes and Chiron with speed, houses,
+		 at pseudo-random dates 1800-2200, tropical and sidereal,
+		 partly topocentric
+	series	 daily positions of the Moon and the planets over decades,
+		 as in an ephemeris table or a transit search
+	houses	 all house systems at many latitudes
+	moshier	 charts with the analytical Moshier ephemeris
+	eclipses solar and lunar eclipses, global and local
+  Each line gives the number of calculations, the time and the rate.
+  The checksum sums all results; it must be the same for every build
+  of the same source, e.g. plain, make lto and make pgo.
+
+  The code of swebench.c is in the public domain.
+  (But not the code of the library functions called by it.)
+
+**************************************************************/
+
+
+#include <time.h>
+#include "swephexp.h"
+
+static int quiet = 0;
+static double checksum = 0;
+static uint32 seed = 12345;
+
+/* deterministic pseudo-random number 0..1, the same on every system */
+static double next_random(void)
+{
+  seed = seed * 1664525 + 1013904223;
+  return (double) (seed >> 8) / 16777216.0;
+}
+
+static void add_sum(double *x, int n)
+{
+  int i;
+  for (i = 0; i < n; i++)
+    checksum += x[i];
+}
+
+static void report(char *name, int32 ncalc, clock_t t0)
+{
+  double ms = (double) (clock() - t0) * 1000.0 / CLOCKS_PER_SEC;
+  if (quiet)
+    return;
+  printf("%-10s %9d calc %10.1f ms %12.0f /s\n", name, ncalc, ms,
+         ms > 0 ? ncalc * 1000.0 / ms : 0);
+}
+
+static int32 do_charts(int32 nchart, int32 iflag)
+{
+  int32 i, ipl, n = 0, iflgret;
+  double tjd, geolat, geolon, x[6], cusp[13], ascmc[10];
+  char serr[AS_MAXCH];
+  for (i = 0; i < nchart; i++) {
+    tjd = 2378496.5 + next_random() * 146100.0;	/* 1800 - 2200 */
+    geolat = next_random() * 120.0 - 60.0;
+    geolon = next_random() * 360.0 - 180.0;
+    if (i % 4 == 3) {
+      swe_set_sid_mode(SE_SIDM_LAHIRI, 0, 0);
+      iflag |= SEFLG_SIDEREAL;
+    } else {
+      iflag &= ~SEFLG_SIDEREAL;
+    }
+    if (i % 8 == 7) {
+      swe_set_topo(geolon, geolat, 0);
+      iflag |= SEFLG_TOPOCTR;
+    } else {
+      iflag &= ~SEFLG_TOPOCTR;
+    }
+    for (ipl = SE_SUN; ipl <= SE_CHIRON; ipl++) {
+      if (ipl == SE_EARTH || ipl == SE_OSCU_APOG)
+	continue;
+      if ((iflgret = swe_calc_ut(tjd, ipl, iflag, x, serr)) < 0) {
+	fprintf(stderr, "swebench: %s\n", serr);
+	continue;
+      }
+      add_sum(x, 6);
+      n++;
+    }
+    swe_houses_ex(tjd, iflag & SEFLG_SIDEREAL, geolat, geolon, 'P', cusp, ascmc);
+    add_sum(cusp + 1, 12);
+    n++;
+  }
+  return n;
+}
+
+static int32 do_series(int32 ndays, int32 iflag)
+{
+  int32 i, ipl, n = 0;
+  double tjd, x[6];
+  char serr[AS_MAXCH];
+  for (ipl = SE_SUN; ipl <= SE_PLUTO; ipl++) {
+    for (i = 0, tjd = 2433282.5; i < ndays; i++, tjd += 1) {
+      if (swe_calc(tjd, ipl, iflag, x, serr) < 0) {
+	fprintf(stderr, "swebench: %s\n", serr);
+	return n;
+      }
+      add_sum(x, 6);
+      n++;
+    }
+  }
+  return n;
+}
+
+static int32 do_houses(int32 ntimes)
+{
+  static char hsys[] = "PKORCEWBAMXHTUGYFIiLNQSVD";
+  int32 i, j, n = 0;
+  double tjd, geolat, cusp[37], ascmc[10];
+  char *sp;
+  for (i = 0; i < ntimes; i++) {
+    tjd = 2415020.5 + next_random() * 73050.0;
+    for (j = -6; j <= 6; j++) {
+      geolat = j * 10.0 + next_random();
+      for (sp = hsys; *sp != '\0'; sp++) {
+	if (swe_houses(tjd, geolat, 8.55, *sp, cusp, ascmc) < 0)
+	  continue;
+	add_sum(cusp + 1, 12);
+	add_sum(ascmc, 4);
+	n++;
+      }
+    }
+  }
+  return n;
+}
+
+static int32 do_eclipses(int32 neclipse)
+{
+  int32 i, n = 0;
+  double tjd, tret[10], attr[20], geopos[3] = {8.55, 47.37, 400};
+  char serr[AS_MAXCH];
+  for (i = 0, tjd = 2451545.0; i < neclipse; i++) {
+    if (swe_sol_eclipse_when_glob(tjd, SEFLG_SWIEPH, 0, tret, 0, serr) < 0)
+      break;
+    add_sum(tret, 4);
+    tjd = tret[0] + 1;
+    n++;
+  }
+  for (i = 0, tjd = 2451545.0; i < neclipse; i++) {
+    if (swe_lun_eclipse_when(tjd, SEFLG_SWIEPH, 0, tret, 0, serr) < 0)
+      break;
+    add_sum(tret, 4);
+    tjd = tret[0] + 1;
+    n++;
+  }
+  for (i = 0, tjd = 2451545.0; i < neclipse / 4; i++) {
+    if (swe_sol_eclipse_when_loc(tjd, SEFLG_SWIEPH, geopos, tret, attr, 0, serr) < 0)
+      break;
+    add_sum(tret, 4);
+    add_sum(attr, 3);
+    tjd = tret[0] + 1;
+    n++;
+  }
+  return n;
+}
+
+int main(int argc, char *argv[])
+{
+  int i, scale = 1;
+  int32 n, ntotal = 0;
+  char *ephepath = NULL;
+  clock_t t0, tstart;
+  for (i = 1; i < argc; i++) {
+    if (strncmp(argv[i], "-e", 2) == 0) {
+      ephepath = argv[i] + 2;
+    } else if (strncmp(argv[i], "-n", 2) == 0) {
+      scale = atoi(argv[i] + 2);
+      if (scale < 1) scale = 1;
+    } else if (strcmp(argv[i], "-l") == 0) {
+      swe_set_light_time_mode(SE_LTIME_ONESTEP);
+    } else if (strcmp(argv[i], "-q") == 0) {
+      quiet = 1;
+    } else {
+      fprintf(stderr, "usage: swebench [-eDIR] [-nSCALE] [-l] [-q]\n");
+      return 1;
+    }
+  }
+  swe_set_ephe_path(ephepath);
+  tstart = clock();
+  t0 = clock();
+  ntotal += n = do_charts(2000 * scale, SEFLG_SWIEPH | SEFLG_SPEED);
+  report("charts", n, t0);
+  t0 = clock();
+  ntotal += n = do_series(10000 * scale, SEFLG_SWIEPH | SEFLG_SPEED);
+  report("series", n, t0);
+  t0 = clock();
+  ntotal += n = do_houses(200 * scale);
+  report("houses", n, t0);
+  t0 = clock();
+  ntotal += n = do_charts(500 * scale, SEFLG_MOSEPH | SEFLG_SPEED);
+  report("moshier", n, t0);
+  t0 = clock();
+  ntotal += n = do_eclipses(20 * scale);
+  report("eclipses", n, t0);
+  report("total", ntotal, tstart);
+  if (!quiet)
+    printf("checksum %.6f\n", checksum);
+  swe_close();
+  return 0;
+}
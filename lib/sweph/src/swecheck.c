@@ -0,0 +1,1039 @@
+/*
+
+  swecheck.c	Regression checks of the Swiss Ephemeris.
+
+  Usage:  swecheck [-eDIR] [-v]
+	-eDIR	ephemeris path, default SE_EPHE_PATH
+	-v	verbose, print every check, not only the failed ones
+
+  Each check compares the results of a function with a reference:
+  a value the function gave in an earlier release, another way of
+  computing the same quantity, or a property the result must have.
+  The program prints the failed checks and returns their number,
+  i.e. 0 if all checks passed (make check).
+
+  The ephemeris path must contain sefstars.txt and the files
+  sepl_18.se1, semo_18.se1 and seas_18.se1, and an eclipse database
+  seecldb.bin of the years 1990 to 2009 (make check builds it with
+  sweecldb). The programs sweeop and swepack must be in the current
+  directory.
+
+  The code of swecheck.c is in the public domain.
+  (But not the code of the library functions called by it.)
+
+**************************************************************/
+
+
+#include "swephexp.h"
+#include "sweph.h"
+#include "swephlib.h"
+#ifdef _WIN32
+# include <direct.h>
+# define mkdir(dir, mode)	_mkdir(dir)
+#else
+# include <sys/stat.h>
+#endif
+
+/* scratch directory for generated files, removed at the end */
+#define CHECK_DIR	"swecheck.tmp"
+
+static int verbose = 0;
+static int nfail = 0;
+static int ncheck = 0;
+
+/* records the result of a check; the message is printed
+ * for failed checks, and in verbose mode for all of them */
+static void check(int ok, char *name, char *msg)
+{
+  ncheck++;
+  if (!ok)
+    nfail++;
+  if (!ok || verbose)
+    printf("%-6s %-24s %s\n", ok ? "ok" : "FAILED", name, msg);
+}
+
+/* star names: a traditional name may be abbreviated, the first
+ * star in sefstars.txt whose name begins with it is taken, also
+ * in functions that look stars up internally */
+static void check_star_names(void)
+{
+  int32 retc;
+  double x[6], x2[6], dret[50];
+  double dgeo[3] = {8.55, 47.38, 400};
+  double datm[4] = {1013.25, 15, 40, 0};
+  double dobs[6] = {36, 1, 0, 0, 0, 0};
+  double tret, tret2;
+  char star[SE_MAX_STNAME * 2 + 1], msg[AS_MAXCH * 2], serr[AS_MAXCH];
+  strcpy(star, "Alde");
+  retc = swe_fixstar2(star, 2451545.0, SEFLG_SWIEPH, x, serr);
+  sprintf(msg, "Alde -> %s", retc < 0 ? serr : star);
+  check(retc >= 0 && strncmp(star, "Aldebaran", 9) == 0, "fixstar2 prefix", msg);
+  strcpy(star, "Aldebaran");
+  swe_fixstar(star, 2451545.0, SEFLG_SWIEPH, x2, serr);
+  sprintf(msg, "lon %.9f, %.9f", x[0], x2[0]);
+  check(retc >= 0 && x[0] == x2[0] && x[1] == x2[1], "fixstar2 prefix pos", msg);
+  strcpy(star, "Alde");
+  retc = swe_heliacal_ut(2451545.0, dgeo, datm, dobs, star,
+                         SE_HELIACAL_RISING, SEFLG_SWIEPH, dret, serr);
+  tret = retc < 0 ? -1 : dret[0];
+  strcpy(star, "Aldebaran");
+  retc = swe_heliacal_ut(2451545.0, dgeo, datm, dobs, star,
+                         SE_HELIACAL_RISING, SEFLG_SWIEPH, dret, serr);
+  tret2 = retc < 0 ? -1 : dret[0];
+  sprintf(msg, "%.5f, %.5f", tret, tret2);
+  check(tret > 0 && tret == tret2, "heliacal prefix", msg);
+}
+
+/* reader of remote files for check_remote(): reads local files,
+ * the URL being a file name; remembers the last URL */
+static char remote_url[AS_MAXCH * 2];
+static int32 remote_reader(const char *url, double offset, int32 nbytes, char *buf, double *fsize)
+{
+  FILE *fp;
+  int32 n;
+  strcpy(remote_url, url);
+  if ((fp = fopen(url, "rb")) == NULL)
+    return -1;
+  fseek(fp, 0, SEEK_END);
+  *fsize = (double) ftell(fp);
+  fseek(fp, (long) offset, SEEK_SET);
+  n = (int32) fread(buf, 1, (size_t) nbytes, fp);
+  fclose(fp);
+  return n;
+}
+
+/* directory of the ephemeris path that contains sepl_18.se1,
+ * or "" */
+static char *ephe_dir(char *ephepath, char *dir)
+{
+  char path[AS_MAXCH * 2], *sp;
+  FILE *fp;
+  *dir = '\0';
+  strcpy(path, ephepath != NULL ? ephepath : SE_EPHE_PATH);
+  for (sp = strtok(path, ":;"); sp != NULL; sp = strtok(NULL, ":;")) {
+    sprintf(dir, "%s/sepl_18.se1", sp);
+    if ((fp = fopen(dir, "rb")) != NULL) {
+      fclose(fp);
+      strcpy(dir, sp);
+      break;
+    }
+    *dir = '\0';
+  }
+  return dir;
+}
+
+/* remote ephemeris files: URLs, block cache and file table */
+static void check_remote(char *ephepath)
+{
+  int i, ipl, ok;
+  int32 nfile;
+  double tjd, x[6], x2[6], dstat[SE_REMOTE_NSTAT];
+  char dir[AS_MAXCH], url[AS_MAXCH * 2], msg[AS_MAXCH * 3], serr[AS_MAXCH];
+  static int ipls[] = {SE_SUN, SE_MOON, SE_MARS, SE_JUPITER, SE_PLUTO, SE_CHIRON};
+  if (*ephe_dir(ephepath, dir) == '\0') {
+    check(0, "remote", "sepl_18.se1 not found in ephemeris path");
+    return;
+  }
+  /* reference positions from local files */
+  swe_set_ephe_path(ephepath);
+  ok = 1;
+  for (i = 0, tjd = 2415020.5; i < 40; i++, tjd += 1234.5) {
+    for (ipl = 0; ipl < 6; ipl++) {
+      swe_calc(tjd, ipls[ipl], SEFLG_SWIEPH | SEFLG_SPEED, x, serr);
+      swe_set_ephe_path("/nonexistent");
+      swe_set_ephe_remote(i % 2 ? strcat(strcpy(url, dir), "/") : dir,
+			  1024, 4, remote_reader, serr);
+      if (swe_calc(tjd, ipls[ipl], SEFLG_SWIEPH | SEFLG_SPEED, x2, serr) < 0
+	  || memcmp(x, x2, sizeof(x)) != 0)
+	ok = 0;
+      swe_set_ephe_remote(NULL, 0, 0, NULL, NULL);
+      swe_set_ephe_path(ephepath);
+    }
+  }
+  check(ok, "remote positions", "remote files give the positions of local files");
+  /* URL resolution, with or without '/' at the end of the base URL */
+  swe_set_ephe_path("/nonexistent");
+  swe_set_ephe_remote(strcat(strcpy(url, dir), "/"), 0, 0, remote_reader, serr);
+  swe_calc(2451545.0, SE_MARS, SEFLG_SWIEPH, x, serr);
+  sprintf(url, "%s/sepl_18.se1", dir);
+  sprintf(msg, "%s", remote_url);
+  check(strcmp(remote_url, url) == 0, "remote url", msg);
+  /* block cache: a series of positions is read mostly from cache */
+  swe_set_ephe_remote(dir, 0, 8, remote_reader, serr);
+  for (i = 0, tjd = 2451545.0; i < 1000; i++, tjd += 0.5)
+    swe_calc(tjd, SE_MOON, SEFLG_SWIEPH, x, serr);
+  nfile = swe_get_ephe_remote_stats(dstat);
+  sprintf(msg, "%.0f hits, %.0f misses, %.0f cached, %d files", dstat[SE_REMOTE_STAT_HITS],
+	  dstat[SE_REMOTE_STAT_MISSES], dstat[SE_REMOTE_STAT_CACHED], nfile);
+  check(dstat[SE_REMOTE_STAT_HITS] > dstat[SE_REMOTE_STAT_MISSES]
+	&& dstat[SE_REMOTE_STAT_CACHED] <= 8 && nfile >= 2, "remote block cache", msg);
+  /* file table: after many missing files, other files can still
+   * be opened, and the open files remain readable */
+  swe_set_ephe_remote(NULL, 0, 0, NULL, NULL);
+  swe_set_ephe_path(ephepath);
+  swe_calc(2268923.5, SE_MARS, SEFLG_SWIEPH, x, serr);
+  swe_set_ephe_path("/nonexistent");
+  swe_set_ephe_remote(dir, 0, 0, remote_reader, serr);
+  swe_calc(2451545.0, SE_MOON, SEFLG_SWIEPH, x2, serr);
+  for (i = 1; i <= 120; i++)
+    swe_calc(2451545.0, SE_AST_OFFSET + 900000 + i, SEFLG_SWIEPH, x2, serr);
+  ok = swe_calc(2268923.5, SE_MARS, SEFLG_SWIEPH, x2, serr) >= 0 && x[0] == x2[0];
+  check(ok, "remote file table", ok ? "new file opened after 120 missing ones" : serr);
+  ok = swe_calc(2451545.0, SE_MOON, SEFLG_SWIEPH, x2, serr) >= 0;
+  check(ok, "remote file table open", ok ? "open files still readable" : serr);
+  swe_set_ephe_remote(NULL, 0, 0, NULL, NULL);
+  swe_set_ephe_path(ephepath);
+}
+
+/* ephemeris archive: with the planetary files and the asteroid files
+ * 5 to 50 packed by swepack, and no loose files in the path, the
+ * positions are those of the loose files, also if the asteroids
+ * alternate. Needs the program swepack in the current directory. */
+static void check_pack(char *ephepath)
+{
+  static double xref[20 * 49 * 6], xx[20 * 49 * 6];
+  int32 i, j, ipl, mode, ret, nmiss = 0, ok = 1;
+  double tjd;
+  char dir[AS_MAXCH], fname[AS_MAXCH], cmd[AS_MAXCH * 2], msg[AS_MAXCH], serr[AS_MAXCH];
+  FILE *fp;
+  if (*ephe_dir(ephepath, dir) == '\0') {
+    check(0, "pack", "sepl_18.se1 not found in ephemeris path");
+    return;
+  }
+  mkdir(CHECK_DIR, 0755);
+  sprintf(fname, "%s/pack.lst", CHECK_DIR);
+  if ((fp = fopen(fname, "w")) == NULL) {
+    check(0, "pack", "cannot write pack.lst");
+    return;
+  }
+  fprintf(fp, "%s/sepl_18.se1\n%s/semo_18.se1\n%s/seas_18.se1\n", dir, dir, dir);
+  for (i = 5; i <= 50; i++)
+    fprintf(fp, "%s/se%05ds.se1\n", dir, i);
+  fclose(fp);
+  sprintf(cmd, "./swepack %s/%s < %s > /dev/null", CHECK_DIR, SE_ASTPACKFILE, fname);
+  if (system(cmd) != 0) {
+    check(0, "pack", "cannot run ./swepack (make check builds it)");
+    ok = 0;
+  }
+  /* Sun to Pluto, Chiron, asteroids 5 to 50, alternating */
+  for (mode = 0; mode < 2 && ok; mode++) {
+    swe_set_ephe_path(mode ? CHECK_DIR : ephepath);
+    for (i = 0, tjd = 2415020.5; i < 20; i++, tjd += 1826.3) {
+      for (j = 0; j < 49; j++) {
+	ipl = (j < 10) ? j : (j == 10) ? SE_CHIRON : SE_AST_OFFSET + 5 + (j - 11) * 7 % 46;
+	ret = swe_calc(tjd, ipl, SEFLG_SWIEPH | SEFLG_SPEED, (mode ? xx : xref) + (i * 49 + j) * 6, serr);
+	if (ret < 0 || !(ret & SEFLG_SWIEPH))
+	  nmiss++;
+      }
+    }
+  }
+  swe_set_ephe_path(ephepath);
+  sprintf(msg, "%d positions, %d not from the ephemeris files", 20 * 49, nmiss);
+  if (ok)
+    check(nmiss == 0 && memcmp(xref, xx, sizeof(xx)) == 0, "pack positions", msg);
+  remove(fname);
+  sprintf(fname, "%s/%s", CHECK_DIR, SE_ASTPACKFILE);
+  remove(fname);
+  remove(CHECK_DIR);
+}
+
+/* prefetch of ephemeris segments: the positions are the same with
+ * and without it, from local and from remote files */
+static void check_prefetch(char *ephepath)
+{
+  static int32 ipls[] = {SE_SUN, SE_MOON, SE_MERCURY, SE_MARS, SE_JUPITER, SE_PLUTO, SE_CHIRON};
+  static double xref[2000 * 7 * 6], xx[2000 * 7 * 6];
+  double tjd0 = 2451545.0, step = 0.73, dstat[SE_REMOTE_NSTAT];
+  int32 i, ipl, mode, nseg, ok;
+  char dir[AS_MAXCH], name[AS_MAXCH], msg[AS_MAXCH], serr[AS_MAXCH];
+  if (*ephe_dir(ephepath, dir) == '\0') {
+    check(0, "prefetch", "sepl_18.se1 not found in ephemeris path");
+    return;
+  }
+  for (mode = 0; mode < 2; mode++) {
+    ok = 1;
+    *serr = '\0';
+    for (nseg = 0; nseg <= 8; nseg += 8) {
+      swe_set_ephe_path(mode ? "/nonexistent" : ephepath);
+      if (mode)
+	swe_set_ephe_remote(dir, 0, 64, remote_reader, serr);
+      swe_set_ephe_prefetch(nseg);
+      if (nseg > 0 && swe_ephe_prefetch(tjd0, tjd0 + 2000 * step, ipls, 7, SEFLG_SWIEPH, serr) < 0)
+	ok = 0;
+      for (i = 0; i < 2000; i++) {
+	for (ipl = 0; ipl < 7; ipl++) {
+	  if (swe_calc(tjd0 + i * step, ipls[ipl], SEFLG_SWIEPH | SEFLG_SPEED,
+		       (nseg ? xx : xref) + (i * 7 + ipl) * 6, serr) < 0)
+	    ok = 0;
+	}
+      }
+    }
+    /* the segments were read ahead */
+    swe_get_ephe_remote_stats(dstat);
+    if (dstat[SE_REMOTE_STAT_PREFETCH] == 0)
+      ok = 0;
+    swe_set_ephe_prefetch(0);
+    swe_set_ephe_remote(NULL, 0, 0, NULL, NULL);
+    swe_set_ephe_path(ephepath);
+    sprintf(name, "prefetch %s", mode ? "remote" : "local");
+    if (ok)
+      sprintf(msg, "%d positions compared, %.0f segments prefetched", 2000 * 7,
+	      dstat[SE_REMOTE_STAT_PREFETCH]);
+    else
+      strcpy(msg, serr);
+    check(ok && memcmp(xref, xx, sizeof(xx)) == 0, name, msg);
+  }
+}
+
+/* Moshier speeds: the analytical speeds agree with a five-point
+ * central difference of the positions */
+static void check_moshier_speed(void)
+{
+  static double tjds[] = {1000000.5, 1721425.5, 2299160.5, 2451545.0, 2600000.5, 2816788.5};
+  int32 j, k, ipl, iflag, ok;
+  double h, tjd, x[6], xm2[6], xm1[6], xp1[6], xp2[6], v, dv, dvrel;
+  char name[AS_MAXCH], msg[AS_MAXCH], serr[AS_MAXCH];
+  for (ipl = SE_SUN; ipl <= SE_PLUTO; ipl++) {
+    iflag = SEFLG_MOSEPH | SEFLG_SPEED | SEFLG_J2000 | SEFLG_NONUT | SEFLG_TRUEPOS | SEFLG_XYZ;
+    if (ipl != SE_MOON && ipl != SE_SUN)
+      iflag |= SEFLG_HELCTR;
+    h = (ipl == SE_MOON) ? 0.01 : 0.1;
+    ok = 1;
+    dvrel = 0;
+    for (j = 0; j < 6; j++) {
+      tjd = tjds[j];
+      if (swe_calc(tjd, ipl, iflag, x, serr) < 0
+	  || swe_calc(tjd - 2 * h, ipl, iflag, xm2, serr) < 0
+	  || swe_calc(tjd - h, ipl, iflag, xm1, serr) < 0
+	  || swe_calc(tjd + h, ipl, iflag, xp1, serr) < 0
+	  || swe_calc(tjd + 2 * h, ipl, iflag, xp2, serr) < 0) {
+	ok = 0;
+	break;
+      }
+      v = sqrt(x[3] * x[3] + x[4] * x[4] + x[5] * x[5]);
+      for (k = 0; k < 3; k++) {
+	dv = (xm2[k] - 8 * xm1[k] + 8 * xp1[k] - xp2[k]) / (12 * h) - x[k + 3];
+	if (fabs(dv) / v > dvrel)
+	  dvrel = fabs(dv) / v;
+      }
+    }
+    if (ok)
+      sprintf(msg, "max. relative difference %.1e", dvrel);
+    else
+      strcpy(msg, serr);
+    sprintf(name, "moshier speed %d", ipl);
+    check(ok && dvrel < 1e-6, name, msg);
+  }
+}
+
+/* lunar extrema: the total number is returned also if it exceeds the
+ * capacity of the array, which holds the earliest; the perigee of
+ * 2016 November 14 is the closest of the years 2000 to 2019 */
+static void check_moon_extremes(void)
+{
+  static double d1[6 * 600], d2[6 * 10];
+  int32 i, n1, n2, ok;
+  double dmin = 1e10, tmin = 0;
+  char msg[AS_MAXCH], serr[AS_MAXCH];
+  n1 = swe_moon_extremes(2451544.5, 2451544.5 + 3652.5 * 2, SEFLG_SWIEPH | SEFLG_TRUEPOS, 1, d1, 600, serr);
+  n2 = swe_moon_extremes(2451544.5, 2451544.5 + 3652.5 * 2, SEFLG_SWIEPH | SEFLG_TRUEPOS, 1, d2, 10, serr);
+  ok = (n1 > 0 && n1 < 600 && n2 == n1 && memcmp(d1, d2, sizeof(d2)) == 0);
+  sprintf(msg, "%d found, %d with nmax = 10", n1, n2);
+  check(ok, "moon extremes nmax", msg);
+  for (i = 0; i < n1; i++) {
+    if (d1[6 * i + 1] < dmin) {
+      dmin = d1[6 * i + 1];
+      tmin = d1[6 * i];
+    }
+  }
+  sprintf(msg, "closest perigee jd %.4f, %.1f km", tmin, dmin);
+  check(fabs(tmin - 2457706.9) < 0.1 && fabs(dmin - 356509) < 5, "moon extremes perigee", msg);
+}
+
+/* declination events: with the declination speeds, a step of one day
+ * finds the same events as a fine step, also near-tangent ones */
+static void check_decl_events(void)
+{
+  static double d1[5 * 5000], d2[5 * 5000];
+  int32 ipl[] = {SE_SUN, SE_MOON, SE_MERCURY, SE_VENUS, SE_MARS, SE_JUPITER, SE_SATURN};
+  int32 i, n1, n2, ok;
+  double dtmax = 0;
+  char msg[AS_MAXCH], serr[AS_MAXCH];
+  n1 = swe_decl_events(2451545.0, 2451545.0 + 1461, ipl, 7, SEFLG_SWIEPH, 1, 0, d1, 5000, serr);
+  n2 = swe_decl_events(2451545.0, 2451545.0 + 1461, ipl, 7, SEFLG_SWIEPH, 0.02, 0, d2, 5000, serr);
+  ok = (n1 > 0 && n1 == n2);
+  for (i = 0; ok && i < n1; i++) {
+    if (d1[5 * i + 1] != d2[5 * i + 1] || d1[5 * i + 2] != d2[5 * i + 2] || d1[5 * i + 3] != d2[5 * i + 3])
+      ok = 0;
+    if (fabs(d1[5 * i] - d2[5 * i]) > dtmax)
+      dtmax = fabs(d1[5 * i] - d2[5 * i]);
+  }
+  sprintf(msg, "%d, %d events, max. dt %.1e d", n1, n2, dtmax);
+  check(ok && dtmax < 1e-6, "decl events step", msg);
+  /* the earliest events of the list, with the total number */
+  n2 = swe_decl_events(2451545.0, 2451545.0 + 1461, ipl, 7, SEFLG_SWIEPH, 1, 0, d2, 5, serr);
+  ok = (n2 == n1 && memcmp(d1, d2, 5 * 5 * sizeof(double)) == 0);
+  sprintf(msg, "%d found, %d with nmax = 5", n1, n2);
+  check(ok, "decl events nmax", msg);
+}
+
+/* conjunctions with fixed stars: the total number is returned also
+ * if it exceeds the capacity of the array, which holds the earliest */
+static void check_star_conjunctions(void)
+{
+  static double d1[5 * 5000], d2[5 * 5000];
+  int32 ipl[] = {SE_SUN, SE_MOON, SE_MERCURY, SE_VENUS, SE_MARS};
+  int32 i, k, n1, n2 = 0, nmax = 0, ok;
+  int32 nmaxs[] = {1, 2, 7, 0};
+  char msg[AS_MAXCH], serr[AS_MAXCH];
+  n1 = swe_fixstar_conjunctions(2451545.0, 2451545.0 + 365, ipl, 5, SEFLG_SWIEPH, 3, 0, d1, 5000, serr);
+  nmaxs[3] = n1 / 3;
+  ok = (n1 > 0 && n1 < 5000);
+  /* the nmax earliest ones, for a few small nmax and a large one */
+  for (k = 0; ok && k < 4; k++) {
+    nmax = nmaxs[k];
+    n2 = swe_fixstar_conjunctions(2451545.0, 2451545.0 + 365, ipl, 5, SEFLG_SWIEPH, 3, 0, d2, nmax, serr);
+    ok = (n2 == n1);
+    for (i = 0; ok && i < nmax; i++) {
+      if (d1[5 * i] != d2[5 * i] || d1[5 * i + 2] != d2[5 * i + 2])
+	ok = 0;
+    }
+  }
+  sprintf(msg, "%d found, %d with nmax = %d", n1, n2, nmax);
+  check(ok, "star conjunctions nmax", msg);
+}
+
+/* panchang: a long period gives the same elements as single days */
+static void check_panchang(void)
+{
+  static double dpan[9 * 2 * 4000];
+  double geopos[6] = {77.21, 28.61, 0, 72.88, 19.08, 0}, dpan1[9 * 2];
+  int32 ndays = 4000, iloc, iday, k, ok = 1;
+  double tjd_start = 2451544.5;
+  char msg[AS_MAXCH], serr[AS_MAXCH];
+  swe_set_sid_mode(SE_SIDM_LAHIRI, 0, 0);
+  if (swe_panchang(tjd_start, ndays, geopos, 2, SEFLG_SWIEPH, dpan, serr) == ERR) {
+    check(0, "panchang long", serr);
+    return;
+  }
+  for (iloc = 0; iloc < 2; iloc++) {
+    for (iday = 0; iday < ndays; iday++) {
+      for (k = 1; k <= 7; k += 2) {
+	if (dpan[(iloc * ndays + iday) * 9 + k] < 1)
+	  ok = 0;
+      }
+    }
+  }
+  sprintf(msg, "%d days, 2 locations", ndays);
+  check(ok, "panchang long", msg);
+  for (iday = 0; iday < ndays && ok; iday += 997) {
+    if (swe_panchang(tjd_start + iday, 1, geopos, 2, SEFLG_SWIEPH, dpan1, serr) == ERR) {
+      ok = 0;
+      break;
+    }
+    for (iloc = 0; iloc < 2; iloc++) {
+      if (memcmp(dpan1 + 9 * iloc, dpan + (iloc * ndays + iday) * 9, 9 * sizeof(double)) != 0)
+	ok = 0;
+    }
+  }
+  check(ok, "panchang single days", ok ? "every 997th day agrees" : serr);
+  swe_set_sid_mode(SE_SIDM_FAGAN_BRADLEY, 0, 0);
+}
+
+/* light-time in one step agrees with the iteration, for planets,
+ * main asteroids and numbered asteroids */
+static void check_light_time(void)
+{
+  static int32 ipls[] = {SE_MERCURY, SE_VENUS, SE_MARS, SE_JUPITER, SE_PLUTO, SE_CHIRON,
+    SE_CERES, SE_VESTA, SE_AST_OFFSET + 5, SE_AST_OFFSET + 10, SE_AST_OFFSET + 44};
+  int32 i, j, k, iflag, ok;
+  double tjd, x1[6], x2[6], dpos, dspd, dposmax, dspdmax;
+  char name[AS_MAXCH], msg[AS_MAXCH], serr[AS_MAXCH];
+  swe_set_topo(8.55, 47.38, 400);
+  for (k = 0; k < 2; k++) {
+    iflag = SEFLG_SWIEPH | SEFLG_SPEED | (k ? SEFLG_TOPOCTR : 0);
+    for (j = 0; j < 11; j++) {
+      ok = 1;
+      dposmax = dspdmax = 0;
+      for (i = 0, tjd = 2415020.5; i < 200; i++, tjd += 360.3) {
+	swe_set_light_time_mode(SE_LTIME_ITERATE);
+	if (swe_calc(tjd, ipls[j], iflag, x1, serr) < 0) {
+	  ok = 0;
+	  break;
+	}
+	swe_set_light_time_mode(SE_LTIME_ONESTEP);
+	if (swe_calc(tjd, ipls[j], iflag, x2, serr) < 0) {
+	  ok = 0;
+	  break;
+	}
+	dpos = fabs(swe_difdeg2n(x1[0], x2[0]));
+	if (fabs(x1[1] - x2[1]) > dpos)
+	  dpos = fabs(x1[1] - x2[1]);
+	dspd = fabs(x1[3] - x2[3]);
+	if (fabs(x1[4] - x2[4]) > dspd)
+	  dspd = fabs(x1[4] - x2[4]);
+	if (dpos * 3600 > dposmax) dposmax = dpos * 3600;
+	if (dspd * 3600 > dspdmax) dspdmax = dspd * 3600;
+      }
+      swe_set_light_time_mode(SE_LTIME_ITERATE);
+      if (ok)
+	sprintf(msg, "%.1e\", %.1e\"/day", dposmax, dspdmax);
+      else
+	strcpy(msg, serr);
+      sprintf(name, "light-time %s %d", k ? "topo" : "geo", ipls[j]);
+      /* the documented tolerance of SE_LTIME_ONESTEP */
+      check(ok && dposmax < 1e-5 && dspdmax < (k ? 0.15 : 2e-4), name, msg);
+    }
+  }
+}
+
+/* crescent visibility map: q is only defined where the class is,
+ * not at sites where the Sun sets before the conjunction */
+static void check_crescent_grid(void)
+{
+  int32 i, n = 0, nundef = 0, retc, ok = 1;
+  int32 cgrid[27];
+  double qgrid[27], dret[2];
+  /* new moon 2000 Jan 6, 18:14 UT: before sunset in America,
+   * after sunset in Asia */
+  double dgrid[6] = {0, 20, -120, 30, 0, 0};
+  char msg[AS_MAXCH], serr[AS_MAXCH];
+  retc = swe_heliacal_crescent_grid(2451549.5, dgrid, 3, 9, SEFLG_SWIEPH, qgrid, cgrid, dret, serr);
+  for (i = 0; i < 27 && retc >= 0; i++) {
+    if (cgrid[i] > 0)
+      n++;
+    else if (qgrid[i] != 0)
+      ok = 0;
+    else
+      nundef++;
+  }
+  if (retc < 0)
+    strcpy(msg, serr);
+  else
+    sprintf(msg, "%d defined, %d undefined, dret[1] = %.0f", n, nundef, dret[1]);
+  check(retc >= 0 && ok && n == (int32) dret[1] && n > 0 && nundef > 0, "crescent grid undefined", msg);
+}
+
+/* Chebyshev fits: the segments cover the range without gaps, and
+ * between the fitting points the polynomials give the positions of
+ * swe_calc_ut() within the tolerance; as documented, by up to 1" more
+ * within a few degrees of the Sun, where light deflection changes fast */
+static void check_cheb_fit(void)
+{
+  static int32 ipls[] = {SE_SUN, SE_MOON, SE_MERCURY, SE_MARS, SE_PLUTO};
+  static double days[] = {365, 60, 365, 730, 3652};
+  static double dseg[200 * SE_CHEB_SEGSIZE(12)];
+  double tol = 1.0 / 3600, t, t0, x, xx[6], xs[6], *dp, d, dmax = 0, dmaxsun = 0;
+  int32 i, k, n, ncoe = 12, nseg = 0, ngap = 0, npt = 0;
+  char msg[AS_MAXCH], serr[AS_MAXCH];
+  for (i = 0; i < 5; i++) {
+    t0 = 2451545.0 + 100.3 * i;
+    n = swe_cheb_fit(t0, t0 + days[i], ipls[i], SEFLG_SWIEPH, tol, ncoe, dseg, 200, serr);
+    if (n <= 0) {
+      check(0, "cheb fit", serr);
+      return;
+    }
+    nseg += n;
+    if (dseg[0] != t0 || dseg[(n - 1) * SE_CHEB_SEGSIZE(ncoe) + 1] != t0 + days[i])
+      ngap++;
+    for (k = 1; k < n; k++)
+      if (dseg[k * SE_CHEB_SEGSIZE(ncoe)] != dseg[(k - 1) * SE_CHEB_SEGSIZE(ncoe) + 1])
+	ngap++;
+    for (k = 0; k < n; k++) {
+      dp = dseg + k * SE_CHEB_SEGSIZE(ncoe);
+      /* points between the fitting points, and the segment ends */
+      for (x = -1; x <= 1; x += 0.0173, npt++) {
+	t = dp[0] + (x + 1) / 2 * (dp[1] - dp[0]);
+	if (swe_calc_ut(t, ipls[i], SEFLG_SWIEPH, xx, serr) == ERR
+	    || swe_calc_ut(t, SE_SUN, SEFLG_SWIEPH, xs, serr) == ERR) {
+	  check(0, "cheb fit", serr);
+	  return;
+	}
+	d = fabs(swe_difdeg2n(swi_echeb(x, dp + 2, ncoe), xx[0]));
+	if (fabs(swi_echeb(x, dp + 2 + ncoe, ncoe) - xx[1]) > d)
+	  d = fabs(swi_echeb(x, dp + 2 + ncoe, ncoe) - xx[1]);
+	if (ipls[i] != SE_SUN && fabs(swe_difdeg2n(xx[0], xs[0])) < 3) {
+	  if (d > dmaxsun)
+	    dmaxsun = d;
+	} else if (d > dmax) {
+	  dmax = d;
+	}
+      }
+    }
+  }
+  sprintf(msg, "%d segments, %d gaps, %d points, max. error %.3f\", %.3f\" near the Sun",
+	  nseg, ngap, npt, dmax * 3600, dmaxsun * 3600);
+  check(ngap == 0 && dmax <= tol && dmaxsun <= tol + 1.0 / 3600, "cheb fit", msg);
+  /* too many segments for the array */
+  n = swe_cheb_fit(2451545.0, 2451545.0 + 3652, SE_MOON, SEFLG_SWIEPH, tol, ncoe, dseg, 10, serr);
+  check(n == ERR, "cheb fit nmax", n == ERR ? serr : "no error");
+}
+
+/* astrocartography: on the MC line the hour angle of the body is 0, on
+ * the ASC and DSC lines its altitude is dhor, in the east and the west
+ * (except at the turning points, due north or south); the lines reach
+ * latitude 90 - |decl| and are clipped at lat_max. At 12h UT, the MC
+ * line of the Sun is at the longitude of the equation of time. */
+static void check_acg_lines(void)
+{
+  static int32 ipls[] = {SE_SUN, SE_MOON, SE_MARS, SE_PLUTO};
+  double tjd = 2451545.0, dhor[] = {0, -0.5667}, dret[10], xasc[2 * 200], xdsc[2 * 200];
+  double x[6], xaz[3], geopos[3], gast, d, e = 0, dsun = 0, dmc = 0, dalt = 0, dlat = 0, latmax = -90;
+  int32 i, j, k, nasc, ndsc, npt = 0, nwrong = 0;
+  char msg[AS_MAXCH], serr[AS_MAXCH];
+  for (i = 0; i < 4; i++) {
+    for (j = 0; j < 2; j++) {
+      if (swe_acg_lines(tjd, ipls[i], NULL, SEFLG_SWIEPH, dhor[j], 80, 1, 200,
+			dret, xasc, &nasc, xdsc, &ndsc, serr) == ERR
+	  || swe_calc_ut(tjd, ipls[i], SEFLG_SWIEPH | SEFLG_EQUATORIAL, x, serr) == ERR) {
+	check(0, "acg lines", serr);
+	return;
+      }
+      gast = swe_sidtime(tjd) * 15;
+      if ((d = fabs(swe_difdeg2n(gast + dret[0], x[0]))) > dmc)
+	dmc = d;
+      if (j == 0 && (d = fabs(dret[5] - (90 - fabs(x[1])))) > dlat)
+	dlat = d;
+      if (ipls[i] == SE_SUN && swe_time_equ(tjd, &e, serr) == OK)
+	dsun = dret[0];
+      if (nasc < 100 || ndsc < 100)
+	nwrong++;
+      geopos[2] = 0;
+      for (k = 0; k < nasc + ndsc; k++, npt++) {
+	geopos[0] = (k < nasc) ? xasc[2 * k] : xdsc[2 * (k - nasc)];
+	geopos[1] = (k < nasc) ? xasc[2 * k + 1] : xdsc[2 * (k - nasc) + 1];
+	swe_azalt(tjd, SE_EQU2HOR, geopos, 0, 0, x, xaz);
+	if ((d = fabs(xaz[1] - dhor[j])) > dalt)
+	  dalt = d;
+	/* azimuth from the south: rising in the east, 180..360 */
+	if ((k < nasc) != (xaz[0] > 180) && fabs(sin(xaz[0] * DEGTORAD)) > 1e-6)
+	  nwrong++;
+	if (geopos[1] > latmax)
+	  latmax = geopos[1];
+      }
+    }
+  }
+  sprintf(msg, "%d points, MC %.1e, alt %.1e, lat %.1e, %d wrong, max lat %.4f",
+	  npt, dmc, dalt, dlat, nwrong, latmax);
+  check(dmc < 1e-9 && dalt < 1e-7 && dlat < 1e-9 && nwrong == 0 && latmax <= 80 + 1e-9,
+	"acg lines", msg);
+  sprintf(msg, "Sun MC line at %.6f, equation of time %.6f min", dsun, e * 1440);
+  check(fabs(dsun + e * 360) < 1e-6 && fabs(dsun - 0.8213) < 1e-4, "acg lines sun", msg);
+}
+
+/* primary directions: a promissor reaches the mundane position of the
+ * significator (plus the aspect) when the ARMC has advanced by the arc;
+ * the arc to the MC is the difference in right ascension */
+static void check_primary_directions(void)
+{
+  static double xprom[] = {200.5, 1.2, 15.0, -3.0, 310.0, 0.5};
+  static double xsig[] = {45.0, 0, 170.0, 2.0, 260.0, -1.5, 300.0, 0};
+  static double dasp[] = {0, 60, -90, 180};
+  static int hsys[] = {'P', 'R'};
+  double armc = 123.4, geolat = 47.38, eps = 23.4392911;
+  double darc[3 * 4 * 4], x[3], xmc[2], cusp[13], ascmc[10], hp, hs, d, dmax;
+  int32 i, ip, ia, is, narc, zod, ok;
+  char name[AS_MAXCH], msg[AS_MAXCH], serr[AS_MAXCH];
+  for (i = 0; i < 4; i++) {
+    zod = i / 2;
+    narc = swe_primary_directions(armc, geolat, eps, hsys[i % 2], zod ? SE_PD_ZODIACAL : SE_PD_MUNDANE, xprom, 3, xsig, 4, dasp, 4, darc, serr);
+    ok = (narc == 3 * 4 * 4);
+    dmax = 0;
+    for (ip = 0; ip < 3 && ok; ip++) {
+      for (ia = 0; ia < 4; ia++) {
+	/* in zodiaco, the aspect point on the ecliptic is directed */
+	x[0] = zod ? swe_degnorm(xprom[2 * ip] + dasp[ia]) : xprom[2 * ip];
+	x[1] = zod ? 0 : xprom[2 * ip + 1];
+	for (is = 0; is < 4; is++) {
+	  hs = swe_house_pos(armc, geolat, eps, hsys[i % 2], xsig + 2 * is, serr);
+	  hp = swe_house_pos(swe_degnorm(armc + darc[(ip * 4 + ia) * 4 + is]), geolat, eps, hsys[i % 2], x, serr);
+	  /* houses count against the mundane position */
+	  d = fabs(swe_difdeg2n((hp - hs) * 30, zod ? 0 : -dasp[ia]));
+	  if (d > dmax)
+	    dmax = d;
+	}
+      }
+    }
+    if (ok)
+      sprintf(msg, "%d arcs, max. difference %.1e deg", narc, dmax);
+    else
+      strcpy(msg, narc < 0 ? serr : "undefined arcs");
+    sprintf(name, "primary directions %c %s", hsys[i % 2], zod ? "zod" : "mund");
+    check(ok && dmax < 1e-9, name, msg);
+  }
+  /* to the MC: right ascension of the promissor minus ARMC */
+  swe_houses_armc(armc, geolat, eps, 'P', cusp, ascmc);
+  xmc[0] = ascmc[SE_MC];
+  xmc[1] = 0;
+  ok = 1;
+  dmax = 0;
+  for (i = 0; i < 2; i++) {
+    for (ip = 0; ip < 3; ip++) {
+      if (swe_primary_directions(armc, geolat, eps, hsys[i], SE_PD_MUNDANE, xprom + 2 * ip, 1, xmc, 1, dasp, 1, darc, serr) != 1) {
+	ok = 0;
+	break;
+      }
+      x[0] = xprom[2 * ip]; x[1] = xprom[2 * ip + 1]; x[2] = 1;
+      swe_cotrans(x, x, -eps);
+      d = fabs(darc[0] - swe_difdeg2n(x[0], armc));
+      if (d > dmax)
+	dmax = d;
+    }
+  }
+  sprintf(msg, "max. difference %.1e deg", dmax);
+  check(ok && dmax < 1e-9, "primary directions MC", ok ? msg : serr);
+}
+
+/* eclipse database: the next and previous eclipses are those of the
+ * search functions, with contacts stored to a fraction of a second;
+ * the total solar eclipse of 1999 August 11 is in Saros series 145 and
+ * Inex series 50. make check builds a database of the years 1990 to
+ * 2009 with sweecldb. */
+static void check_eclipse_db(void)
+{
+  double tret[10], tret2[10], attr[20], tsar[100], tstart, tend, t, dtmax = 0;
+  int32 i, k, kind, back, n, nsar, ndif = 0, ret, ret2;
+  char msg[AS_MAXCH], serr[AS_MAXCH];
+  n = swe_eclipse_db_range(&tstart, &tend, serr);
+  if (n <= 0) {
+    check(0, "eclipse db", serr);
+    return;
+  }
+  for (i = 0, t = tstart + 40; t < tend - 400; i++, t += 97.3) {
+    for (kind = SE_ECLDB_SOLAR; kind <= SE_ECLDB_LUNAR; kind++) {
+      for (back = 0; back <= 1; back++) {
+	if (back && t < tstart + 400)
+	  continue;
+	ret = swe_eclipse_db_when(t, kind, 0, tret, attr, back, serr);
+	if (kind == SE_ECLDB_SOLAR)
+	  ret2 = swe_sol_eclipse_when_glob(t, SEFLG_SWIEPH, 0, tret2, back, serr);
+	else
+	  ret2 = swe_lun_eclipse_when(t, SEFLG_SWIEPH, 0, tret2, back, serr);
+	if (ret != ret2 || ret < 0) {
+	  ndif++;
+	  continue;
+	}
+	for (k = 0; k < 8; k++) {
+	  if (k == 1)
+	    continue;
+	  if (fabs(tret[k] - tret2[k]) > dtmax)
+	    dtmax = fabs(tret[k] - tret2[k]);
+	}
+      }
+    }
+  }
+  sprintf(msg, "%d eclipses, %d dates, %d differ, max. dt %.1e d", n, i, ndif, dtmax);
+  check(ndif == 0 && dtmax < 1e-6, "eclipse db search", msg);
+  /* 1999 August 11 */
+  ret = swe_eclipse_db_when(2451400.5, SE_ECLDB_SOLAR, SE_ECL_TOTAL, tret, attr, FALSE, serr);
+  if (ret < 0) {
+    check(0, "eclipse db saros", serr);
+    return;
+  }
+  nsar = swe_eclipse_db_saros(SE_ECLDB_SOLAR, (int32) attr[9], tsar, 100, serr);
+  for (k = 0; k < nsar && k < 100 && tsar[k] != tret[0]; k++)
+    ;
+  sprintf(msg, "jd %.4f, Saros %.0f member %.0f, Inex %.0f, %d of the series in the db",
+    tret[0], attr[9], attr[10], attr[11], nsar);
+  check(fabs(tret[0] - 2451401.96) < 0.01 && attr[9] == 145 && attr[11] == 50
+    && nsar > 0 && k < nsar, "eclipse db saros", msg);
+}
+
+/* synthetic nutation corrections dpsi, deps of day i, in " */
+static double eop_dpsi(int32 i)
+{
+  return floor((-0.05 + 0.02 * sin(i * 0.0172) + 0.0005 * cos(i * 0.23)) * 1000 + 0.5) / 1000;
+}
+
+static double eop_deps(int32 i)
+{
+  return floor((-0.004 + 0.003 * cos(i * 0.0172)) * 1000 + 0.5) / 1000;
+}
+
+/* places the number s into line at column col */
+static void put_col(char *line, int col, char *s)
+{
+  memcpy(line + col, s, strlen(s));
+}
+
+/* earth orientation for SEFLG_JPLHOR: the binary file written by
+ * sweeop gives the nutation of the text files eop_1962_today.txt and
+ * eop_finals.txt, which are synthetic, 3000 days from 1962 and 300
+ * days from finals.all of which the last 100 have only Bulletin A
+ * values. Needs the program sweeop in the current directory. */
+static void check_eop(char *ephepath)
+{
+  static double tjds[] = {2437600.5, 2437690.5, 2438000.25, 2439444.7, 2440664.5, 2440665.5, 2440764.5, 2440870.5, 2441000.5};
+  double nut[2], nut0[2], xnut[2][9][2], tjd, d, dmax = 0;
+  int32 i, k, mode, nrec = 3000, ok = 1;
+  char line[200], num[40], fname[AS_MAXCH], cmd[AS_MAXCH * 2], msg[AS_MAXCH];
+  FILE *fp;
+  mkdir(CHECK_DIR, 0755);
+  mkdir(CHECK_DIR "/bin", 0755);
+  sprintf(fname, "%s/%s", CHECK_DIR, DPSI_DEPS_IAU1980_FILE_EOPC04);
+  if ((fp = fopen(fname, "w")) == NULL) {
+    check(0, "eop", "cannot write eop_1962_today.txt");
+    return;
+  }
+  fprintf(fp, "  EARTH ORIENTATION PARAMETER (EOP) PRODUCT CENTER\n\n");
+  fprintf(fp, "  Date      MJD      x          y        UT1-UTC       LOD         dPsi        dEps\n\n");
+  for (i = 0; i < nrec; i++) {
+    int iy, im, id;
+    double ut;
+    swe_revjul(2437665.5 + i, SE_GREG_CAL, &iy, &im, &id, &ut);
+    fprintf(fp, "%4d %3d %3d %6d   0.100000   0.200000   0.0300000   0.0010000  %9.6f  %9.6f   0.030000   0.030000\n",
+	    iy, im, id, 37665 + i, eop_dpsi(i), eop_deps(i));
+  }
+  fclose(fp);
+  /* finals.all: from 10 days before the end of the C04 data */
+  sprintf(fname, "%s/%s", CHECK_DIR, DPSI_DEPS_IAU1980_FILE_FINALS);
+  if ((fp = fopen(fname, "w")) == NULL) {
+    check(0, "eop", "cannot write eop_finals.txt");
+    return;
+  }
+  for (i = nrec - 10; i <= nrec + 300; i++) {
+    memset(line, ' ', 188);
+    line[188] = '\0';
+    sprintf(num, "%5d", 37665 + i);
+    put_col(line, 7, num);
+    if (i < nrec + 300) {
+      sprintf(num, "%9.3f", eop_dpsi(i) * 1000);
+      put_col(line, i < nrec + 200 ? 168 : 99, num);
+      sprintf(num, "%9.3f", eop_deps(i) * 1000);
+      put_col(line, i < nrec + 200 ? 178 : 118, num);
+    }
+    fprintf(fp, "%s\n", line);
+  }
+  fclose(fp);
+  sprintf(cmd, "./sweeop %s/%s %s/%s %s/bin/%s > /dev/null", CHECK_DIR, DPSI_DEPS_IAU1980_FILE_EOPC04,
+	  CHECK_DIR, DPSI_DEPS_IAU1980_FILE_FINALS, CHECK_DIR, DPSI_DEPS_IAU1980_FILE_BIN);
+  if (system(cmd) != 0) {
+    check(0, "eop", "cannot run ./sweeop (make check builds it)");
+    goto done;
+  }
+  /* nutation from the text files, then from the binary file; the
+   * data are kept until swe_close() */
+  for (mode = 0; mode < 2 && ok; mode++) {
+    swe_close();
+    swe_set_ephe_path(mode ? CHECK_DIR "/bin" : CHECK_DIR);
+    load_dpsi_deps();
+    if (swed.eop_dpsi_loaded != 2 || swed.eop_tjd_end != 2437665.5 + nrec + 299)
+      ok = 0;
+    for (k = 0; k < 9; k++)
+      swi_nutation(tjds[k], SEFLG_JPLHOR, xnut[mode][k]);
+  }
+  /* at whole days, the correction is that of the file */
+  swe_close();
+  swe_set_ephe_path("/nonexistent");
+  for (k = 3; k < 8 && ok; k++) {
+    tjd = tjds[k];
+    if (tjd != floor(tjd) + 0.5)
+      continue;
+    i = (int32) (tjd - 2437665.5);
+    swi_nutation(tjd, SEFLG_JPLHOR, nut0);
+    nut[0] = (xnut[0][k][0] - nut0[0]) * RADTODEG * 3600 + DPSI_IAU1980_TJD0;
+    nut[1] = (xnut[0][k][1] - nut0[1]) * RADTODEG * 3600 + DEPS_IAU1980_TJD0;
+    d = fabs(nut[0] - eop_dpsi(i));
+    if (fabs(nut[1] - eop_deps(i)) > d)
+      d = fabs(nut[1] - eop_deps(i));
+    if (d > dmax)
+      dmax = d;
+  }
+  if (ok)
+    sprintf(msg, "9 dates, text and binary %s, max. error %.1e\"",
+	    memcmp(xnut[0], xnut[1], sizeof(xnut[0])) == 0 ? "agree" : "differ", dmax);
+  else
+    strcpy(msg, "earth orientation files not loaded");
+  check(ok && memcmp(xnut[0], xnut[1], sizeof(xnut[0])) == 0 && dmax < 1e-9, "eop text and binary", msg);
+done:
+  swe_close();
+  swe_set_ephe_path(ephepath);
+  remove(fname);
+  sprintf(fname, "%s/%s", CHECK_DIR, DPSI_DEPS_IAU1980_FILE_EOPC04);
+  remove(fname);
+  sprintf(fname, "%s/bin/%s", CHECK_DIR, DPSI_DEPS_IAU1980_FILE_BIN);
+  remove(fname);
+  remove(CHECK_DIR "/bin");
+  remove(CHECK_DIR);
+}
+
+/* writes an element catalogue of n synthetic minor planets, numbered
+ * 1..n, to CHECK_DIR; main belt objects and every 50th an earth
+ * crosser, which can move fast */
+static int write_ast_catalogue(int32 n)
+{
+  int32 i, k;
+  uint32 u, seed = 12345;
+  float val[9];
+  unsigned char rec[40], *c;
+  char fname[AS_MAXCH];
+  FILE *fp;
+  mkdir(CHECK_DIR, 0755);
+  sprintf(fname, "%s/%s", CHECK_DIR, SE_ASTELEMFILE);
+  if ((fp = fopen(fname, "wb")) == NULL)
+    return ERR;
+  memset(rec, 0, 16);
+  memcpy(rec, "SEASTEL1", 8);
+  for (k = 0; k < 4; k++)
+    rec[8 + k] = (unsigned char) ((uint32) n >> (8 * k));
+  fwrite(rec, 16, 1, fp);
+  for (i = 0; i < n; i++) {
+    for (k = 1; k < 7; k++) {
+      seed = seed * 1103515245 + 12345;
+      val[k] = (float) ((seed >> 8) / 16777216.0);
+    }
+    val[0] = 8000.5f;	/* epoch 2021 Nov 25 */
+    val[1] *= 360;	/* mean anomaly */
+    val[2] = (i % 50 == 0) ? 1.0f + val[2] : 2.1f + 1.3f * val[2];
+    val[3] = (i % 50 == 0) ? 0.2f + 0.5f * val[3] : 0.25f * val[3];
+    val[4] *= 360;
+    val[5] *= 360;
+    val[6] *= 25;
+    val[7] = 15;
+    val[8] = 0.15f;
+    c = rec;
+    for (k = 0; k < 4; k++)
+      c[k] = (unsigned char) ((uint32) (i + 1) >> (8 * k));
+    for (k = 0; k < 9; k++) {
+      memcpy(&u, &val[k], 4);
+      c = rec + 4 + 4 * k;
+      c[0] = (unsigned char) u;
+      c[1] = (unsigned char) (u >> 8);
+      c[2] = (unsigned char) (u >> 16);
+      c[3] = (unsigned char) (u >> 24);
+    }
+    fwrite(rec, 40, 1, fp);
+  }
+  fclose(fp);
+  return OK;
+}
+
+static void remove_ast_catalogue(void)
+{
+  char fname[AS_MAXCH];
+  sprintf(fname, "%s/%s", CHECK_DIR, SE_ASTELEMFILE);
+  remove(fname);
+  remove(CHECK_DIR);
+}
+
+/* minor planets near points: the longitude index finds the same
+ * objects as a scan of the whole catalogue, and the total number of
+ * matches is returned if the array is too small */
+static void check_ast_elem_near(char *ephepath)
+{
+  static double tjds[] = {2451545.0, 2451548.9, 2451552.1, 2459580.3, 2459581.75, 2462502.5};
+  static int32 iflags[] = {SEFLG_SWIEPH, SEFLG_SWIEPH | SEFLG_HELCTR, SEFLG_SWIEPH | SEFLG_TRUEPOS | SEFLG_J2000 | SEFLG_NONUT};
+  static double xlon[] = {10, 100, 200, 300};
+  double orb = 5, *xast, *dret, d;
+  int32 n = 20000, nmax = 8000, i, j, k, m, nbrute, nnear, nmiss, nset, ok = 1;
+  char path[AS_MAXCH * 2], *found, msg[AS_MAXCH], serr[AS_MAXCH];
+  xast = (double *) malloc(n * 3 * sizeof(double));
+  dret = (double *) malloc(nmax * 6 * sizeof(double));
+  found = (char *) malloc(n * 4);
+  if (xast == NULL || dret == NULL || found == NULL || write_ast_catalogue(n) != OK) {
+    check(0, "ast near", "cannot write element catalogue");
+    ok = 0;
+  }
+  sprintf(path, "%s;%s", CHECK_DIR, ephepath != NULL ? ephepath : SE_EPHE_PATH);
+  swe_set_ephe_path(path);
+  nbrute = nnear = nmiss = nset = 0;
+  for (k = 0; k < 3 && ok; k++) {
+    for (j = 0; j < 6 && ok; j++) {
+      /* scan: all objects within the orb of a point */
+      if (swe_calc_ast_elements(tjds[j], iflags[k], 0, n, xast, NULL, serr) != n) {
+	ok = 0;
+	break;
+      }
+      memset(found, 0, n * 4);
+      for (i = 0; i < n; i++) {
+	for (m = 0; m < 4; m++) {
+	  if (fabs(swe_difdeg2n(xast[3 * i], xlon[m])) <= orb) {
+	    found[i * 4 + m] = 1;
+	    nbrute++;
+	  }
+	}
+      }
+      nset = swe_ast_elem_near(tjds[j], iflags[k], xlon, 4, orb, dret, nmax, serr);
+      if (nset < 0 || nset > nmax) {
+	ok = 0;
+	break;
+      }
+      for (i = 0; i < nset; i++) {
+	d = dret[6 * i];
+	m = (int32) dret[6 * i + 1];
+	if (d < 1 || d > n || found[((int32) d - 1) * 4 + m] != 1)
+	  nmiss++;
+	else
+	  found[((int32) d - 1) * 4 + m] = 2;
+	nnear++;
+      }
+      for (i = 0; i < n * 4; i++)
+	if (found[i] == 1)
+	  nmiss++;
+    }
+  }
+  if (ok)
+    sprintf(msg, "%d matches, %d scanned, %d differences", nnear, nbrute, nmiss);
+  else
+    strcpy(msg, serr);
+  check(ok && nnear == nbrute && nmiss == 0 && nnear > 0, "ast near index", msg);
+  /* too small an array: the total is returned */
+  if (ok) {
+    i = swe_ast_elem_near(tjds[5], iflags[2], xlon, 4, orb, dret, 10, serr);
+    sprintf(msg, "%d returned with 10 stored, %d in all", i, nset);
+    check(i == nset, "ast near total", msg);
+  }
+  /* an asteroid without ephemeris file is computed from the catalogue,
+   * without a message */
+  if (ok) {
+    double xx[6];
+    *serr = '\0';
+    i = swe_calc_ut(tjds[3], SE_AST_OFFSET + 1000, SEFLG_SWIEPH, xx, serr);
+    swe_calc_ast_elements(tjds[3], SEFLG_SWIEPH, 999, 1, xast, NULL, NULL);
+    d = fabs(swe_difdeg2n(xx[0], xast[0])) * 3600;
+    sprintf(msg, "retflag %d, diff %.2f\", serr \"%s\"", i, d, serr);
+    check(i == SEFLG_SWIEPH && *serr == '\0' && d < 1, "ast elements calc", msg);
+  }
+  remove_ast_catalogue();
+  swe_set_ephe_path(ephepath);
+  free(xast);
+  free(dret);
+  free(found);
+}
+
+int main(int argc, char *argv[])
+{
+  int i;
+  char *ephepath = NULL;
+  for (i = 1; i < argc; i++) {
+    if (strncmp(argv[i], "-e", 2) == 0) {
+      ephepath = argv[i] + 2;
+    } else if (strcmp(argv[i], "-v") == 0) {
+      verbose = 1;
+    } else {
+      fprintf(stderr, "usage: swecheck [-eDIR] [-v]\n");
+      return 1;
+    }
+  }
+  swe_set_ephe_path(ephepath);
+  check_star_names();
+  check_remote(ephepath);
+  check_prefetch(ephepath);
+  check_pack(ephepath);
+  check_moshier_speed();
+  check_moon_extremes();
+  check_decl_events();
+  check_star_conjunctions();
+  check_panchang();
+  check_light_time();
+  check_crescent_grid();
+  check_cheb_fit();
+  check_acg_lines();
+  check_primary_directions();
+  check_eclipse_db();
+  check_eop(ephepath);
+  check_ast_elem_near(ephepath);
+  printf("%d checks, %d failed\n", ncheck, nfail);
+  swe_close();
+  return nfail;
+}
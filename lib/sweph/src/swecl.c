@@ -891,7 +891,7 @@ static int32 calc_planet_star(double tjd_et, int32 ipl, char *starname, int32 if
   if (starname == NULL || *starname == '\0') {
     retc = swe_calc(tjd_et, ipl, iflag, x, serr);
   } else {
-    retc = swe_fixstar(starname, tjd_et, iflag, x, serr);
+    retc = swe_fixstar2(starname, tjd_et, iflag, x, serr);
   }
   return retc;
 }
@@ -4454,7 +4454,7 @@ int ncalc = 0;
    * western half of the sky for a short time. 
    */
   if (do_fixstar) {
-    if (swe_fixstar(starname, tjd_et, iflag, xc, serr) == ERR)
+    if (swe_fixstar2(starname, tjd_et, iflag, xc, serr) == ERR)
       return ERR;
   } 
   for (ii = 0, t = tjd_ut - twohrs; ii <= jmax; ii++, t += twohrs) {
@@ -4709,7 +4709,7 @@ static int32 calc_mer_trans(
     armc0 += 24;
   armc0 *= 15;
   if (do_fixstar) {
-    if (swe_fixstar(starname, tjd_et, iflag, x0, serr) == ERR)
+    if (swe_fixstar2(starname, tjd_et, iflag, x0, serr) == ERR)
       return ERR;
   } else {
     if (swe_calc(tjd_et, ipl, iflag, x0, serr) == ERR)
@@ -6345,7 +6345,7 @@ int32 CALL_CONV swe_gauquelin_sector(
     nutlo[1] *= RADTODEG;
     armc = swe_degnorm(swe_sidtime0(t_ut, eps + nutlo[1], nutlo[0]) * 15 + geopos[0]);
     if (do_fixstar) {
-      if (swe_fixstar(starname, t_et, iflag, x0, serr) == ERR)
+      if (swe_fixstar2(starname, t_et, iflag, x0, serr) == ERR)
 	return ERR;
     } else {
       if (swe_calc(t_et, ipl, iflag, x0, serr) == ERR)
@@ -6428,3 +6428,656 @@ int32 CALL_CONV swe_gauquelin_sector(
     return ERR;
   }
 }
+
+static double acg_lon_norm(double x)
+{
+  x = swe_degnorm(x);
+  if (x >= 180)
+    x -= 360;
+  return x;
+}
+
+static int32 acg_sample_curve(double sind, double cosd, double sinr, double cosr, double lon0, double a0, double a1, int32 np, double *xp)
+{
+  int32 i;
+  double a, sinp, dlon;
+  for (i = 0; i < np; i++) {
+    a = (np > 1) ? a0 + (a1 - a0) * i / (np - 1) : a0;
+    sinp = sind * cosr + cosd * sinr * cos(a);
+    if (sinp > 1) sinp = 1;
+    if (sinp < -1) sinp = -1;
+    dlon = atan2(sin(a) * sinr * cosd, cosr - sind * sinp);
+    xp[2 * i] = acg_lon_norm(lon0 + dlon * RADTODEG);
+    xp[2 * i + 1] = asin(sinp) * RADTODEG;
+  }
+  return np;
+}
+
+/* astrocartography lines of a planet or fixed star
+ *
+ * Computes, for one instant, the geographic curves on which a body
+ * culminates (MC line), anticulminates (IC line), rises (ASC line)
+ * or sets (DSC line). The curves follow analytically from the body's
+ * apparent right ascension and declination and from the Greenwich
+ * apparent sidereal time, so no grid search is required.
+ *
+ * The MC and IC lines are meridians. The ASC and DSC lines together
+ * form a small circle around the sub-body point (geogr. latitude = decl.,
+ * longitude = RA - GAST) at an angular distance of 90 - dhor degrees.
+ * The circle is sampled at uniform arc length, therefore the points
+ * automatically crowd in latitude near the turning latitudes where
+ * the lines bend around towards the circumpolar zone.
+ *
+ * tjd_ut	time (UT)
+ * ipl, starname  body; if starname != NULL and not empty, a star is computed.
+ * iflag	ephemeris flag (SEFLG_SWIEPH, SEFLG_JPLEPH, SEFLG_MOSEPH)
+ * dhor		altitude of the horizon for rising/setting, degrees;
+ *              0 = geometric horizon, e.g. -0.5667 for standard refraction
+ * lat_max	lines are clipped at +-lat_max (e.g. 85 for Mercator maps)
+ * max_step	maximum distance between polyline points on the ASC/DSC
+ *              curves, degrees of arc
+ * npmax	capacity of xasc and xdsc in points; if more points would be
+ *              needed, the step is increased so that the curve fits.
+ * dret		return array, declare as dret[10] at least:
+ *              dret[0]	geogr. longitude of MC line
+ *              dret[1]	geogr. longitude of IC line
+ *              dret[2]	apparent right ascension of body
+ *              dret[3]	apparent declination of body
+ *              dret[4]	Greenwich apparent sidereal time in degrees
+ *              dret[5]	northernmost latitude of ASC/DSC lines
+ *              dret[6]	southernmost latitude of ASC/DSC lines
+ * xasc, xdsc	polylines of ASC and DSC line, pairs of (longitude, latitude),
+ *              ordered from south to north, longitudes in -180..180;
+ *              declare as [2 * npmax]
+ * nasc, ndsc	number of points returned in xasc and xdsc
+ *
+ * return OK or ERR
+ */
+int32 CALL_CONV swe_acg_lines(double tjd_ut, int32 ipl, char *starname, int32 iflag, double dhor, double lat_max, double max_step, int32 npmax, double *dret, double *xasc, int32 *nasc, double *xdsc, int32 *ndsc, char *serr)
+{
+  int32 np;
+  double tjd_et, x[6], gast, lon0, ra, de;
+  double sind, cosd, sinr, cosr, clo, chi, alo, ahi, arc;
+  *nasc = *ndsc = 0;
+  if (npmax < 2) {
+    if (serr != NULL)
+      sprintf(serr, "swe_acg_lines(): npmax must be >= 2");
+    return ERR;
+  }
+  if (lat_max <= 0 || lat_max > 90)
+    lat_max = 90;
+  if (max_step <= 0)
+    max_step = 1;
+  iflag &= SEFLG_EPHMASK;
+  tjd_et = tjd_ut + swe_deltat_ex(tjd_ut, iflag, serr);
+  if (calc_planet_star(tjd_et, ipl, starname, iflag | SEFLG_EQUATORIAL, x, serr) == ERR)
+    return ERR;
+  ra = x[0];
+  de = x[1];
+  gast = swe_sidtime(tjd_ut) * 15;
+  lon0 = acg_lon_norm(ra - gast);
+  dret[0] = lon0;
+  dret[1] = acg_lon_norm(lon0 + 180);
+  dret[2] = ra;
+  dret[3] = de;
+  dret[4] = swe_degnorm(gast);
+  /* rising/setting circle: angular radius r = 90 - dhor around the
+   * sub-body point; a = position angle on the circle, counted from north,
+   * 0..180 lies east of the sub-body point (setting), 180..360 west (rising) */
+  sind = sin(de * DEGTORAD);
+  cosd = cos(de * DEGTORAD);
+  sinr = cos(dhor * DEGTORAD);
+  cosr = sin(dhor * DEGTORAD);
+  dret[5] = asin(sind * cosr + cosd * sinr) * RADTODEG;
+  dret[6] = asin(sind * cosr - cosd * sinr) * RADTODEG;
+  if (cosd < 1e-9 || sinr < 1e-9)
+    return OK;
+  /* clip at +-lat_max: allowed range of cos(a) */
+  chi = (sin(lat_max * DEGTORAD) - sind * cosr) / (cosd * sinr);
+  clo = (-sin(lat_max * DEGTORAD) - sind * cosr) / (cosd * sinr);
+  if (chi > 1) chi = 1;
+  if (clo < -1) clo = -1;
+  if (clo > chi)
+    return OK;
+  alo = acos(chi);	/* northern end */
+  ahi = acos(clo);	/* southern end */
+  arc = (ahi - alo) * sinr * RADTODEG;
+  np = (int32) ceil(arc / max_step) + 1;
+  if (np < 2) np = 2;
+  if (np > npmax) np = npmax;
+  /* both polylines run from south to north */
+  *ndsc = acg_sample_curve(sind, cosd, sinr, cosr, lon0, ahi, alo, np, xdsc);
+  *nasc = acg_sample_curve(sind, cosd, sinr, cosr, lon0, TWOPI - ahi, TWOPI - alo, np, xasc);
+  return OK;
+}
+
+struct paran_event {
+  double ramc;
+  int32 ibody;
+  int32 event;
+};
+
+/* function for sorting paran events with qsort() */
+static int paran_event_compare(const void *ev1, const void *ev2)
+{
+  const struct paran_event *e1 = (const struct paran_event *) ev1;
+  const struct paran_event *e2 = (const struct paran_event *) ev2;
+  if (e1->ramc < e2->ramc) return -1;
+  if (e1->ramc > e2->ramc) return 1;
+  return 0;
+}
+
+/* parans: pairs of bodies that are simultaneously on an angle
+ *
+ * For each body of a list, right ascension and declination are computed
+ * once for tjd_ut. For each latitude of a list, the sidereal times (RAMC)
+ * of rising, setting, upper and lower culmination then follow from the
+ * semi-arc, cos(H0) = (sin(dhor) - sin(lat) sin(decl)) / (cos(lat) cos(decl)),
+ * without any search. The motion of the bodies during the day is neglected,
+ * as is usual with parans. The events of one latitude are sorted by RAMC,
+ * and all pairs of different bodies whose RAMC differ by no more than orb
+ * are returned. Pairs of two culminations are omitted, since they do not
+ * depend on latitude.
+ *
+ * tjd_ut	time (UT)
+ * nbody	number of bodies
+ * ipl		array of nbody planet numbers
+ * starname	NULL, or array of nbody star names; a body with a non-empty
+ *              star name is a fixed star, otherwise ipl[i] is used.
+ *              The star names must be writable buffers of at least
+ *              SE_MAX_STNAME * 2 characters, see swe_fixstar().
+ * iflag	ephemeris flag (SEFLG_SWIEPH, SEFLG_JPLEPH, SEFLG_MOSEPH)
+ * dhor		altitude of the horizon for rising/setting, degrees
+ * dlat		array of nlat geographic latitudes
+ * orb		maximum difference of RAMC in degrees (1 degree = 4 minutes)
+ * evmask	events to consider, combination of SE_CALC_RISE, SE_CALC_SET,
+ *              SE_CALC_MTRANSIT, SE_CALC_ITRANSIT; 0 = all
+ * dpar		return array, 7 doubles per paran, declare as dpar[7 * npmax]:
+ *              dpar[0]	geographic latitude
+ *              dpar[1]	index of first body in the list
+ *              dpar[2]	event of first body (SE_CALC_RISE etc.)
+ *              dpar[3]	index of second body
+ *              dpar[4]	event of second body
+ *              dpar[5]	RAMC of the event of the first body
+ *              dpar[6]	RAMC difference second - first (0..orb)
+ * npmax	capacity of dpar in parans
+ *
+ * returns the total number of parans found (of which at most npmax are
+ * stored in dpar), or ERR.
+ */
+int32 CALL_CONV swe_parans(double tjd_ut, int32 nbody, int32 *ipl, char **starname, int32 iflag, double dhor, double *dlat, int32 nlat, double orb, int32 evmask, double *dpar, int32 npmax, char *serr)
+{
+  int32 i, j, k, ilat, nev, npar = 0;
+  double tjd_et, x[6], d, sinh0, sinp, cosp, cosh0, h0;
+  double *ra, *sinde, *cosde;
+  char *sname;
+  struct paran_event *ev;
+  if (nbody <= 0 || nlat <= 0)
+    return 0;
+  if (evmask == 0)
+    evmask = SE_CALC_RISE | SE_CALC_SET | SE_CALC_MTRANSIT | SE_CALC_ITRANSIT;
+  iflag &= SEFLG_EPHMASK;
+  ra = (double *) malloc(3 * nbody * sizeof(double));
+  ev = (struct paran_event *) malloc(4 * nbody * sizeof(struct paran_event));
+  if (ra == NULL || ev == NULL) {
+    if (serr != NULL)
+      strcpy(serr, "swe_parans(): out of memory");
+    free(ra);
+    free(ev);
+    return ERR;
+  }
+  sinde = ra + nbody;
+  cosde = ra + 2 * nbody;
+  tjd_et = tjd_ut + swe_deltat_ex(tjd_ut, iflag, serr);
+  for (i = 0; i < nbody; i++) {
+    sname = (starname != NULL) ? starname[i] : NULL;
+    if (calc_planet_star(tjd_et, ipl[i], sname, iflag | SEFLG_EQUATORIAL, x, serr) == ERR) {
+      free(ra);
+      free(ev);
+      return ERR;
+    }
+    ra[i] = x[0];
+    sinde[i] = sin(x[1] * DEGTORAD);
+    cosde[i] = cos(x[1] * DEGTORAD);
+  }
+  sinh0 = sin(dhor * DEGTORAD);
+  for (ilat = 0; ilat < nlat; ilat++) {
+    sinp = sin(dlat[ilat] * DEGTORAD);
+    cosp = cos(dlat[ilat] * DEGTORAD);
+    nev = 0;
+    for (i = 0; i < nbody; i++) {
+      if (evmask & SE_CALC_MTRANSIT) {
+	ev[nev].ramc = ra[i];
+	ev[nev].ibody = i;
+	ev[nev++].event = SE_CALC_MTRANSIT;
+      }
+      if (evmask & SE_CALC_ITRANSIT) {
+	ev[nev].ramc = swe_degnorm(ra[i] + 180);
+	ev[nev].ibody = i;
+	ev[nev++].event = SE_CALC_ITRANSIT;
+      }
+      if (!(evmask & (SE_CALC_RISE | SE_CALC_SET)) || cosp * cosde[i] < 1e-10)
+	continue;
+      cosh0 = (sinh0 - sinp * sinde[i]) / (cosp * cosde[i]);
+      if (cosh0 <= -1 || cosh0 >= 1)	/* circumpolar or never rising */
+	continue;
+      h0 = acos(cosh0) * RADTODEG;
+      if (evmask & SE_CALC_RISE) {
+	ev[nev].ramc = swe_degnorm(ra[i] - h0);
+	ev[nev].ibody = i;
+	ev[nev++].event = SE_CALC_RISE;
+      }
+      if (evmask & SE_CALC_SET) {
+	ev[nev].ramc = swe_degnorm(ra[i] + h0);
+	ev[nev].ibody = i;
+	ev[nev++].event = SE_CALC_SET;
+      }
+    }
+    qsort((void *) ev, (size_t) nev, sizeof(struct paran_event), paran_event_compare);
+    for (i = 0; i < nev; i++) {
+      for (k = 1; k < nev; k++) {
+	j = (i + k) % nev;
+	d = ev[j].ramc - ev[i].ramc;
+	if (j < i)
+	  d += 360;
+	if (d > orb)
+	  break;
+	if (ev[i].ibody == ev[j].ibody)
+	  continue;
+	if ((ev[i].event & (SE_CALC_MTRANSIT | SE_CALC_ITRANSIT))
+	  && (ev[j].event & (SE_CALC_MTRANSIT | SE_CALC_ITRANSIT)))
+	  continue;
+	if (npar < npmax) {
+	  dpar[7 * npar] = dlat[ilat];
+	  dpar[7 * npar + 1] = ev[i].ibody;
+	  dpar[7 * npar + 2] = ev[i].event;
+	  dpar[7 * npar + 3] = ev[j].ibody;
+	  dpar[7 * npar + 4] = ev[j].event;
+	  dpar[7 * npar + 5] = ev[i].ramc;
+	  dpar[7 * npar + 6] = d;
+	}
+	npar++;
+      }
+    }
+  }
+  free(ra);
+  free(ev);
+  return npar;
+}
+
+/* Eclipse database, built by sweecldb.c from swe_sol_eclipse_when_glob()
+ * and swe_lun_eclipse_when(), so that the next eclipse or the members of
+ * a Saros series are found without a search.
+ * File SE_ECLDBFILE, little-endian:
+ * header, ECLDB_HDRSIZE bytes:
+ *   0	"SEECLDB1"
+ *   8	uint32 number of eclipses n
+ *  12	uint32 number of time bins nbin
+ *  16	double first date covered (UT)
+ *  24	double end of the dates covered (UT)
+ *  32	double width of a time bin in days
+ *  40	uint32 record size (ECLDB_RECSIZE)
+ * n records, sorted by time, ECLDB_RECSIZE bytes:
+ *   0	double time of maximum eclipse (UT)
+ *   8	uint32 eclipse type, SE_ECL_TOTAL etc.
+ *  12	int16 Saros series, -1 if not known
+ *  14	int16 member of the Saros series
+ *  16	int16 Inex series
+ *  18	uint8 SE_ECLDB_SOLAR or SE_ECLDB_LUNAR
+ *  20	float magnitude: solar according to NASA, lunar umbral
+ *  24	float solar ratio of diameters, lunar penumbral magnitude
+ *  28	float gamma, axis distance in earth radii, north positive
+ *  32	float[6] tret[2] .. tret[7] of the search functions minus
+ *	the time of maximum, in days, ECLDB_NOTIME if there is no
+ *	such contact
+ * nbin + 1 uint32, first record of each time bin, the last one = n
+ * n uint32, record numbers by kind, Saros series and time; those of
+ *	unknown series or series >= ECLDB_NSAROS come first
+ */
+#define ECLDB_MAGIC	"SEECLDB1"
+#define ECLDB_HDRSIZE	48
+#define ECLDB_RECSIZE	56
+#define ECLDB_NSAROS	256	/* Saros series 0..255 are indexed */
+#define ECLDB_NOTIME	1e30
+struct ecldb_rec {
+  double tmax;
+  int32 type;
+  short saros, member, inex;
+  int32 kind;
+  float mag[2], gamma, dt[6];
+};
+static TLS struct {
+  int32 state;		/* 0 = not searched, 1 = not available, 2 = loaded */
+  char path[AS_MAXCH];	/* ephemeris path it was searched in */
+  int32 n;
+  struct ecldb_rec *rec;
+  double tstart, tend, binsize;
+  int32 nbin;
+  int32 *bin;		/* first record of each time bin */
+  int32 *bysaros;	/* record numbers by kind, Saros series, time */
+  int32 sarstart[2 * ECLDB_NSAROS + 1];	/* into bysaros */
+} ecldb = {0, "", 0, NULL, 0, 0, 0, 0, NULL, NULL, {0}};
+
+void swi_ecl_db_free(void)
+{
+  if (ecldb.rec != NULL)
+    free(ecldb.rec);
+  if (ecldb.bin != NULL)
+    free(ecldb.bin);
+  if (ecldb.bysaros != NULL)
+    free(ecldb.bysaros);
+  ecldb.rec = NULL;
+  ecldb.bin = ecldb.bysaros = NULL;
+  ecldb.n = ecldb.nbin = 0;
+  ecldb.state = 0;
+  *ecldb.path = '\0';
+}
+
+/* memory held by the eclipse database, in bytes */
+double swi_ecl_db_bytes(void)
+{
+  double n = 0;
+  if (ecldb.rec != NULL)
+    n += (double) ecldb.n * (sizeof(struct ecldb_rec) + sizeof(int32));
+  if (ecldb.bin != NULL)
+    n += (double) (ecldb.nbin + 1) * sizeof(int32);
+  return n;
+}
+
+static uint32 ecldb_uint32(unsigned char *c)
+{
+  return (uint32) c[0] | ((uint32) c[1] << 8) | ((uint32) c[2] << 16) | ((uint32) c[3] << 24);
+}
+
+static short ecldb_int16(unsigned char *c)
+{
+  return (short) ((uint32) c[0] | ((uint32) c[1] << 8));
+}
+
+static float ecldb_float(unsigned char *c)
+{
+  uint32 u = ecldb_uint32(c);
+  float f;
+  memcpy((void *) &f, (void *) &u, sizeof(float));
+  return f;
+}
+
+static double ecldb_double(unsigned char *c)
+{
+  unsigned long long u = (unsigned long long) ecldb_uint32(c)
+    | ((unsigned long long) ecldb_uint32(c + 4) << 32);
+  double d;
+  memcpy((void *) &d, (void *) &u, sizeof(double));
+  return d;
+}
+
+/* reads the database; returns the number of eclipses or ERR */
+static int32 ecldb_load(char *serr)
+{
+  int32 i, k, n, nbin, sar;
+  unsigned char hdr[ECLDB_HDRSIZE], *buf = NULL, *c;
+  struct ecldb_rec *r;
+  FILE *fp;
+  if (ecldb.state != 0 && strcmp(ecldb.path, swed.ephepath) == 0) {
+    if (ecldb.state == 2)
+      return ecldb.n;
+    if (serr != NULL)
+      sprintf(serr, "eclipse database %s not found", SE_ECLDBFILE);
+    return ERR;
+  }
+  swi_ecl_db_free();
+  strcpy(ecldb.path, swed.ephepath);
+  ecldb.state = 1;
+  if ((fp = swi_fopen(-1, SE_ECLDBFILE, swed.ephepath, serr)) == NULL)
+    return ERR;
+  if (fread((void *) hdr, ECLDB_HDRSIZE, 1, fp) != 1
+    || strncmp((char *) hdr, ECLDB_MAGIC, 8) != 0
+    || (n = (int32) ecldb_uint32(hdr + 8)) <= 0
+    || (nbin = (int32) ecldb_uint32(hdr + 12)) <= 0
+    || ecldb_uint32(hdr + 40) != ECLDB_RECSIZE)
+    goto file_damaged;
+  ecldb.tstart = ecldb_double(hdr + 16);
+  ecldb.tend = ecldb_double(hdr + 24);
+  ecldb.binsize = ecldb_double(hdr + 32);
+  if (!(ecldb.tend > ecldb.tstart) || !(ecldb.binsize > 0)
+    || (ecldb.tend - ecldb.tstart) / ecldb.binsize > nbin)
+    goto file_damaged;
+  buf = (unsigned char *) malloc((size_t) n * ECLDB_RECSIZE);
+  ecldb.rec = (struct ecldb_rec *) malloc((size_t) n * sizeof(struct ecldb_rec));
+  ecldb.bin = (int32 *) malloc((size_t) (nbin + 1) * sizeof(int32));
+  ecldb.bysaros = (int32 *) malloc((size_t) n * sizeof(int32));
+  if (buf == NULL || ecldb.rec == NULL || ecldb.bin == NULL || ecldb.bysaros == NULL) {
+    if (serr != NULL)
+      sprintf(serr, "error in malloc() with eclipse database");
+    goto return_error;
+  }
+  if (fread((void *) buf, ECLDB_RECSIZE, (size_t) n, fp) != (size_t) n)
+    goto file_damaged;
+  for (i = 0, r = ecldb.rec; i < n; i++, r++) {
+    c = buf + i * ECLDB_RECSIZE;
+    r->tmax = ecldb_double(c);
+    r->type = (int32) ecldb_uint32(c + 8);
+    r->saros = ecldb_int16(c + 12);
+    r->member = ecldb_int16(c + 14);
+    r->inex = ecldb_int16(c + 16);
+    r->kind = c[18];
+    r->mag[0] = ecldb_float(c + 20);
+    r->mag[1] = ecldb_float(c + 24);
+    r->gamma = ecldb_float(c + 28);
+    for (k = 0; k < 6; k++)
+      r->dt[k] = ecldb_float(c + 32 + 4 * k);
+    if (r->kind > SE_ECLDB_LUNAR || (i > 0 && r->tmax < r[-1].tmax))
+      goto file_damaged;
+  }
+  /* both indexes are read into buf, then checked */
+  if (fread((void *) buf, sizeof(int32), (size_t) (nbin + 1 + n), fp) != (size_t) (nbin + 1 + n))
+    goto file_damaged;
+  for (i = 0; i <= nbin; i++) {
+    ecldb.bin[i] = (int32) ecldb_uint32(buf + 4 * i);
+    if (ecldb.bin[i] > n || (i > 0 && ecldb.bin[i] < ecldb.bin[i-1]))
+      goto file_damaged;
+  }
+  if (ecldb.bin[nbin] != n)
+    goto file_damaged;
+  /* start of each Saros series in bysaros */
+  memset((void *) ecldb.sarstart, 0, sizeof(ecldb.sarstart));
+  for (i = 0; i < n; i++) {
+    k = ecldb.bysaros[i] = (int32) ecldb_uint32(buf + 4 * (nbin + 1 + i));
+    if (k < 0 || k >= n)
+      goto file_damaged;
+    sar = ecldb.rec[k].saros;
+    if (sar >= 0 && sar < ECLDB_NSAROS)
+      ecldb.sarstart[ecldb.rec[k].kind * ECLDB_NSAROS + sar + 1]++;
+  }
+  for (i = 1; i <= 2 * ECLDB_NSAROS; i++)
+    ecldb.sarstart[i] += ecldb.sarstart[i-1];
+  /* the records of unknown or unindexed series come first */
+  k = n - ecldb.sarstart[2 * ECLDB_NSAROS];
+  for (i = 0; i <= 2 * ECLDB_NSAROS; i++)
+    ecldb.sarstart[i] += k;
+  free(buf);
+  fclose(fp);
+  ecldb.n = n;
+  ecldb.nbin = nbin;
+  ecldb.state = 2;
+  return n;
+file_damaged:
+  if (serr != NULL)
+    sprintf(serr, "eclipse database %s is damaged", SE_ECLDBFILE);
+return_error:
+  if (buf != NULL)
+    free(buf);
+  fclose(fp);
+  swi_ecl_db_free();
+  strcpy(ecldb.path, swed.ephepath);
+  ecldb.state = 1;
+  return ERR;
+}
+
+/* eclipse types as selected by swe_sol_eclipse_when_glob() and
+ * swe_lun_eclipse_when() */
+static AS_BOOL ecldb_wanted(int32 type, int32 ifltype)
+{
+  if (!(ifltype & SE_ECL_NONCENTRAL) && (type & SE_ECL_NONCENTRAL))
+    return FALSE;
+  if (!(ifltype & SE_ECL_CENTRAL) && (type & SE_ECL_CENTRAL))
+    return FALSE;
+  if (!(ifltype & SE_ECL_ANNULAR) && (type & SE_ECL_ANNULAR))
+    return FALSE;
+  if (!(ifltype & SE_ECL_PARTIAL) && (type & SE_ECL_PARTIAL))
+    return FALSE;
+  if (!(ifltype & SE_ECL_TOTAL) && (type & SE_ECL_TOTAL))
+    return FALSE;
+  if (!(ifltype & SE_ECL_ANNULAR_TOTAL) && (type & SE_ECL_ANNULAR_TOTAL))
+    return FALSE;
+  if (!(ifltype & SE_ECL_PENUMBRAL) && (type & SE_ECL_PENUMBRAL))
+    return FALSE;
+  return TRUE;
+}
+
+/* Covered range of the eclipse database.
+ * tjd_start, tjd_end	first date and end of the dates covered (UT),
+ *			may be NULL
+ * returns the number of eclipses, or ERR if there is no database in
+ * the ephemeris path.
+ */
+int32 CALL_CONV swe_eclipse_db_range(double *tjd_start, double *tjd_end, char *serr)
+{
+  if (ecldb_load(serr) == ERR)
+    return ERR;
+  if (tjd_start != NULL)
+    *tjd_start = ecldb.tstart;
+  if (tjd_end != NULL)
+    *tjd_end = ecldb.tend;
+  return ecldb.n;
+}
+
+/* Next (or previous) solar or lunar eclipse from the eclipse database,
+ * as swe_sol_eclipse_when_glob() or swe_lun_eclipse_when() would find
+ * it with SEFLG_SWIEPH.
+ *
+ * tjd_start	start time (UT)
+ * ikind	SE_ECLDB_SOLAR or SE_ECLDB_LUNAR
+ * ifltype	eclipse type to be searched (SE_ECL_TOTAL, etc.), 0 = any
+ * tret		as of the search functions, except that tret[1] (solar:
+ *		local apparent noon) is 0; declare as tret[10] at least
+ * attr[0]	magnitude: solar according to NASA, lunar umbral
+ * attr[1]	solar: ratio of lunar diameter to solar one;
+ *		lunar: penumbral magnitude
+ * attr[2]	gamma: least distance of the shadow axis from the center
+ *		of the earth (solar) or of the moon from the axis of the
+ *		earth shadow (lunar), in earth radii, north positive
+ * attr[9]	saros series number
+ * attr[10]	saros series member number
+ * attr[11]	inex series number
+ *		attr[9..11] are -99999999 if not known
+ *		declare as attr[20] at least
+ * backward	TRUE, if backward search
+ *
+ * returns the eclipse type, or ERR if there is no database, or if
+ * tjd_start or the eclipse is outside the dates covered; the search
+ * functions must then be used.
+ */
+int32 CALL_CONV swe_eclipse_db_when(double tjd_start, int32 ikind, int32 ifltype, double *tret, double *attr, int32 backward, char *serr)
+{
+  int32 i, k;
+  struct ecldb_rec *r;
+  if (ikind != SE_ECLDB_SOLAR && ikind != SE_ECLDB_LUNAR) {
+    if (serr != NULL)
+      sprintf(serr, "swe_eclipse_db_when(): invalid kind %d", ikind);
+    return ERR;
+  }
+  if (ecldb_load(serr) == ERR)
+    return ERR;
+  if (ikind == SE_ECLDB_SOLAR) {
+    if (ifltype == (SE_ECL_PARTIAL | SE_ECL_CENTRAL)) {
+      if (serr != NULL)
+        strcpy(serr, "central partial eclipses do not exist");
+      return ERR;
+    }
+    if (ifltype == 0)
+      ifltype = SE_ECL_TOTAL | SE_ECL_ANNULAR | SE_ECL_PARTIAL
+             | SE_ECL_ANNULAR_TOTAL | SE_ECL_NONCENTRAL | SE_ECL_CENTRAL;
+    if (ifltype == SE_ECL_TOTAL || ifltype == SE_ECL_ANNULAR || ifltype == SE_ECL_ANNULAR_TOTAL)
+      ifltype |= (SE_ECL_NONCENTRAL | SE_ECL_CENTRAL);
+    if (ifltype == SE_ECL_PARTIAL)
+      ifltype |= SE_ECL_NONCENTRAL;
+  } else {
+    ifltype &= ~(SE_ECL_CENTRAL | SE_ECL_NONCENTRAL | SE_ECL_ANNULAR | SE_ECL_ANNULAR_TOTAL);
+    if (ifltype == 0)
+      ifltype = SE_ECL_TOTAL | SE_ECL_PENUMBRAL | SE_ECL_PARTIAL;
+  }
+  if (!(tjd_start >= ecldb.tstart && tjd_start < ecldb.tend))
+    goto not_covered;
+  /* time bin of tjd_start, then the first record after it */
+  k = (int32) ((tjd_start - ecldb.tstart) / ecldb.binsize);
+  if (k >= ecldb.nbin) k = ecldb.nbin - 1;
+  if (!backward) {
+    for (i = ecldb.bin[k]; i < ecldb.n && ecldb.rec[i].tmax <= tjd_start; i++)
+      ;
+    for (; i < ecldb.n; i++)
+      if (ecldb.rec[i].kind == ikind && ecldb_wanted(ecldb.rec[i].type, ifltype))
+	break;
+    if (i == ecldb.n)
+      goto not_covered;
+  } else {
+    for (i = ecldb.bin[k + 1] - 1; i >= 0 && ecldb.rec[i].tmax >= tjd_start; i--)
+      ;
+    for (; i >= 0; i--)
+      if (ecldb.rec[i].kind == ikind && ecldb_wanted(ecldb.rec[i].type, ifltype))
+	break;
+    if (i < 0)
+      goto not_covered;
+  }
+  r = &ecldb.rec[i];
+  for (k = 0; k < 10; k++)
+    tret[k] = 0;
+  tret[0] = r->tmax;
+  for (k = 0; k < 6; k++)
+    if (r->dt[k] < ECLDB_NOTIME / 2)
+      tret[k + 2] = r->tmax + r->dt[k];
+  for (k = 0; k < 20; k++)
+    attr[k] = 0;
+  attr[0] = r->mag[0];
+  attr[1] = r->mag[1];
+  attr[2] = r->gamma;
+  if (r->saros >= 0) {
+    attr[9] = r->saros;
+    attr[10] = r->member;
+    attr[11] = r->inex;
+  } else {
+    attr[9] = attr[10] = attr[11] = -99999999;
+  }
+  return r->type;
+not_covered:
+  if (serr != NULL)
+    sprintf(serr, "date %f is not covered by the eclipse database %s", tjd_start, SE_ECLDBFILE);
+  return ERR;
+}
+
+/* Members of a Saros series in the eclipse database.
+ * ikind	SE_ECLDB_SOLAR or SE_ECLDB_LUNAR
+ * saros	series number
+ * tret		times of maximum (UT) in ascending order, nmax at most;
+ *		swe_eclipse_db_when(tret[i] - 1, ...) gives the details
+ * returns the number of members in the database (of which at most nmax
+ * are stored in tret), or ERR if there is no database.
+ */
+int32 CALL_CONV swe_eclipse_db_saros(int32 ikind, int32 saros, double *tret, int32 nmax, char *serr)
+{
+  int32 i, n, i0;
+  if (ikind != SE_ECLDB_SOLAR && ikind != SE_ECLDB_LUNAR) {
+    if (serr != NULL)
+      sprintf(serr, "swe_eclipse_db_saros(): invalid kind %d", ikind);
+    return ERR;
+  }
+  if (ecldb_load(serr) == ERR)
+    return ERR;
+  if (saros < 0 || saros >= ECLDB_NSAROS)
+    return 0;
+  i0 = ecldb.sarstart[ikind * ECLDB_NSAROS + saros];
+  n = ecldb.sarstart[ikind * ECLDB_NSAROS + saros + 1] - i0;
+  for (i = 0; i < n && i < nmax; i++)
+    tret[i] = ecldb.rec[ecldb.bysaros[i0 + i]].tmax;
+  return n;
+}
@@ -92,6 +92,9 @@ extern "C" {
 DllImport int32 CALL_CONV_IMP swe_heliacal_ut(double JDNDaysUTStart, double *geopos, double *datm, double *dobs, char *ObjectName, int32 TypeEvent, int32 iflag, double *dret, char *serr);
 DllImport int32 CALL_CONV_IMP swe_heliacal_pheno_ut(double JDNDaysUT, double *geopos, double *datm, double *dobs, char *ObjectName, int32 TypeEvent, int32 helflag, double *darr, char *serr);
 DllImport int32 CALL_CONV_IMP swe_vis_limit_mag(double tjdut, double *geopos, double *datm, double *dobs, char *ObjectName, int32 helflag, double *dret, char *serr);
+DllImport int32 CALL_CONV_IMP swe_heliacal_crescent_grid(double tjd_ut, double *dgrid, int32 nlat, int32 nlon, int32 helflag, double *qgrid, int32 *cgrid, double *dret, char *serr);
+DllImport int32 CALL_CONV_IMP swe_sky_brightness_grid(double tjdut, double *dgeo, double *datm, double *dobs, int32 helflag, double *dgrid, int32 nalt, int32 nazi, float *bgrid, float *mgrid, double *dret, char *serr);
+DllImport int32 CALL_CONV_IMP swe_vis_limit_mag_series(double tjd_start, double tstep, int32 nstep, double *dgeo, double *datm, double *dobs, int32 helflag, double alt, double azi, float *bret, float *mret, char *serr);
 /* the following are secret, for Victor Reijs' */
 DllImport int32 CALL_CONV_IMP swe_heliacal_angle(double tjdut, double *dgeo, double *datm, double *dobs, int32 helflag, double mag, double azi_obj, double azi_sun, double azi_moon, double alt_moon, double *dret, char *serr);
 DllImport int32 CALL_CONV_IMP swe_topo_arcus_visionis(double tjdut, double *dgeo, double *datm, double *dobs, int32 helflag, double mag, double azi_obj, double alt_obj, double azi_sun, double azi_moon, double alt_moon, double *dret, char *serr);
@@ -131,6 +134,24 @@ DllImport int32 CALL_CONV_IMP swe_helio_cross(
 	int ipl, double x2cross, double jd_et, int32 iflag, int32 dir, double *jd_cross, char *serr);
 DllImport int32 CALL_CONV_IMP swe_helio_cross_ut(
 	int ipl, double x2cross, double jd_ut, int32 iflag, int32 dir, double *jd_cross, char *serr);
+DllImport int32 CALL_CONV_IMP swe_panchang_transits(
+	double tjd_start, double tjd_end, int32 ptype, int32 iflag, double *tret, int32 *iret, int32 nmax, char *serr);
+DllImport int32 CALL_CONV_IMP swe_panchang(
+	double tjd_start, int32 ndays, double *geopos, int32 nloc, int32 iflag, double *dpan, char *serr);
+DllImport int32 CALL_CONV_IMP swe_moon_extremes(
+	double tjd_start, double tjd_end, int32 iflag, double dtsyz, double *dret, int32 nmax, char *serr);
+DllImport int32 CALL_CONV_IMP swe_decl_events(
+	double tjd_start, double tjd_end, int32 *ipl, int32 nbody, int32 iflag, double step, int32 evmask, double *dret, int32 nmax, char *serr);
+DllImport int32 CALL_CONV_IMP swe_fixstar_conjunctions(
+	double tjd_start, double tjd_end, int32 *ipl, int32 nbody, int32 iflag, double maxmag, double latorb, double *dret, int32 nmax, char *serr);
+DllImport int32 CALL_CONV_IMP swe_cheb_fit(
+	double tjd_start, double tjd_end, int32 ipl, int32 iflag, double tol, int32 ncoe, double *dseg, int32 nmax, char *serr);
+DllImport int32 CALL_CONV_IMP swe_calc_ast_elements(
+	double tjd_ut, int32 iflag, int32 first, int32 count, double *xret, int32 *anum, char *serr);
+DllImport int32 CALL_CONV_IMP swe_ast_elem_near(
+	double tjd_ut, int32 iflag, double *xlon, int32 npoints, double orb, double *dret, int32 nmax, char *serr);
+DllImport void CALL_CONV_IMP swe_set_ast_elem_mode(int32 mode);
+DllImport void CALL_CONV_IMP swe_set_light_time_mode(int32 mode);
 
 DllImport int32 CALL_CONV_IMP swe_fixstar(
         char *star, double tjd, int32 iflag, 
@@ -187,11 +208,25 @@ DllImport int  CALL_CONV_IMP swe_houses_armc_ex2(
 DllImport double  CALL_CONV_IMP swe_house_pos(
         double armc, double geolon, double eps, int hsys, double *xpin, char *serr);
 
+DllImport int32  CALL_CONV_IMP swe_primary_directions(
+        double armc, double geolat, double eps, int hsys, int32 pdflag,
+        double *xprom, int32 npro, double *xsig, int32 nsig, double *dasp, int32 nasp,
+        double *darc, char *serr);
+
+DllImport int32  CALL_CONV_IMP swe_primary_directions_dates(
+        double tjd_ut, int32 iflag, int32 key, double *darc, int32 narc, double *dtjd, char *serr);
+
 DllImport const char * CALL_CONV_IMP swe_house_name(int hsys);
 
 DllImport int32  CALL_CONV_IMP swe_gauquelin_sector(
 	double t_ut, int32 ipl, char *starname, int32 iflag, int32 imeth, double *geopos, double atpress, double attemp, double *dgsect, char *serr);
 
+DllImport int32  CALL_CONV_IMP swe_acg_lines(
+	double tjd_ut, int32 ipl, char *starname, int32 iflag, double dhor, double lat_max, double max_step, int32 npmax, double *dret, double *xasc, int32 *nasc, double *xdsc, int32 *ndsc, char *serr);
+
+DllImport int32  CALL_CONV_IMP swe_parans(
+	double tjd_ut, int32 nbody, int32 *ipl, char **starname, int32 iflag, double dhor, double *dlat, int32 nlat, double orb, int32 evmask, double *dpar, int32 npmax, char *serr);
+
 DllImport void  CALL_CONV_IMP swe_set_sid_mode(
         int32 sid_mode, double t0, double ayan_t0);
 
@@ -252,6 +287,11 @@ DllImport void  CALL_CONV_IMP swe_set_tid_acc(double tidacc);
 DllImport void  CALL_CONV_IMP swe_set_delta_t_userdef(double dt);
 DllImport void  CALL_CONV_IMP swe_set_ephe_path(const char *path);
 DllImport void  CALL_CONV_IMP swe_set_jpl_file(const char *fname);
+DllImport int32 CALL_CONV_IMP swe_set_ephe_remote(char *url, int32 block_size, int32 cache_blocks, SWE_REMOTE_READ reader, char *serr);
+DllImport int32 CALL_CONV_IMP swe_get_ephe_remote_stats(double *dstat);
+DllImport void  CALL_CONV_IMP swe_set_ephe_prefetch(int32 nseg);
+DllImport int32 CALL_CONV_IMP swe_ephe_prefetch(double tjd_start, double tjd_end, int32 *ipl, int32 nbody, int32 iflag, char *serr);
+DllImport int32 CALL_CONV_IMP swe_get_memory_stats(double *dstat);
 DllImport void  CALL_CONV_IMP swe_close(void);
 DllImport char * CALL_CONV_IMP swe_get_planet_name(int ipl, char *spname);
 DllImport void  CALL_CONV_IMP swe_cotrans(double *xpo, double *xpn, double eps);
@@ -295,6 +335,9 @@ DllImport int32  CALL_CONV_IMP swe_lun_eclipse_how(
           char *serr);
 DllImport int32  CALL_CONV_IMP swe_lun_eclipse_when(double tjd_start, int32 ifl, int32 ifltype, double *tret, int32 backward, char *serr);
 DllImport int32  CALL_CONV_IMP swe_lun_eclipse_when_loc(double tjd_start, int32 ifl, double *geopos, double *tret, double *attr, int32 backward, char *serr);
+DllImport int32  CALL_CONV_IMP swe_eclipse_db_range(double *tjd_start, double *tjd_end, char *serr);
+DllImport int32  CALL_CONV_IMP swe_eclipse_db_when(double tjd_start, int32 ikind, int32 ifltype, double *tret, double *attr, int32 backward, char *serr);
+DllImport int32  CALL_CONV_IMP swe_eclipse_db_saros(int32 ikind, int32 saros, double *tret, int32 nmax, char *serr);
 /* planetary phenomena */
 DllImport int32  CALL_CONV_IMP swe_pheno(double tjd, int32 ipl, int32 iflag, double *attr, char *serr);
 
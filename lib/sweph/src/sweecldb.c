@@ -0,0 +1,370 @@
+/*
+
+  sweecldb.c	Builds the eclipse database (seecldb.bin) with the
+		eclipse search functions of the Swiss Ephemeris.
+
+  Usage:  sweecldb [-v] [-jTHREADS] [-eDIR] start_year end_year seecldb.bin
+	All solar and lunar eclipses from 1 January of start_year to
+	31 December of end_year are searched with
+	swe_sol_eclipse_when_glob() and swe_lun_eclipse_when(), in
+	decades that are shared by THREADS threads (default: one per
+	processor). DIR is the ephemeris path (default SE_EPHE_PATH).
+	The database is found by the Swiss Ephemeris in the ephemeris
+	path like any other file and is read by swe_eclipse_db_when()
+	and swe_eclipse_db_saros(). The format is described in swecl.c,
+	see ecldb_load().
+
+  The Inex series of an eclipse follows from its Saros series s and
+  the lunation K (Meeus; for lunar eclipses, of the preceding new
+  moon) by K = 358 s + 223 i - 63065 (rounded down for lunar eclipses),
+  which puts the solar eclipse of 11 August 1999 (Saros 145) in
+  Inex series 50.
+
+  The code of sweecldb.c is in the public domain.
+  (But not the code of the library functions called by it.)
+
+**************************************************************/
+
+
+#include <math.h>
+#include <pthread.h>
+#include <unistd.h>
+#include "swephexp.h"
+
+#define ECLDB_MAGIC	"SEECLDB1"
+#define ECLDB_HDRSIZE	48
+#define ECLDB_RECSIZE	56
+#define ECLDB_NSAROS	256
+#define ECLDB_NOTIME	1e30		/* contact that does not occur */
+#define ECLDB_BINSIZE	365.25		/* days per time bin */
+#define CHUNK_DAYS	3652.5		/* days searched by a thread at once */
+#define MAX_THREADS	64
+#define NEWMOON_K0	2451550.09766	/* Meeus, lunation 0 */
+#define LUNATION	29.530588861
+#define EARTH_RADIUS_AU	(6378.137 / 149597870.7)
+
+struct eclipse {
+  double tmax;
+  double dt[6];		/* tret[2..7] - tmax */
+  double mag[2], gamma;
+  int32 type, kind, saros, member, inex;
+};
+
+struct chunk {
+  double t0, t1;
+  struct eclipse *e;
+  int32 n, nalloc;
+  int32 err;
+  char serr[AS_MAXCH];
+};
+
+static char *ephepath = NULL;
+static int verbose = 0;
+static struct chunk *chunks;
+static int32 nchunk, next_chunk = 0;
+static pthread_mutex_t chunk_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static void put_uint32(unsigned char *c, uint32 u)
+{
+  c[0] = (unsigned char) (u & 0xff);
+  c[1] = (unsigned char) ((u >> 8) & 0xff);
+  c[2] = (unsigned char) ((u >> 16) & 0xff);
+  c[3] = (unsigned char) ((u >> 24) & 0xff);
+}
+
+static void put_int16(unsigned char *c, int32 i)
+{
+  c[0] = (unsigned char) (i & 0xff);
+  c[1] = (unsigned char) ((i >> 8) & 0xff);
+}
+
+static void put_float(unsigned char *c, float f)
+{
+  uint32 u;
+  memcpy((void *) &u, (void *) &f, sizeof(float));
+  put_uint32(c, u);
+}
+
+static void put_double(unsigned char *c, double d)
+{
+  unsigned long long u;
+  memcpy((void *) &u, (void *) &d, sizeof(double));
+  put_uint32(c, (uint32) (u & 0xffffffff));
+  put_uint32(c + 4, (uint32) (u >> 32));
+}
+
+/* a / b, rounded down also for negative a */
+static int32 floor_div(int32 a, int32 b)
+{
+  return (a >= 0) ? a / b : -((-a + b - 1) / b);
+}
+
+/* distance of the shadow axis from the earth center (solar) or of the
+ * moon from the axis of the earth shadow (lunar), in earth radii,
+ * positive if north */
+static double eclipse_gamma(double tjd_ut, int32 kind)
+{
+  double xs[6], xm[6], u[3], d[3], r, p;
+  int32 iflag = SEFLG_SWIEPH | SEFLG_EQUATORIAL | SEFLG_XYZ;
+  char serr[AS_MAXCH];
+  int i;
+  if (swe_calc_ut(tjd_ut, SE_SUN, iflag, xs, serr) < 0
+    || swe_calc_ut(tjd_ut, SE_MOON, iflag, xm, serr) < 0)
+    return 0;
+  /* the axis runs from the sun through the moon or the earth; in both
+   * cases, the distance is that of the moon's position vector from a
+   * line through the origin or the moon with direction u */
+  for (i = 0; i < 3; i++)
+    u[i] = (kind == SE_ECLDB_SOLAR) ? xm[i] - xs[i] : -xs[i];
+  r = sqrt(u[0] * u[0] + u[1] * u[1] + u[2] * u[2]);
+  for (i = 0; i < 3; i++)
+    u[i] /= r;
+  p = xm[0] * u[0] + xm[1] * u[1] + xm[2] * u[2];
+  for (i = 0; i < 3; i++)
+    d[i] = xm[i] - p * u[i];
+  r = sqrt(d[0] * d[0] + d[1] * d[1] + d[2] * d[2]) / EARTH_RADIUS_AU;
+  return (d[2] < 0) ? -r : r;
+}
+
+static int add_eclipse(struct chunk *ch, struct eclipse *e)
+{
+  if (ch->n == ch->nalloc) {
+    ch->nalloc = ch->nalloc * 2 + 64;
+    ch->e = (struct eclipse *) realloc(ch->e, ch->nalloc * sizeof(struct eclipse));
+    if (ch->e == NULL) {
+      strcpy(ch->serr, "out of memory");
+      return ERR;
+    }
+  }
+  ch->e[ch->n++] = *e;
+  return OK;
+}
+
+/* all eclipses of one kind with maxima in t0 <= t < t1 */
+static int search_chunk(struct chunk *ch, int32 kind)
+{
+  double t = ch->t0, tret[10], attr[20], geopos[3] = {0, 0, 0}, k;
+  int32 i, retflag;
+  struct eclipse e;
+  for (;;) {
+    if (kind == SE_ECLDB_SOLAR)
+      retflag = swe_sol_eclipse_when_glob(t, SEFLG_SWIEPH, 0, tret, FALSE, ch->serr);
+    else
+      retflag = swe_lun_eclipse_when(t, SEFLG_SWIEPH, 0, tret, FALSE, ch->serr);
+    if (retflag == ERR)
+      return ERR;
+    if (tret[0] >= ch->t1)
+      return OK;
+    t = tret[0] + 1;
+    if (tret[0] < ch->t0)
+      continue;
+    memset((void *) &e, 0, sizeof(e));
+    e.tmax = tret[0];
+    e.type = retflag;
+    e.kind = kind;
+    for (i = 0; i < 6; i++)
+      e.dt[i] = (tret[i + 2] != 0) ? tret[i + 2] - tret[0] : ECLDB_NOTIME;
+    if (kind == SE_ECLDB_SOLAR) {
+      if (swe_sol_eclipse_where(tret[0], SEFLG_SWIEPH, geopos, attr, ch->serr) == ERR)
+	return ERR;
+      e.mag[0] = attr[8];
+      e.mag[1] = attr[1];
+      k = floor((tret[0] - NEWMOON_K0) / LUNATION + 0.5);
+    } else {
+      if (swe_lun_eclipse_how(tret[0], SEFLG_SWIEPH, geopos, attr, ch->serr) == ERR)
+	return ERR;
+      e.mag[0] = attr[0];
+      e.mag[1] = attr[1];
+      k = floor((tret[0] - NEWMOON_K0) / LUNATION);
+    }
+    e.gamma = eclipse_gamma(tret[0], kind);
+    if (attr[9] >= 0 && attr[9] < ECLDB_NSAROS) {
+      e.saros = (int32) attr[9];
+      e.member = (int32) attr[10];
+      e.inex = floor_div((int32) k - 358 * e.saros + 63065, 223);
+    } else {
+      e.saros = -1;
+    }
+    if (add_eclipse(ch, &e) == ERR)
+      return ERR;
+  }
+}
+
+static void *search_thread(void *arg)
+{
+  struct chunk *ch;
+  int32 ic;
+  (void) arg;
+  swe_set_ephe_path(ephepath);
+  for (;;) {
+    pthread_mutex_lock(&chunk_lock);
+    ic = next_chunk++;
+    pthread_mutex_unlock(&chunk_lock);
+    if (ic >= nchunk)
+      break;
+    ch = &chunks[ic];
+    if (search_chunk(ch, SE_ECLDB_SOLAR) == ERR || search_chunk(ch, SE_ECLDB_LUNAR) == ERR) {
+      ch->err = 1;
+      break;
+    }
+    if (verbose)
+      fprintf(stderr, "sweecldb: %.1f - %.1f: %d eclipses\n", ch->t0, ch->t1, ch->n);
+  }
+  swe_close();
+  return NULL;
+}
+
+static struct eclipse *all;
+
+static int eclipse_time_compare(const void *a, const void *b)
+{
+  double ta = ((const struct eclipse *) a)->tmax, tb = ((const struct eclipse *) b)->tmax;
+  return (ta > tb) - (ta < tb);
+}
+
+/* unknown series first, then by kind, series and time */
+static int eclipse_saros_compare(const void *a, const void *b)
+{
+  struct eclipse *ea = &all[*(const int32 *) a], *eb = &all[*(const int32 *) b];
+  int32 ka = (ea->saros < 0) ? -1 : ea->kind * ECLDB_NSAROS + ea->saros;
+  int32 kb = (eb->saros < 0) ? -1 : eb->kind * ECLDB_NSAROS + eb->saros;
+  if (ka != kb)
+    return (ka > kb) - (ka < kb);
+  return (ea->tmax > eb->tmax) - (ea->tmax < eb->tmax);
+}
+
+int main(int argc, char *argv[])
+{
+  int i, k, nthread = 0, iarg = 0, year0 = 0, year1 = 0;
+  int32 n, nbin, ibin, *bysaros;
+  double tstart, tend;
+  char *fname = NULL;
+  unsigned char hdr[ECLDB_HDRSIZE], rec[ECLDB_RECSIZE], c[4];
+  pthread_t thread[MAX_THREADS];
+  struct eclipse *e;
+  FILE *fp;
+  for (i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "-v") == 0) {
+      verbose = 1;
+    } else if (strncmp(argv[i], "-j", 2) == 0) {
+      nthread = atoi(argv[i] + 2);
+    } else if (strncmp(argv[i], "-e", 2) == 0) {
+      ephepath = argv[i] + 2;
+    } else if (iarg == 0) {
+      year0 = atoi(argv[i]);
+      iarg++;
+    } else if (iarg == 1) {
+      year1 = atoi(argv[i]);
+      iarg++;
+    } else if (iarg == 2) {
+      fname = argv[i];
+      iarg++;
+    } else {
+      iarg++;
+    }
+  }
+  if (iarg != 3 || year1 < year0) {
+    fprintf(stderr, "usage: sweecldb [-v] [-jTHREADS] [-eDIR] start_year end_year seecldb.bin\n");
+    return 1;
+  }
+  if (nthread <= 0)
+    nthread = (int) sysconf(_SC_NPROCESSORS_ONLN);
+  if (nthread <= 0)
+    nthread = 1;
+  if (nthread > MAX_THREADS)
+    nthread = MAX_THREADS;
+  tstart = swe_julday(year0, 1, 1, 0, SE_GREG_CAL);
+  tend = swe_julday(year1 + 1, 1, 1, 0, SE_GREG_CAL);
+  /* search in parallel, a decade at a time */
+  nchunk = (int32) ceil((tend - tstart) / CHUNK_DAYS);
+  chunks = (struct chunk *) calloc((size_t) nchunk, sizeof(struct chunk));
+  if (chunks == NULL) {
+    fprintf(stderr, "sweecldb: out of memory\n");
+    return 1;
+  }
+  for (i = 0; i < nchunk; i++) {
+    chunks[i].t0 = tstart + i * CHUNK_DAYS;
+    chunks[i].t1 = (i == nchunk - 1) ? tend : tstart + (i + 1) * CHUNK_DAYS;
+  }
+  if (nthread > nchunk)
+    nthread = nchunk;
+  for (i = 0; i < nthread; i++) {
+    if (pthread_create(&thread[i], NULL, search_thread, NULL) != 0) {
+      fprintf(stderr, "sweecldb: cannot create thread\n");
+      return 1;
+    }
+  }
+  for (i = 0; i < nthread; i++)
+    pthread_join(thread[i], NULL);
+  for (i = 0, n = 0; i < nchunk; i++) {
+    if (chunks[i].err) {
+      fprintf(stderr, "sweecldb: %s\n", chunks[i].serr);
+      return 1;
+    }
+    n += chunks[i].n;
+  }
+  all = (struct eclipse *) malloc((size_t) (n + 1) * sizeof(struct eclipse));
+  bysaros = (int32 *) malloc((size_t) (n + 1) * sizeof(int32));
+  if (all == NULL || bysaros == NULL) {
+    fprintf(stderr, "sweecldb: out of memory\n");
+    return 1;
+  }
+  for (i = 0, n = 0; i < nchunk; i++) {
+    memcpy((void *) (all + n), (void *) chunks[i].e, chunks[i].n * sizeof(struct eclipse));
+    n += chunks[i].n;
+  }
+  if (n == 0) {
+    fprintf(stderr, "sweecldb: no eclipses found\n");
+    return 1;
+  }
+  qsort((void *) all, (size_t) n, sizeof(struct eclipse), eclipse_time_compare);
+  for (i = 0; i < n; i++)
+    bysaros[i] = i;
+  qsort((void *) bysaros, (size_t) n, sizeof(int32), eclipse_saros_compare);
+  nbin = (int32) ceil((tend - tstart) / ECLDB_BINSIZE);
+  if ((fp = fopen(fname, "wb")) == NULL) {
+    fprintf(stderr, "sweecldb: cannot write %s\n", fname);
+    return 1;
+  }
+  memset((void *) hdr, 0, sizeof(hdr));
+  memcpy((void *) hdr, ECLDB_MAGIC, 8);
+  put_uint32(hdr + 8, (uint32) n);
+  put_uint32(hdr + 12, (uint32) nbin);
+  put_double(hdr + 16, tstart);
+  put_double(hdr + 24, tend);
+  put_double(hdr + 32, ECLDB_BINSIZE);
+  put_uint32(hdr + 40, ECLDB_RECSIZE);
+  fwrite((void *) hdr, ECLDB_HDRSIZE, 1, fp);
+  for (i = 0, e = all; i < n; i++, e++) {
+    memset((void *) rec, 0, sizeof(rec));
+    put_double(rec, e->tmax);
+    put_uint32(rec + 8, (uint32) e->type);
+    put_int16(rec + 12, e->saros);
+    put_int16(rec + 14, e->member);
+    put_int16(rec + 16, e->inex);
+    rec[18] = (unsigned char) e->kind;
+    put_float(rec + 20, (float) e->mag[0]);
+    put_float(rec + 24, (float) e->mag[1]);
+    put_float(rec + 28, (float) e->gamma);
+    for (k = 0; k < 6; k++)
+      put_float(rec + 32 + 4 * k, (float) e->dt[k]);
+    fwrite((void *) rec, ECLDB_RECSIZE, 1, fp);
+  }
+  /* time index: first eclipse of each bin */
+  for (ibin = 0, i = 0; ibin <= nbin; ibin++) {
+    while (i < n && all[i].tmax < tstart + ibin * ECLDB_BINSIZE)
+      i++;
+    put_uint32(c, (uint32) ((ibin == nbin) ? n : i));
+    fwrite((void *) c, 4, 1, fp);
+  }
+  for (i = 0; i < n; i++) {
+    put_uint32(c, (uint32) bysaros[i]);
+    fwrite((void *) c, 4, 1, fp);
+  }
+  if (fclose(fp) != 0) {
+    fprintf(stderr, "sweecldb: error writing %s\n", fname);
+    return 1;
+  }
+  printf("%s: %d eclipses %d-%d, %d threads\n", fname, n, year0, year1, nthread);
+  return 0;
+}
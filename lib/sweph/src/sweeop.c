@@ -0,0 +1,209 @@
+/*
+
+  sweeop.c	Converts the earth orientation files eop_1962_today.txt
+		(IERS EOP C04) and eop_finals.txt (IERS finals.all) into
+		the binary file seeop.bin.
+
+  Usage:  sweeop [-v] eop_1962_today.txt [eop_finals.txt] seeop.bin
+	The daily corrections dpsi, deps to the IAU 1980 nutation are
+	taken in the same way as the Swiss Ephemeris takes them from the
+	text files for SEFLG_JPLHOR. With seeop.bin in the ephemeris path,
+	the library reads it instead of the text files. The format is
+	described in sweph.c, see load_dpsi_deps().
+
+  The code of sweeop.c is in the public domain.
+
+**************************************************************/
+
+
+#include "swephexp.h"
+
+#define EOP_MAGIC	"SEEOPBN1"
+#define EOP_HDRSIZE	32
+#define EOP_BLKDAYS	32
+#define EOP_MAXDAYS	36525
+#define TJDOFS		2400000.5
+
+static void put_uint32(unsigned char *c, uint32 u)
+{
+  c[0] = (unsigned char) (u & 0xff);
+  c[1] = (unsigned char) ((u >> 8) & 0xff);
+  c[2] = (unsigned char) ((u >> 16) & 0xff);
+  c[3] = (unsigned char) ((u >> 24) & 0xff);
+}
+
+static void put_double(unsigned char *c, double d)
+{
+  unsigned long long u;
+  memcpy((void *) &u, (void *) &d, sizeof(double));
+  put_uint32(c, (uint32) (u & 0xffffffff));
+  put_uint32(c + 4, (uint32) (u >> 32));
+}
+
+static int put_varint(unsigned char *c, int32 v)
+{
+  int k = 0;
+  uint32 u = (v < 0) ? ((uint32) (-(v + 1)) << 1) | 1 : (uint32) v << 1;
+  while (u >= 0x80) {
+    c[k++] = (unsigned char) (u | 0x80);
+    u >>= 7;
+  }
+  c[k++] = (unsigned char) u;
+  return k;
+}
+
+/* i-th field of s, separated by blanks, or "" */
+static char *field(char *s, int i, char *f)
+{
+  int n;
+  for (;; i--) {
+    s += strspn(s, " \t");
+    n = (int) strcspn(s, " \t\r\n");
+    if (i == 0 || n == 0)
+      break;
+    s += n;
+  }
+  memcpy(f, s, (size_t) n);
+  f[n] = '\0';
+  return f;
+}
+
+static int32 ipsi[EOP_MAXDAYS], ieps[EOP_MAXDAYS];
+
+int main(int argc, char *argv[])
+{
+  int i, k, n = 0, mjd = 0, mjdsv = 0, state, nblk, verbose = 0;
+  int32 size = 0;
+  char *file[3], s[AS_MAXCH], f[AS_MAXCH];
+  double dpsi, deps, tjd_beg = 0, tjd_end;
+  unsigned char hdr[EOP_HDRSIZE], *offs, *data;
+  FILE *fp;
+  for (i = 1, k = 0; i < argc; i++) {
+    if (strcmp(argv[i], "-v") == 0)
+      verbose = 1;
+    else if (k < 3)
+      file[k++] = argv[i];
+  }
+  if (k < 2) {
+    fprintf(stderr, "usage: sweeop [-v] eop_1962_today.txt [eop_finals.txt] seeop.bin\n");
+    return 1;
+  }
+  if (k == 2) {
+    file[2] = file[1];
+    file[1] = NULL;
+  }
+  /* EOP C04: year month day MJD x y UT1-UTC LOD dpsi deps ..., in " */
+  if ((fp = fopen(file[0], "r")) == NULL) {
+    fprintf(stderr, "sweeop: cannot open %s\n", file[0]);
+    return 1;
+  }
+  while (fgets(s, AS_MAXCH, fp) != NULL) {
+    if (atoi(field(s, 0, f)) == 0)
+      continue;
+    mjd = atoi(field(s, 3, f));
+    if (mjdsv > 0 && mjd - mjdsv != 1) {
+      fprintf(stderr, "sweeop: %s is not in one-day steps at MJD %d\n", file[0], mjd);
+      return 1;
+    }
+    if (n >= EOP_MAXDAYS)
+      break;
+    if (n == 0)
+      tjd_beg = mjd + TJDOFS;
+    ipsi[n] = (int32) floor(atof(field(s, 8, f)) * 1000000.0 + 0.5);
+    ieps[n] = (int32) floor(atof(field(s, 9, f)) * 1000000.0 + 0.5);
+    n++;
+    mjdsv = mjd;
+  }
+  fclose(fp);
+  if (n == 0) {
+    fprintf(stderr, "sweeop: no data in %s\n", file[0]);
+    return 1;
+  }
+  tjd_end = mjdsv + TJDOFS;
+  state = 1;
+  /* finals.all, fixed columns, in 0.001"; Bulletin B or else Bulletin A
+   * values, up to the first day without any */
+  if (file[1] != NULL) {
+    if ((fp = fopen(file[1], "r")) == NULL) {
+      fprintf(stderr, "sweeop: cannot open %s\n", file[1]);
+      return 1;
+    }
+    state = 2;
+    while (fgets(s, AS_MAXCH, fp) != NULL) {
+      if (strlen(s) < 8)
+	continue;
+      mjd = atoi(s + 7);
+      if (mjd + TJDOFS <= tjd_end)
+	continue;
+      if (n >= EOP_MAXDAYS) {
+	state = 1;
+	break;
+      }
+      if (mjdsv > 0 && mjd - mjdsv != 1) {
+	fprintf(stderr, "sweeop: %s is not in one-day steps at MJD %d\n", file[1], mjd);
+	state = -3;
+	break;
+      }
+      dpsi = deps = 0;
+      if (strlen(s) > 178) {
+	dpsi = atof(s + 168);
+	deps = atof(s + 178);
+      }
+      if (dpsi == 0 && strlen(s) > 118) {
+	dpsi = atof(s + 99);
+	deps = atof(s + 118);
+      }
+      if (dpsi == 0)
+	break;
+      tjd_end = mjd + TJDOFS;
+      ipsi[n] = (int32) floor(dpsi * 1000.0 + 0.5);
+      ieps[n] = (int32) floor(deps * 1000.0 + 0.5);
+      n++;
+      mjdsv = mjd;
+    }
+    fclose(fp);
+  }
+  /* block offsets and varints; at most 5 bytes per varint */
+  nblk = (n + EOP_BLKDAYS - 1) / EOP_BLKDAYS;
+  offs = (unsigned char *) malloc((size_t) 4 * nblk);
+  data = (unsigned char *) malloc((size_t) 10 * n);
+  if (offs == NULL || data == NULL) {
+    fprintf(stderr, "sweeop: out of memory\n");
+    return 1;
+  }
+  for (i = 0; i < n; i++) {
+    if (i % EOP_BLKDAYS == 0) {
+      put_uint32(offs + 4 * (i / EOP_BLKDAYS), (uint32) size);
+      size += put_varint(data + size, ipsi[i]);
+      size += put_varint(data + size, ieps[i]);
+    } else {
+      size += put_varint(data + size, ipsi[i] - ipsi[i-1]);
+      size += put_varint(data + size, ieps[i] - ieps[i-1]);
+    }
+    if (verbose)
+      printf("%.1f\t%.6f\t%.6f\n", tjd_beg + i, ipsi[i] / 1000000.0, ieps[i] / 1000000.0);
+  }
+  memset((void *) hdr, 0, EOP_HDRSIZE);
+  memcpy(hdr, EOP_MAGIC, 8);
+  put_uint32(hdr + 8, (uint32) n);
+  put_uint32(hdr + 12, (uint32) state);
+  put_double(hdr + 16, tjd_beg);
+  put_uint32(hdr + 24, EOP_BLKDAYS);
+  put_uint32(hdr + 28, (uint32) size);
+  if ((fp = fopen(file[2], BFILE_W_CREATE)) == NULL) {
+    fprintf(stderr, "sweeop: cannot create %s\n", file[2]);
+    return 1;
+  }
+  if (fwrite((void *) hdr, EOP_HDRSIZE, 1, fp) != 1
+    || fwrite((void *) offs, (size_t) 4 * nblk, 1, fp) != 1
+    || fwrite((void *) data, (size_t) size, 1, fp) != 1) {
+    fprintf(stderr, "sweeop: write error on %s\n", file[2]);
+    fclose(fp);
+    remove(file[2]);
+    return 1;
+  }
+  fclose(fp);
+  printf("%s: %d days, %.1f to %.1f, %d bytes\n", file[2], n, tjd_beg,
+      tjd_beg + n - 1, EOP_HDRSIZE + 4 * nblk + size);
+  return 0;
+}
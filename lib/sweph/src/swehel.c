@@ -364,18 +364,18 @@ int32 call_swe_calc(double tjd, int32 ipl, int32 iflag, double *x, char *serr)
 #endif
 
 /* avoids problems with star name string that may be overwritten by 
-   swe_fixstar() */
+   swe_fixstar2() */
 static int32 call_swe_fixstar(char *star, double tjd, int32 iflag, double *xx, char *serr)
 {
   int32 retval;
   char star2[AS_MAXCH];
   strcpy(star2, star);
-  retval =  swe_fixstar(star2, tjd, iflag, xx, serr);
+  retval =  swe_fixstar2(star2, tjd, iflag, xx, serr);
   return retval;
 }
 
 /* avoids problems with star name string that may be overwritten by 
-   swe_fixstar_mag() */
+   swe_fixstar2_mag() */
 static int32 call_swe_fixstar_mag(char *star, double *mag, char *serr)
 {
   int32 retval;
@@ -388,7 +388,7 @@ static int32 call_swe_fixstar_mag(char *star, double *mag, char *serr)
   }
   strcpy(star_save, star);
   strcpy(star2, star);
-  retval = swe_fixstar_mag(star2, &dmag, serr);
+  retval = swe_fixstar2_mag(star2, &dmag, serr);
   *mag = dmag;
   return retval;
 }
@@ -1180,14 +1180,37 @@ static double MoonPhase(double AltM, double AziM, double AltS, double AziS)
   return 180 - acos(cos(AziSi - AziMi - MoonAvgPar * DEGTORAD) * cos(AltMi + MoonAvgPar * DEGTORAD) * cos(AltSi) + sin(AltSi) * sin(AltMi + MoonAvgPar * DEGTORAD)) / DEGTORAD;
 }
 
+/*###################################################################
+' moonlight at distance RM [deg] from the Moon, for C3 = 10^(-0.4 kXM),
+' fM = 10^(-0.4 (MM - M0 + 43.27)) and fX = 1 - 10^(-0.4 kX)
+' Bm_rm [nL]
+*/
+static double Bm_rm(double RM, double C3, double fM, double fX)
+{
+  double FM, Bm;
+  FM = (62000000.0) / RM / RM + pow(10, 6.15 - RM / 40) + pow(10, 5.36) * (1.06 + pow(cos(RM * DEGTORAD), 2));
+  Bm = FM * C3 + 440000 * (1 - C3);
+  Bm = Bm * fM;
+  Bm = Bm * fX;
+  return mymax(Bm, 0) * erg2nL;
+}
+
+/* factor of Bm() that depends on the Moon's phase */
+static double Bm_phase(double AltM, double AziM, double AltS, double AziS)
+{
+  double M0 = -11.05;
+  double phasemoon = MoonPhase(AltM, AziM, AltS, AziS);
+  double MM = MoonsBrightness(MoonDistance, phasemoon);
+  return pow(10, -0.4 * (MM - M0 + 43.27));
+}
+
 /*###################################################################
 ' Pressure [mbar]
 */
 static double Bm(double AltO, double AziO, double AltM, double AziM, double AltS, double AziS, double sunra, double Lat, double HeightEye, double *datm, int32 helflag, char *serr)
 {
-  double M0 = -11.05;
   double Bm = 0;
-  double RM, kXM, kX, C3, FM, phasemoon, MM;
+  double RM, kXM, kX, C3;
   double lunar_radius = 0.25 * DEGTORAD;
   AS_BOOL object_is_moon = FALSE;
   if (AltO == AltM && AziO == AziM)
@@ -1201,21 +1224,28 @@ static double Bm(double AltO, double AziO, double AltM, double AziM, double AltS
     kXM = Deltam(AltM, AltS, sunra, Lat, HeightEye, datm, helflag, serr);
     kX = Deltam(AltO, AltS, sunra, Lat, HeightEye, datm, helflag, serr);
     C3 = pow(10, -0.4 * kXM);
-    FM = (62000000.0) / RM / RM + pow(10, 6.15 - RM / 40) + pow(10, 5.36) * (1.06 + pow(cos(RM * DEGTORAD), 2));
-    Bm = FM * C3 + 440000 * (1 - C3);
-    phasemoon = MoonPhase(AltM, AziM, AltS, AziS);
-    MM = MoonsBrightness(MoonDistance, phasemoon);
-    Bm = Bm * pow(10, -0.4 * (MM - M0 + 43.27));
-    Bm = Bm * (1 - pow(10, -0.4 * kX));
+    return Bm_rm(RM, C3, Bm_phase(AltM, AziM, AltS, AziS), 1 - pow(10, -0.4 * kX));
   }
   Bm = mymax(Bm, 0) * erg2nL;
   return Bm;
 }
 
+/*###################################################################
+' twilight at distance RS [deg] from the Sun, for the factor fT of the
+' altitude and fX = 1 - 10^(-0.4 kX)
+' Btwi_rs [nL]
+*/
+static double Btwi_rs(double RS, double fT, double fX)
+{
+  double Btwi = fT * (100 / RS) * fX;
+  return mymax(Btwi, 0) * erg2nL;
+}
+
 /*###################################################################
 ' Pressure [mbar]
 */
-static double Btwi(double AltO, double AziO, double AltS, double AziS, double sunra, double Lat, double HeightEye, double *datm, int32 helflag, char *serr)
+/* factor of Btwi() that depends on the altitudes of object and Sun */
+static double Btwi_alt(double AltO, double AltS, double sunra, double Lat, double HeightEye, double *datm, int32 helflag, char *serr)
 {
 double M0 = -11.05;
 double MS = -26.74;
@@ -1223,14 +1253,16 @@ double PresE = PresEfromPresS(datm[1], datm[0], HeightEye);
 double TempE = TempEfromTempS(datm[1], HeightEye, LapseSA);
 double AppAltO = AppAltfromTopoAlt(AltO, TempE, PresE, helflag);
 double ZendO = 90 - AppAltO;
-double RS = DistanceAngle(AltO * DEGTORAD, AziO * DEGTORAD, AltS * DEGTORAD, AziS * DEGTORAD) / DEGTORAD;
-double kX = Deltam(AltO, AltS, sunra, Lat, HeightEye, datm, helflag, serr);
 double k = kt(AltS, sunra, Lat, HeightEye, datm[1], datm[2], datm[3], 4, serr);
 /* From Schaefer , Archaeoastronomy, XV, 2000, page 129*/
-double Btwi = pow(10, -0.4 * (MS - M0 + 32.5 - AltS - (ZendO / (360 * k))));
-Btwi = Btwi * (100 / RS) * (1 - pow(10, -0.4 * kX));
-Btwi = mymax(Btwi, 0) * erg2nL;
-return Btwi;
+return pow(10, -0.4 * (MS - M0 + 32.5 - AltS - (ZendO / (360 * k))));
+}
+
+static double Btwi(double AltO, double AziO, double AltS, double AziS, double sunra, double Lat, double HeightEye, double *datm, int32 helflag, char *serr)
+{
+double RS = DistanceAngle(AltO * DEGTORAD, AziO * DEGTORAD, AltS * DEGTORAD, AziS * DEGTORAD) / DEGTORAD;
+double kX = Deltam(AltO, AltS, sunra, Lat, HeightEye, datm, helflag, serr);
+return Btwi_rs(RS, Btwi_alt(AltO, AltS, sunra, Lat, HeightEye, datm, helflag, serr), 1 - pow(10, -0.4 * kX));
 }
 
 /*###################################################################
@@ -1243,23 +1275,29 @@ return Btwi;
 2350 BD=BD*(1-10^(-.4*K(I)*X))
 2360 BD=BD*(FS*C4+440000.0*(1-C4))
 */
-static double Bday(double AltO, double AziO, double AltS, double AziS, double sunra, double Lat, double HeightEye, double *datm, int32 helflag, char *serr)
+/* daylight at distance RS [deg] from the Sun, for C4 = 10^(-0.4 kXS)
+ * and fX = 1 - 10^(-0.4 kX) */
+static double Bday_rs(double RS, double C4, double fX)
 {
   double M0 = -11.05;
   double MS = -26.74;
-  double RS = DistanceAngle(AltO * DEGTORAD, AziO * DEGTORAD, AltS * DEGTORAD, AziS * DEGTORAD) / DEGTORAD;
-  double kXS = Deltam(AltS, AltS, sunra, Lat, HeightEye, datm, helflag, serr);
-  double kX = Deltam(AltO, AltS, sunra, Lat, HeightEye, datm, helflag, serr);
   /* From Schaefer , Archaeoastronomy, XV, 2000, page 129*/
-  double C4 = pow(10, -0.4 * kXS);
   double FS = (62000000.0) / RS / RS + pow(10, (6.15 - RS / 40)) + pow(10, 5.36) * (1.06 + pow(cos(RS * DEGTORAD), 2));
   double Bday = FS * C4 + 440000.0 * (1 - C4);
   Bday = Bday * pow(10, (-0.4 * (MS - M0 + 43.27)));
-  Bday = Bday * (1 - pow(10, -0.4 * kX));
+  Bday = Bday * fX;
   Bday = mymax(Bday, 0) * erg2nL;
   return Bday;
 }
 
+static double Bday(double AltO, double AziO, double AltS, double AziS, double sunra, double Lat, double HeightEye, double *datm, int32 helflag, char *serr)
+{
+  double RS = DistanceAngle(AltO * DEGTORAD, AziO * DEGTORAD, AltS * DEGTORAD, AziS * DEGTORAD) / DEGTORAD;
+  double kXS = Deltam(AltS, AltS, sunra, Lat, HeightEye, datm, helflag, serr);
+  double kX = Deltam(AltO, AltS, sunra, Lat, HeightEye, datm, helflag, serr);
+  return Bday_rs(RS, pow(10, -0.4 * kXS), 1 - pow(10, -0.4 * kX));
+}
+
 /*###################################################################
 ' Value [nL]
 ' PresS [mbar]
@@ -1360,35 +1398,12 @@ static void default_heliacal_parameters(double *datm, double *dgeo, double *dobs
   }
 }
 
-/*###################################################################
-' age [Year]
-' SN [-]
-' AltO [deg]
-' AziO [deg]
-' AltM [deg]
-' AziM [deg]
-' MoonDistance [km]
-' JDNDaysUT [-]
-' AltS [deg]
-' AziS [deg]
-' lat [deg]
-' heighteye [m]
-' TempS [C]
-' PresS [mbar]
-' RH [%]
-' VR [km]
-' VisLimMagn [-]
-*/
-static double VisLimMagn(double *dobs, double AltO, double AziO, double AltM, double AziM, double JDNDaysUT, double AltS, double AziS, double sunra, double Lat, double HeightEye, double *datm, int32 helflag, int32 *scotopic_flag, char *serr)
+/* VisLimMagn() for a sky brightness Bsk [nL] and extinction kX */
+static double VisLimMagn_b(double *dobs, double Bsk, double kX, double JDNDaysUT, int32 helflag, int32 *scotopic_flag)
 {
-  double C1, C2, Th, kX, Bsk, CorrFactor1, CorrFactor2;
+  double C1, C2, Th, CorrFactor1, CorrFactor2;
   double log10 = 2.302585092994;
   AS_BOOL is_scotopic = FALSE;
-  /*double Age = dobs[0];*/
-  /*double SN = dobs[1];*/
-  Bsk = Bsky(AltO, AziO, AltM, AziM, JDNDaysUT, AltS, AziS, sunra, Lat, HeightEye, datm, helflag, serr);
-  /* Schaefer, Astronomy and the limits of vision, Archaeoastronomy, 1993 Verder:*/
-  kX = Deltam(AltO, AltS, sunra, Lat, HeightEye, datm, helflag, serr);
 if ((0)) {
   static int a = 0;
   if (a == 0)
@@ -1442,6 +1457,36 @@ if ((0)) {
   return -16.57 - 2.5 * (log(Th) / log10);
 }
 
+/*###################################################################
+' age [Year]
+' SN [-]
+' AltO [deg]
+' AziO [deg]
+' AltM [deg]
+' AziM [deg]
+' MoonDistance [km]
+' JDNDaysUT [-]
+' AltS [deg]
+' AziS [deg]
+' lat [deg]
+' heighteye [m]
+' TempS [C]
+' PresS [mbar]
+' RH [%]
+' VR [km]
+' VisLimMagn [-]
+*/
+static double VisLimMagn(double *dobs, double AltO, double AziO, double AltM, double AziM, double JDNDaysUT, double AltS, double AziS, double sunra, double Lat, double HeightEye, double *datm, int32 helflag, int32 *scotopic_flag, char *serr)
+{
+  double kX, Bsk;
+  /*double Age = dobs[0];*/
+  /*double SN = dobs[1];*/
+  Bsk = Bsky(AltO, AziO, AltM, AziM, JDNDaysUT, AltS, AziS, sunra, Lat, HeightEye, datm, helflag, serr);
+  /* Schaefer, Astronomy and the limits of vision, Archaeoastronomy, 1993 Verder:*/
+  kX = Deltam(AltO, AltS, sunra, Lat, HeightEye, datm, helflag, serr);
+  return VisLimMagn_b(dobs, Bsk, kX, JDNDaysUT, helflag, scotopic_flag);
+}
+
 /* tolower star name, but not Bayer designation */
 static char *tolower_string_star(char *str)
 {
@@ -1540,6 +1585,177 @@ int32 CALL_CONV swe_vis_limit_mag(double tjdut, double *dgeo, double *datm, doub
   return retval;
 }
 
+/*###################################################################
+' Sky brightness and limiting magnitude for a grid of directions.
+'
+' swe_vis_limit_mag() evaluates Schaefer's model for one object at a
+' time and recomputes Sun and Moon for every call. Here, the positions
+' of Sun and Moon, the Sun's and the Moon's extinction and the phase 
+' of the Moon are computed once for the instant; airmass, extinction, 
+' night sky and twilight, which depend only on the altitude, once per 
+' row; and the azimuth terms of the angular distances from Sun and 
+' Moon once per column. For a direction of an object, the results are
+' the same as those of swe_vis_limit_mag().
+'
+' tjdut		time (UT)
+' dgeo, datm, dobs, helflag	as with swe_vis_limit_mag(); datm and
+'		dobs are not changed
+' dgrid[0]	altitude of first row [deg], topocentric, without refraction
+' dgrid[1]	altitude step between rows [deg]
+' dgrid[2]	azimuth of first column [deg], from north over east
+' dgrid[3]	azimuth step between columns [deg]
+' nalt, nazi	number of rows and columns
+' bgrid		nalt * nazi sky brightnesses [nL], row by row, 0 below
+'		the horizon; or NULL
+' mgrid		nalt * nazi limiting magnitudes, row by row, -100 below
+'		the horizon; or NULL
+' dret[0..3]	AltS, AziS, AltM, AziM
+*/
+int32 CALL_CONV swe_sky_brightness_grid(double tjdut, double *dgeo, double *datm, double *dobs, int32 helflag, double *dgrid, int32 nalt, int32 nazi, float *bgrid, float *mgrid, double *dret, char *serr)
+{
+  int32 ialt, iazi, idx;
+  double datm2[4], dobs2[6], *sdlon;
+  double AltO, AziO, AltS, AziS, AltM, AziM, sunra, Lat, HeightEye;
+  double C4, C3 = 0, fM = 0, kX, fX, fT, Bnrow, sl2, cc, corde, RS, RM, Bsk;
+  double lunar_radius = 0.25 * DEGTORAD;
+  AS_BOOL moon_up;
+  if (nalt <= 0 || nazi <= 0) {
+    if (serr != NULL)
+      sprintf(serr, "swe_sky_brightness_grid: empty grid %d x %d", nalt, nazi);
+    return ERR;
+  }
+  for (idx = 0; idx < 4; idx++)
+    datm2[idx] = datm[idx];
+  for (idx = 0; idx < 6; idx++)
+    dobs2[idx] = dobs[idx];
+  swi_set_tid_acc(tjdut, helflag, 0, serr);
+  sunra = SunRA(tjdut, helflag, serr);
+  default_heliacal_parameters(datm2, dgeo, dobs2, helflag);
+  swe_set_topo(dgeo[0], dgeo[1], dgeo[2]);
+  Lat = dgeo[1];
+  HeightEye = dgeo[2];
+  /* 
+   * Sun and Moon, as in swe_vis_limit_mag()
+   */
+  if (helflag & SE_HELFLAG_VISLIM_DARK) {
+    AltS = -90;
+    AziS = 0;
+  } else {
+    if (ObjectLoc(tjdut, dgeo, datm2, "sun", 0, helflag, &AltS, serr) == ERR)
+      return ERR;
+    if (ObjectLoc(tjdut, dgeo, datm2, "sun", 1, helflag, &AziS, serr) == ERR)
+      return ERR;
+  }
+  if ((helflag & SE_HELFLAG_VISLIM_DARK) || (helflag & SE_HELFLAG_VISLIM_NOMOON)) {
+    AltM = -90; AziM = 0;
+  } else {
+    if (ObjectLoc(tjdut, dgeo, datm2, "moon", 0, helflag, &AltM, serr) == ERR)
+      return ERR;
+    if (ObjectLoc(tjdut, dgeo, datm2, "moon", 1, helflag, &AziM, serr) == ERR)
+      return ERR;
+  }
+  dret[0] = AltS;
+  dret[1] = AziS;
+  dret[2] = AltM;
+  dret[3] = AziM;
+  /* terms of Bday() and Bm() that do not depend on the direction */
+  C4 = pow(10, -0.4 * Deltam(AltS, AltS, sunra, Lat, HeightEye, datm2, helflag, serr));
+  moon_up = (AltM > -0.26);
+  if (moon_up) {
+    C3 = pow(10, -0.4 * Deltam(AltM, AltS, sunra, Lat, HeightEye, datm2, helflag, serr));
+    fM = Bm_phase(AltM, AziM, AltS, AziS);
+  }
+  /* sin(dlon / 2) of DistanceAngle() for each column, for Sun and Moon */
+  if ((sdlon = (double *) malloc(2 * nazi * sizeof(double))) == NULL) {
+    if (serr != NULL)
+      strcpy(serr, "swe_sky_brightness_grid: out of memory");
+    return ERR;
+  }
+  for (iazi = 0; iazi < nazi; iazi++) {
+    AziO = dgrid[2] + iazi * dgrid[3];
+    sdlon[iazi] = sin((AziS * DEGTORAD - AziO * DEGTORAD) / 2);
+    sdlon[nazi + iazi] = sin((AziM * DEGTORAD - AziO * DEGTORAD) / 2);
+  }
+  for (ialt = 0; ialt < nalt; ialt++) {
+    AltO = dgrid[0] + ialt * dgrid[1];
+    idx = ialt * nazi;
+    if (AltO < 0) {
+      for (iazi = 0; iazi < nazi; iazi++, idx++) {
+	if (bgrid != NULL) bgrid[idx] = 0;
+	if (mgrid != NULL) mgrid[idx] = -100;
+      }
+      continue;
+    }
+    kX = Deltam(AltO, AltS, sunra, Lat, HeightEye, datm2, helflag, serr);
+    fX = 1 - pow(10, -0.4 * kX);
+    fT = Btwi_alt(AltO, AltS, sunra, Lat, HeightEye, datm2, helflag, serr);
+    Bnrow = Bn(AltO, tjdut, AltS, sunra, Lat, HeightEye, datm2, helflag, serr);
+    for (iazi = 0; iazi < nazi; iazi++, idx++) {
+      AziO = dgrid[2] + iazi * dgrid[3];
+      /* as in Bsky() */
+      sl2 = sin((AltS * DEGTORAD - AltO * DEGTORAD) / 2);
+      cc = cos(AltO * DEGTORAD) * cos(AltS * DEGTORAD);
+      corde = sl2 * sl2 + cc * sdlon[iazi] * sdlon[iazi];
+      if (corde > 1) corde = 1;
+      RS = 2 * asin(sqrt(corde)) / DEGTORAD;
+      if (AltS < -3) 
+	Bsk = Btwi_rs(RS, fT, fX);
+      else if (AltS > 4)
+	Bsk = Bday_rs(RS, C4, fX);
+      else
+	Bsk = mymin(Bday_rs(RS, C4, fX), Btwi_rs(RS, fT, fX));
+      if (Bsk < 200000000.0 && moon_up && !(AltO == AltM && AziO == AziM)) {
+	sl2 = sin((AltM * DEGTORAD - AltO * DEGTORAD) / 2);
+	cc = cos(AltO * DEGTORAD) * cos(AltM * DEGTORAD);
+	corde = sl2 * sl2 + cc * sdlon[nazi + iazi] * sdlon[nazi + iazi];
+	if (corde > 1) corde = 1;
+	RM = 2 * asin(sqrt(corde)) / DEGTORAD;
+	if (RM <= lunar_radius)
+	  RM = lunar_radius;
+	Bsk += Bm_rm(RM, C3, fM, fX);
+      }
+      if (AltS <= 0)
+	Bsk += Bcity(0, datm2[0]);
+      if (Bsk < 5000)
+	Bsk = Bsk + Bnrow;
+      if (bgrid != NULL)
+	bgrid[idx] = (float) Bsk;
+      if (mgrid != NULL)
+	mgrid[idx] = (float) VisLimMagn_b(dobs2, Bsk, kX, tjdut, helflag, NULL);
+    }
+  }
+  free(sdlon);
+  return OK;
+}
+
+/*###################################################################
+' Sky brightness and limiting magnitude in one direction over a 
+' period, e.g. at the zenith through a night.
+'
+' tjd_start	time of the first value (UT)
+' tstep		step [days]
+' nstep		number of values
+' dgeo, datm, dobs, helflag	as with swe_vis_limit_mag()
+' alt, azi	direction [deg], as in swe_sky_brightness_grid()
+' bret		nstep sky brightnesses [nL], or NULL
+' mret		nstep limiting magnitudes, or NULL
+*/
+int32 CALL_CONV swe_vis_limit_mag_series(double tjd_start, double tstep, int32 nstep, double *dgeo, double *datm, double *dobs, int32 helflag, double alt, double azi, float *bret, float *mret, char *serr)
+{
+  int32 i;
+  double dgrid[4], dret[4];
+  dgrid[0] = alt;
+  dgrid[1] = 0;
+  dgrid[2] = azi;
+  dgrid[3] = 0;
+  for (i = 0; i < nstep; i++) {
+    if (swe_sky_brightness_grid(tjd_start + i * tstep, dgeo, datm, dobs, helflag, dgrid, 1, 1, 
+	  (bret != NULL) ? bret + i : NULL, (mret != NULL) ? mret + i : NULL, dret, serr) == ERR)
+      return ERR;
+  }
+  return OK;
+}
+
 /*###################################################################
 ' Magn [-]
 ' age [Year]
@@ -2073,6 +2289,266 @@ output_heliacal_pheno:
   return OK;
 }
 
+/*###################################################################
+' Crescent visibility map (Yallop q-test) for a whole geographic grid.
+'
+' swe_heliacal_pheno_ut() recomputes Sun and Moon, the sunset and 
+' the moonset for every single site. For a world map this is far too
+' slow. Here, the geocentric positions of Sun and Moon are computed 
+' once on an hourly grid covering all local evenings of the day and
+' interpolated (Hermite, using the speeds); sidereal time is linear 
+' over the window. Sunset and moonset are found by hour angle 
+' iteration, starting from the result of the neighbouring column, 
+' which usually converges in one or two steps. q is computed at 
+' Yallop's best time Tb = Ts + 4/9 * lag, as in darr[15], darr[17].
+'
+' tjd_ut	0h UT of the date of the map; the evening of this 
+'		(local) date is used at every site
+' dgrid[0]	latitude of first row [deg]
+' dgrid[1]	latitude step between rows [deg]
+' dgrid[2]	longitude of first column [deg], east positive
+' dgrid[3]	longitude step between columns [deg]
+' dgrid[4]	height above sea [m]
+' dgrid[5]	time of conjunction (UT), or 0 to have it computed.
+'		Callers who split the map into bands of rows (e.g.
+'		one band per thread) can compute it once and pass it on.
+' nlat, nlon	number of rows and columns
+' helflag	ephemeris flag (SEFLG_SWIEPH etc.)
+' qgrid		nlat * nlon values of q, row by row; 0 where the
+'		class is undefined
+' cgrid		nlat * nlon visibility classes, row by row:
+'		1 .. 6 = Yallop A .. F, 0 = undefined (Sun or Moon do
+'		not set, or sunset is before the conjunction)
+' dret[0]	time of conjunction used (UT)
+' dret[1]	number of sites with a defined q
+*/
+#define CRESC_NSAMP	73	/* hourly samples over 3 days */
+#define CRESC_STEP	(1.0 / 24.0)
+#define CRESC_SIDRATE	360.98564736629	/* deg per day */
+#define CRESC_SUN_H0	(-0.8333)	/* upper limb with std. refraction */
+#define CRESC_REFR_H0	(-0.5667)	/* std. horizontal refraction */
+#define CRESC_EARTH_RAD_AU	(6378.137 / 149597870.7)
+
+struct cresc_ephe {
+  double tjd0;
+  double ra[CRESC_NSAMP], de[CRESC_NSAMP], dist[CRESC_NSAMP];
+  double dra[CRESC_NSAMP], dde[CRESC_NSAMP];
+};
+
+static int32 cresc_fill_ephe(double tjd0, int32 ipl, int32 iflag, struct cresc_ephe *pe, char *serr)
+{
+  int i;
+  double x[6];
+  pe->tjd0 = tjd0;
+  for (i = 0; i < CRESC_NSAMP; i++) {
+    if (swe_calc_ut(tjd0 + i * CRESC_STEP, ipl, iflag, x, serr) == ERR)
+      return ERR;
+    pe->ra[i] = x[0];
+    /* unwrap right ascension, so that it can be interpolated */
+    if (i > 0) {
+      while (pe->ra[i] - pe->ra[i-1] > 180) pe->ra[i] -= 360;
+      while (pe->ra[i] - pe->ra[i-1] < -180) pe->ra[i] += 360;
+    }
+    pe->de[i] = x[1];
+    pe->dist[i] = x[2];
+    pe->dra[i] = x[3];
+    pe->dde[i] = x[4];
+  }
+  return OK;
+}
+
+/* cubic Hermite interpolation of right ascension and declination, 
+ * linear interpolation of distance. Returns ra speed in deg/day. */
+static double cresc_interpol(struct cresc_ephe *pe, double tjd, double *ra, double *de, double *dist)
+{
+  int i;
+  double u, h = CRESC_STEP, h00, h10, h01, h11;
+  u = (tjd - pe->tjd0) / h;
+  i = (int) floor(u);
+  if (i < 0) i = 0;
+  if (i > CRESC_NSAMP - 2) i = CRESC_NSAMP - 2;
+  u -= i;
+  h00 = (1 + 2 * u) * (1 - u) * (1 - u);
+  h10 = u * (1 - u) * (1 - u);
+  h01 = u * u * (3 - 2 * u);
+  h11 = u * u * (u - 1);
+  *ra = h00 * pe->ra[i] + h10 * h * pe->dra[i] + h01 * pe->ra[i+1] + h11 * h * pe->dra[i+1];
+  *de = h00 * pe->de[i] + h10 * h * pe->dde[i] + h01 * pe->de[i+1] + h11 * h * pe->dde[i+1];
+  *dist = pe->dist[i] + u * (pe->dist[i+1] - pe->dist[i]);
+  return pe->dra[i] + u * (pe->dra[i+1] - pe->dra[i]);
+}
+
+/* topocentric hour angle and declination (Meeus, Astr. Alg., ch. 40);
+ * rcp = rho * cos(phi'), rsp = rho * sin(phi') */
+static void cresc_topo(double ha, double de, double dist, double rcp, double rsp, double *hat, double *det)
+{
+  double sinpi = CRESC_EARTH_RAD_AU / dist;
+  double cha = cos(ha * DEGTORAD), sha = sin(ha * DEGTORAD);
+  double cde = cos(de * DEGTORAD), sde = sin(de * DEGTORAD);
+  double a = cde - rcp * sinpi * cha;
+  double dra = atan2(-rcp * sinpi * sha, a);
+  *hat = ha - dra * RADTODEG;
+  *det = atan2((sde - rsp * sinpi) * cos(dra), a) * RADTODEG;
+}
+
+/* altitude and azimuth (from north, as in ObjectLoc()) */
+static void cresc_altaz(double ha, double de, double sinlat, double coslat, double *alt, double *azi)
+{
+  double cha = cos(ha * DEGTORAD), sha = sin(ha * DEGTORAD);
+  double cde = cos(de * DEGTORAD), sde = sin(de * DEGTORAD);
+  *alt = asin(sinlat * sde + coslat * cde * cha) * RADTODEG;
+  *azi = swe_degnorm(atan2(sha, cha * sinlat - sde / cde * coslat) * RADTODEG + 180);
+}
+
+/* time of setting near tjd, where the body's altitude is h0 
+ * (topocentric if is_topo). Returns ERR if the body does not set. */
+static int32 cresc_set_time(struct cresc_ephe *pe, double tjd, double gast0, double lon, double sinlat, double coslat, double rcp, double rsp, AS_BOOL is_topo, double h0, double *tset)
+{
+  int i;
+  double ra, de, dist, dradt, lst, ha, hat, cosh0, dt;
+  for (i = 0; i < 8; i++) {
+    dradt = cresc_interpol(pe, tjd, &ra, &de, &dist);
+    lst = gast0 + CRESC_SIDRATE * (tjd - pe->tjd0) + lon;
+    ha = lst - ra;
+    if (is_topo) {
+      cresc_topo(ha, de, dist, rcp, rsp, &hat, &de);
+      ha = hat;
+      /* the Moon's limb: semidiameter plus refraction */
+      h0 = CRESC_REFR_H0 - asin(0.2725076 * CRESC_EARTH_RAD_AU / dist) * RADTODEG;
+    }
+    cosh0 = (sin(h0 * DEGTORAD) - sinlat * sin(de * DEGTORAD)) / (coslat * cos(de * DEGTORAD));
+    if (cosh0 < -1 || cosh0 > 1) 
+      return ERR;
+    dt = swe_difdeg2n(acos(cosh0) * RADTODEG, ha) / (CRESC_SIDRATE - dradt);
+    tjd += dt;
+    if (fabs(dt) < 1e-5)
+      break;
+  }
+  if (tjd < pe->tjd0 || tjd > pe->tjd0 + (CRESC_NSAMP - 1) * CRESC_STEP)
+    return ERR;
+  *tset = tjd;
+  return OK;
+}
+
+int32 CALL_CONV swe_heliacal_crescent_grid(double tjd_ut, double *dgrid, int32 nlat, int32 nlon, int32 helflag, double *qgrid, int32 *cgrid, double *dret, char *serr)
+{
+  struct cresc_ephe *pesun, *pemoon;
+  int32 ilat, ilon, idx, ndef = 0, retval = OK;
+  int32 iflag = (helflag & (SEFLG_JPLEPH|SEFLG_SWIEPH|SEFLG_MOSEPH)) | SEFLG_SPEED;
+  double tjd0, tconj, gast0, x[6], xs[6], dlon;
+  double lat, lon, sinlat, coslat, u, rcp, rsp, ts, tm, tb, tguess;
+  double ra, de, dist, ha, hat, det;
+  double AltS, AziS, AltO, AziO, GeoAltO, AziGeo, ParO, ARCVact, WMoon, qYal;
+  if (nlat <= 0 || nlon <= 0) {
+    if (serr != NULL)
+      sprintf(serr, "swe_heliacal_crescent_grid: empty grid %d x %d", nlat, nlon);
+    return ERR;
+  }
+  if (dgrid[4] < SEI_ECL_GEOALT_MIN || dgrid[4] > SEI_ECL_GEOALT_MAX) {
+    if (serr != NULL)
+      sprintf(serr, "location for heliacal events must be between %.0f and %.0f m above sea", SEI_ECL_GEOALT_MIN, SEI_ECL_GEOALT_MAX);
+    return ERR;
+  }
+  swi_set_tid_acc(tjd_ut, helflag, 0, serr);
+  /* 
+   * conjunction preceding the evening, found once for all sites
+   */
+  tconj = dgrid[5];
+  if (tconj == 0) {
+    tconj = tjd_ut + 1;
+    for (idx = 0; idx < 20; idx++) {
+      if (swe_calc_ut(tconj, SE_SUN, iflag, xs, serr) == ERR
+	|| swe_calc_ut(tconj, SE_MOON, iflag, x, serr) == ERR)
+	return ERR;
+      u = swe_degnorm(x[0] - xs[0]);
+      if (idx > 0 && u > 180) u -= 360;
+      tconj -= u / (x[3] - xs[3]);
+      if (fabs(u) < 1e-6) 
+	break;
+    }
+  }
+  dret[0] = tconj;
+  /* 
+   * all local evenings of this date fall between 0h UT and 
+   * 2 days later; add some margin for moonset
+   */
+  tjd0 = tjd_ut - 0.25;
+  pesun = (struct cresc_ephe *) malloc(2 * sizeof(struct cresc_ephe));
+  if (pesun == NULL) {
+    if (serr != NULL)
+      strcpy(serr, "swe_heliacal_crescent_grid: out of memory");
+    return ERR;
+  }
+  pemoon = pesun + 1;
+  if (cresc_fill_ephe(tjd0, SE_SUN, iflag | SEFLG_EQUATORIAL, pesun, serr) == ERR
+    || cresc_fill_ephe(tjd0, SE_MOON, iflag | SEFLG_EQUATORIAL, pemoon, serr) == ERR) {
+    retval = ERR;
+    goto end_crescent_grid;
+  }
+  gast0 = swe_sidtime(tjd0) * 15;
+  for (ilat = 0; ilat < nlat; ilat++) {
+    lat = dgrid[0] + ilat * dgrid[1];
+    sinlat = sin(lat * DEGTORAD);
+    coslat = cos(lat * DEGTORAD);
+    /* geocentric position of observer, Meeus ch. 11 */
+    u = atan(Rb / Ra * tan(lat * DEGTORAD));
+    rsp = Rb / Ra * sin(u) + dgrid[4] / Ra * sinlat;
+    rcp = cos(u) + dgrid[4] / Ra * coslat;
+    tguess = 0;
+    for (ilon = 0; ilon < nlon; ilon++) {
+      idx = ilat * nlon + ilon;
+      qgrid[idx] = 0;
+      cgrid[idx] = 0;
+      lon = swe_degnorm(dgrid[2] + ilon * dgrid[3] + 180) - 180;
+      /* local noon of this date, plus 6 hours; or the sunset of the 
+       * previous column, shifted by the difference in longitude */
+      dlon = dgrid[3];
+      if (tguess == 0 || fabs(dlon) > 30)
+	tguess = tjd_ut + 0.75 - lon / 360.0;
+      else
+	tguess -= dlon / 360.0;
+      if (cresc_set_time(pesun, tguess, gast0, lon, sinlat, coslat, rcp, rsp, FALSE, CRESC_SUN_H0, &ts) == ERR) {
+	tguess = 0;
+	continue;
+      }
+      tguess = ts;
+      /* no crescent yet, q is undefined */
+      if (ts < tconj)
+	continue;
+      if (cresc_set_time(pemoon, ts, gast0, lon, sinlat, coslat, rcp, rsp, TRUE, 0, &tm) == ERR)
+	continue;
+      /* Yallop's best time; if the Moon sets first, evaluate at sunset */
+      tb = ts;
+      if (tm > ts)
+	tb = (ts * 5 + tm * 4) / 9.0;
+      cresc_interpol(pesun, tb, &ra, &de, &dist);
+      ha = gast0 + CRESC_SIDRATE * (tb - tjd0) + lon - ra;
+      cresc_altaz(ha, de, sinlat, coslat, &AltS, &AziS);
+      cresc_interpol(pemoon, tb, &ra, &de, &dist);
+      ha = gast0 + CRESC_SIDRATE * (tb - tjd0) + lon - ra;
+      cresc_altaz(ha, de, sinlat, coslat, &GeoAltO, &AziGeo);
+      cresc_topo(ha, de, dist, rcp, rsp, &hat, &det);
+      cresc_altaz(hat, det, sinlat, coslat, &AltO, &AziO);
+      ParO = GeoAltO - AltO;
+      ARCVact = GeoAltO - AltS;
+      WMoon = WidthMoon(AltO, AziO, AltS, AziS, ParO);
+      qYal = qYallop(WMoon, ARCVact);
+      qgrid[idx] = qYal;
+      ndef++;
+      if (tm <= ts || qYal < -0.293) cgrid[idx] = 6; /* F */
+      else if (qYal < -0.232) cgrid[idx] = 5; /* E */
+      else if (qYal < -0.16) cgrid[idx] = 4; /* D */
+      else if (qYal < -0.014) cgrid[idx] = 3; /* C */
+      else if (qYal < 0.216) cgrid[idx] = 2; /* B */
+      else cgrid[idx] = 1; /* A */
+    }
+  }
+  dret[1] = (double) ndef;
+end_crescent_grid:
+  free(pesun);
+  return retval;
+}
+
 #if 0
 int32 HeliacalJDut(double JDNDaysUTStart, double Age, double SN, double Lat, double Longitude, double HeightEye, double Temperature, double Pressure, double RH, double VR, char *ObjectName, int TypeEvent, char *AVkind, double *dret, char *serr)
 {
@@ -2459,7 +2935,7 @@ static int32 get_asc_obl(double tjd, int32 ipl, char *star, int32 iflag, double
   char star2[AS_MAXCH];
   strcpy(star2, star);
   if (ipl == -1) {
-    if ((retval = swe_fixstar(star2, tjd, epheflag | SEFLG_EQUATORIAL, x, serr)) == ERR)
+    if ((retval = swe_fixstar2(star2, tjd, epheflag | SEFLG_EQUATORIAL, x, serr)) == ERR)
       return ERR;
   } else {
     if ((retval = swe_calc(tjd, ipl, epheflag | SEFLG_EQUATORIAL, x, serr)) == ERR)
@@ -68,6 +68,7 @@ house and (simple) aspect calculation
 #define MILLIARCSEC 	(1.0 / 3600000.0)
 #define SOLAR_YEAR   365.24219893
 #define ARMCS ((SOLAR_YEAR+1) / SOLAR_YEAR * 360)
+#define SEFLG_EPHMASK	(SEFLG_JPLEPH|SEFLG_SWIEPH|SEFLG_MOSEPH)
 
 static double Asc1(double, double, double, double);
 static double AscDash(double, double, double, double);
@@ -3138,3 +3139,223 @@ static int sunshine_solution_treindl(double ramc, double lat, double ecl, struct
   }
   return retval;
 }
+
+/* primary directions
+ *
+ * Data of a promissor or significator that do not depend on the other
+ * body of a direction: equatorial position, hour angle and semi-arcs.
+ * They are computed once per body; the arcs are then evaluated for all
+ * combinations of promissors, aspects and significators without any
+ * further trigonometry on the significator side.
+ */
+struct pd_point {
+  double de;	/* declination */
+  double ha;	/* hour angle, -180..180, positive to the west */
+  double dsa;	/* diurnal semi-arc */
+  double nsa;	/* nocturnal semi-arc */
+  double m;	/* mundane position, 0 = upper meridian, 90 = western horizon */
+  AS_BOOL ok;	/* mundane position is defined */
+};
+
+static void pd_point_init(double lon, double lat, double armc, double geolat, double eps, int hsys, struct pd_point *p)
+{
+  double x[3], ad, hm, s;
+  x[0] = lon; x[1] = lat; x[2] = 1;
+  swe_cotrans(x, x, -eps);
+  p->de = x[1];
+  p->ha = swe_difdeg2n(armc, x[0]);
+  p->ok = TRUE;
+  ad = tand(geolat) * tand(p->de);
+  if (fabs(ad) >= 1) {	/* circumpolar, no semi-arcs */
+    p->dsa = p->nsa = 0;
+    if (hsys == 'P') {
+      p->ok = FALSE;
+      return;
+    }
+  } else {
+    p->dsa = 90 + asind(ad);
+    p->nsa = 180 - p->dsa;
+  }
+  if (hsys == 'P') {
+    /* proportion of the semi-arc */
+    if (fabs(p->ha) <= p->dsa)
+      p->m = p->ha / p->dsa * 90;
+    else
+      p->m = 180 + swe_difdeg2n(p->ha, 180) / p->nsa * 90;
+  } else {
+    /* Regiomontanus: position circle through the north and south points
+     * of the horizon; m is the hour angle of its intersection with the
+     * equator. hm is the hour angle of the circle's lowest point. */
+    hm = atan2d(-(tand(p->de) * tand(geolat) + cosd(p->ha)), sind(p->ha));
+    if (hm > 90) hm -= 180;
+    if (hm <= -90) hm += 180;
+    s = (swe_difdeg2n(p->ha, hm) >= 0) ? 1 : -1;
+    p->m = hm + s * 90;
+  }
+  p->m = swe_degnorm(p->m);
+}
+
+/* hour angle at which body p reaches mundane position m */
+static AS_BOOL pd_target_ha(double m, struct pd_point *p, double geolat, int hsys, double *ha)
+{
+  double hm, s, c;
+  m = swe_difdeg2n(m, 0);
+  if (hsys == 'P') {
+    if (!p->ok)
+      return FALSE;
+    if (fabs(m) <= 90)
+      *ha = m / 90 * p->dsa;
+    else
+      *ha = 180 + swe_difdeg2n(m, 180) / 90 * p->nsa;
+    return TRUE;
+  }
+  hm = m - 90;
+  if (hm <= -90) hm += 180;
+  s = (swe_difdeg2n(m, hm) >= 0) ? 1 : -1;
+  c = -tand(p->de) * tand(geolat) * cosd(hm);
+  if (fabs(c) > 1)
+    return FALSE;
+  *ha = hm + s * acosd(c);
+  return TRUE;
+}
+
+/* computes a table of primary directional arcs
+ *
+ * armc, geolat, eps  radix ARMC, geographic latitude, obliquity
+ * hsys		'P' Placidus (semi-arc proportions) or
+ *              'R' Regiomontanus (position circles)
+ * pdflag	SE_PD_MUNDANE: directions in mundo, with the promissors'
+ *              latitudes; aspects are taken in mundane position, i.e.
+ *              90 = three Placidus or Regiomontanus houses.
+ *              SE_PD_ZODIACAL: aspects are taken in the zodiac; the aspect
+ *              point of the promissor has latitude 0.
+ * xprom	npro promissors, ecliptic longitude and latitude (2 doubles each)
+ * xsig		nsig significators, ecliptic longitude and latitude
+ * dasp		nasp aspect angles, signed (e.g. 0, 60, -60, 90, -90, 180)
+ * darc		return array, npro * nasp * nsig arcs in degrees,
+ *              index (iprom * nasp + iasp) * nsig + isig;
+ *              positive = direct, negative = converse;
+ *              SE_PD_ARC_UNDEFINED if undefined (circumpolar bodies)
+ *
+ * returns the number of defined arcs, or ERR.
+ */
+int32 CALL_CONV swe_primary_directions(double armc, double geolat, double eps, int hsys, int32 pdflag, double *xprom, int32 npro, double *xsig, int32 nsig, double *dasp, int32 nasp, double *darc, char *serr)
+{
+  int32 ip, ia, is, narc = 0;
+  double ha, *darcp;
+  struct pd_point pp, *psig;
+  hsys = toupper(hsys);
+  if (hsys != 'P' && hsys != 'R') {
+    if (serr != NULL)
+      sprintf(serr, "swe_primary_directions(): house system %c not supported", hsys);
+    return ERR;
+  }
+  if (npro <= 0 || nsig <= 0 || nasp <= 0)
+    return 0;
+  psig = (struct pd_point *) malloc(nsig * sizeof(struct pd_point));
+  if (psig == NULL) {
+    if (serr != NULL)
+      strcpy(serr, "swe_primary_directions(): out of memory");
+    return ERR;
+  }
+  for (is = 0; is < nsig; is++)
+    pd_point_init(xsig[2 * is], xsig[2 * is + 1], armc, geolat, eps, hsys, &psig[is]);
+  for (ip = 0; ip < npro; ip++) {
+    if (pdflag & SE_PD_ZODIACAL) {
+      for (ia = 0; ia < nasp; ia++) {
+	pd_point_init(swe_degnorm(xprom[2 * ip] + dasp[ia]), 0, armc, geolat, eps, hsys, &pp);
+	darcp = darc + (ip * nasp + ia) * nsig;
+	for (is = 0; is < nsig; is++) {
+	  darcp[is] = SE_PD_ARC_UNDEFINED;
+	  if (!psig[is].ok || !pd_target_ha(psig[is].m, &pp, geolat, hsys, &ha))
+	    continue;
+	  darcp[is] = swe_difdeg2n(ha, pp.ha);
+	  narc++;
+	}
+      }
+    } else {
+      pd_point_init(xprom[2 * ip], xprom[2 * ip + 1], armc, geolat, eps, hsys, &pp);
+      for (ia = 0; ia < nasp; ia++) {
+	darcp = darc + (ip * nasp + ia) * nsig;
+	for (is = 0; is < nsig; is++) {
+	  darcp[is] = SE_PD_ARC_UNDEFINED;
+	  if (!psig[is].ok || !pd_target_ha(psig[is].m + dasp[ia], &pp, geolat, hsys, &ha))
+	    continue;
+	  darcp[is] = swe_difdeg2n(ha, pp.ha);
+	  narc++;
+	}
+      }
+    }
+  }
+  free(psig);
+  return narc;
+}
+
+/* converts directional arcs into dates
+ *
+ * tjd_ut	time of birth (UT)
+ * iflag	ephemeris flag, only needed for SE_PD_KEY_SOLAR_ARC
+ * key		SE_PD_KEY_PTOLEMY	1 degree = 1 year
+ *              SE_PD_KEY_NAIBOD	mean motion of the Sun in RA,
+ *              			0.98564733 degrees = 1 year
+ *              SE_PD_KEY_SOLAR_ARC	true solar arc: the arc equals the
+ *              			Sun's motion in right ascension
+ *              			during as many days after birth
+ *              			as years have passed
+ * darc		narc arcs; converse arcs are timed by their absolute value,
+ *              undefined arcs (SE_PD_ARC_UNDEFINED) return 0
+ * dtjd		return array, narc dates (UT)
+ */
+int32 CALL_CONV swe_primary_directions_dates(double tjd_ut, int32 iflag, int32 key, double *darc, int32 narc, double *dtjd, char *serr)
+{
+  int32 i, j, nday = 0;
+  double arc, arcmax = 0, x[6], ra0 = 0, *dra = NULL;
+  if (key == SE_PD_KEY_SOLAR_ARC) {
+    /* Sun's RA progression, one value per day after birth */
+    for (i = 0; i < narc; i++) {
+      if (darc[i] != SE_PD_ARC_UNDEFINED && fabs(darc[i]) > arcmax)
+	arcmax = fabs(darc[i]);
+    }
+    nday = (int32) (arcmax * 1.1) + 3;
+    dra = (double *) malloc(nday * sizeof(double));
+    if (dra == NULL) {
+      if (serr != NULL)
+	strcpy(serr, "swe_primary_directions_dates(): out of memory");
+      return ERR;
+    }
+    iflag = (iflag & SEFLG_EPHMASK) | SEFLG_EQUATORIAL;
+    for (j = 0; j < nday; j++) {
+      if (swe_calc_ut(tjd_ut + j, SE_SUN, iflag, x, serr) == ERR) {
+	free(dra);
+	return ERR;
+      }
+      if (j == 0)
+	ra0 = x[0];
+      dra[j] = swe_degnorm(x[0] - ra0);
+      if (j > 0 && dra[j] < dra[j - 1])
+	dra[j] += 360;
+    }
+  }
+  for (i = 0; i < narc; i++) {
+    dtjd[i] = 0;
+    if (darc[i] == SE_PD_ARC_UNDEFINED)
+      continue;
+    arc = fabs(darc[i]);
+    switch (key) {
+      case SE_PD_KEY_NAIBOD:
+	dtjd[i] = tjd_ut + arc / 0.98564733 * SOLAR_YEAR;
+	break;
+      case SE_PD_KEY_SOLAR_ARC:
+	for (j = 1; j < nday - 1 && dra[j] < arc; j++)
+	  ;
+	dtjd[i] = tjd_ut + (j - 1 + (arc - dra[j - 1]) / (dra[j] - dra[j - 1])) * SOLAR_YEAR;
+	break;
+      default:
+	dtjd[i] = tjd_ut + arc * SOLAR_YEAR;
+	break;
+    }
+  }
+  if (dra != NULL)
+    free(dra);
+  return OK;
+}
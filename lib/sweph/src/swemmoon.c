@@ -187,7 +187,7 @@ static void mean_elements_pl(void);
 static double mods3600(double x);
 static void ecldat_equ2000(double tjd, double *xpm);
 static void chewm(const short *pt, int nlines, int nangles, 
-  				     int typflg, double *ans );
+  				     int typflg, double *ans, double *vans );
 static void sscc(int k, double arg, int n );
 static void moon1(void);
 static void moon2(void);
@@ -842,8 +842,35 @@ static TLS double l2;
 static TLS double l3;
 static TLS double l4;
 
+/* Time derivatives of the above, per Julian century, so that
+ * the speed comes out of the same pass as the position:
+ * mean elements in arcsec, angle arguments in radians.
+ */
+static TLS double vang[4];	/* of the sscc() angles D, M, MP, NF */
+static TLS double vmoonpol[3];
+static TLS double vSWELP;
+static TLS double vM;
+static TLS double vMP;
+static TLS double vD;
+static TLS double vNF;
+static TLS double vf;
+static TLS double vg;
+static TLS double vVe;
+static TLS double vEa;
+static TLS double vMa;
+static TLS double vJu;
+static TLS double vSa;
+static TLS double vl;
+static TLS double vB;
+static TLS double vl1;
+static TLS double vl2;
+static TLS double vl3;
+static TLS double vl4;
+
 /* Calculate geometric coordinates of Moon
  * without light time or nutation correction.
+ * pol[0..2] polar ecliptic coordinates of date,
+ * pol[3..5] their time derivatives per day
  */
 int swi_moshmoon2(double J, double *pol)
 {
@@ -856,8 +883,10 @@ moon1();
 moon2();
 moon3();
 moon4();
-for( i=0; i<3; i++ ) 
+for( i=0; i<3; i++ ) {
   pol[i] = moonpol[i];
+  pol[i+3] = vmoonpol[i] / 36525.0;
+}
 return(0);
 }
 
@@ -869,7 +898,9 @@ return(0);
 int swi_moshmoon(double tjd, AS_BOOL do_save, double *xpmret, char *serr) 
 {
   int i;
+#ifdef MOSH_MOON_200
   double a, b, x1[6], x2[6], t;
+#endif
   double xx[6], *xpm;
   struct plan_data *pdp = &swed.pldat[SEI_MOON];
   char s[AS_MAXCH];
@@ -908,6 +939,7 @@ int swi_moshmoon(double tjd, AS_BOOL do_save, double *xpmret, char *serr)
    * Besides, this helps to keep the program structure simpler 
    */
   ecldat_equ2000(tjd, xpm);
+#ifdef MOSH_MOON_200
   /* speed */
   /* from 2 other positions. */
   /* one would be good enough for computation of osculating node, 
@@ -927,6 +959,7 @@ int swi_moshmoon(double tjd, AS_BOOL do_save, double *xpmret, char *serr)
     xpm[i+3] = (2 * a + b) / MOON_SPEED_INTV;
 #endif
   }
+#endif	/* MOSH_MOON_200 */
   if (xpmret != NULL)
     for (i = 0; i <= 5; i++)
       xpmret[i] = xpm[i];
@@ -948,8 +981,8 @@ moonpol[1] = 0.0;
 moonpol[2] = 0.0;
 
 /* terms in T^2, scale 1.0 = 10^-5" */
-chewm( LRT2, NLRT2, 4, 2, moonpol );
-chewm( BT2, NBT2, 4, 4, moonpol );
+chewm( LRT2, NLRT2, 4, 2, moonpol, NULL );
+chewm( BT2, NBT2, 4, 4, moonpol, NULL );
 
 f = 18 * Ve - 16 * Ea;
 
@@ -1086,8 +1119,8 @@ moonpol[2] *= T;
 
 /* terms in T */
 moonpol[0] = 0.0;
-chewm( BT, NBT, 4, 4, moonpol );
-chewm( LRT, NLRT, 4, 1, moonpol );
+chewm( BT, NBT, 4, 4, moonpol, NULL );
+chewm( LRT, NLRT, 4, 1, moonpol, NULL );
 g = STR*(f - MP - NF - 2355767.6); /* 18V - 16E - l - F */
 moonpol[1] +=  -1127. * sin(g);
 g = STR*(f - MP + NF - 235353.6); /* 18V - 16E - l + F */
@@ -1181,7 +1214,7 @@ moonpol[2] *= a;
 #else
 static void moon1()
 {
-double a;
+double a, va;
 /* This code added by Bhanu Pinnamaneni, 17-aug-2009 */
 /* Note by Dieter: Bhanu noted that ss and cc are not sufficiently
  * initialised and random values are used for the calculation.
@@ -1202,163 +1235,270 @@ sscc( 0, STR*D, 6 );
 sscc( 1, STR*M,  4 );
 sscc( 2, STR*MP, 4 );
 sscc( 3, STR*NF, 4 );
+vang[0] = STR*vD;
+vang[1] = STR*vM;
+vang[2] = STR*vMP;
+vang[3] = STR*vNF;
 moonpol[0] = 0.0;
 moonpol[1] = 0.0;
 moonpol[2] = 0.0;
+vmoonpol[0] = 0.0;
+vmoonpol[1] = 0.0;
+vmoonpol[2] = 0.0;
 /* terms in T^2, scale 1.0 = 10^-5" */
-chewm( LRT2, NLRT2, 4, 2, moonpol );
-chewm( BT2, NBT2, 4, 4, moonpol );
+chewm( LRT2, NLRT2, 4, 2, moonpol, vmoonpol );
+chewm( BT2, NBT2, 4, 4, moonpol, vmoonpol );
 f = 18 * Ve - 16 * Ea;
+vf = 18 * vVe - 16 * vEa;
 g = STR*(f - MP );  /* 18V - 16E - l */
+vg = STR*(vf - vMP );
 cg = cos(g);
 sg = sin(g);
 l = 6.367278 * cg + 12.747036 * sg;  /* t^0 */
+vl = (12.747036 * cg - 6.367278 * sg) * vg;
 l1 = 23123.70 * cg - 10570.02 * sg;  /* t^1 */
+vl1 = (-10570.02 * cg - 23123.70 * sg) * vg;
 l2 = z[12] * cg + z[13] * sg;        /* t^2 */
+vl2 = (z[13] * cg - z[12] * sg) * vg;
 moonpol[2] += 5.01 * cg + 2.72 * sg;
+vmoonpol[2] += (2.72 * cg - 5.01 * sg) * vg;
 g = STR * (10.*Ve - 3.*Ea - MP);
+vg = STR * (10.*vVe - 3.*vEa - vMP);
 cg = cos(g);
 sg = sin(g);
 l += -0.253102 * cg + 0.503359 * sg;
+vl += (0.503359 * cg + 0.253102 * sg) * vg;
 l1 += 1258.46 * cg + 707.29 * sg;
+vl1 += (707.29 * cg - 1258.46 * sg) * vg;
 l2 += z[14] * cg + z[15] * sg;
+vl2 += (z[15] * cg - z[14] * sg) * vg;
 g = STR*(8.*Ve - 13.*Ea);
+vg = STR*(8.*vVe - 13.*vEa);
 cg = cos(g);
 sg = sin(g);
 l += -0.187231 * cg - 0.127481 * sg;
+vl += (-0.127481 * cg + 0.187231 * sg) * vg;
 l1 += -319.87 * cg - 18.34 * sg;
+vl1 += (-18.34 * cg + 319.87 * sg) * vg;
 l2 += z[16] * cg + z[17] * sg;
+vl2 += (z[17] * cg - z[16] * sg) * vg;
 a = 4.0*Ea - 8.0*Ma + 3.0*Ju;
+va = 4.0*vEa - 8.0*vMa + 3.0*vJu;
 g = STR * a;
+vg = STR * va;
 cg = cos(g);
 sg = sin(g);
 l += -0.866287 * cg + 0.248192 * sg;
+vl += (0.248192 * cg + 0.866287 * sg) * vg;
 l1 += 41.87 * cg + 1053.97 * sg;
+vl1 += (1053.97 * cg - 41.87 * sg) * vg;
 l2 += z[18] * cg + z[19] * sg;
+vl2 += (z[19] * cg - z[18] * sg) * vg;
 g = STR*(a - MP);
+vg = STR*(va - vMP);
 cg = cos(g);
 sg = sin(g);
 l += -0.165009 * cg + 0.044176 * sg;
+vl += (0.044176 * cg + 0.165009 * sg) * vg;
 l1 += 4.67 * cg + 201.55 * sg;
+vl1 += (201.55 * cg - 4.67 * sg) * vg;
 g = STR*f;  /* 18V - 16E */
+vg = STR*vf;
 cg = cos(g);
 sg = sin(g);
 l += 0.330401 * cg + 0.661362 * sg;
+vl += (0.661362 * cg - 0.330401 * sg) * vg;
 l1 += 1202.67 * cg - 555.59 * sg;
+vl1 += (-555.59 * cg - 1202.67 * sg) * vg;
 l2 += z[20] * cg + z[21] * sg;
+vl2 += (z[21] * cg - z[20] * sg) * vg;
 g = STR*(f - 2.0*MP );  /* 18V - 16E - 2l */
+vg = STR*(vf - 2.0*vMP );
 cg = cos(g);
 sg = sin(g);
 l += 0.352185 * cg + 0.705041 * sg;
+vl += (0.705041 * cg - 0.352185 * sg) * vg;
 l1 += 1283.59 * cg - 586.43 * sg;
+vl1 += (-586.43 * cg - 1283.59 * sg) * vg;
 g = STR * (2.0*Ju - 5.0*Sa);
+vg = STR * (2.0*vJu - 5.0*vSa);
 cg = cos(g);
 sg = sin(g);
 l += -0.034700 * cg + 0.160041 * sg;
+vl += (0.160041 * cg + 0.034700 * sg) * vg;
 l2 += z[22] * cg + z[23] * sg;
+vl2 += (z[23] * cg - z[22] * sg) * vg;
 g = STR * (SWELP - NF);
+vg = STR * (vSWELP - vNF);
 cg = cos(g);
 sg = sin(g);
 l += 0.000116 * cg + 7.063040 * sg;
+vl += (7.063040 * cg - 0.000116 * sg) * vg;
 l1 +=  298.8 * sg;
+vl1 += 298.8 * cg * vg;
 /* T^3 terms */
 sg = sin( STR * M );
 /* l3 +=  z[24] * sg;			moshier! l3 not initialized! */
 l3 =  z[24] * sg;			
+vl3 = z[24] * cos( STR * M ) * STR * vM;
 l4 = 0;					
+vl4 = 0;
 g = STR * (2.0*D - M);
+vg = STR * (2.0*vD - vM);
 sg = sin(g);
 cg = cos(g);
 moonpol[2] +=  -0.2655 * cg * T;
+vmoonpol[2] += -0.2655 * (cg - sg * vg * T);
 g = STR * (M - MP);
+vg = STR * (vM - vMP);
 moonpol[2] +=  -0.1568 * cos( g ) * T;
+vmoonpol[2] += -0.1568 * (cos( g ) - sin( g ) * vg * T);
 g = STR * (M + MP);
+vg = STR * (vM + vMP);
 moonpol[2] +=  0.1309 * cos( g ) * T;
+vmoonpol[2] += 0.1309 * (cos( g ) - sin( g ) * vg * T);
 g = STR * (2.0*(D + M) - MP);
+vg = STR * (2.0*(vD + vM) - vMP);
 sg = sin(g);
 cg = cos(g);
 moonpol[2] +=   0.5568 * cg * T;
+vmoonpol[2] += 0.5568 * (cg - sg * vg * T);
 l2 += moonpol[0];
+vl2 += vmoonpol[0];
 g = STR*(2.0*D - M - MP);
+vg = STR*(2.0*vD - vM - vMP);
 moonpol[2] +=  -0.1910 * cos( g ) * T;
+vmoonpol[2] += -0.1910 * (cos( g ) - sin( g ) * vg * T);
+vmoonpol[1] = vmoonpol[1] * T + moonpol[1];
+vmoonpol[2] = vmoonpol[2] * T + moonpol[2];
 moonpol[1] *= T;
 moonpol[2] *= T;
 /* terms in T */
 moonpol[0] = 0.0;
-chewm( BT, NBT, 4, 4, moonpol );
-chewm( LRT, NLRT, 4, 1, moonpol );
+vmoonpol[0] = 0.0;
+chewm( BT, NBT, 4, 4, moonpol, vmoonpol );
+chewm( LRT, NLRT, 4, 1, moonpol, vmoonpol );
 g = STR*(f - MP - NF - 2355767.6); /* 18V - 16E - l - F */
+vg = STR*(vf - vMP - vNF);
 moonpol[1] +=  -1127. * sin(g);
+vmoonpol[1] += -1127. * cos(g) * vg;
 g = STR*(f - MP + NF - 235353.6); /* 18V - 16E - l + F */
+vg = STR*(vf - vMP + vNF);
 moonpol[1] +=  -1123. * sin(g);
+vmoonpol[1] += -1123. * cos(g) * vg;
 g = STR*(Ea + D + 51987.6);
+vg = STR*(vEa + vD);
 moonpol[1] +=  1303. * sin(g);
+vmoonpol[1] += 1303. * cos(g) * vg;
 g = STR*SWELP;
+vg = STR*vSWELP;
 moonpol[1] +=  342. * sin(g);
+vmoonpol[1] += 342. * cos(g) * vg;
 g = STR*(2.*Ve - 3.*Ea);
+vg = STR*(2.*vVe - 3.*vEa);
 cg = cos(g);
 sg = sin(g);
 l +=  -0.343550 * cg - 0.000276 * sg;
+vl += (-0.000276 * cg + 0.343550 * sg) * vg;
 l1 +=  105.90 * cg + 336.53 * sg;
+vl1 += (336.53 * cg - 105.90 * sg) * vg;
 g = STR*(f - 2.*D); /* 18V - 16E - 2D */
+vg = STR*(vf - 2.*vD);
 cg = cos(g);
 sg = sin(g);
 l += 0.074668 * cg + 0.149501 * sg;
+vl += (0.149501 * cg - 0.074668 * sg) * vg;
 l1 += 271.77 * cg - 124.20 * sg;
+vl1 += (-124.20 * cg - 271.77 * sg) * vg;
 g = STR*(f - 2.*D - MP);
+vg = STR*(vf - 2.*vD - vMP);
 cg = cos(g);
 sg = sin(g);
 l += 0.073444 * cg + 0.147094 * sg;
+vl += (0.147094 * cg - 0.073444 * sg) * vg;
 l1 += 265.24 * cg - 121.16 * sg;
+vl1 += (-121.16 * cg - 265.24 * sg) * vg;
 g = STR*(f + 2.*D - MP);
+vg = STR*(vf + 2.*vD - vMP);
 cg = cos(g);
 sg = sin(g);
 l += 0.072844 * cg + 0.145829 * sg;
+vl += (0.145829 * cg - 0.072844 * sg) * vg;
 l1 += 265.18 * cg - 121.29 * sg;
+vl1 += (-121.29 * cg - 265.18 * sg) * vg;
 g = STR*(f + 2.*(D - MP));
+vg = STR*(vf + 2.*(vD - vMP));
 cg = cos(g);
 sg = sin(g);
 l += 0.070201 * cg + 0.140542 * sg;
+vl += (0.140542 * cg - 0.070201 * sg) * vg;
 l1 += 255.36 * cg - 116.79 * sg;
+vl1 += (-116.79 * cg - 255.36 * sg) * vg;
 g = STR*(Ea + D - NF);
+vg = STR*(vEa + vD - vNF);
 cg = cos(g);
 sg = sin(g);
 l += 0.288209 * cg - 0.025901 * sg;
+vl += (-0.025901 * cg - 0.288209 * sg) * vg;
 l1 += -63.51 * cg - 240.14 * sg;
+vl1 += (-240.14 * cg + 63.51 * sg) * vg;
 g = STR*(2.*Ea - 3.*Ju + 2.*D - MP);
+vg = STR*(2.*vEa - 3.*vJu + 2.*vD - vMP);
 cg = cos(g);
 sg = sin(g);
 l += 0.077865 * cg + 0.438460 * sg;
+vl += (0.438460 * cg - 0.077865 * sg) * vg;
 l1 += 210.57 * cg + 124.84 * sg;
+vl1 += (124.84 * cg - 210.57 * sg) * vg;
 g = STR*(Ea - 2.*Ma);
+vg = STR*(vEa - 2.*vMa);
 cg = cos(g);
 sg = sin(g);
 l += -0.216579 * cg + 0.241702 * sg;
+vl += (0.241702 * cg + 0.216579 * sg) * vg;
 l1 += 197.67 * cg + 125.23 * sg;
+vl1 += (125.23 * cg - 197.67 * sg) * vg;
 g = STR*(a + MP);
+vg = STR*(va + vMP);
 cg = cos(g);
 sg = sin(g);
 l += -0.165009 * cg + 0.044176 * sg;
+vl += (0.044176 * cg + 0.165009 * sg) * vg;
 l1 += 4.67 * cg + 201.55 * sg;
+vl1 += (201.55 * cg - 4.67 * sg) * vg;
 g = STR*(a + 2.*D - MP);
+vg = STR*(va + 2.*vD - vMP);
 cg = cos(g);
 sg = sin(g);
 l += -0.133533 * cg + 0.041116 * sg;
+vl += (0.041116 * cg + 0.133533 * sg) * vg;
 l1 +=  6.95 * cg + 187.07 * sg;
+vl1 += (187.07 * cg - 6.95 * sg) * vg;
 g = STR*(a - 2.*D + MP);
+vg = STR*(va - 2.*vD + vMP);
 cg = cos(g);
 sg = sin(g);
 l += -0.133430 * cg + 0.041079 * sg;
+vl += (0.041079 * cg + 0.133430 * sg) * vg;
 l1 +=  6.28 * cg + 169.08 * sg;
+vl1 += (169.08 * cg - 6.28 * sg) * vg;
 g = STR*(3.*Ve - 4.*Ea);
+vg = STR*(3.*vVe - 4.*vEa);
 cg = cos(g);
 sg = sin(g);
 l += -0.175074 * cg + 0.003035 * sg;
+vl += (0.003035 * cg + 0.175074 * sg) * vg;
 l1 +=  49.17 * cg + 150.57 * sg;
+vl1 += (150.57 * cg - 49.17 * sg) * vg;
 g = STR*(2.*(Ea + D - MP) - 3.*Ju + 213534.);
+vg = STR*(2.*(vEa + vD - vMP) - 3.*vJu);
 l1 +=  158.4 * sin(g);
+vl1 += 158.4 * cos(g) * vg;
 l1 += moonpol[0];
+vl1 += vmoonpol[0];
 a = 0.1 * T; /* set amplitude scale of 1.0 = 10^-4 arcsec */
+vmoonpol[1] = vmoonpol[1] * a + 0.1 * moonpol[1];
+vmoonpol[2] = vmoonpol[2] * a + 0.1 * moonpol[2];
 moonpol[1] *= a;
 moonpol[2] *= a;
 }
@@ -1368,89 +1508,167 @@ static void moon2()
 {
 /* terms in T^0 */
 g = STR*(2*(Ea-Ju+D)-MP+648431.172);
+vg = STR*(2*(vEa-vJu+vD)-vMP);
 l += 1.14307 * sin(g);
+vl += 1.14307 * cos(g) * vg;
 g = STR*(Ve-Ea+648035.568);
+vg = STR*(vVe-vEa);
 l += 0.82155 * sin(g);
+vl += 0.82155 * cos(g) * vg;
 g = STR*(3*(Ve-Ea)+2*D-MP+647933.184);
+vg = STR*(3*(vVe-vEa)+2*vD-vMP);
 l += 0.64371 * sin(g);
+vl += 0.64371 * cos(g) * vg;
 g = STR*(Ea-Ju+4424.04);
+vg = STR*(vEa-vJu);
 l += 0.63880 * sin(g);
+vl += 0.63880 * cos(g) * vg;
 g = STR*(SWELP + MP - NF + 4.68);
+vg = STR*(vSWELP + vMP - vNF);
 l += 0.49331 * sin(g);
+vl += 0.49331 * cos(g) * vg;
 g = STR*(SWELP - MP - NF + 4.68);
+vg = STR*(vSWELP - vMP - vNF);
 l += 0.4914 * sin(g);
+vl += 0.4914 * cos(g) * vg;
 g = STR*(SWELP+NF+2.52);
+vg = STR*(vSWELP+vNF);
 l += 0.36061 * sin(g);
+vl += 0.36061 * cos(g) * vg;
 g = STR*(2.*Ve - 2.*Ea + 736.2);
+vg = STR*(2.*vVe - 2.*vEa);
 l += 0.30154 * sin(g);
+vl += 0.30154 * cos(g) * vg;
 g = STR*(2.*Ea - 3.*Ju + 2.*D - 2.*MP + 36138.2);
+vg = STR*(2.*vEa - 3.*vJu + 2.*vD - 2.*vMP);
 l += 0.28282 * sin(g);
+vl += 0.28282 * cos(g) * vg;
 g = STR*(2.*Ea - 2.*Ju + 2.*D - 2.*MP + 311.0);
+vg = STR*(2.*vEa - 2.*vJu + 2.*vD - 2.*vMP);
 l += 0.24516 * sin(g);
+vl += 0.24516 * cos(g) * vg;
 g = STR*(Ea - Ju - 2.*D + MP + 6275.88);
+vg = STR*(vEa - vJu - 2.*vD + vMP);
 l += 0.21117 * sin(g);
+vl += 0.21117 * cos(g) * vg;
 g = STR*(2.*(Ea - Ma) - 846.36);
+vg = STR*(2.*(vEa - vMa));
 l += 0.19444 * sin(g);
+vl += 0.19444 * cos(g) * vg;
 g = STR*(2.*(Ea - Ju) + 1569.96);
+vg = STR*(2.*(vEa - vJu));
 l -= 0.18457 * sin(g);
+vl -= 0.18457 * cos(g) * vg;
 g = STR*(2.*(Ea - Ju) - MP - 55.8);
+vg = STR*(2.*(vEa - vJu) - vMP);
 l += 0.18256 * sin(g);
+vl += 0.18256 * cos(g) * vg;
 g = STR*(Ea - Ju - 2.*D + 6490.08);
+vg = STR*(vEa - vJu - 2.*vD);
 l += 0.16499 * sin(g);
+vl += 0.16499 * cos(g) * vg;
 g = STR*(Ea - 2.*Ju - 212378.4);
+vg = STR*(vEa - 2.*vJu);
 l += 0.16427 * sin(g);
+vl += 0.16427 * cos(g) * vg;
 g = STR*(2.*(Ve - Ea - D) + MP + 1122.48);
+vg = STR*(2.*(vVe - vEa - vD) + vMP);
 l += 0.16088 * sin(g);
+vl += 0.16088 * cos(g) * vg;
 g = STR*(Ve - Ea - MP + 32.04);
+vg = STR*(vVe - vEa - vMP);
 l -= 0.15350 * sin(g);
+vl -= 0.15350 * cos(g) * vg;
 g = STR*(Ea - Ju - MP + 4488.88);
+vg = STR*(vEa - vJu - vMP);
 l += 0.14346 * sin(g);
+vl += 0.14346 * cos(g) * vg;
 g = STR*(2.*(Ve - Ea + D) - MP - 8.64);
+vg = STR*(2.*(vVe - vEa + vD) - vMP);
 l += 0.13594 * sin(g);
+vl += 0.13594 * cos(g) * vg;
 g = STR*(2.*(Ve - Ea - D) + 1319.76);
+vg = STR*(2.*(vVe - vEa - vD));
 l += 0.13432 * sin(g);
+vl += 0.13432 * cos(g) * vg;
 g = STR*(Ve - Ea - 2.*D + MP - 56.16);
+vg = STR*(vVe - vEa - 2.*vD + vMP);
 l -= 0.13122 * sin(g);
+vl -= 0.13122 * cos(g) * vg;
 g = STR*(Ve - Ea + MP + 54.36);
+vg = STR*(vVe - vEa + vMP);
 l -= 0.12722 * sin(g);
+vl -= 0.12722 * cos(g) * vg;
 g = STR*(3.*(Ve - Ea) - MP + 433.8);
+vg = STR*(3.*(vVe - vEa) - vMP);
 l += 0.12539 * sin(g);
+vl += 0.12539 * cos(g) * vg;
 g = STR*(Ea - Ju + MP + 4002.12);
+vg = STR*(vEa - vJu + vMP);
 l += 0.10994 * sin(g);
+vl += 0.10994 * cos(g) * vg;
 g = STR*(20.*Ve - 21.*Ea - 2.*D + MP - 317511.72);
+vg = STR*(20.*vVe - 21.*vEa - 2.*vD + vMP);
 l += 0.10652 * sin(g);
+vl += 0.10652 * cos(g) * vg;
 g = STR*(26.*Ve - 29.*Ea - MP + 270002.52);
+vg = STR*(26.*vVe - 29.*vEa - vMP);
 l += 0.10490 * sin(g);
+vl += 0.10490 * cos(g) * vg;
 g = STR*(3.*Ve - 4.*Ea + D - MP - 322765.56);
+vg = STR*(3.*vVe - 4.*vEa + vD - vMP);
 l += 0.10386 * sin(g);
+vl += 0.10386 * cos(g) * vg;
 g = STR*(SWELP+648002.556);
+vg = STR*vSWELP;
 B =  8.04508 * sin(g);
+vB = 8.04508 * cos(g) * vg;
 g = STR*(Ea+D+996048.252);
+vg = STR*(vEa+vD);
 B += 1.51021 * sin(g);
+vB += 1.51021 * cos(g) * vg;
 g = STR*(f - MP + NF + 95554.332);
+vg = STR*(vf - vMP + vNF);
 B += 0.63037 * sin(g);
+vB += 0.63037 * cos(g) * vg;
 g = STR*(f - MP - NF + 95553.792);
+vg = STR*(vf - vMP - vNF);
 B += 0.63014 * sin(g);
+vB += 0.63014 * cos(g) * vg;
 g = STR*(SWELP - MP + 2.9);
+vg = STR*(vSWELP - vMP);
 B +=  0.45587 * sin(g);
+vB += 0.45587 * cos(g) * vg;
 g = STR*(SWELP + MP + 2.5);
+vg = STR*(vSWELP + vMP);
 B +=  -0.41573 * sin(g);
+vB += -0.41573 * cos(g) * vg;
 g = STR*(SWELP - 2.0*NF + 3.2);
+vg = STR*(vSWELP - 2.0*vNF);
 B +=  0.32623 * sin(g);
+vB += 0.32623 * cos(g) * vg;
 g = STR*(SWELP - 2.0*D + 2.5);
+vg = STR*(vSWELP - 2.0*vD);
 B +=  0.29855 * sin(g);
+vB += 0.29855 * cos(g) * vg;
 }
 
 static void moon3()
 {
 /* terms in T^0 */
 moonpol[0] = 0.0;
-chewm( LR, NLR, 4, 1, moonpol );
-chewm( MB, NMB, 4, 3, moonpol );
+vmoonpol[0] = 0.0;
+chewm( LR, NLR, 4, 1, moonpol, vmoonpol );
+chewm( MB, NMB, 4, 3, moonpol, vmoonpol );
+vl += ((((vl4 * T + vl3) * T + vl2) * T + vl1) * T
+  + ((4 * l4 * T + 3 * l3) * T + 2 * l2) * T + l1) * 1.0e-5;
 l += (((l4 * T + l3) * T + l2) * T + l1) * T * 1.0e-5;
 moonpol[0] = SWELP + l + 1.0e-4 * moonpol[0];
 moonpol[1] = 1.0e-4 * moonpol[1] + B;
 moonpol[2] = 1.0e-4 * moonpol[2] + 385000.52899; /* kilometers */
+vmoonpol[0] = vSWELP + vl + 1.0e-4 * vmoonpol[0];
+vmoonpol[1] = 1.0e-4 * vmoonpol[1] + vB;
+vmoonpol[2] = 1.0e-4 * vmoonpol[2];
 }
 
 /* Compute final ecliptic polar coordinates
@@ -1461,6 +1679,9 @@ moonpol[2] /= AUNIT / 1000;
 moonpol[0] = STR * mods3600( moonpol[0] );
 moonpol[1] = STR * moonpol[1];
 B = moonpol[1];
+vmoonpol[2] /= AUNIT / 1000;
+vmoonpol[0] *= STR;
+vmoonpol[1] *= STR;
 }
 
 #define CORR_MNODE_JD_T0GREG  -3063616.5   /* 1 jan -13100 greg. */
@@ -1623,16 +1844,19 @@ int swi_mean_apog(double J, double *pol, char *serr)
   return OK;
 }
 
-/* Program to step through the perturbation table
+/* Program to step through the perturbation table.
+ * If vans != NULL, the time derivatives of the terms are summed
+ * into it, with the angle rates from vang[].
  */
-static void chewm(const short *pt, int nlines, int nangles, int typflg, double *ans )
+static void chewm(const short *pt, int nlines, int nangles, int typflg, double *ans, double *vans )
 {
   int i, j, k, k1, m;
-  double cu, su, cv, sv, ff;
+  double cu, su, cv, sv, ff, w;
   for( i=0; i<nlines; i++ ) {
     k1 = 0;
     sv = 0.0;
     cv = 0.0;
+    w = 0.0;
     for( m=0; m<nangles; m++ ) {
       j = *pt++; /* multiple angle factor */
       if( j ) {
@@ -1642,6 +1866,7 @@ static void chewm(const short *pt, int nlines, int nangles, int typflg, double *
 	su = ss[m][k-1];
 	cu = cc[m][k-1];
 	if( j < 0 ) su = -su; /* negative angle factor */
+	w += j * vang[m];
 	if( k1 == 0 ) {
 	  /* Set sin, cos of first angle. */
 	  sv = su;
@@ -1664,9 +1889,11 @@ static void chewm(const short *pt, int nlines, int nangles, int typflg, double *
       j = *pt++;
       k = *pt++;
       ans[0] += (10000.0 * j  + k) * sv;
+      if( vans != NULL ) vans[0] += (10000.0 * j  + k) * cv * w;
       j = *pt++;
       k = *pt++;
       if( k ) ans[2] += (10000.0 * j  + k) * cv;
+      if( k && vans != NULL ) vans[2] -= (10000.0 * j  + k) * sv * w;
       break;
     /* longitude and radius */
     case 2:
@@ -1674,17 +1901,23 @@ static void chewm(const short *pt, int nlines, int nangles, int typflg, double *
       k = *pt++;
       ans[0] += j * sv;
       ans[2] += k * cv;
+      if( vans != NULL ) {
+	vans[0] += j * cv * w;
+	vans[2] -= k * sv * w;
+      }
       break;
     /* large latitude */
     case 3:
       j = *pt++;
       k = *pt++;
       ans[1] += ( 10000.0*j + k)*sv;
+      if( vans != NULL ) vans[1] += ( 10000.0*j + k)*cv * w;
       break;
     /* latitude */
     case 4:
       j = *pt++;
       ans[1] += j * sv;
+      if( vans != NULL ) vans[1] += j * cv * w;
       break;
     }
   }
@@ -1717,15 +1950,17 @@ static void sscc(int k, double arg, int n )
 /* converts from polar coordinates of ecliptic of date
  *          to   cartesian coordinates of equator 2000
  * tjd		date
- * x 		array of position
+ * x 		array of position and speed
  */
 static void ecldat_equ2000(double tjd, double *xpm) {
   /* cartesian */
-  swi_polcart(xpm, xpm);
+  swi_polcart_sp(xpm, xpm);
   /* equatorial */
   swi_coortrf2(xpm, xpm, -swed.oec.seps, swed.oec.ceps);
+  swi_coortrf2(xpm+3, xpm+3, -swed.oec.seps, swed.oec.ceps);
   /* j2000 */
   swi_precess(xpm, tjd, 0, J_TO_J2000);/**/
+  swi_precess_speed(xpm, tjd, 0, J_TO_J2000);
 }
 
 /* Reduce arc seconds modulo 360 degrees
@@ -1776,6 +2011,16 @@ M += ((((((((
 - 1.1297037031e-5 ) * T
 + 1.4732069041e-4 ) * T
 - 0.552891801772 ) * T2;
+vM = 129596581.038354 + ((((((((
+  10 * 1.62e-20 * T
+- 9 * 1.0390e-17 ) * T
+- 8 * 3.83508e-15 ) * T
++ 7 * 4.237343e-13 ) * T
++ 6 * 8.8555011e-11 ) * T
+- 5 * 4.77258489e-8 ) * T
+- 4 * 1.1297037031e-5 ) * T
++ 3 * 1.4732069041e-4 ) * T
+- 2 * 0.552891801772 ) * T;
 #ifdef MOSH_MOON_200
 /* Mean distance of moon from its ascending node = F */
 NF = mods3600( 1739527263.0983 * T + 335779.55755 );
@@ -1808,6 +2053,11 @@ NF += ((z[2]*T + z[1])*T + z[0])*T2;
 MP += ((z[5]*T + z[4])*T + z[3])*T2;
 D  += ((z[8]*T + z[7])*T + z[6])*T2;
 SWELP += ((z[11]*T + z[10])*T + z[9])*T2;
+/* rates, arcsec per century */
+vNF = 1739527263.0983 - 2.079419901760e-01 + ((4*z[2]*T + 3*z[1])*T + 2*z[0])*T;
+vMP = 1717915923.4728 - 2.035946368532e-01 + ((4*z[5]*T + 3*z[4])*T + 2*z[3])*T;
+vD = 1602961601.4603 + 3.962893294503e-01 + ((4*z[8]*T + 3*z[7])*T + 2*z[6])*T;
+vSWELP = 1732564372.83264 - 6.784914260953e-01 + ((4*z[11]*T + 3*z[10])*T + 2*z[9])*T;
 #endif	/* ! MOSH_MOON_200 */
 /* sensitivity of mean elements
  *    delta argument = scale factor times delta amplitude (arcsec)
@@ -1831,6 +2081,16 @@ Ve += ((((((((
  - 2.26602516e-9 ) * T
  - 1.4244812531e-5 ) * T
  + 0.005871373088 ) * T2;
+vVe = 210664136.4335482 + ((((((((
+  -10 * 9.36e-023 * T
+ - 9 * 1.95e-20 ) * T
+ + 8 * 6.097e-18 ) * T
+ + 7 * 4.43201e-15 ) * T
+ + 6 * 2.509418e-13 ) * T
+ - 5 * 3.0622898e-10 ) * T
+ - 4 * 2.26602516e-9 ) * T
+ - 3 * 1.4244812531e-5 ) * T
+ + 2 * 0.005871373088 ) * T;
 Ea = mods3600( 129597742.26669231  * T +  361679.214649 );
 Ea += (((((((( -1.16e-22 * T
  + 2.976e-19 ) * T
@@ -1841,12 +2101,24 @@ Ea += (((((((( -1.16e-22 * T
  + 1.515912254e-7 ) * T
  + 8.863982531e-6 ) * T
  - 2.0199859001e-2 ) * T2;
+vEa = 129597742.26669231 + (((((((( -10 * 1.16e-22 * T
+ + 9 * 2.976e-19 ) * T
+ + 8 * 2.8460e-17 ) * T
+ - 7 * 1.08402e-14 ) * T
+ - 6 * 1.226182e-12 ) * T
+ + 5 * 1.7228268e-10 ) * T
+ + 4 * 1.515912254e-7 ) * T
+ + 3 * 8.863982531e-6 ) * T
+ - 2 * 2.0199859001e-2 ) * T;
 Ma = mods3600(  68905077.59284 * T + 1279559.78866 );
 Ma += (-1.043e-5*T + 9.38012e-3)*T2;
+vMa = 68905077.59284 + (-3 * 1.043e-5*T + 2 * 9.38012e-3)*T;
 Ju = mods3600( 10925660.428608 * T +  123665.342120 );
 Ju += (1.543273e-5*T - 3.06037836351e-1)*T2;
+vJu = 10925660.428608 + (3 * 1.543273e-5*T - 2 * 3.06037836351e-1)*T;
 Sa = mods3600( 4399609.65932 * T + 180278.89694 );
 Sa += (( 4.475946e-8*T - 6.874806E-5 ) * T + 7.56161437443E-1)*T2;
+vSa = 4399609.65932 + (( 4 * 4.475946e-8*T - 3 * 6.874806E-5 ) * T + 2 * 7.56161437443E-1)*T;
 }
 
 /* Calculate geometric coordinates of true interpolated Moon apsides
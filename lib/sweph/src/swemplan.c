@@ -131,6 +131,11 @@ static TLS double cc[9][24];
 
 static void sscc (int k, double arg, int n);
 
+/* Heliocentric polar ecliptic coordinates of equinox J2000 and their
+ * time derivatives (radians and au per day) in pobj[0..5].
+ * The speeds are summed from the same terms as the positions,
+ * with dA/dT = sum of harmonic * frequency for each argument A.
+ */
 int swi_moshplan2 (double J, int iplm, double *pobj)
 {
   int i, j, k, m, k1, ip, np, nt;
@@ -138,6 +143,7 @@ int swi_moshplan2 (double J, int iplm, double *pobj)
   double *pl, *pb, *pr;
   double su, cu, sv, cv, T;
   double t, sl, sb, sr;
+  double dsu, dcu, w, dsl, dsb, dsr;
   const struct plantbl *plan = planets[iplm];
 
   T = (J - J2000) / TIMESCALE;
@@ -160,6 +166,9 @@ int swi_moshplan2 (double J, int iplm, double *pobj)
   sl = 0.0;
   sb = 0.0;
   sr = 0.0;
+  dsl = 0.0;
+  dsb = 0.0;
+  dsr = 0.0;
 
   for (;;)
     {
@@ -173,30 +182,40 @@ int swi_moshplan2 (double J, int iplm, double *pobj)
 	  nt = *p++;
 	  /* Longitude polynomial. */
 	  cu = *pl++;
+	  dcu = 0.0;
 	  for (ip = 0; ip < nt; ip++)
 	    {
+	      dcu = dcu * T + cu;
 	      cu = cu * T + *pl++;
 	    }
 	  sl +=  mods3600 (cu);
+	  dsl += dcu;
 	  /* Latitude polynomial. */
 	  cu = *pb++;
+	  dcu = 0.0;
 	  for (ip = 0; ip < nt; ip++)
 	    {
+	      dcu = dcu * T + cu;
 	      cu = cu * T + *pb++;
 	    }
 	  sb += cu;
+	  dsb += dcu;
 	  /* Radius polynomial. */
 	  cu = *pr++;
+	  dcu = 0.0;
 	  for (ip = 0; ip < nt; ip++)
 	    {
+	      dcu = dcu * T + cu;
 	      cu = cu * T + *pr++;
 	    }
 	  sr += cu;
+	  dsr += dcu;
 	  continue;
 	}
       k1 = 0;
       cv = 0.0;
       sv = 0.0;
+      w = 0.0;
       for (ip = 0; ip < np; ip++)
 	{
 	  /* What harmonic.  */
@@ -213,6 +232,7 @@ int swi_moshplan2 (double J, int iplm, double *pobj)
 	      if (j < 0)
 		su = -su;
 	      cu = cc[m][k];
+	      w += j * freqs[m];
 	      if (k1 == 0)
 		{		/* set first angle */
 		  sv = su;
@@ -229,37 +249,56 @@ int swi_moshplan2 (double J, int iplm, double *pobj)
 	}
       /* Highest power of T.  */
       nt = *p++;
+      w *= STR;
       /* Longitude. */
       cu = *pl++;
       su = *pl++;
+      dcu = 0.0;
+      dsu = 0.0;
       for (ip = 0; ip < nt; ip++)
 	{
+	  dcu = dcu * T + cu;
+	  dsu = dsu * T + su;
 	  cu = cu * T + *pl++;
 	  su = su * T + *pl++;
 	}
       sl += cu * cv + su * sv;
+      dsl += dcu * cv + dsu * sv + w * (su * cv - cu * sv);
       /* Latitiude. */
       cu = *pb++;
       su = *pb++;
+      dcu = 0.0;
+      dsu = 0.0;
       for (ip = 0; ip < nt; ip++)
 	{
+	  dcu = dcu * T + cu;
+	  dsu = dsu * T + su;
 	  cu = cu * T + *pb++;
 	  su = su * T + *pb++;
 	}
       sb += cu * cv + su * sv;
+      dsb += dcu * cv + dsu * sv + w * (su * cv - cu * sv);
       /* Radius. */
       cu = *pr++;
       su = *pr++;
+      dcu = 0.0;
+      dsu = 0.0;
       for (ip = 0; ip < nt; ip++)
 	{
+	  dcu = dcu * T + cu;
+	  dsu = dsu * T + su;
 	  cu = cu * T + *pr++;
 	  su = su * T + *pr++;
 	}
       sr += cu * cv + su * sv;
+      dsr += dcu * cv + dsu * sv + w * (su * cv - cu * sv);
     }
   pobj[0] = STR * sl;
   pobj[1] = STR * sb;
   pobj[2] = STR * plan->distance * sr + plan->distance;
+  pobj[3] = STR * dsl / TIMESCALE;
+  pobj[4] = STR * dsb / TIMESCALE;
+  pobj[5] = STR * plan->distance * dsr / TIMESCALE;
   return OK;
 }
 
@@ -277,9 +316,8 @@ int swi_moshplan(double tjd, int ipli, AS_BOOL do_save, double *xpret, double *x
 {
   int i;
   int do_earth = FALSE;
-  double dx[3], x2[3], xxe[6], xxp[6];
+  double xxe[6], xxp[6];
   double *xp, *xe;
-  double dt; 
   char s[AS_MAXCH];
   int iplm = pnoint2msh[ipli];
   struct plan_data *pdp = &swed.pldat[ipli];
@@ -311,27 +349,17 @@ int swi_moshplan(double tjd, int ipli, AS_BOOL do_save, double *xpret, double *x
 	  && pedp->iephe == SEFLG_MOSEPH) {
       xe = pedp->x;
     } else {
-      /* emb */
+      /* emb, with speed */
       swi_moshplan2(tjd, pnoint2msh[SEI_EMB], xe); /* emb hel. ecl. 2000 polar */ 
-      swi_polcart(xe, xe);			  /* to cartesian */
+      swi_polcart_sp(xe, xe);			  /* to cartesian */
       swi_coortrf2(xe, xe, -seps2000, ceps2000);/* and equator 2000 */
+      swi_coortrf2(xe+3, xe+3, -seps2000, ceps2000);
       embofs_mosh(tjd, xe);		  /* emb -> earth */
       if (do_save) {
 	pedp->teval = tjd;		  
 	pedp->xflgs = -1;
 	pedp->iephe = SEFLG_MOSEPH;
       }
-      /* one more position for speed. */
-      swi_moshplan2(tjd - PLAN_SPEED_INTV, pnoint2msh[SEI_EMB], x2); 
-      swi_polcart(x2, x2);
-      swi_coortrf2(x2, x2, -seps2000, ceps2000);
-      embofs_mosh(tjd - PLAN_SPEED_INTV, x2);/**/
-      for (i = 0; i <= 2; i++) 
-	dx[i] = (xe[i] - x2[i]) / PLAN_SPEED_INTV;
-      /* store speed */
-      for (i = 0; i <= 2; i++) {
-	xe[i+3] = dx[i];
-      }
     }
     if (xeret != NULL)
       for (i = 0; i <= 5; i++) 
@@ -347,31 +375,14 @@ int swi_moshplan(double tjd, int ipli, AS_BOOL do_save, double *xpret, double *x
       xp = pdp->x;
     } else { 
       swi_moshplan2(tjd, iplm, xp); 
-      swi_polcart(xp, xp);
+      swi_polcart_sp(xp, xp);
       swi_coortrf2(xp, xp, -seps2000, ceps2000);
+      swi_coortrf2(xp+3, xp+3, -seps2000, ceps2000);
       if (do_save) {
 	pdp->teval = tjd;/**/
 	pdp->xflgs = -1;
 	pdp->iephe = SEFLG_MOSEPH;
       }
-      /* one more position for speed. 
-       * the following dt gives good speed for light-time correction
-       */
-    #if 0
-      for (i = 0; i <= 2; i++) 
-	dx[i] = xp[i] - pedp->x[i];
-      dt = LIGHTTIME_AUNIT * sqrt(square_sum(dx));   
-    #endif
-      dt = PLAN_SPEED_INTV;
-      swi_moshplan2(tjd - dt, iplm, x2); 
-      swi_polcart(x2, x2);
-      swi_coortrf2(x2, x2, -seps2000, ceps2000);
-      for (i = 0; i <= 2; i++) 
-	dx[i] = (xp[i] - x2[i]) / dt;
-      /* store speed */
-      for (i = 0; i <= 2; i++) {
-	xp[i+3] = dx[i];
-      }
     }
     if (xpret != NULL)
       for (i = 0; i <= 5; i++)
@@ -408,7 +419,7 @@ static void sscc (int k, double arg, int n)
 }
 
 
-/* Adjust position from Earth-Moon barycenter to Earth
+/* Adjust position and speed from Earth-Moon barycenter to Earth
  *
  * J = Julian day number
  * xemb = rectangular equatorial coordinates of Earth
@@ -418,15 +429,18 @@ static void embofs_mosh(double tjd, double *xemb)
   double T, M, a, L, B, p;
   double smp, cmp, s2mp, c2mp, s2d, c2d, sf, cf;
   double s2f, sx, cx, xyz[6];
+  double dmp, dd, df, dL, dB, dp;
   double seps = swed.oec.seps;
   double ceps = swed.oec.ceps;
   int i;
   /* Short series for position of the Moon
+   * (argument rates dmp, dd, df in radians per century)
    */
   T = (tjd-J1900)/36525.0;
   /* Mean anomaly of moon (MP) */
   a = swe_degnorm(((1.44e-5*T + 0.009192)*T + 477198.8491)*T + 296.104608);
   a *= DEGTORAD;
+  dmp = ((3*1.44e-5*T + 2*0.009192)*T + 477198.8491) * DEGTORAD;
   smp = sin(a);
   cmp = cos(a);
   s2mp = 2.0*smp*cmp;		/* sin(2MP) */
@@ -434,11 +448,13 @@ static void embofs_mosh(double tjd, double *xemb)
   /* Mean elongation of moon (D) */
   a = swe_degnorm(((1.9e-6*T - 0.001436)*T + 445267.1142)*T + 350.737486);
   a  = 2.0 * DEGTORAD * a;
+  dd = ((3*1.9e-6*T - 2*0.001436)*T + 445267.1142) * DEGTORAD;
   s2d = sin(a);
   c2d = cos(a);
   /* Mean distance of moon from its ascending node (F) */
   a = swe_degnorm((( -3.e-7*T - 0.003211)*T + 483202.0251)*T + 11.250889);
   a  *= DEGTORAD;
+  df = ((-3*3.e-7*T - 2*0.003211)*T + 483202.0251) * DEGTORAD;
   sf = sin(a);
   cf = cos(a);
   s2f = 2.0*sf*cf;	/* sin(2F) */
@@ -456,6 +472,26 @@ static void embofs_mosh(double tjd, double *xemb)
 	+ 0.213616*s2mp
 	- 0.185596*sin( DEGTORAD * M )
 	- 0.114336*s2f;
+  dL =	((3*1.9e-6*T - 2*0.001133)*T + 481267.8831)
+	+ 6.288750*cmp*dmp
+	+ 1.274018*cx*(2*dd - dmp)
+	+ 0.658309*c2d*2*dd
+	+ 0.213616*c2mp*2*dmp
+	- 0.185596*cos( DEGTORAD * M )
+	  * ((-3*3.3e-6*T - 2*1.50e-4)*T + 35999.0498) * DEGTORAD
+	- 0.114336*(cf*cf - sf*sf)*2*df;
+  /* Parallax of the moon */
+  p =	 0.950724
+	+0.051818*cmp
+	+0.009531*cx
+	+0.007843*c2d
+	+0.002824*c2mp;
+  dp =	-0.051818*smp*dmp
+	-0.009531*sx*(2*dd - dmp)
+	-0.007843*s2d*2*dd
+	-0.002824*s2mp*2*dmp;
+  p *= DEGTORAD;
+  dp *= DEGTORAD;
   /* Ecliptic latitude of the moon */
   a = smp*cf;
   sx = cmp*sf;
@@ -463,31 +499,37 @@ static void embofs_mosh(double tjd, double *xemb)
 	+ 0.280606*(a+sx)		/* sin(MP+F) */
 	+ 0.277693*(a-sx)		/* sin(MP-F) */
 	+ 0.173238*(s2d*cf - c2d*sf);	/* sin(2D-F) */
+  a = cmp*cf;
+  sx = smp*sf;
+  dB =	  5.128189*cf*df
+	+ 0.280606*(a-sx)*(dmp+df)	/* cos(MP+F) */
+	+ 0.277693*(a+sx)*(dmp-df)	/* cos(MP-F) */
+	+ 0.173238*(c2d*cf + s2d*sf)*(2*dd-df);	/* cos(2D-F) */
   B *= DEGTORAD;
-  /* Parallax of the moon */
-  p =	 0.950724
-	+0.051818*cmp
-	+0.009531*cx
-	+0.007843*c2d
-	+0.002824*c2mp;
-  p *= DEGTORAD;
   /* Elongation of Moon from Sun
    */
   L = swe_degnorm(L);
   L *= DEGTORAD;
   /* Distance in au */
   a = 4.263523e-5/sin(p);
-  /* Convert to rectangular ecliptic coordinates */
+  /* Convert to rectangular ecliptic coordinates,
+   * speeds from centuries to days */
   xyz[0] = L;
   xyz[1] = B;
   xyz[2] = a;
-  swi_polcart(xyz, xyz);
+  xyz[3] = dL * DEGTORAD / 36525.0;
+  xyz[4] = dB * DEGTORAD / 36525.0;
+  xyz[5] = -a * cos(p) / sin(p) * dp / 36525.0;
+  swi_polcart_sp(xyz, xyz);
   /* Convert to equatorial */
   swi_coortrf2(xyz, xyz, -seps, ceps);
-  /* Precess to equinox of J2000.0 */
+  swi_coortrf2(xyz+3, xyz+3, -seps, ceps);
+  /* Precess to equinox of J2000.0; the rate of precession
+   * is negligible for this offset */
   swi_precess(xyz, tjd, 0, J_TO_J2000);/**/
+  swi_precess(xyz+3, tjd, 0, J_TO_J2000);
   /* now emb -> earth */
-  for (i = 0; i <= 2; i++)
+  for (i = 0; i <= 5; i++)
     xemb[i] -= xyz[i] / (EARTH_MOON_MRAT + 1.0);
 }
 
@@ -570,31 +612,20 @@ static const double plan_oscu_elem[SE_NFICT_ELEM][8] = {
 #endif
 };
 
-/* computes a planet from osculating elements *
- * tjd		julian day
- * ipl		body number
- * ipli 	body number in planetary data structure
- * iflag	flags
- */
-int swi_osc_el_plan(double tjd, double *xp, int ipl, int ipli, double *xearth, double *xsun, char *serr)
+/* heliocentric (or, with FICT_GEO, geocentric) position and speed from
+ * osculating elements, equatorial J2000; angles in radians, tequ is the
+ * equinox of the elements */
+static void osc_el_to_xp(double tjd, double tjd0, double tequ, 
+  double mano, double sema, double ecce, 
+  double parg, double node, double incl, 
+  int32 fict_ifl, double *xp)
 {
   double pqr[9], x[6];
   double eps, K, fac, rho, cose, sine;
   double alpha, beta, zeta, sigma, M2, Msgn, M_180_or_0;
-  double tjd0, tequ, mano, sema, ecce, parg, node, incl, dmot;
+  double dmot;
   double cosnode, sinnode, cosincl, sinincl, cosparg, sinparg;
   double M, E;
-  struct plan_data *pedp = &swed.pldat[SEI_EARTH];
-  struct plan_data *pdp = &swed.pldat[ipli];
-  int32 fict_ifl = 0;
-  int i;
-  /* orbital elements, either from file or, if file not found,
-   * from above built-in set  
-   */
-  if (read_elements_file(ipl, tjd, &tjd0, &tequ, 
-       &mano, &sema, &ecce, &parg, &node, &incl, 
-       NULL, &fict_ifl, serr) == ERR)
-    return ERR;
   dmot = 0.9856076686 * DEGTORAD / sema / sqrt(sema);	/* daily motion */
   if (fict_ifl & FICT_GEO)
     dmot /= sqrt(SUN_EARTH_MRAT);
@@ -672,6 +703,29 @@ int swi_osc_el_plan(double tjd, double *xp, int ipl, int ipli, double *xearth, d
     swi_precess(xp, tequ, 0, J_TO_J2000);
     swi_precess(xp+3, tequ, 0, J_TO_J2000);
   }
+}
+
+/* computes a planet from osculating elements *
+ * tjd		julian day
+ * ipl		body number
+ * ipli 	body number in planetary data structure
+ * iflag	flags
+ */
+int swi_osc_el_plan(double tjd, double *xp, int ipl, int ipli, double *xearth, double *xsun, char *serr)
+{
+  double tjd0, tequ, mano, sema, ecce, parg, node, incl;
+  struct plan_data *pedp = &swed.pldat[SEI_EARTH];
+  struct plan_data *pdp = &swed.pldat[ipli];
+  int32 fict_ifl = 0;
+  int i;
+  /* orbital elements, either from file or, if file not found,
+   * from above built-in set  
+   */
+  if (read_elements_file(ipl, tjd, &tjd0, &tequ, 
+       &mano, &sema, &ecce, &parg, &node, &incl, 
+       NULL, &fict_ifl, serr) == ERR)
+    return ERR;
+  osc_el_to_xp(tjd, tjd0, tequ, mano, sema, ecce, parg, node, incl, fict_ifl, xp);
   /* to solar system barycentre */
   if (fict_ifl & FICT_GEO) {
     for (i = 0; i <= 5; i++) {
@@ -965,3 +1019,298 @@ static int check_t_terms(double t, char *sinp, double *doutp)
   }
   return retc;	/* there have been additional terms */
 }
+
+/*
+ * Element catalogue of numbered minor planets.
+ * A file SE_ASTELEMFILE in the ephemeris path holds osculating elements
+ * of any number of numbered minor planets, e.g. of all objects of the
+ * MPC orbit database, built with the tool sweastel. Asteroids without
+ * an ephemeris file are computed from these elements by a two-body orbit,
+ * which is good to about 1' within a year of the epoch of the elements
+ * (see swe_calc_ast_elements() in sweph.c).
+ * Format, all numbers little-endian:
+ *   8 bytes	magic "SEASTEL1"
+ *   4 bytes	number of records n
+ *   4 bytes	reserved
+ *   n * 40	records, sorted by MPC number:
+ *		int32 MPC number,
+ *		float epoch (TT, days after J2000), mean anomaly, 
+ *		semi-axis (AU), eccentricity, arg. of perihelion, 
+ *		asc. node, inclination, H, G
+ *		(angles in degrees, ecliptic and equinox J2000)
+ * The catalogue is read once per ephemeris path.
+ */
+#define ASTEL_MAGIC	"SEASTEL1"
+#define ASTEL_HDRSIZE	16
+#define ASTEL_RECSIZE	40
+#define ASTEL_NVAL	7	/* values kept per object: epoch .. incl */
+#define ASTEL_NDIRECT	1000000	/* numbers below this are indexed directly */
+#define ASTEL_SEC_N	256	/* secular rates: table size */
+#define ASTEL_SEC_AMIN	0.2	/* and range of semi-axes */
+#define ASTEL_SEC_AMAX	200.0
+static TLS struct {
+  int32 state;		/* 0 = not searched, 1 = not available, 2 = loaded */
+  char path[AS_MAXCH];	/* ephemeris path it was searched in */
+  int32 n;
+  int32 *num;		/* MPC numbers, ascending */
+  float *el;		/* ASTEL_NVAL values per object */
+  int32 *index;		/* MPC number -> record + 1, if numbers are small */
+  int32 nindex;
+  int32 mode;		/* SE_ASTEL_SECULAR */
+  AS_BOOL sec_done;
+  double sec[ASTEL_SEC_N];	/* apsidal rate / mean motion over log(a) */
+} astel = {0, "", 0, NULL, NULL, NULL, 0, 0, FALSE, {0}};
+
+void swi_ast_elem_free(void)
+{
+  if (astel.num != NULL)
+    free(astel.num);
+  if (astel.el != NULL)
+    free(astel.el);
+  if (astel.index != NULL)
+    free(astel.index);
+  astel.num = NULL;
+  astel.el = NULL;
+  astel.index = NULL;
+  astel.n = astel.nindex = 0;
+  astel.state = 0;
+  *astel.path = '\0';
+}
+
+/* memory held by the element catalogue, in bytes */
+double swi_ast_elem_bytes(void)
+{
+  double n = 0;
+  if (astel.num != NULL)
+    n += (double) astel.n * sizeof(int32);
+  if (astel.el != NULL)
+    n += (double) astel.n * ASTEL_NVAL * sizeof(float);
+  if (astel.index != NULL)
+    n += (double) astel.nindex * sizeof(int32);
+  return n;
+}
+
+static uint32 astel_uint32(unsigned char *c)
+{
+  return (uint32) c[0] | ((uint32) c[1] << 8) | ((uint32) c[2] << 16) | ((uint32) c[3] << 24);
+}
+
+static float astel_float(unsigned char *c)
+{
+  uint32 u = astel_uint32(c);
+  float f;
+  memcpy((void *) &f, (void *) &u, sizeof(float));
+  return f;
+}
+
+/* reads the catalogue; returns the number of objects or ERR */
+int32 swi_ast_elem_load(char *serr)
+{
+  int32 i, k, n;
+  unsigned char hdr[ASTEL_HDRSIZE], *buf = NULL, *c;
+  FILE *fp;
+  if (astel.state != 0 && strcmp(astel.path, swed.ephepath) == 0) {
+    if (astel.state == 2)
+      return astel.n;
+    if (serr != NULL)
+      sprintf(serr, "element catalogue %s not found", SE_ASTELEMFILE);
+    return ERR;
+  }
+  swi_ast_elem_free();
+  strcpy(astel.path, swed.ephepath);
+  astel.state = 1;
+  if ((fp = swi_fopen(-1, SE_ASTELEMFILE, swed.ephepath, serr)) == NULL)
+    return ERR;
+  if (fread((void *) hdr, ASTEL_HDRSIZE, 1, fp) != 1
+    || strncmp((char *) hdr, ASTEL_MAGIC, 8) != 0
+    || (n = (int32) astel_uint32(hdr + 8)) <= 0)
+    goto file_damaged;
+  buf = (unsigned char *) malloc((size_t) n * ASTEL_RECSIZE);
+  astel.num = (int32 *) malloc((size_t) n * sizeof(int32));
+  astel.el = (float *) malloc((size_t) n * ASTEL_NVAL * sizeof(float));
+  if (buf == NULL || astel.num == NULL || astel.el == NULL) {
+    if (serr != NULL)
+      sprintf(serr, "error in malloc() with element catalogue");
+    goto return_error;
+  }
+  if (fread((void *) buf, ASTEL_RECSIZE, (size_t) n, fp) != (size_t) n)
+    goto file_damaged;
+  for (i = 0; i < n; i++) {
+    c = buf + i * ASTEL_RECSIZE;
+    astel.num[i] = (int32) astel_uint32(c);
+    if (i > 0 && astel.num[i] <= astel.num[i-1])
+      goto file_damaged;
+    for (k = 0; k < ASTEL_NVAL; k++)
+      astel.el[i * ASTEL_NVAL + k] = astel_float(c + 4 + 4 * k);
+  }
+  /* direct index, if the numbers are not too large */
+  if (astel.num[n-1] < ASTEL_NDIRECT 
+    && (astel.index = (int32 *) calloc((size_t) astel.num[n-1] + 1, sizeof(int32))) != NULL) {
+    astel.nindex = astel.num[n-1] + 1;
+    for (i = 0; i < n; i++)
+      if (astel.num[i] >= 0)
+        astel.index[astel.num[i]] = i + 1;
+  }
+  free(buf);
+  fclose(fp);
+  astel.n = n;
+  astel.state = 2;
+  return n;
+file_damaged:
+  if (serr != NULL)
+    sprintf(serr, "element catalogue %s is damaged", SE_ASTELEMFILE);
+return_error:
+  if (buf != NULL)
+    free(buf);
+  fclose(fp);
+  swi_ast_elem_free();
+  strcpy(astel.path, swed.ephepath);
+  astel.state = 1;
+  return ERR;
+}
+
+/* index of minor planet astno in the catalogue, -1 if not there */
+int32 swi_ast_elem_find(int32 astno)
+{
+  int32 lo, hi, m;
+  if (swi_ast_elem_load(NULL) == ERR)
+    return -1;
+  if (astel.index != NULL) 
+    return (astno >= 0 && astno < astel.nindex) ? astel.index[astno] - 1 : -1;
+  lo = 0; hi = astel.n - 1;
+  while (lo <= hi) {
+    m = (lo + hi) / 2;
+    if (astel.num[m] == astno)
+      return m;
+    if (astel.num[m] < astno)
+      lo = m + 1;
+    else
+      hi = m - 1;
+  }
+  return -1;
+}
+
+int32 swi_ast_elem_number(int32 i)
+{
+  return astel.num[i];
+}
+
+/*
+ * Optional secular perturbations by the eight planets.
+ * First order Laplace-Lagrange theory for a massless body (Murray & 
+ * Dermott, Solar System Dynamics, 7.56): the perihelion advances and
+ * the node regresses with the same rate
+ *   A = n/4 * sum m_j * alpha_j * alphabar_j * b(1)_3/2(alpha_j).
+ * Planets closer than alpha = 0.9 are omitted, the theory does not 
+ * hold for them. This only models the slow rotation of the orbit plane
+ * and of the line of apsides. The main error of a two-body orbit is
+ * along the orbit (osculating instead of mean motion), typically 
+ * 0.5 degree after ten years; elements should be renewed from the 
+ * MPC database every year or two.
+ */
+static double laplace_b32_1(double alpha)
+{
+  int i;
+  double psi, b = 0;
+  for (i = 0; i < 128; i++) {
+    psi = i * TWOPI / 128;
+    b += cos(psi) / pow(1 - 2 * alpha * cos(psi) + alpha * alpha, 1.5);
+  }
+  return b * TWOPI / 128 / PI;
+}
+
+static void astel_secular_table(void)
+{
+  static const double pla[8] = {0.387098, 0.723332, 1.000001, 1.523679,
+                                5.202603, 9.554909, 19.218446, 30.110387};
+  static const double plm[8] = {6023600.0, 408523.719, 328900.5614, 3098703.59,
+                                1047.348644, 3497.9018, 22902.98, 19412.26};
+  int i, j;
+  double a, alpha, s;
+  for (i = 0; i < ASTEL_SEC_N; i++) {
+    a = ASTEL_SEC_AMIN * exp(i * log(ASTEL_SEC_AMAX / ASTEL_SEC_AMIN) / (ASTEL_SEC_N - 1));
+    s = 0;
+    for (j = 0; j < 8; j++) {
+      if (pla[j] > a) {	/* outer planet */
+        alpha = a / pla[j];
+        if (alpha <= 0.9)
+          s += alpha * alpha * laplace_b32_1(alpha) / plm[j];
+      } else {		/* inner planet */
+        alpha = pla[j] / a;
+        if (alpha <= 0.9)
+          s += alpha * laplace_b32_1(alpha) / plm[j];
+      }
+    }
+    astel.sec[i] = s / 4;
+  }
+  astel.sec_done = TRUE;
+}
+
+static double astel_secular_rate(double sema)
+{
+  double x;
+  int32 i;
+  if (!astel.sec_done)
+    astel_secular_table();
+  if (sema <= ASTEL_SEC_AMIN || sema >= ASTEL_SEC_AMAX)
+    return 0;
+  x = log(sema / ASTEL_SEC_AMIN) / log(ASTEL_SEC_AMAX / ASTEL_SEC_AMIN) * (ASTEL_SEC_N - 1);
+  i = (int32) x;
+  if (i >= ASTEL_SEC_N - 1)
+    return astel.sec[ASTEL_SEC_N - 1];
+  return astel.sec[i] + (x - i) * (astel.sec[i+1] - astel.sec[i]);
+}
+
+void swi_ast_elem_set_mode(int32 mode)
+{
+  astel.mode = mode;
+}
+
+int32 swi_ast_elem_get_mode(void)
+{
+  return astel.mode;
+}
+
+/* heliocentric position and speed of catalogue object i,
+ * equatorial J2000 */
+void swi_ast_elem_helio(int32 i, double tjd, double *xp)
+{
+  float *e = astel.el + i * ASTEL_NVAL;
+  double tjd0 = J2000 + e[0];
+  double mano = e[1] * DEGTORAD, sema = e[2];
+  double parg = e[4] * DEGTORAD, node = e[5] * DEGTORAD;
+  double dsec;
+  if (astel.mode & SE_ASTEL_SECULAR) {
+    /* A * (t - t0), in radians; the perihelion longitude node + parg
+     * advances by A, the mean longitude is kept */
+    dsec = astel_secular_rate(sema) * KGAUSS / sema / sqrt(sema) * (tjd - tjd0);
+    parg += 2 * dsec;
+    node -= dsec;
+    mano -= dsec;
+  }
+  osc_el_to_xp(tjd, tjd0, J2000, mano, sema, e[3],
+    parg, node, e[6] * DEGTORAD, 0, xp);
+}
+
+/* computes a numbered minor planet from the element catalogue,
+ * like swi_osc_el_plan() */
+int swi_osc_el_ast(double tjd, double *xp, int astno, int ipli, double *xsun, char *serr)
+{
+  int i;
+  int32 iel;
+  struct plan_data *pedp = &swed.pldat[SEI_EARTH];
+  struct plan_data *pdp = &swed.pldat[ipli];
+  if ((iel = swi_ast_elem_find(astno)) < 0) {
+    if (serr != NULL)
+      sprintf(serr, "asteroid No. %d not in element catalogue %s", astno, SE_ASTELEMFILE);
+    return ERR;
+  }
+  swi_ast_elem_helio(iel, tjd, xp);
+  for (i = 0; i <= 5; i++)
+    xp[i] += xsun[i];
+  if (pdp->x == xp) {
+    pdp->teval = tjd;	/* for precession! */
+    pdp->iephe = pedp->iephe;
+  }
+  return OK;
+}
@@ -0,0 +1,180 @@
+/*
+
+  swepack.c	Builds an ephemeris archive (seastpak.bin) from .se1 files.
+
+  Usage:  swepack [-v] archive [file.se1 ...]
+  	If no files are given, the file names are read from stdin, one
+	per line, e.g.
+	  find ast0 ast1 -name 'se*.se1' | swepack seastpak.bin
+	The archive is found by the Swiss Ephemeris in the ephemeris path
+	like any other file. Its members are used instead of separate
+	files of the same name; loose files are used for names which are
+	not in the archive. The format is described in sweph.c,
+	see pack_load().
+
+  The code of swepack.c is in the public domain.
+  (But not the code of the library functions called by it.)
+
+**************************************************************/
+
+
+#include "swephexp.h"
+
+#define PACK_MAGIC	"SEPACK01"
+#define PACK_HDRSIZE	16
+#define PACK_ENTSIZE	32
+#define PACK_NAMSIZE	16
+
+struct member {
+  char name[PACK_NAMSIZE];
+  char *path;
+  long length;
+  int pos;	/* order of the input, to keep the first duplicate */
+};
+
+static void put_uint32(unsigned char *c, uint32 u)
+{
+  c[0] = (unsigned char) (u & 0xff);
+  c[1] = (unsigned char) ((u >> 8) & 0xff);
+  c[2] = (unsigned char) ((u >> 16) & 0xff);
+  c[3] = (unsigned char) ((u >> 24) & 0xff);
+}
+
+static int member_compare(const void *a, const void *b)
+{
+  const struct member *ma = (const struct member *) a, *mb = (const struct member *) b;
+  int i = strcmp(ma->name, mb->name);
+  if (i != 0)
+    return i;
+  /* qsort() is not stable */
+  return (ma->pos > mb->pos) - (ma->pos < mb->pos);
+}
+
+static int add_member(struct member **mem, int *nmem, int *nalloc, char *path)
+{
+  char *sp;
+  FILE *fp;
+  struct member *m;
+  if ((sp = strrchr(path, '/')) == NULL && (sp = strrchr(path, '\\')) == NULL)
+    sp = path;
+  else
+    sp++;
+  if (strlen(sp) >= PACK_NAMSIZE) {
+    fprintf(stderr, "swepack: file name too long, skipped: %s\n", path);
+    return OK;
+  }
+  if ((fp = fopen(path, BFILE_R_ACCESS)) == NULL) {
+    fprintf(stderr, "swepack: cannot open %s\n", path);
+    return ERR;
+  }
+  if (*nmem >= *nalloc) {
+    *nalloc = (*nalloc == 0) ? 1024 : *nalloc * 2;
+    if ((*mem = (struct member *) realloc(*mem, (size_t) *nalloc * sizeof(struct member))) == NULL) {
+      fprintf(stderr, "swepack: out of memory\n");
+      fclose(fp);
+      return ERR;
+    }
+  }
+  m = *mem + *nmem;
+  strcpy(m->name, sp);
+  /* the library looks up members in lower case */
+  for (sp = m->name; *sp != '\0'; sp++)
+    *sp = tolower((int) *sp);
+  m->path = strdup(path);
+  fseek(fp, 0L, SEEK_END);
+  m->length = ftell(fp);
+  m->pos = *nmem;
+  fclose(fp);
+  (*nmem)++;
+  return OK;
+}
+
+int main(int argc, char *argv[])
+{
+  int i, j, nmem = 0, nalloc = 0, verbose = 0;
+  size_t n;
+  char *archive = NULL, s[AS_MAXCH], *sp;
+  unsigned char hdr[PACK_HDRSIZE], ent[PACK_ENTSIZE], buf[65536];
+  int64 offset;
+  struct member *mem = NULL;
+  FILE *fp, *fin;
+  for (i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "-v") == 0) {
+      verbose = 1;
+    } else if (archive == NULL) {
+      archive = argv[i];
+    } else if (add_member(&mem, &nmem, &nalloc, argv[i]) != OK) {
+      return 1;
+    }
+  }
+  if (archive == NULL) {
+    fprintf(stderr, "usage: swepack [-v] archive [file.se1 ...]\n");
+    return 1;
+  }
+  if (nmem == 0) {
+    while (fgets(s, AS_MAXCH, stdin) != NULL) {
+      sp = s + strlen(s);
+      while (sp > s && (sp[-1] == '\n' || sp[-1] == '\r' || sp[-1] == ' '))
+	*--sp = '\0';
+      if (*s == '\0')
+	continue;
+      if (add_member(&mem, &nmem, &nalloc, s) != OK)
+	return 1;
+    }
+  }
+  if (nmem == 0) {
+    fprintf(stderr, "swepack: no files\n");
+    return 1;
+  }
+  /* sorted index; of several files with the same name, the first one is kept */
+  qsort((void *) mem, (size_t) nmem, sizeof(struct member), member_compare);
+  for (i = 1, j = 0; i < nmem; i++) {
+    if (strcmp(mem[i].name, mem[j].name) == 0) {
+      fprintf(stderr, "swepack: duplicate name, skipped: %s\n", mem[i].path);
+      continue;
+    }
+    mem[++j] = mem[i];
+  }
+  nmem = j + 1;
+  if ((fp = fopen(archive, BFILE_W_CREATE)) == NULL) {
+    fprintf(stderr, "swepack: cannot create %s\n", archive);
+    return 1;
+  }
+  memset((void *) hdr, 0, PACK_HDRSIZE);
+  memcpy(hdr, PACK_MAGIC, 8);
+  put_uint32(hdr + 8, (uint32) nmem);
+  fwrite((void *) hdr, PACK_HDRSIZE, 1, fp);
+  offset = PACK_HDRSIZE + (int64) nmem * PACK_ENTSIZE;
+  for (i = 0; i < nmem; i++) {
+    memset((void *) ent, 0, PACK_ENTSIZE);
+    memcpy(ent, mem[i].name, strlen(mem[i].name));
+    put_uint32(ent + 16, (uint32) (offset & 0xffffffff));
+    put_uint32(ent + 20, (uint32) (offset >> 32));
+    put_uint32(ent + 24, (uint32) mem[i].length);
+    fwrite((void *) ent, PACK_ENTSIZE, 1, fp);
+    offset += mem[i].length;
+  }
+  for (i = 0; i < nmem; i++) {
+    if ((fin = fopen(mem[i].path, BFILE_R_ACCESS)) == NULL) {
+      fprintf(stderr, "swepack: cannot open %s\n", mem[i].path);
+      fclose(fp);
+      remove(archive);
+      return 1;
+    }
+    while ((n = fread((void *) buf, 1, sizeof(buf), fin)) > 0) {
+      if (fwrite((void *) buf, 1, n, fp) != n) {
+	fprintf(stderr, "swepack: write error on %s\n", archive);
+	fclose(fin);
+	fclose(fp);
+	remove(archive);
+	return 1;
+      }
+    }
+    fclose(fin);
+    if (verbose)
+      printf("%s\t%ld\n", mem[i].name, mem[i].length);
+  }
+  fclose(fp);
+  printf("%s: %d files, %.0f bytes\n", archive, nmem, (double) offset);
+  return 0;
+}
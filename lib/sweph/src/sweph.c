@@ -59,9 +59,21 @@
   for promoting such software, products or services.
 */
 
+#if defined(__linux__) || defined(__EMSCRIPTEN__)
+# ifndef _GNU_SOURCE
+#  define _GNU_SOURCE	/* for fopencookie(), used by remote and packed ephemeris files */
+# endif
+# define SE_FILE_COOKIES
+#endif
+#if defined(__linux__)
+# define SE_FILE_ADVISE	/* posix_fadvise(), used by segment prefetch */
+#endif
 
 #include <string.h>
 #include <ctype.h>
+#ifdef SE_FILE_ADVISE
+#include <fcntl.h>
+#endif
 #if MSDOS
 #include <tchar.h>
 #include <windows.h>
@@ -117,8 +129,10 @@ TLS struct swe_data swed = {FALSE,	/* ephe_path_is_set = FALSE */
 			    "",		/* astelem[] */
 			    0, 		/* i_saved_planet_name */
 			    "",		/* saved_planet_name[] */
-			    NULL,	/* dpsi */
-			    NULL,	/* deps */
+			    NULL,	/* eop_data */
+			    0,		/* eop_ndays */
+			    0,		/* eop_blkdays */
+			    0,		/* eop_data_size */
 			    0,		/* timeout */
 			    {0,0,0,0,0,0,0,0,}, /* astro_models */
 			    };
@@ -204,6 +218,8 @@ static void rot_back(int ipl);
 static int read_const(int ifno, char *serr);
 static void embofs(double *xemb, double *xmoon);
 static int app_pos_etc_plan(int ipli, int iplmoon, int32 iflag, char *serr);
+static double light_time_solve(double *dx, double *v);
+static AS_BOOL light_time_cheb(double t, double dt, struct plan_data *pdp, int32 iflag, double *xx, double *xearth);
 static int app_pos_etc_plan_osc(int ipl, int ipli, int32 iflag, char *serr);
 static int app_pos_etc_sun(int32 iflag, char *serr);
 static int app_pos_etc_moon(int32 iflag, char *serr);
@@ -223,6 +239,17 @@ static int app_pos_rest(struct plan_data *pdp, int32 iflag,
     double *xx, double *x2000, struct epsilon *oe, char *serr);
 static int open_jpl_file(double *ss, char *fname, char *fpath, char *serr);
 static void free_planets(void);
+static FILE *remote_fopen(char *fname, char *fnamp, char *serr);
+static FILE *pack_fopen(char *fname, char *fnamp, char *ephepath);
+static void pack_free(void);
+static void ast_cache_put(void);
+static AS_BOOL ast_cache_get(int ipli, double tjd);
+static void ast_cache_free(void);
+static void seg_prefetch(int ipli, int ifno, int32 iseg);
+static void ast_index_free(void);
+static void fixstar_cache_free(void);
+static void eop_free(void);
+static uint32 pack_uint32(unsigned char *c);
 
 #ifdef TRACE
 static void trace_swe_calc(int param, double tjd, int ipl, int32 iflag, double *xx, char *serr);
@@ -1075,9 +1102,21 @@ static int32 swecalc(double tjd, int ipl, int32 iplmoon, int32 iflag, double *x,
     }
     /* asteroid */
     retc = sweph(tjd, ipli_ast, ifno, iflag, psdp->x, DO_SAVE, NULL, serr);
-    if (retc == ERR || retc == NOT_AVAILABLE) 
+    if (retc == NOT_AVAILABLE && ipli_ast > SE_AST_OFFSET
+      && swed.fidat[ifno].fptr == NULL
+      && swi_ast_elem_find(ipli_ast - SE_AST_OFFSET) >= 0) {
+      /* no ephemeris file: osculating elements from the catalogue */
+      if (swi_osc_el_ast(tjd, pdp->x, ipli_ast - SE_AST_OFFSET, ipli, psdp->x, serr) != OK)
+	goto return_error;
+      /* forget the message of the missing file */
+      if (serr != NULL)
+	*serr = '\0';
+      retc = app_pos_etc_plan_osc(ipli_ast, ipli, iflag, serr);
+    } else if (retc == ERR || retc == NOT_AVAILABLE) {
       goto return_error;
-    retc = app_pos_etc_plan(ipli_ast, 0, iflag, serr);
+    } else {
+      retc = app_pos_etc_plan(ipli_ast, 0, iflag, serr);
+    }
     if (retc == ERR)
       goto return_error;
     /* app_pos_etc_plan() might have failed, if t(light-time)
@@ -1205,6 +1244,7 @@ static void swi_close_keep_topo_etc(void)
     memset((void *) &swed.fidat[i], 0, sizeof(struct file_data));
   }
   free_planets();
+  ast_cache_free();
   memset((void *) &swed.oec, 0, sizeof(struct epsilon));
   memset((void *) &swed.oec2000, 0, sizeof(struct epsilon));
   memset((void *) &swed.nut, 0, sizeof(struct nut));
@@ -1240,6 +1280,11 @@ void CALL_CONV swe_close(void)
     memset((void *) &swed.fidat[i], 0, sizeof(struct file_data));
   }
   free_planets();
+  ast_cache_free();
+  pack_free();
+  swi_ast_elem_free();
+  swi_ecl_db_free();
+  ast_index_free();
   memset((void *) &swed.oec, 0, sizeof(struct epsilon));
   memset((void *) &swed.oec2000, 0, sizeof(struct epsilon));
   memset((void *) &swed.nut, 0, sizeof(struct nut));
@@ -1265,14 +1310,7 @@ void CALL_CONV swe_close(void)
   memset((void *) &swed.sidd, 0, sizeof(struct sid_data));
   swed.timeout = 0;
   swed.last_epheflag = 0;
-  if (swed.dpsi != NULL) {
-    free(swed.dpsi);
-    swed.dpsi = NULL;
-  }
-  if (swed.deps != NULL) {
-    free(swed.deps);
-    swed.deps = NULL;
-  }
+  eop_free();
   if (swed.n_fixstars_records > 0) {
     free(swed.fixed_stars);
     swed.fixed_stars = NULL;
@@ -1280,6 +1318,7 @@ void CALL_CONV swe_close(void)
     swed.n_fixstars_named = 0;
     swed.n_fixstars_records = 0;
   }
+  fixstar_cache_free();
 /*  swed.ephe_path_is_set = FALSE;
   *swed.ephepath = '\0'; */
 #ifdef TRACE
@@ -1376,6 +1415,197 @@ void CALL_CONV swe_set_ephe_path(const char *path)
 #endif
 }
 
+/* Earth orientation data, the daily corrections dpsi, deps to the 
+ * IAU 1980 nutation for SEFLG_JPLHOR.
+ * File DPSI_DEPS_IAU1980_FILE_BIN, built by sweeop.c from the text files
+ * DPSI_DEPS_IAU1980_FILE_EOPC04 and DPSI_DEPS_IAU1980_FILE_FINALS, 
+ * little-endian:
+ * header, EOP_HDRSIZE bytes:
+ *   0	"SEEOPBN1"
+ *   8	uint32 number of days n
+ *  12	int32 state as in swed.eop_dpsi_loaded: 1 = EOP C04 only, 
+ *	2 = continued with finals, -3 = finals corrupt
+ *  16	double date of the first day (JD)
+ *  24	uint32 days per block nd
+ *  28	uint32 size of the block data in bytes
+ * (n + nd - 1) / nd uint32, offset of each block in the block data
+ * block data: dpsi, deps of each day in units of 0.000001", as zigzag 
+ *	varints (7 bits per byte, lowest first, the high bit set if more
+ *	bytes follow); the first day of a block holds the values, the 
+ *	other days the differences to the day before.
+ * The offsets and the block data are kept in swed.eop_data as they are
+ * in the file, and swi_eop_get() decodes the few days an interpolation
+ * needs. Without the binary file, the text files are read and encoded 
+ * the same way.
+ */
+#define EOP_MAGIC	"SEEOPBN1"
+#define EOP_HDRSIZE	32
+#define EOP_BLKDAYS	32	/* days per block when encoding the text files */
+#define EOP_UNIT	1000000.0
+#define EOP_NWIN	6	/* days of the last window decoded */
+static TLS struct {
+  int32 i0, i1;
+  double dpsi[EOP_NWIN], deps[EOP_NWIN];
+} eop_win = {-1, -1, {0}, {0}};
+
+static void eop_free(void)
+{
+  eop_win.i0 = eop_win.i1 = -1;
+  if (swed.eop_data != NULL)
+    free(swed.eop_data);
+  swed.eop_data = NULL;
+  swed.eop_ndays = swed.eop_blkdays = swed.eop_data_size = 0;
+  swed.eop_dpsi_loaded = 0;
+}
+
+static int32 eop_put_varint(unsigned char *c, int32 v)
+{
+  int32 k = 0;
+  uint32 u = (v < 0) ? ((uint32) (-(v + 1)) << 1) | 1 : (uint32) v << 1;
+  while (u >= 0x80) {
+    c[k++] = (unsigned char) (u | 0x80);
+    u >>= 7;
+  }
+  c[k++] = (unsigned char) u;
+  return k;
+}
+
+static int32 eop_get_varint(unsigned char **c)
+{
+  uint32 u = 0;
+  int sh = 0;
+  while (**c & 0x80) {
+    u |= (uint32) (**c & 0x7f) << sh;
+    sh += 7;
+    (*c)++;
+  }
+  u |= (uint32) **c << sh;
+  (*c)++;
+  return (u & 1) ? -(int32) (u >> 1) - 1 : (int32) (u >> 1);
+}
+
+/* dpsi, deps (arcsec) of the days i0..i1 of the earth orientation data,
+ * into dpsi[0..i1-i0], deps[0..i1-i0] */
+void swi_eop_get(int32 i0, int32 i1, double *dpsi, double *deps)
+{
+  int32 i, nd = swed.eop_blkdays, nblk, vpsi = 0, veps = 0;
+  unsigned char *c;
+  /* successive calls mostly need the same days */
+  if (i0 == eop_win.i0 && i1 == eop_win.i1) {
+    memcpy((void *) dpsi, (void *) eop_win.dpsi, (size_t) (i1 - i0 + 1) * sizeof(double));
+    memcpy((void *) deps, (void *) eop_win.deps, (size_t) (i1 - i0 + 1) * sizeof(double));
+    return;
+  }
+  nblk = (swed.eop_ndays + nd - 1) / nd;
+  /* blocks are contiguous, so only the first one is looked up */
+  c = swed.eop_data + 4 * nblk + pack_uint32(swed.eop_data + 4 * (i0 / nd));
+  for (i = i0 / nd * nd; i <= i1; i++) {
+    if (i % nd == 0)
+      vpsi = veps = 0;
+    vpsi += eop_get_varint(&c);
+    veps += eop_get_varint(&c);
+    if (i >= i0) {
+      dpsi[i - i0] = vpsi / EOP_UNIT;
+      deps[i - i0] = veps / EOP_UNIT;
+    }
+  }
+  if (i1 - i0 < EOP_NWIN) {
+    eop_win.i0 = i0;
+    eop_win.i1 = i1;
+    memcpy((void *) eop_win.dpsi, (void *) dpsi, (size_t) (i1 - i0 + 1) * sizeof(double));
+    memcpy((void *) eop_win.deps, (void *) deps, (size_t) (i1 - i0 + 1) * sizeof(double));
+  }
+}
+
+/* encodes n days of dpsi, deps (0.000001") into swed.eop_data */
+static int32 eop_encode(int32 *ipsi, int32 *ieps, int32 n)
+{
+  int32 i, k = 0, nblk = (n + EOP_BLKDAYS - 1) / EOP_BLKDAYS;
+  unsigned char *c, *d;
+  /* at most 5 bytes per varint */
+  if ((c = (unsigned char *) malloc((size_t) (4 * nblk + 10 * n))) == NULL)
+    return ERR;
+  d = c + 4 * nblk;
+  for (i = 0; i < n; i++) {
+    if (i % EOP_BLKDAYS == 0) {
+      c[4 * (i / EOP_BLKDAYS)] = (unsigned char) (k & 0xff);
+      c[4 * (i / EOP_BLKDAYS) + 1] = (unsigned char) ((k >> 8) & 0xff);
+      c[4 * (i / EOP_BLKDAYS) + 2] = (unsigned char) ((k >> 16) & 0xff);
+      c[4 * (i / EOP_BLKDAYS) + 3] = (unsigned char) ((k >> 24) & 0xff);
+      k += eop_put_varint(d + k, ipsi[i]);
+      k += eop_put_varint(d + k, ieps[i]);
+    } else {
+      k += eop_put_varint(d + k, ipsi[i] - ipsi[i-1]);
+      k += eop_put_varint(d + k, ieps[i] - ieps[i-1]);
+    }
+  }
+  swed.eop_data_size = 4 * nblk + k;
+  if ((swed.eop_data = (unsigned char *) realloc(c, (size_t) swed.eop_data_size)) == NULL)
+    swed.eop_data = c;
+  swed.eop_ndays = n;
+  swed.eop_blkdays = EOP_BLKDAYS;
+  return OK;
+}
+
+/* reads the binary file; returns OK, or ERR if it is not found or damaged */
+static int32 load_dpsi_deps_bin(void)
+{
+  int32 i, k, n, nd, nblk, size;
+  unsigned long long u;
+  unsigned char hdr[EOP_HDRSIZE], *c, *d;
+  FILE *fp;
+  if ((fp = swi_fopen(-1, DPSI_DEPS_IAU1980_FILE_BIN, swed.ephepath, NULL)) == NULL)
+    return ERR;
+  if (fread((void *) hdr, EOP_HDRSIZE, 1, fp) != 1
+    || strncmp((char *) hdr, EOP_MAGIC, 8) != 0
+    || (n = (int32) pack_uint32(hdr + 8)) <= 0
+    || (nd = (int32) pack_uint32(hdr + 24)) <= 0
+    || (size = (int32) pack_uint32(hdr + 28)) <= 0
+    || size > 10 * n) {
+    fclose(fp);
+    return ERR;
+  }
+  nblk = (n + nd - 1) / nd;
+  if ((swed.eop_data = (unsigned char *) malloc((size_t) (4 * nblk + size))) == NULL) {
+    fclose(fp);
+    return ERR;
+  }
+  swed.eop_ndays = n;
+  swed.eop_blkdays = nd;
+  swed.eop_data_size = 4 * nblk + size;
+  if (fread((void *) swed.eop_data, (size_t) swed.eop_data_size, 1, fp) != 1)
+    goto file_damaged;
+  fclose(fp);
+  fp = NULL;
+  /* check that the blocks are contiguous and the varints in bounds, 
+   * so that swi_eop_get() need not */
+  d = swed.eop_data + 4 * nblk;
+  for (i = 0, c = d; i < 2 * n; i++) {
+    if (i % (2 * nd) == 0 && pack_uint32(swed.eop_data + 4 * (i / (2 * nd))) != (uint32) (c - d))
+      goto file_damaged;
+    for (k = 0; c < d + size && (*c & 0x80); k++, c++) {
+      if (k == 4)
+	goto file_damaged;
+    }
+    if (c++ >= d + size)
+      goto file_damaged;
+  }
+  swed.eop_dpsi_loaded = (int) (int32) pack_uint32(hdr + 12);
+  u = (unsigned long long) pack_uint32(hdr + 16) 
+    | ((unsigned long long) pack_uint32(hdr + 20) << 32);
+  memcpy((void *) &swed.eop_tjd_beg, (void *) &u, sizeof(double));
+  if (swed.eop_dpsi_loaded != 1 && swed.eop_dpsi_loaded != 2 && swed.eop_dpsi_loaded != -3)
+    goto file_damaged;
+  swed.eop_tjd_end = swed.eop_tjd_beg + n - 1;
+  swed.eop_tjd_beg_horizons = DPSI_DEPS_IAU1980_TJD0_HORIZONS;
+  return OK;
+file_damaged:
+  if (fp != NULL)
+    fclose(fp);
+  eop_free();
+  return ERR;
+}
+
 void load_dpsi_deps(void)
 {
   FILE *fp;
@@ -1383,20 +1613,22 @@ void load_dpsi_deps(void)
   char *cpos[20];
   int n = 0, iyear, mjd = 0, mjdsv = 0;
   double dpsi, deps, TJDOFS = 2400000.5;
+  int32 *ipsi = NULL, *ieps = NULL;
   if (swed.eop_dpsi_loaded > 0) 
     return;
+  eop_free();
+  if (load_dpsi_deps_bin() == OK)
+    return;
   fp = swi_fopen(-1, DPSI_DEPS_IAU1980_FILE_EOPC04, swed.ephepath, NULL);
   if (fp == NULL) {
     swed.eop_dpsi_loaded = ERR;
     return;
   }
-  if ((swed.dpsi = (double *) calloc((size_t) SWE_DATA_DPSI_DEPS, sizeof(double))) == NULL) {
+  /* the values are collected in 0.000001" and encoded at the end */
+  if ((ipsi = (int32 *) calloc((size_t) SWE_DATA_DPSI_DEPS, sizeof(int32))) == NULL
+    || (ieps = (int32 *) calloc((size_t) SWE_DATA_DPSI_DEPS, sizeof(int32))) == NULL) {
     swed.eop_dpsi_loaded = ERR;
-    return;
-  }
-  if ((swed.deps = (double *) calloc((size_t) SWE_DATA_DPSI_DEPS, sizeof(double))) == NULL) {
-    swed.eop_dpsi_loaded = ERR;
-    return;
+    goto done;
   }
   swed.eop_tjd_beg_horizons = DPSI_DEPS_IAU1980_TJD0_HORIZONS;
   while (fgets(s, AS_MAXCH, fp) != NULL) {
@@ -1408,38 +1640,37 @@ void load_dpsi_deps(void)
     if (mjdsv > 0 && mjd - mjdsv != 1) {
       /* we cannot return error but we note it as follows: */
       swed.eop_dpsi_loaded = -2;
-      fclose(fp);
-      return;
+      goto done;
     }
+    if (n >= SWE_DATA_DPSI_DEPS)
+      break;
     if (n == 0)
       swed.eop_tjd_beg = mjd + TJDOFS;
-    swed.dpsi[n] = atof(cpos[8]);
-    swed.deps[n] = atof(cpos[9]);
-/*    fprintf(stderr, "n=%d, tjd=%f, dpsi=%f, deps=%f\n", n, mjd + 2400000.5, swed.dpsi[n] * 1000, swed.deps[n] * 1000);exit(0);*/
+    ipsi[n] = (int32) floor(atof(cpos[8]) * EOP_UNIT + 0.5);
+    ieps[n] = (int32) floor(atof(cpos[9]) * EOP_UNIT + 0.5);
     n++;
     mjdsv = mjd;
   }
-  swed.eop_tjd_end = mjd + TJDOFS;
+  swed.eop_tjd_end = mjdsv + TJDOFS;
   swed.eop_dpsi_loaded = 1;
   fclose(fp);
   /* file finals.all may have some more data, and especially estimations 
    * for the near future */
   fp = swi_fopen(-1, DPSI_DEPS_IAU1980_FILE_FINALS, swed.ephepath, NULL);
   if (fp == NULL) 
-    return; /* return without error as existence of file is not mandatory */
+    goto done; /* return without error as existence of file is not mandatory */
   while (fgets(s, AS_MAXCH, fp) != NULL) {
     mjd = atoi(s + 7);
     if (mjd + TJDOFS <= swed.eop_tjd_end)
       continue;
     if (n >= SWE_DATA_DPSI_DEPS)
-      return;
+      goto done;
     /* are data in one-day steps? */
     if (mjdsv > 0 && mjd - mjdsv != 1) {
       /* no error, as we do have data; however, if this file is usefull,
        * then swed.eop_dpsi_loaded will be set to 2 */
       swed.eop_dpsi_loaded = -3;
-      fclose(fp);
-      return;
+      goto done;
     }
     /* dpsi, deps Bulletin B */
     dpsi = atof(s + 168);
@@ -1449,21 +1680,27 @@ void load_dpsi_deps(void)
       dpsi = atof(s + 99);
       deps = atof(s + 118);
     }
-    if (dpsi == 0) {
-      swed.eop_dpsi_loaded = 2;
-      /*printf("dpsi from %f to %f \n", swed.eop_tjd_beg, swed.eop_tjd_end);*/
-      fclose(fp);
-      return;
-    }
+    if (dpsi == 0) 
+      break;
     swed.eop_tjd_end = mjd + TJDOFS;
-    swed.dpsi[n] = dpsi / 1000.0;
-    swed.deps[n] = deps / 1000.0;
-    /*fprintf(stderr, "tjd=%f, dpsi=%f, deps=%f\n", mjd + 2400000.5, swed.dpsi[n] * 1000, swed.deps[n] * 1000);*/
+    /* given in 0.001" */
+    ipsi[n] = (int32) floor(dpsi * 1000.0 + 0.5);
+    ieps[n] = (int32) floor(deps * 1000.0 + 0.5);
     n++;
     mjdsv = mjd;
   }
   swed.eop_dpsi_loaded = 2;
-  fclose(fp);
+done:
+  if (fp != NULL)
+    fclose(fp);
+  if (n == 0 && swed.eop_dpsi_loaded > 0)
+    swed.eop_dpsi_loaded = -2;
+  if (n > 0 && eop_encode(ipsi, ieps, n) == ERR)
+    swed.eop_dpsi_loaded = ERR;
+  if (ipsi != NULL)
+    free(ipsi);
+  if (ieps != NULL)
+    free(ieps);
 }
 
 /* sets jpl file name.
@@ -2165,18 +2402,25 @@ static int sweph(double tjd, int ipli, int ifno, int32 iflag, double *xsunb, AS_
      * if new asteroid, close old file. */
     if (tjd < fdp->tfstart || tjd > fdp->tfend
       || (ipl == SEI_ANYBODY && ipli != pdp->ibdy)) { 	
-      fclose(fdp->fptr);
-      fdp->fptr = NULL;
-      if (pdp->refep != NULL) 
-	free((void *) pdp->refep);
-      pdp->refep = NULL;
-      if (pdp->segp != NULL)
-	free((void *) pdp->segp);
-      pdp->segp = NULL;
+      if (ifno == SEI_FILE_ANY_AST && ipli != pdp->ibdy) {
+	/* other asteroid: keep this one in the asteroid cache */
+	ast_cache_put();
+      } else {
+	fclose(fdp->fptr);
+	fdp->fptr = NULL;
+	if (pdp->refep != NULL) 
+	  free((void *) pdp->refep);
+	pdp->refep = NULL;
+	if (pdp->segp != NULL)
+	  free((void *) pdp->segp);
+	pdp->segp = NULL;
+      }
     }
   }
-  /* if sweph file not open, find and open it */
-  if (fdp->fptr == NULL) {
+  /* if sweph file not open, find and open it, unless the asteroid
+   * is in the asteroid cache */
+  if (fdp->fptr == NULL 
+    && !(ifno == SEI_FILE_ANY_AST && ast_cache_get(ipli, tjd))) {
     swi_gen_filename(tjd, ipli, fname); 
     strcpy(subdirnam, fname);
     sp = strrchr(subdirnam, (int) *DIR_GLUE);
@@ -2372,6 +2616,9 @@ FILE *swi_fopen(int ifno, char *fname, char *ephepath, char *serr)
   } else {
     fnamp = fn; 
   }
+  /* member of the ephemeris archive? */
+  if ((fp = pack_fopen(fname, fnamp, ephepath)) != NULL)
+    return fp;
   strcpy(s1, ephepath);
   np = swi_cutstr(s1, PATH_SEPARATOR, cpos, 20);
   *s = '\0';
@@ -2396,107 +2643,1061 @@ FILE *swi_fopen(int ifno, char *fname, char *ephepath, char *serr)
     if (fp != NULL) 
       return fp;
   }
-  sprintf(s, "SwissEph file '%s' not found in PATH '%s'", fname, ephepath);
+  /* not found locally: try the remote ephemeris source, if any */
+  *s = '\0';
+  if ((fp = remote_fopen(fname, fnamp, s)) != NULL)
+    return fp;
+  if (*s == '\0')
+    sprintf(s, "SwissEph file '%s' not found in PATH '%s'", fname, ephepath);
   s[AS_MAXCH-1] = '\0';		/* s must not be longer then AS_MAXCH */
   if (serr != NULL)
     strcpy(serr, s);
   return NULL;
 }
 
-int32 swi_get_denum(int32 ipli, int32 iflag)
+/*
+ * Remote ephemeris files.
+ * If a file is not found in the ephemeris path and a remote source has
+ * been set with swe_set_ephe_remote(), the file is opened as a virtual
+ * stream whose bytes are fetched on demand, in fixed-size blocks, through
+ * a caller-supplied reader (e.g. HTTP Range requests in the browser).
+ * Fetched blocks are kept in a least-recently-used cache, so that only
+ * the parts of a large file (e.g. a JPL ephemeris) which are actually
+ * touched are ever transferred. The stream is a normal FILE pointer,
+ * therefore the readers of sweph.c and swejpl.c need no changes.
+ */
+#define REMOTE_MAXFILES		50
+#define REMOTE_BLOCK_DEFAULT	65536
+#define REMOTE_CACHE_DEFAULT	64
+struct remote_block {
+  int32 ifile;		/* index in remote file table, -1 = unused */
+  int64 iblock;		/* block number within file */
+  uint32 used;		/* time of last use, for LRU replacement */
+  int32 nbytes;
+  char *data;
+};
+struct remote_file {
+  char fname[AS_MAXCH];
+  double fsize;		/* file size, -1 if file does not exist */
+  int32 nopen;		/* number of open streams of the file */
+  uint32 used;		/* time of last open, for LRU replacement */
+};
+struct remote_cookie {
+  int32 ifile;
+  int64 pos;
+};
+static TLS struct {
+  char url[AS_MAXCH];
+  SWE_REMOTE_READ reader;
+  int32 block_size;
+  int32 nblocks;
+  struct remote_block *blocks;
+  int32 last_hit;
+  uint32 clock;
+  struct remote_file files[REMOTE_MAXFILES];
+  int32 nfiles;
+  double stat[SE_REMOTE_NSTAT];
+} remote = {"", NULL, 0, 0, NULL, -1, 0};
+
+#ifdef SE_FILE_COOKIES
+#ifdef __GLIBC__
+typedef off64_t file_off_t;
+#else
+typedef off_t file_off_t;
+#endif
+static void remote_free_cache(void)
 {
-  struct file_data *fdp = NULL;
-  if (iflag & SEFLG_MOSEPH)
-    return 403;
-  if (iflag & SEFLG_JPLEPH) {
-    if (swed.jpldenum > 0) {
-      return swed.jpldenum;
-    } else {
-      return SE_DE_NUMBER;
-    }
+  int i;
+  if (remote.blocks != NULL) {
+    for (i = 0; i < remote.nblocks; i++)
+      if (remote.blocks[i].data != NULL)
+	free(remote.blocks[i].data);
+    free(remote.blocks);
+  }
+  remote.blocks = NULL;
+  remote.nblocks = 0;
+  remote.last_hit = -1;
+  remote.nfiles = 0;
+  memset((void *) remote.stat, 0, sizeof(remote.stat));
+}
+
+static void remote_file_url(int32 ifile, char *s)
+{
+  size_t len = strlen(remote.url);
+  strcpy(s, remote.url);
+  if (len > 0 && s[len - 1] != '/')
+    strcat(s, "/");
+  strcat(s, remote.files[ifile].fname);
+}
+
+/* returns cache slot of block iblock of file ifile, fetching it if
+ * necessary; -1 on read error */
+static int32 remote_get_block(int32 ifile, int64 iblock)
+{
+  int32 i, islot = 0;
+  double off, nb, fsize;
+  struct remote_block *rb;
+  char url[2 * AS_MAXCH];
+  rb = remote.blocks;
+  remote.clock++;
+  if (remote.last_hit >= 0 && rb[remote.last_hit].ifile == ifile 
+    && rb[remote.last_hit].iblock == iblock) {
+    rb[remote.last_hit].used = remote.clock;
+    remote.stat[SE_REMOTE_STAT_HITS]++;
+    return remote.last_hit;
+  }
+  for (i = 0; i < remote.nblocks; i++) {
+    if (rb[i].ifile == ifile && rb[i].iblock == iblock) {
+      rb[i].used = remote.clock;
+      remote.last_hit = i;
+      remote.stat[SE_REMOTE_STAT_HITS]++;
+      return i;
+    }
+    /* remember least recently used slot */
+    if (rb[i].used < rb[islot].used)
+      islot = i;
+  }
+  remote.stat[SE_REMOTE_STAT_MISSES]++;
+  rb = &remote.blocks[islot];
+  if (rb->data == NULL && (rb->data = (char *) malloc((size_t) remote.block_size)) == NULL)
+    return -1;
+  off = (double) iblock * remote.block_size;
+  nb = remote.files[ifile].fsize - off;
+  if (nb > remote.block_size)
+    nb = remote.block_size;
+  if (nb <= 0)
+    return -1;
+  remote_file_url(ifile, url);
+  rb->ifile = -1;
+  fsize = remote.files[ifile].fsize;
+  remote.stat[SE_REMOTE_STAT_REQUESTS]++;
+  if ((rb->nbytes = remote.reader(url, off, (int32) nb, rb->data, &fsize)) <= 0)
+    return -1;
+  remote.stat[SE_REMOTE_STAT_BYTES] += rb->nbytes;
+  rb->ifile = ifile;
+  rb->iblock = iblock;
+  rb->used = remote.clock;
+  remote.last_hit = islot;
+  return islot;
+}
+
+static ssize_t remote_read(void *cookie, char *buf, size_t size)
+{
+  struct remote_cookie *rc = (struct remote_cookie *) cookie;
+  double fsize = remote.files[rc->ifile].fsize;
+  size_t nread = 0;
+  int32 islot, boff, n;
+  int64 iblock;
+  while (nread < size && rc->pos < fsize) {
+    iblock = rc->pos / remote.block_size;
+    if ((islot = remote_get_block(rc->ifile, iblock)) < 0)
+      return nread > 0 ? (ssize_t) nread : -1;
+    boff = (int32) (rc->pos - iblock * remote.block_size);
+    n = remote.blocks[islot].nbytes - boff;
+    if (n <= 0)
+      break;
+    if ((size_t) n > size - nread)
+      n = (int32) (size - nread);
+    memcpy(buf + nread, remote.blocks[islot].data + boff, (size_t) n);
+    nread += n;
+    rc->pos += n;
   }
-  if (ipli > SE_AST_OFFSET) {
-    fdp = &swed.fidat[SEI_FILE_ANY_AST];
-  } else if (ipli > SE_PLMOON_OFFSET) {
-    fdp = &swed.fidat[SEI_FILE_ANY_AST];
-  } else if (ipli == SEI_CHIRON
-      || ipli == SEI_PHOLUS
-      || ipli == SEI_CERES
-      || ipli == SEI_PALLAS
-      || ipli == SEI_JUNO
-      || ipli == SEI_VESTA) {
-    fdp = &swed.fidat[SEI_FILE_MAIN_AST];
-  } else if (ipli == SEI_MOON) {
-    fdp = &swed.fidat[SEI_FILE_MOON];
-  } else {
-    fdp = &swed.fidat[SEI_FILE_PLANET];
+  return (ssize_t) nread;
+}
+
+static int remote_seek(void *cookie, file_off_t *offset, int whence)
+{
+  struct remote_cookie *rc = (struct remote_cookie *) cookie;
+  int64 pos;
+  switch (whence) {
+    case SEEK_SET: pos = *offset; break;
+    case SEEK_CUR: pos = rc->pos + *offset; break;
+    case SEEK_END: pos = (int64) remote.files[rc->ifile].fsize + *offset; break;
+    default: return -1;
+  }
+  if (pos < 0)
+    return -1;
+  rc->pos = pos;
+  *offset = (file_off_t) pos;
+  return 0;
+}
+
+static int remote_close(void *cookie)
+{
+  struct remote_cookie *rc = (struct remote_cookie *) cookie;
+  if (rc->ifile < remote.nfiles && remote.files[rc->ifile].nopen > 0)
+    remote.files[rc->ifile].nopen--;
+  free(cookie);
+  return 0;
+}
+
+/* returns a free entry of the remote file table; if the table is full,
+ * the least recently opened file without open streams is dropped,
+ * together with its cached blocks; -1 if all files are open */
+static int32 remote_new_file(void)
+{
+  int32 i, ifile = -1;
+  if (remote.nfiles < REMOTE_MAXFILES)
+    return remote.nfiles++;
+  for (i = 0; i < remote.nfiles; i++) {
+    if (remote.files[i].nopen > 0)
+      continue;
+    if (ifile < 0 || remote.files[i].used < remote.files[ifile].used)
+      ifile = i;
   }
-  if (fdp != NULL) {
-    if (fdp->sweph_denum != 0) {
-      return fdp->sweph_denum;
-    } else {
-      return SE_DE_NUMBER;
+  if (ifile < 0)
+    return -1;
+  for (i = 0; i < remote.nblocks; i++) {
+    if (remote.blocks[i].ifile == ifile) {
+      remote.blocks[i].ifile = -1;
+      remote.blocks[i].used = 0;
     }
   }
-  return SE_DE_NUMBER;
+  remote.last_hit = -1;
+  return ifile;
 }
 
-static int calc_center_body(int32 ipli, int32 iflag, double *xx, double *xcom, char *serr)
+static int cookie_close(void *cookie)
 {
-  int i;
-  if (!(iflag & SEFLG_CENTER_BODY))
-    return OK;
-  if (ipli < SEI_MARS || ipli > SEI_PLUTO)
+  free(cookie);
+  return 0;
+}
+#endif /* SE_FILE_COOKIES */
+
+static FILE *remote_fopen(char *fname, char *fnamp, char *serr)
+{
+#ifdef SE_FILE_COOKIES
+  int32 i, ifile = -1;
+  double fsize = -1;
+  char c, url[2 * AS_MAXCH];
+  struct remote_cookie *rc;
+  cookie_io_functions_t iofunc = {remote_read, NULL, remote_seek, remote_close};
+  FILE *fp;
+  if (remote.reader == NULL || strlen(fname) >= AS_MAXCH)
+    return NULL;
+  for (i = 0; i < remote.nfiles; i++) {
+    if (strcmp(remote.files[i].fname, fname) == 0) {
+      ifile = i;
+      break;
+    }
+  }
+  if (ifile < 0) {
+    /* first access: a one-byte read tells whether the file exists
+     * and how large it is. Missing files are remembered, so that the
+     * optional files probed by every swe_set_ephe_path() cost only
+     * one request. */
+    if ((ifile = remote_new_file()) < 0) {
+      if (serr != NULL)
+	sprintf(serr, "cannot open remote file %s: more than %d remote files open", fname, REMOTE_MAXFILES);
+      return NULL;
+    }
+    strcpy(remote.files[ifile].fname, fname);
+    remote.files[ifile].fsize = -1;
+    remote.files[ifile].nopen = 0;
+    remote_file_url(ifile, url);
+    remote.stat[SE_REMOTE_STAT_REQUESTS]++;
+    if (remote.reader(url, 0, 1, &c, &fsize) > 0 && fsize > 0) {
+      remote.stat[SE_REMOTE_STAT_BYTES]++;
+      remote.files[ifile].fsize = fsize;
+    }
+  }
+  remote.files[ifile].used = ++remote.clock;
+  /* file is known not to exist */
+  if (remote.files[ifile].fsize <= 0)
+    return NULL;
+  if ((rc = (struct remote_cookie *) calloc(1, sizeof(struct remote_cookie))) == NULL)
+    return NULL;
+  rc->ifile = ifile;
+  rc->pos = 0;
+  if ((fp = fopencookie(rc, BFILE_R_ACCESS, iofunc)) == NULL) {
+    free(rc);
+    return NULL;
+  }
+  remote.files[ifile].nopen++;
+  remote_file_url(ifile, url);
+  url[AS_MAXCH-1] = '\0';
+  strcpy(fnamp, url);
+  return fp;
+#else
+  return NULL;
+#endif
+}
+
+/* sets a remote source for ephemeris files which are not found in the
+ * ephemeris path.
+ * url		base URL (or any other name the reader understands); file
+ *		names are appended to it with '/'. NULL or "" removes the 
+ *		remote source and frees the block cache.
+ * block_size	size of transferred blocks in bytes, 0 = 65536
+ * cache_blocks	number of blocks kept in memory, 0 = 64
+ * reader	function which reads nbytes at offset of a file into buf,
+ *		stores the total file size in *fsize and returns the
+ *		number of bytes read, or -1 if the file does not exist.
+ */
+int32 CALL_CONV swe_set_ephe_remote(char *url, int32 block_size, int32 cache_blocks, SWE_REMOTE_READ reader, char *serr)
+{
+  int32 i;
+  swi_close_keep_topo_etc();
+#ifdef SE_FILE_COOKIES
+  remote_free_cache();
+#endif
+  *remote.url = '\0';
+  remote.reader = NULL;
+  if (url == NULL || *url == '\0')
     return OK;
-  for (i = 0; i <= 5; i++)
-    xx[i] += xcom[i];
+#ifndef SE_FILE_COOKIES
+  if (serr != NULL)
+    strcpy(serr, "remote ephemeris files are not supported on this platform");
+  return ERR;
+#endif
+  if (reader == NULL || strlen(url) >= AS_MAXCH - 1) {
+    if (serr != NULL)
+      strcpy(serr, "swe_set_ephe_remote: invalid url or reader");
+    return ERR;
+  }
+  if (block_size <= 0)
+    block_size = REMOTE_BLOCK_DEFAULT;
+  if (cache_blocks <= 0)
+    cache_blocks = REMOTE_CACHE_DEFAULT;
+  if (block_size < 1024)
+    block_size = 1024;
+  if (cache_blocks < 2)
+    cache_blocks = 2;
+  remote.blocks = (struct remote_block *) calloc((size_t) cache_blocks, sizeof(struct remote_block));
+  if (remote.blocks == NULL) {
+    if (serr != NULL)
+      strcpy(serr, "swe_set_ephe_remote: could not allocate cache");
+    return ERR;
+  }
+  for (i = 0; i < cache_blocks; i++)
+    remote.blocks[i].ifile = -1;
+  remote.nblocks = cache_blocks;
+  remote.block_size = block_size;
+  remote.reader = reader;
+  strcpy(remote.url, url);
   return OK;
 }
 
-/* converts planets from barycentric to geocentric,
- * apparent positions
- * precession and nutation
- * according to flags
- * ipli		planet number
- * iflag	flags
- * serr         error string
+/* transfer statistics of the remote ephemeris source:
+ * dstat[SE_REMOTE_STAT_REQUESTS]	number of reader calls
+ * dstat[SE_REMOTE_STAT_BYTES]		bytes transferred
+ * dstat[SE_REMOTE_STAT_HITS]		block reads served from cache
+ * dstat[SE_REMOTE_STAT_MISSES]		block reads that required a transfer
+ * dstat[SE_REMOTE_STAT_CACHED]		blocks currently held in cache
+ * and of segment prefetch (all files, not only remote ones):
+ * dstat[SE_REMOTE_STAT_PREFETCH]	segments prefetched
+ * dstat[SE_REMOTE_STAT_PREFETCH_HITS]	segments read after being prefetched
+ * returns number of existing remote files in the file table.
  */
-static int app_pos_etc_plan(int ipli, int iplmoon, int32 iflag, char *serr)
+int32 CALL_CONV swe_get_ephe_remote_stats(double *dstat)
 {
-  int i, j, niter, retc = OK;
-  int ipl, ifno, ibody;
-  int32 flg1, flg2;
-  double xx[6], xx0[6], dx[3], dt, t, dtsave_for_defl;
-  double xobs[6], xobs2[6];
-  double xearth[6], xsun[6], xcom[6];
-  double xxsp[6], xxsv[6];
-  struct plan_data *pedp = &swed.pldat[SEI_EARTH];
-  struct plan_data *pdp;
-  struct epsilon *oe = &swed.oec2000;
-  int32 epheflag = iflag & SEFLG_EPHMASK;
-  dtsave_for_defl = 0;	
-  /* ephemeris file */
-  if (ipli > SE_PLMOON_OFFSET || ipli > SE_AST_OFFSET) { // 2nd condition obsolete
-    ifno = SEI_FILE_ANY_AST;	
-    ibody = IS_ANY_BODY;
-    pdp = &swed.pldat[SEI_ANYBODY];
-  } else if (ipli == SEI_CHIRON
-      || ipli == SEI_PHOLUS
-      || ipli == SEI_CERES
-      || ipli == SEI_PALLAS
-      || ipli == SEI_JUNO
-      || ipli == SEI_VESTA) {
-    ifno = SEI_FILE_MAIN_AST;	
-    ibody = IS_MAIN_ASTEROID;
-    pdp = &swed.pldat[ipli];
+  int32 i, n = 0;
+  for (i = 0; i < remote.nblocks; i++)
+    if (remote.blocks[i].ifile >= 0)
+      n++;
+  remote.stat[SE_REMOTE_STAT_CACHED] = n;
+  for (i = 0; i < SE_REMOTE_NSTAT; i++)
+    dstat[i] = remote.stat[i];
+  n = 0;
+  for (i = 0; i < remote.nfiles; i++)
+    if (remote.files[i].fsize > 0)
+      n++;
+  return n;
+}
+
+/*
+ * Packed ephemeris files.
+ * An archive SE_ASTPACKFILE in the ephemeris path may contain any number
+ * of .se1 files (typically thousands of asteroid files), built with the
+ * tool swepack. Format, all integers little-endian:
+ *   8 bytes	magic "SEPACK01"
+ *   4 bytes	number of members n
+ *   4 bytes	reserved
+ *   n * 32	index, sorted by member name:
+ *		16 bytes name (file name without directory, zero-padded),
+ *		 8 bytes offset of member in archive, 4 bytes length,
+ *		 4 bytes reserved
+ *   member files, unchanged
+ * The index is read once per ephemeris path. A member is opened without
+ * any directory search, as a stream on the archive, and is read by
+ * read_const() and get_new_segment() like a separate file.
+ */
+#define PACK_MAGIC	"SEPACK01"
+#define PACK_HDRSIZE	16
+#define PACK_ENTSIZE	32
+#define PACK_NAMSIZE	16
+struct pack_entry {
+  char name[PACK_NAMSIZE];
+  int64 offset;
+  int32 length;
+};
+struct pack_cookie {
+  int32 ient;
+  int64 pos;
+};
+static TLS struct {
+  int32 state;		/* 0 = not searched, 1 = not available, 2 = loaded */
+  char path[AS_MAXCH];	/* ephemeris path it was searched in */
+  FILE *fp;
+  int32 nent;
+  struct pack_entry *ent;
+} pack = {0, "", NULL, 0, NULL};
+
+static void pack_free(void)
+{
+  if (pack.fp != NULL)
+    fclose(pack.fp);
+  if (pack.ent != NULL)
+    free(pack.ent);
+  pack.fp = NULL;
+  pack.ent = NULL;
+  pack.nent = 0;
+  pack.state = 0;
+  *pack.path = '\0';
+}
+
+static uint32 pack_uint32(unsigned char *c)
+{
+  return (uint32) c[0] | ((uint32) c[1] << 8) | ((uint32) c[2] << 16) | ((uint32) c[3] << 24);
+}
+
+static int CMP_CALL_CONV pack_entry_compare(const void *a, const void *b)
+{
+  return strcmp(((const struct pack_entry *) a)->name, ((const struct pack_entry *) b)->name);
+}
+
+/* reads the index of the archive, if there is one in ephepath */
+static AS_BOOL pack_load(char *ephepath)
+{
+  int32 i;
+  unsigned char hdr[PACK_HDRSIZE], *buf;
+  if (pack.state != 0 && strcmp(pack.path, ephepath) == 0)
+    return pack.state == 2;
+  pack_free();
+  strcpy(pack.path, ephepath);
+  /* state 1 during the search also prevents recursion through swi_fopen() */
+  pack.state = 1;
+  if ((pack.fp = swi_fopen(-1, SE_ASTPACKFILE, ephepath, NULL)) == NULL)
+    return FALSE;
+  if (fread((void *) hdr, PACK_HDRSIZE, 1, pack.fp) != 1 
+    || strncmp((char *) hdr, PACK_MAGIC, 8) != 0
+    || (pack.nent = (int32) pack_uint32(hdr + 8)) <= 0)
+    goto not_available;
+  buf = (unsigned char *) malloc((size_t) pack.nent * PACK_ENTSIZE);
+  pack.ent = (struct pack_entry *) malloc((size_t) pack.nent * sizeof(struct pack_entry));
+  if (buf == NULL || pack.ent == NULL 
+    || fread((void *) buf, PACK_ENTSIZE, (size_t) pack.nent, pack.fp) != (size_t) pack.nent) {
+    if (buf != NULL) free(buf);
+    goto not_available;
+  }
+  for (i = 0; i < pack.nent; i++) {
+    unsigned char *c = buf + i * PACK_ENTSIZE;
+    memcpy(pack.ent[i].name, c, PACK_NAMSIZE);
+    pack.ent[i].name[PACK_NAMSIZE - 1] = '\0';
+    pack.ent[i].offset = (int64) pack_uint32(c + 16) | ((int64) pack_uint32(c + 20) << 32);
+    pack.ent[i].length = (int32) pack_uint32(c + 24);
+  }
+  free(buf);
+  pack.state = 2;
+  return TRUE;
+not_available:
+  pack_free();
+  strcpy(pack.path, ephepath);
+  pack.state = 1;
+  return FALSE;
+}
+
+#ifdef SE_FILE_COOKIES
+static ssize_t pack_read(void *cookie, char *buf, size_t size)
+{
+  struct pack_cookie *pc = (struct pack_cookie *) cookie;
+  struct pack_entry *pe = &pack.ent[pc->ient];
+  size_t n;
+  if (pc->pos >= pe->length)
+    return 0;
+  if ((int64) size > pe->length - pc->pos)
+    size = (size_t) (pe->length - pc->pos);
+  if (fseeko(pack.fp, (off_t) (pe->offset + pc->pos), SEEK_SET) != 0)
+    return -1;
+  n = fread((void *) buf, 1, size, pack.fp);
+  pc->pos += n;
+  return (ssize_t) n;
+}
+
+static int pack_seek(void *cookie, file_off_t *offset, int whence)
+{
+  struct pack_cookie *pc = (struct pack_cookie *) cookie;
+  int64 pos;
+  switch (whence) {
+    case SEEK_SET: pos = *offset; break;
+    case SEEK_CUR: pos = pc->pos + *offset; break;
+    case SEEK_END: pos = pack.ent[pc->ient].length + *offset; break;
+    default: return -1;
+  }
+  if (pos < 0)
+    return -1;
+  pc->pos = pos;
+  *offset = (file_off_t) pos;
+  return 0;
+}
+#endif /* SE_FILE_COOKIES */
+
+/* opens member fname of the archive, if present; fnamp receives
+ * archive name and member name, e.g. "ephe/seastpak.bin/se00433s.se1" */
+static FILE *pack_fopen(char *fname, char *fnamp, char *ephepath)
+{
+#ifdef SE_FILE_COOKIES
+  struct pack_entry key, *pe;
+  struct pack_cookie *pc;
+  cookie_io_functions_t iofunc = {pack_read, NULL, pack_seek, cookie_close};
+  char *sp;
+  FILE *fp;
+  size_t len = strlen(fname);
+  /* only ephemeris files, and only in the current ephemeris path; 
+   * the JPL file is searched in its own path */
+  if (len < 4 || strcmp(fname + len - 4, "." SE_FILE_SUFFIX) != 0
+    || strcmp(ephepath, swed.ephepath) != 0)
+    return NULL;
+  if (!pack_load(ephepath))
+    return NULL;
+  if ((sp = strrchr(fname, (int) *DIR_GLUE)) == NULL)
+    sp = fname;
+  else
+    sp++;
+  if (strlen(sp) >= PACK_NAMSIZE)
+    return NULL;
+  strcpy(key.name, sp);
+  pe = (struct pack_entry *) bsearch((void *) &key, (void *) pack.ent, (size_t) pack.nent, sizeof(struct pack_entry), pack_entry_compare);
+  if (pe == NULL)
+    return NULL;
+  if ((pc = (struct pack_cookie *) calloc(1, sizeof(struct pack_cookie))) == NULL)
+    return NULL;
+  pc->ient = (int32) (pe - pack.ent);
+  if ((fp = fopencookie(pc, BFILE_R_ACCESS, iofunc)) == NULL) {
+    free(pc);
+    return NULL;
+  }
+  if (strlen(ephepath) + strlen(SE_ASTPACKFILE) + strlen(sp) + 2 < AS_MAXCH)
+    sprintf(fnamp, "%s%s%s%s", ephepath, SE_ASTPACKFILE, DIR_GLUE, sp);
+  else
+    strcpy(fnamp, sp);
+  return fp;
+#else
+  return NULL;
+#endif
+}
+
+/*
+ * Segment prefetch.
+ * Time series step through the Chebyshev segments of a body one after
+ * the other. When get_new_segment() has read the same body's segments
+ * sequentially twice, in either direction, the file range of the next
+ * segprf.nahead segments is announced to the operating system with
+ * posix_fadvise(), which reads it into the page cache in the background
+ * while the current segment is used. Streams without a file descriptor
+ * (remote and packed files) are only prefetched by swe_ephe_prefetch(),
+ * which reads a given time range through the stream, so that the
+ * remote blocks are in the block cache before a time series starts.
+ */
+#define SEG_PREFETCH_MAX	64
+static TLS struct {
+  int32 nahead;		/* segments to prefetch, 0 = off */
+  struct seg_access {
+    FILE *fp;		/* file the following refers to */
+    int32 last;		/* last segment read */
+    int32 dir, run;	/* direction and length of sequential run */
+    int32 lo, hi;	/* prefetched segments */
+  } body[SEI_NPLANETS];
+} segprf;
+
+/* file position of segment iseg of body pdp, from the segment index */
+static int32 seg_fpos(struct plan_data *pdp, int ifno, int32 iseg, int32 *fpos)
+{
+  struct file_data *fdp = &swed.fidat[ifno];
+  int freord  = (int) fdp->iflg & SEI_FILE_REORD;
+  int fendian = (int) fdp->iflg & SEI_FILE_LITENDIAN;
+  *fpos = 0;
+  return do_fread((void *) fpos, 3, 1, 4, fdp->fptr, pdp->lndx0 + iseg * 3, freord, fendian, ifno, NULL);
+}
+
+/* brings segments i0..i1 of body pdp into the cache; if read_through,
+ * streams without file descriptor are read, otherwise skipped */
+static int32 seg_fetch(struct plan_data *pdp, int ifno, int32 i0, int32 i1, AS_BOOL read_through)
+{
+  FILE *fp = swed.fidat[ifno].fptr;
+  int32 fpos0, fpos1;
+  char buf[4096];
+  size_t n;
+  if (i0 < 0) i0 = 0;
+  if (i1 > pdp->nndx - 1) i1 = pdp->nndx - 1;
+  if (i1 < i0 || seg_fpos(pdp, ifno, i0, &fpos0) != OK)
+    return 0;
+  /* end: start of next segment, or some bytes for the last one */
+  if (i1 + 1 < pdp->nndx) {
+    if (seg_fpos(pdp, ifno, i1 + 1, &fpos1) != OK)
+      return 0;
   } else {
-    ifno = SEI_FILE_PLANET;
-    ibody = IS_PLANET;
-    pdp = &swed.pldat[ipli];
+    fpos1 = fpos0 + (i1 - i0 + 1) * pdp->ncoe * 3 * 4;
   }
-  t = pdp->teval;
-  /* if the same conversions have already been done for the same 
-   * date, then return */
+  if (fpos1 <= fpos0)
+    return 0;
+#ifdef SE_FILE_ADVISE
+  if (fileno(fp) >= 0) {
+    posix_fadvise(fileno(fp), (off_t) fpos0, (off_t) (fpos1 - fpos0), POSIX_FADV_WILLNEED);
+    return i1 - i0 + 1;
+  }
+#endif
+  if (!read_through)
+    return 0;
+  if (fseek(fp, fpos0, SEEK_SET) != 0)
+    return 0;
+  while (fpos0 < fpos1) {
+    n = (size_t) (fpos1 - fpos0) < sizeof(buf) ? (size_t) (fpos1 - fpos0) : sizeof(buf);
+    if (fread((void *) buf, 1, n, fp) != n)
+      break;
+    fpos0 += (int32) n;
+  }
+  return i1 - i0 + 1;
+}
+
+/* called by get_new_segment() after segment iseg of body ipli was read */
+static void seg_prefetch(int ipli, int ifno, int32 iseg)
+{
+  struct plan_data *pdp = &swed.pldat[ipli];
+  struct seg_access *sa = &segprf.body[ipli];
+  int32 dir, i0, i1, lo, hi, n;
+  if (sa->fp != swed.fidat[ifno].fptr) {
+    memset((void *) sa, 0, sizeof(struct seg_access));
+    sa->fp = swed.fidat[ifno].fptr;
+    sa->last = -2;
+    sa->lo = 1;	/* empty */
+  }
+  if (iseg >= sa->lo && iseg <= sa->hi)
+    remote.stat[SE_REMOTE_STAT_PREFETCH_HITS]++;
+  dir = iseg - sa->last;
+  sa->last = iseg;
+  if (dir != 1 && dir != -1) {
+    sa->run = 0;
+    return;
+  }
+  if (dir == sa->dir) {
+    sa->run++;
+  } else {
+    sa->dir = dir;
+    sa->run = 1;
+  }
+  if (segprf.nahead <= 0 || sa->run < 2)
+    return;
+  /* the next nahead segments, without those already prefetched */
+  lo = sa->lo;
+  hi = sa->hi;
+  if (dir > 0) {
+    i0 = iseg + 1;
+    i1 = iseg + segprf.nahead;
+    if (i1 <= hi)
+      return;
+    if (i0 >= lo && i0 <= hi)
+      i0 = hi + 1;
+    else
+      lo = i0;
+    hi = i1;
+  } else {
+    i0 = iseg - segprf.nahead;
+    i1 = iseg - 1;
+    if (i0 >= lo)
+      return;
+    if (i1 >= lo && i1 <= hi)
+      i1 = lo - 1;
+    else
+      hi = i1;
+    lo = i0;
+  }
+  if ((n = seg_fetch(pdp, ifno, i0, i1, FALSE)) == 0)
+    return;
+  sa->lo = lo;
+  sa->hi = hi;
+  remote.stat[SE_REMOTE_STAT_PREFETCH] += n;
+}
+
+/* number of segments to prefetch in sequential access, 0 = off
+ * (default), up to SEG_PREFETCH_MAX */
+void CALL_CONV swe_set_ephe_prefetch(int32 nseg)
+{
+  if (nseg < 0) nseg = 0;
+  if (nseg > SEG_PREFETCH_MAX) nseg = SEG_PREFETCH_MAX;
+  segprf.nahead = nseg;
+}
+
+/* Prefetches the ephemeris segments that bodies ipl[0..nbody-1], and
+ * the earth, sun and moon needed with them, use from tjd_start through
+ * tjd_end (TT), within the files that cover tjd_start. Native files are
+ * announced to the operating system, remote and packed files are read
+ * into their caches (the remote block cache must be large enough).
+ * Only for the Swiss Ephemeris files.
+ * returns number of segments prefetched, or ERR
+ */
+int32 CALL_CONV swe_ephe_prefetch(double tjd_start, double tjd_end, int32 *ipl, int32 nbody, int32 iflag, char *serr)
+{
+  int32 i, ipli, ifno, i0, i1, k, n = 0, done = 0;
+  double x[6];
+  struct plan_data *pdp;
+  struct seg_access *sa;
+  if (iflag & (SEFLG_MOSEPH | SEFLG_JPLEPH))
+    return 0;
+  if (tjd_end < tjd_start) {
+    double t = tjd_start; tjd_start = tjd_end; tjd_end = t;
+  }
+  for (i = 0; i < nbody; i++) {
+    if (swe_calc(tjd_start, ipl[i], iflag, x, serr) == ERR)
+      return ERR;
+    /* segments now loaded: of the body and of earth, sun and moon */
+    for (ipli = 0; ipli < SEI_NPLANETS; ipli++) {
+      pdp = &swed.pldat[ipli];
+      if (pdp->segp == NULL || pdp->dseg <= 0 || (done & (1 << ipli)))
+	continue;
+      if (ipli == SEI_MOON)
+	ifno = SEI_FILE_MOON;
+      else if (ipli <= SEI_SUNBARY)
+	ifno = SEI_FILE_PLANET;
+      else if (ipli == SEI_ANYBODY)
+	ifno = SEI_FILE_ANY_AST;
+      else
+	ifno = SEI_FILE_MAIN_AST;
+      if (swed.fidat[ifno].fptr == NULL)
+	continue;
+      if (ipli != SEI_ANYBODY)	/* the next body may be another asteroid */
+	done |= (1 << ipli);
+      i0 = (int32) ((tjd_start - pdp->tfstart) / pdp->dseg);
+      i1 = (int32) ((tjd_end - pdp->tfstart) / pdp->dseg);
+      if ((k = seg_fetch(pdp, ifno, i0, i1, TRUE)) == 0)
+	continue;
+      n += k;
+      /* for the hit count of get_new_segment() */
+      sa = &segprf.body[ipli];
+      if (sa->fp != swed.fidat[ifno].fptr) {
+	memset((void *) sa, 0, sizeof(struct seg_access));
+	sa->fp = swed.fidat[ifno].fptr;
+	sa->last = -2;
+      }
+      sa->lo = i0;
+      sa->hi = i1;
+    }
+  }
+  remote.stat[SE_REMOTE_STAT_PREFETCH] += n;
+  return n;
+}
+
+/*
+ * Asteroid cache.
+ * All asteroid files share one file slot (swed.fidat[SEI_FILE_ANY_AST])
+ * and one planet slot (swed.pldat[SEI_ANYBODY]). When a calculation 
+ * switches to another asteroid, sweph() parks the open file together 
+ * with its header constants and current segment here, instead of 
+ * closing it. Switching back restores it without any file access.
+ */
+#define AST_CACHE_SIZE	32
+static TLS struct ast_cache {
+  int ibdy;		/* 0 = unused */
+  uint32 used;
+  struct file_data fd;
+  struct plan_data pd;
+  char astelem[AS_MAXCH * 10];
+  double ast_H, ast_G, ast_diam;
+} astc[AST_CACHE_SIZE];
+static TLS uint32 astc_clock;
+
+static void ast_cache_entry_free(struct ast_cache *ac)
+{
+  if (ac->fd.fptr != NULL)
+    fclose(ac->fd.fptr);
+  if (ac->pd.refep != NULL)
+    free((void *) ac->pd.refep);
+  if (ac->pd.segp != NULL)
+    free((void *) ac->pd.segp);
+  memset((void *) ac, 0, sizeof(struct ast_cache));
+}
+
+static void ast_cache_free(void)
+{
+  int i;
+  for (i = 0; i < AST_CACHE_SIZE; i++)
+    if (astc[i].ibdy != 0)
+      ast_cache_entry_free(&astc[i]);
+}
+
+/* moves the open asteroid file and its data into the cache */
+static void ast_cache_put(void)
+{
+  int i, islot = 0;
+  struct file_data *fdp = &swed.fidat[SEI_FILE_ANY_AST];
+  struct plan_data *pdp = &swed.pldat[SEI_ANYBODY];
+  for (i = 0; i < AST_CACHE_SIZE; i++) {
+    if (astc[i].ibdy == 0 || astc[i].ibdy == pdp->ibdy) {
+      islot = i;
+      break;
+    }
+    if (astc[i].used < astc[islot].used)
+      islot = i;
+  }
+  if (astc[islot].ibdy != 0)
+    ast_cache_entry_free(&astc[islot]);
+  astc[islot].ibdy = pdp->ibdy;
+  astc[islot].used = ++astc_clock;
+  astc[islot].fd = *fdp;
+  astc[islot].pd = *pdp;
+  strcpy(astc[islot].astelem, swed.astelem);
+  astc[islot].ast_H = swed.ast_H;
+  astc[islot].ast_G = swed.ast_G;
+  astc[islot].ast_diam = swed.ast_diam;
+  fdp->fptr = NULL;
+  pdp->refep = NULL;
+  pdp->segp = NULL;
+}
+
+/* restores asteroid ipli from the cache, if its file covers tjd */
+static AS_BOOL ast_cache_get(int ipli, double tjd)
+{
+  int i;
+  struct plan_data *pdp = &swed.pldat[SEI_ANYBODY];
+  for (i = 0; i < AST_CACHE_SIZE; i++) {
+    if (astc[i].ibdy == ipli && tjd >= astc[i].fd.tfstart && tjd <= astc[i].fd.tfend) {
+      if (pdp->refep != NULL)
+        free((void *) pdp->refep);
+      if (pdp->segp != NULL)
+        free((void *) pdp->segp);
+      swed.fidat[SEI_FILE_ANY_AST] = astc[i].fd;
+      *pdp = astc[i].pd;
+      pdp->teval = 0;
+      pdp->xflgs = -1;
+      strcpy(swed.astelem, astc[i].astelem);
+      swed.ast_H = astc[i].ast_H;
+      swed.ast_G = astc[i].ast_G;
+      swed.ast_diam = astc[i].ast_diam;
+      memset((void *) &astc[i], 0, sizeof(struct ast_cache));
+      return TRUE;
+    }
+  }
+  return FALSE;
+}
+
+int32 swi_get_denum(int32 ipli, int32 iflag)
+{
+  struct file_data *fdp = NULL;
+  if (iflag & SEFLG_MOSEPH)
+    return 403;
+  if (iflag & SEFLG_JPLEPH) {
+    if (swed.jpldenum > 0) {
+      return swed.jpldenum;
+    } else {
+      return SE_DE_NUMBER;
+    }
+  }
+  if (ipli > SE_AST_OFFSET) {
+    fdp = &swed.fidat[SEI_FILE_ANY_AST];
+  } else if (ipli > SE_PLMOON_OFFSET) {
+    fdp = &swed.fidat[SEI_FILE_ANY_AST];
+  } else if (ipli == SEI_CHIRON
+      || ipli == SEI_PHOLUS
+      || ipli == SEI_CERES
+      || ipli == SEI_PALLAS
+      || ipli == SEI_JUNO
+      || ipli == SEI_VESTA) {
+    fdp = &swed.fidat[SEI_FILE_MAIN_AST];
+  } else if (ipli == SEI_MOON) {
+    fdp = &swed.fidat[SEI_FILE_MOON];
+  } else {
+    fdp = &swed.fidat[SEI_FILE_PLANET];
+  }
+  if (fdp != NULL) {
+    if (fdp->sweph_denum != 0) {
+      return fdp->sweph_denum;
+    } else {
+      return SE_DE_NUMBER;
+    }
+  }
+  return SE_DE_NUMBER;
+}
+
+static int calc_center_body(int32 ipli, int32 iflag, double *xx, double *xcom, char *serr)
+{
+  int i;
+  if (!(iflag & SEFLG_CENTER_BODY))
+    return OK;
+  if (ipli < SEI_MARS || ipli > SEI_PLUTO)
+    return OK;
+  for (i = 0; i <= 5; i++)
+    xx[i] += xcom[i];
+  return OK;
+}
+
+/* converts planets from barycentric to geocentric,
+ * apparent positions
+ * precession and nutation
+ * according to flags
+ * ipli		planet number
+ * iflag	flags
+ * serr         error string
+ */
+/* light-time mode of app_pos_etc_plan(), see swe_set_light_time_mode() */
+static TLS int32 ltime_mode = SE_LTIME_ITERATE;
+
+/* Light-time correction in one step (SE_LTIME_ONESTEP).
+ * The iteration in app_pos_etc_plan() solves dt = |x - dt * v - xobs| / c,
+ * where x and v are the barycentric position and speed of the planet at
+ * pdp->teval and xobs is the observer. Squaring gives a quadratic 
+ * equation in dt, of which the positive root is taken. This is the limit
+ * of the iteration; after its two steps, the position may still differ
+ * from it by 0.00001".
+ * dx = x - xobs
+ */
+static double light_time_solve(double *dx, double *v)
+{
+  double c = CLIGHT * 86400.0 / AUNIT;	/* au per day */
+  double d2 = square_sum(dx);
+  double dv = dot_prod(dx, v);
+  double a = c * c - square_sum(v);
+  if (d2 == 0)
+    return 0;
+  /* dt = (-dv + sqrt(dv^2 + a d2)) / a, without cancellation */
+  return d2 / (dv + sqrt(dv * dv + a * d2));
+}
+
+/* Planet at t = pdp->teval - dt from the Chebyshev segment in memory,
+ * instead of sweplan(), which also evaluates sun, earth-moon barycenter
+ * and moon. If the planet is heliocentric on the file, the barycentric
+ * sun at t is taken from its position and speed at pdp->teval; the 
+ * error is below 0.000001". The speed of the earth at t, which is only
+ * needed for the aberration part of the apparent speed, is computed 
+ * from its acceleration by sun and moon.
+ * Returns FALSE, if the segment does not contain t or sun, earth and
+ * moon at pdp->teval are not available; then sweplan() is used.
+ */
+static AS_BOOL light_time_cheb(double t, double dt, struct plan_data *pdp, int32 iflag, double *xx, double *xearth)
+{
+  int i;
+  double tc, r, xse[3], xm[3], gms, gmm;
+  struct plan_data *pedp = &swed.pldat[SEI_EARTH];
+  struct plan_data *psbdp = &swed.pldat[SEI_SUNBARY];
+  struct plan_data *pmdp = &swed.pldat[SEI_MOON];
+  AS_BOOL need_speed = (iflag & SEFLG_SPEED) ? TRUE : FALSE;
+  AS_BOOL helio = ((pdp->iflg & SEI_FLG_HELIO) || pdp - swed.pldat >= SEI_ANYBODY);
+  if (pdp->segp == NULL || t < pdp->tseg0 || t > pdp->tseg1)
+    return FALSE;
+  if (psbdp->teval != pdp->teval || psbdp->iephe != SEFLG_SWIEPH)
+    return FALSE;
+  if (need_speed && (pedp->teval != pdp->teval || pedp->iephe != SEFLG_SWIEPH
+    || pmdp->teval != pdp->teval || pmdp->iephe != SEFLG_SWIEPH))
+    return FALSE;
+  /* the ephemerides of sun, earth-moon barycenter and moon jump by up 
+   * to 1 km at the boundaries of their segments. if t and pdp->teval 
+   * are not in the same segments of those needed, sweplan() is used. */
+  if ((helio || need_speed) 
+    && (pedp->segp == NULL || t < pedp->tseg0 || pdp->teval > pedp->tseg1))
+    return FALSE;
+  if (helio
+    && (psbdp->segp == NULL || t < psbdp->tseg0 || pdp->teval > psbdp->tseg1))
+    return FALSE;
+  if (need_speed
+    && (pmdp->segp == NULL || t < pmdp->tseg0 || pdp->teval > pmdp->tseg1))
+    return FALSE;
+  /* evaluate chebyshew polynomial for t, as in sweph() */
+  tc = (t - pdp->tseg0) / pdp->dseg;
+  tc = tc * 2 - 1;
+  for (i = 0; i <= 2; i++) {
+    xx[i]  = swi_echeb (tc, pdp->segp+(i*pdp->ncoe), pdp->neval);
+    if (need_speed) 
+      xx[i+3] = swi_edcheb(tc, pdp->segp+(i*pdp->ncoe), pdp->neval) / pdp->dseg * 2;
+    else
+      xx[i+3] = 0;
+  }
+  /* heliocentric planets and asteroids to barycentric */
+  if (helio) {
+    for (i = 0; i <= 2; i++) 
+      xx[i] += psbdp->x[i] - dt * psbdp->x[i+3];
+    if (need_speed)
+      for (i = 3; i <= 5; i++) 
+	xx[i] += psbdp->x[i];
+  }
+  if (!need_speed)
+    return TRUE;
+  /* earth at t; only its speed is used. the acceleration is taken
+   * halfway between pdp->teval and t, with sun and moon moved linearly */
+  gms = HELGRAVCONST * 86400.0 * 86400.0 / AUNIT / AUNIT / AUNIT;
+  gmm = GEOGCONST / EARTH_MOON_MRAT * 86400.0 * 86400.0 / AUNIT / AUNIT / AUNIT;
+  for (i = 0; i <= 2; i++) {
+    xse[i] = pedp->x[i] - psbdp->x[i] - dt / 2 * (pedp->x[i+3] - psbdp->x[i+3]);
+    xm[i] = pmdp->x[i] - dt / 2 * pmdp->x[i+3];
+  }
+  r = sqrt(square_sum(xse));
+  gms /= r * r * r;
+  r = sqrt(square_sum(xm));
+  gmm /= r * r * r;
+  for (i = 0; i <= 2; i++) {
+    xearth[i] = pedp->x[i] - dt * pedp->x[i+3];
+    xearth[i+3] = pedp->x[i+3] + dt * (gms * xse[i] - gmm * xm[i]);
+  }
+  return TRUE;
+}
+
+/* Light-time correction of planets and asteroids (main and numbered
+ * ones, not planetary moons) with the Swiss Ephemeris files, for
+ * geocentric and topocentric positions.
+ * mode		SE_LTIME_ITERATE = iteration and new computation of
+ *		planet, sun, earth and moon for t - dt (default),
+ *		SE_LTIME_ONESTEP = dt solved directly and only the 
+ *		planet evaluated for t - dt, in its Chebyshev segment.
+ *		Positions agree with the iteration within 0.00001",
+ *		geocentric speeds within 0.0002"/day; topocentric
+ *		speeds are closer to a converged iteration than the
+ *		two steps of SE_LTIME_ITERATE, from which they differ
+ *		by up to 0.15"/day.
+ */
+void CALL_CONV swe_set_light_time_mode(int32 mode)
+{
+  if (mode != SE_LTIME_ONESTEP)
+    mode = SE_LTIME_ITERATE;
+  if (mode != ltime_mode) 
+    swi_force_app_pos_etc();
+  ltime_mode = mode;
+}
+
+static int app_pos_etc_plan(int ipli, int iplmoon, int32 iflag, char *serr)
+{
+  int i, j, niter, retc = OK;
+  int ipl, ifno, ibody;
+  int32 flg1, flg2;
+  AS_BOOL onestep = FALSE;
+  double xx[6], xx0[6], dx[3], dt, t, dtsave_for_defl;
+  double xobs[6], xobs2[6];
+  double xearth[6], xsun[6], xcom[6];
+  double xxsp[6], xxsv[6];
+  struct plan_data *pedp = &swed.pldat[SEI_EARTH];
+  struct plan_data *pdp;
+  struct epsilon *oe = &swed.oec2000;
+  int32 epheflag = iflag & SEFLG_EPHMASK;
+  dtsave_for_defl = 0;	
+  /* ephemeris file */
+  if (ipli > SE_PLMOON_OFFSET || ipli > SE_AST_OFFSET) { // 2nd condition obsolete
+    ifno = SEI_FILE_ANY_AST;	
+    ibody = IS_ANY_BODY;
+    pdp = &swed.pldat[SEI_ANYBODY];
+  } else if (ipli == SEI_CHIRON
+      || ipli == SEI_PHOLUS
+      || ipli == SEI_CERES
+      || ipli == SEI_PALLAS
+      || ipli == SEI_JUNO
+      || ipli == SEI_VESTA) {
+    ifno = SEI_FILE_MAIN_AST;	
+    ibody = IS_MAIN_ASTEROID;
+    pdp = &swed.pldat[ipli];
+  } else {
+    ifno = SEI_FILE_PLANET;
+    ibody = IS_PLANET;
+    pdp = &swed.pldat[ipli];
+  }
+  t = pdp->teval;
+  /* if the same conversions have already been done for the same 
+   * date, then return */
   flg1 = iflag & ~SEFLG_EQUATORIAL & ~SEFLG_XYZ;
   flg2 = pdp->xflgs & ~SEFLG_EQUATORIAL & ~SEFLG_XYZ;
   if (flg1 == flg2) {
@@ -2548,6 +3749,14 @@ static int app_pos_etc_plan(int ipli, int iplmoon, int32 iflag, char *serr)
     } else { 	/* SEFLG_MOSEPH or planet from osculating elements */
       niter = 0;
     }
+    /* light-time in one step, see light_time_solve() */
+    if (ltime_mode == SE_LTIME_ONESTEP && epheflag == SEFLG_SWIEPH
+      && pdp->iephe == SEFLG_SWIEPH
+      && !(ipli > SE_PLMOON_OFFSET && ipli < SE_AST_OFFSET)
+      && !(iflag & (SEFLG_HELCTR | SEFLG_BARYCTR | SEFLG_CENTER_BODY))) {
+      onestep = TRUE;
+      niter = 0;
+    }
     if (iflag & SEFLG_SPEED) {
       /* 
        * Apparent speed is influenced by the fact that dt changes with
@@ -2567,7 +3776,10 @@ static int app_pos_etc_plan(int ipli, int iplmoon, int32 iflag, char *serr)
 	    dx[i] -= (xobs[i] - xobs[i+3]);
 	}
 	/* new dt */
-	dt = sqrt(square_sum(dx)) * AUNIT / CLIGHT / 86400.0;     
+	if (onestep)
+	  dt = light_time_solve(dx, xx0 + 3);
+	else
+	  dt = sqrt(square_sum(dx)) * AUNIT / CLIGHT / 86400.0;     
 	for (i = 0; i <= 2; i++) { 	/* rough apparent position at t-1 */
 	  //xxsp[i] = xxsv[i] - dt * pdp->x[i+3];
 	  xxsp[i] = xxsv[i] - dt * xx0[i+3];
@@ -2584,7 +3796,10 @@ static int app_pos_etc_plan(int ipli, int iplmoon, int32 iflag, char *serr)
 	if (!(iflag & SEFLG_HELCTR) && !(iflag & SEFLG_BARYCTR))
 	  dx[i] -= xobs[i];
       }
-      dt = sqrt(square_sum(dx)) * AUNIT / CLIGHT / 86400.0;    
+      if (onestep)
+	dt = light_time_solve(dx, xx0 + 3);
+      else
+	dt = sqrt(square_sum(dx)) * AUNIT / CLIGHT / 86400.0;    
       /* new t */
       t = pdp->teval - dt;
       dtsave_for_defl = dt;
@@ -2645,7 +3860,9 @@ static int app_pos_etc_plan(int ipli, int iplmoon, int32 iflag, char *serr)
 	}
 	break;
       case SEFLG_SWIEPH:
-	if (ibody == IS_PLANET) {
+	if (onestep && light_time_cheb(t, dt, pdp, iflag, xx, xearth)) {
+	  retc = OK;
+	} else if (ibody == IS_PLANET) {
 	  retc = sweplan(t, ipli, ifno, iflag, NO_SAVE, xx, xearth, xsun, NULL, serr);
 	} else { 		/*asteroid*/
 	  retc = sweplan(t, SEI_EARTH, SEI_FILE_PLANET, iflag, NO_SAVE, xearth, NULL, xsun, NULL, serr);
@@ -3047,7 +4264,7 @@ int32 swi_get_ayanamsa_ex(double tjd_et, int32 iflag, double *daya, char *serr)
     swe_set_sid_mode(SE_SIDM_FAGAN_BRADLEY, 0, 0);
   if (sid_mode == SE_SIDM_TRUE_CITRA) {
     strcpy(star, "Spica"); /* Citra */
-    if ((retflag = swe_fixstar(star, tjd_et, iflag_true, x, serr)) == ERR) {
+    if ((retflag = swe_fixstar2(star, tjd_et, iflag_true, x, serr)) == ERR) {
       return ERR; 
     }
     /*fprintf(stderr, "serr=%s\n", serr);*/
@@ -3056,35 +4273,35 @@ int32 swi_get_ayanamsa_ex(double tjd_et, int32 iflag, double *daya, char *serr)
   }
   if (sid_mode == SE_SIDM_TRUE_REVATI) {
     strcpy(star, ",zePsc"); /* Revati */
-    if ((retflag = swe_fixstar(star, tjd_et, iflag_true, x, serr)) == ERR)
+    if ((retflag = swe_fixstar2(star, tjd_et, iflag_true, x, serr)) == ERR)
       return ERR;
     *daya = swe_degnorm(x[0] - 359.8333333333);
     return (retflag & SEFLG_EPHMASK);
   }
   if (sid_mode == SE_SIDM_TRUE_PUSHYA) {
     strcpy(star, ",deCnc"); /* Pushya = Asellus Australis */
-    if ((retflag = swe_fixstar(star, tjd_et, iflag_true, x, serr)) == ERR)
+    if ((retflag = swe_fixstar2(star, tjd_et, iflag_true, x, serr)) == ERR)
       return ERR;
     *daya = swe_degnorm(x[0] - 106);
     return (retflag & SEFLG_EPHMASK);
   }
   if (sid_mode == SE_SIDM_TRUE_SHEORAN) {
     strcpy(star, ",deCnc"); /* Asellus Australis */
-    if ((retflag = swe_fixstar(star, tjd_et, iflag_true, x, serr)) == ERR)
+    if ((retflag = swe_fixstar2(star, tjd_et, iflag_true, x, serr)) == ERR)
       return ERR;
     *daya = swe_degnorm(x[0] - 103.49264221625);
     return (retflag & SEFLG_EPHMASK);
   }
   if (sid_mode == SE_SIDM_TRUE_MULA) {
     strcpy(star, ",laSco"); /* Mula = lambda Scorpionis */
-    if ((retflag = swe_fixstar(star, tjd_et, iflag_true, x, serr)) == ERR)
+    if ((retflag = swe_fixstar2(star, tjd_et, iflag_true, x, serr)) == ERR)
       return ERR;
     *daya = swe_degnorm(x[0] - 240);
     return (retflag & SEFLG_EPHMASK);
   }
   if (sid_mode ==  SE_SIDM_GALCENT_0SAG) {
     strcpy(star, ",SgrA*"); /* Galactic Centre */
-    if ((retflag = swe_fixstar(star, tjd_et, iflag_true, x, serr)) == ERR)
+    if ((retflag = swe_fixstar2(star, tjd_et, iflag_true, x, serr)) == ERR)
       return ERR;
     *daya = swe_degnorm(x[0] - 240.0);
     return (retflag & SEFLG_EPHMASK);
@@ -3092,7 +4309,7 @@ int32 swi_get_ayanamsa_ex(double tjd_et, int32 iflag, double *daya, char *serr)
   }
   if (sid_mode ==  SE_SIDM_GALCENT_COCHRANE) {
     strcpy(star, ",SgrA*"); /* Galactic Centre */
-    if ((retflag = swe_fixstar(star, tjd_et, iflag_true, x, serr)) == ERR)
+    if ((retflag = swe_fixstar2(star, tjd_et, iflag_true, x, serr)) == ERR)
       return ERR;
     *daya = swe_degnorm(x[0] - 270.0);
     return (retflag & SEFLG_EPHMASK);
@@ -3100,7 +4317,7 @@ int32 swi_get_ayanamsa_ex(double tjd_et, int32 iflag, double *daya, char *serr)
   }
   if (sid_mode ==  SE_SIDM_GALCENT_RGILBRAND) {
     strcpy(star, ",SgrA*"); /* Galactic Centre */
-    if ((retflag = swe_fixstar(star, tjd_et, iflag_true, x, serr)) == ERR)
+    if ((retflag = swe_fixstar2(star, tjd_et, iflag_true, x, serr)) == ERR)
       return ERR;
     *daya = swe_degnorm(x[0] - 210.0 - 90.0 * 0.3819660113);
     return (retflag & SEFLG_EPHMASK);
@@ -3110,7 +4327,7 @@ int32 swi_get_ayanamsa_ex(double tjd_et, int32 iflag, double *daya, char *serr)
     strcpy(star, ",SgrA*"); /* Galactic Centre */
     /* right ascension in polar projection onto the ecliptic, 
      * and that point is put in the middle of Mula */
-    if ((retflag = swe_fixstar(star, tjd_et, iflag_true | SEFLG_EQUATORIAL, x, serr)) == ERR)
+    if ((retflag = swe_fixstar2(star, tjd_et, iflag_true | SEFLG_EQUATORIAL, x, serr)) == ERR)
       return ERR;
     eps = swi_epsiln(tjd_et, iflag) * RADTODEG;
     *daya = swi_armc_to_mc(x[0], eps);
@@ -3120,21 +4337,21 @@ int32 swi_get_ayanamsa_ex(double tjd_et, int32 iflag, double *daya, char *serr)
   }
   if (sid_mode == SE_SIDM_GALEQU_IAU1958) {
     strcpy(star, ",GP1958"); /* Galactic Pole IAU 1958 */
-    if ((retflag = swe_fixstar(star, tjd_et, iflag_galequ, x, serr)) == ERR)
+    if ((retflag = swe_fixstar2(star, tjd_et, iflag_galequ, x, serr)) == ERR)
       return ERR;
     *daya = swe_degnorm(x[0] - 150);
     return (retflag & SEFLG_EPHMASK);
   }
   if (sid_mode == SE_SIDM_GALEQU_TRUE) {
     strcpy(star, ",GPol"); /* Galactic Pole modern, true */
-    if ((retflag = swe_fixstar(star, tjd_et, iflag_galequ, x, serr)) == ERR)
+    if ((retflag = swe_fixstar2(star, tjd_et, iflag_galequ, x, serr)) == ERR)
       return ERR;
     *daya = swe_degnorm(x[0] - 150);
     return (retflag & SEFLG_EPHMASK);
   }
   if (sid_mode == SE_SIDM_GALEQU_MULA) {
     strcpy(star, ",GPol"); /* Galactic Pole modern, true */
-    if ((retflag = swe_fixstar(star, tjd_et, iflag_galequ, x, serr)) == ERR)
+    if ((retflag = swe_fixstar2(star, tjd_et, iflag_galequ, x, serr)) == ERR)
       return ERR;
     *daya = swe_degnorm(x[0] - 150 - 6.6666666667);
     return (retflag & SEFLG_EPHMASK);
@@ -3475,7 +4692,10 @@ static int app_pos_etc_plan_osc(int ipl, int ipli, int32 iflag, char *serr)
       t = pdp->teval - dt;
       /* for accuracy in speed, we will need earth as well */
       retc = main_planet_bary(t, SEI_EARTH, epheflag, iflag, NO_SAVE, xearth, xearth, xsun, xmoon, serr);
-      if (swi_osc_el_plan(t, xx, ipl-SE_FICT_OFFSET, ipli, xearth, xsun, serr) != OK)
+      if (ipl > SE_AST_OFFSET) {
+	if (swi_osc_el_ast(t, xx, ipl-SE_AST_OFFSET, ipli, xsun, serr) != OK)
+	  return ERR;
+      } else if (swi_osc_el_plan(t, xx, ipl-SE_FICT_OFFSET, ipli, xearth, xsun, serr) != OK)
 	return ERR;
       if (retc != OK)
 	return(retc);
@@ -4492,6 +5712,7 @@ static int get_new_segment(double tjd, int ipli, int ifno, char *serr)
       }
     }
   }
+  seg_prefetch(ipli, ifno, iseg);
   return(OK);
 return_error_gns:
   fclose(fdp->fptr);
@@ -6710,12 +7931,21 @@ static int32 search_star_in_list(char *sstar, struct fixed_star *stardata, char
     strcpy(searchkey, sstar);
     len = (int) (strlen(sstar) - 1);
     searchkey[len] = '\0';
-    for (i = 0; i < ndata; i++) {
-      if (strncmp(stardatabegp[i].skey, sstar, len) == 0) {
-        *stardata = stardatabegp[i];
-	return OK;
+    /* the names are sorted, so the first one not below the search
+     * string is the first one that may begin with it */
+    i = 0;
+    while (ndata > 0) {
+      if (strcmp(stardatabegp[i + ndata / 2].skey, searchkey) < 0) {
+	i += ndata / 2 + 1;
+	ndata -= ndata / 2 + 1;
+      } else {
+	ndata /= 2;
       }
     }
+    if (i < swed.n_fixstars_named && strncmp(stardatabegp[i].skey, searchkey, len) == 0) {
+      *stardata = stardatabegp[i];
+      return OK;
+    }
     if (serr != NULL)
       sprintf(serr, "error, swe_fixstar(): star search string %s did not match", sstar);
     return ERR;
@@ -6802,6 +8032,66 @@ static AS_BOOL get_builtin_star(char *star, char *sstar, char *srecord)
   return FALSE;
 }
 
+/* cache of star records by search name, shared by swe_fixstar2()
+ * and swe_fixstar2_mag(); heliacal and occultation searches alternate
+ * between a few stars many times */
+#define FIXSTAR_NCACHE	16
+static TLS struct fixstar_cache {
+  char sstar[SWI_STAR_LENGTH + 1];
+  struct fixed_star stardata;
+} fixstar_cache[FIXSTAR_NCACHE];
+static TLS int fixstar_cache_next;
+
+static void fixstar_cache_free(void)
+{
+  memset((void *) fixstar_cache, 0, sizeof(fixstar_cache));
+  fixstar_cache_next = 0;
+}
+
+/* function finds a star by its formatted search name sstar,
+ * in the cache, among the built-in stars or in the star list;
+ * the star file is only read for stars that are not built in
+ */
+static int32 fixstar_find(char *star, char *sstar, struct fixed_star *stardata, char *serr)
+{
+  int i;
+  int32 retc;
+  char skey[SWI_STAR_LENGTH + 1];
+  char sprefix[SWI_STAR_LENGTH + 2];
+  char srecord[AS_MAXCH + 20];	/* 20 byte for SE_STARFILE */
+  for (i = 0; i < FIXSTAR_NCACHE; i++) {
+    if (*fixstar_cache[i].sstar != '\0' && strcmp(fixstar_cache[i].sstar, sstar) == 0) {
+      *stardata = fixstar_cache[i].stardata;
+      return OK;
+    }
+  }
+  strcpy(skey, sstar);
+  if (get_builtin_star(star, sstar, srecord)) {
+    retc = fixstar_cut_string(srecord, NULL, stardata, serr);
+  } else {
+    // loads stars unless loaded with an earlier call of function
+    if (load_all_fixed_stars(serr) == ERR)
+      return ERR;
+    retc = search_star_in_list(sstar, stardata, serr);
+    /* a traditional name that is not in the list may be the beginning
+     * of a name; search it in the loaded list as if it ended with the
+     * wildcard '%'. The star found is cached under the name given. */
+    if (retc == ERR && *sstar != ',' && !isdigit((int) *sstar) && strchr(sstar, '%') == NULL) {
+      if (serr != NULL)
+	*serr = '\0';
+      sprintf(sprefix, "%s%%", sstar);
+      retc = search_star_in_list(sprefix, stardata, serr);
+    }
+  }
+  if (retc == ERR)
+    return ERR;
+  i = fixstar_cache_next;
+  fixstar_cache_next = (i + 1) % FIXSTAR_NCACHE;
+  strcpy(fixstar_cache[i].sstar, skey);
+  fixstar_cache[i].stardata = *stardata;
+  return OK;
+}
+
 /**********************************************************
  * function gets fixstar positions
  * parameters:
@@ -6819,12 +8109,7 @@ int32 CALL_CONV swe_fixstar2(char *star, double tjd, int32 iflag,
   double *xx, char *serr)
 {
   int i;
-  AS_BOOL is_builtin_star = FALSE;
   char sstar[SWI_STAR_LENGTH + 1];
-  //static TLS char slast_stardata[AS_MAXCH];
-  static TLS char slast_starname[AS_MAXCH];
-  static TLS struct fixed_star last_stardata;
-  char srecord[AS_MAXCH + 20];	/* 20 byte for SE_STARFILE */
   int retc;
   struct fixed_star stardata;
   if (serr != NULL)
@@ -6833,33 +8118,11 @@ int32 CALL_CONV swe_fixstar2(char *star, double tjd, int32 iflag,
   swi_open_trace(serr);
   trace_swe_fixstar(1, star, tjd, iflag, xx, serr);
 #endif /* TRACE */
-  load_all_fixed_stars(serr); // loads stars unless loaded with an earlier call of function
   retc = fixstar_format_search_name(star, sstar, serr);
   if (retc == ERR)
     goto return_err;
-  /* star elements from last call: */
-  if (swed.n_fixstars_records > 0 && strcmp(slast_starname, sstar) == 0) {
- //   strcpy(srecord, slast_stardata);
-    stardata = last_stardata;
-    goto found;
-  }
-  if (get_builtin_star(star, sstar, srecord)) {
-    is_builtin_star = TRUE;
-  }
-  if (is_builtin_star) {
-    retc = fixstar_cut_string(srecord, star, &stardata, serr);
-    //printf("builtin: %s, %s, %s, %f\n", stardata.skey, stardata.starname, stardata.starbayer, stardata.mag);
-    goto found;
-  /* sequential fixed star number: get it from array directly */
-  } 
-  retc = search_star_in_list(sstar, &stardata, serr);
-  if (retc == ERR)
+  if ((retc = fixstar_find(star, sstar, &stardata, serr)) == ERR)
     goto return_err;
-  /******************************************************/
-  found:
-  //strcpy(slast_stardata, srecord);
-  last_stardata = stardata;
-  strcpy(slast_starname, sstar);
   if ((retc = fixstar_calc_from_struct(&stardata, tjd, iflag, star, xx, serr)) == ERR)
     goto return_err;
 #ifdef TRACE
@@ -6911,30 +8174,15 @@ int32 CALL_CONV swe_fixstar2_ut(char *star, double tjd_ut, int32 iflag,
 int32 CALL_CONV swe_fixstar2_mag(char *star, double *mag, char *serr)
 {
   char sstar[SWI_STAR_LENGTH + 1];
-  //static TLS char slast_stardata[AS_MAXCH];
-  static TLS char slast_starname[AS_MAXCH];
-  static TLS struct fixed_star last_stardata;
   int retc;
   struct fixed_star stardata;
   if (serr != NULL)
     *serr = '\0';
-  load_all_fixed_stars(serr); // loads stars unless loaded with an earlier call of function
   retc = fixstar_format_search_name(star, sstar, serr);
   if (retc == ERR)
     goto return_err;
-  /* star elements from last call: */
-  if (swed.n_fixstars_records > 0 && strcmp(slast_starname, sstar) == 0) {
- //   strcpy(srecord, slast_stardata);
-    stardata = last_stardata;
-    goto found;
-  }
-  retc = search_star_in_list(sstar, &stardata, serr);
-  if (retc == ERR)
+  if ((retc = fixstar_find(star, sstar, &stardata, serr)) == ERR)
     goto return_err;
-  /******************************************************/
-  found:
-  last_stardata = stardata;
-  strcpy(slast_starname, sstar);
   *mag = stardata.mag;
   sprintf(star, "%s,%s", stardata.starname, stardata.starbayer);
   return OK;
@@ -8613,3 +9861,1340 @@ int32 CALL_CONV swe_helio_cross_ut(int ipl, double x2cross, double jd_ut, int if
   *jd_cross = jd;
   return OK;
 }
+
+/*************************************************
+ * panchang: tithi, nakshatra, yoga and karana
+ *
+ * The elements of the Hindu calendar day are defined by
+ * - tithi:	elongation Moon - Sun, 30 parts of 12 degrees
+ * - karana:	elongation Moon - Sun, 60 parts of 6 degrees
+ * - nakshatra:	sidereal longitude of Moon, 27 parts of 13°20'
+ * - yoga:	sum of sidereal longitudes of Sun and Moon,
+ *		27 parts of 13°20'
+ * All of them are location independent. The transitions are
+ * found with the same Newton iteration as in swe_mooncross().
+ * The sidereal mode is taken from swe_set_sid_mode().
+ *************************************************/
+static int32 panch_value(double tjd_ut, int32 ptype, int32 iflag, double *val, double *speed, char *serr)
+{
+  double xs[6], xm[6];
+  iflag |= SEFLG_SPEED;
+  if (ptype == SE_PANCH_NAKSHATRA || ptype == SE_PANCH_YOGA)
+    iflag |= SEFLG_SIDEREAL;
+  if (swe_calc_ut(tjd_ut, SE_MOON, iflag, xm, serr) < 0)
+    return ERR;
+  if (ptype == SE_PANCH_NAKSHATRA) {
+    *val = xm[0];
+    *speed = xm[3];
+    return OK;
+  }
+  if (swe_calc_ut(tjd_ut, SE_SUN, iflag, xs, serr) < 0)
+    return ERR;
+  if (ptype == SE_PANCH_YOGA) {
+    *val = swe_degnorm(xm[0] + xs[0]);
+    *speed = xm[3] + xs[3];
+  } else {
+    *val = swe_degnorm(xm[0] - xs[0]);
+    *speed = xm[3] - xs[3];
+  }
+  return OK;
+}
+
+/* Newton iteration from *jd to the time when the panchang value of ptype
+ * reaches target; returns the value and its speed there. The elements
+ * move at least 11 degrees a day, so that a few steps are enough. */
+#define PANCH_MAXITER	30
+static int32 panch_cross(double *jd, double target, int32 ptype, int32 iflag, double *val, double *speed, char *serr)
+{
+  int32 i;
+  double dist;
+  for (i = 0; i < PANCH_MAXITER; i++) {
+    if (panch_value(*jd, ptype, iflag, val, speed, serr) == ERR)
+      return ERR;
+    dist = swe_difdeg2n(target, *val);
+    *jd += dist / *speed;
+    if (fabs(dist) < CROSS_PRECISION)
+      return OK;
+  }
+  if (serr != NULL)
+    sprintf(serr, "panchang element %d: no convergence near jd %f", ptype, *jd);
+  return ERR;
+}
+
+/*
+ * finds all transitions of a panchang element between tjd_start and tjd_end
+ * ptype	SE_PANCH_TITHI, SE_PANCH_NAKSHATRA, SE_PANCH_YOGA, SE_PANCH_KARANA
+ * tret		return array, UT of transitions
+ * iret		return array, number of the element beginning at tret[i]:
+ *		tithi 1..30, nakshatra 1..27, yoga 1..27,
+ *		karana 1..60 (position within the synodic month)
+ * nmax		size of tret and iret
+ * returns the number of transitions stored, or ERR. If it equals nmax,
+ * there may be more: call again from tret[nmax - 1], as swe_panchang()
+ * does. Unlike the event searches, the search stops at nmax, so that a
+ * long range can be read in parts.
+ */
+int32 CALL_CONV swe_panchang_transits(double tjd_start, double tjd_end, int32 ptype, int32 iflag, double *tret, int32 *iret, int32 nmax, char *serr)
+{
+  int32 n = 0, npart, k;
+  double part, val, speed, target, jd;
+  switch (ptype) {
+    case SE_PANCH_TITHI: npart = 30; break;
+    case SE_PANCH_KARANA: npart = 60; break;
+    case SE_PANCH_NAKSHATRA:
+    case SE_PANCH_YOGA: npart = 27; break;
+    default:
+      if (serr != NULL)
+	sprintf(serr, "swe_panchang_transits(): invalid type %d", ptype);
+      return ERR;
+  }
+  iflag &= (SEFLG_EPHMASK | SEFLG_NONUT);
+  part = 360.0 / npart;
+  if (panch_value(tjd_start, ptype, iflag, &val, &speed, serr) == ERR)
+    return ERR;
+  k = ((int32) (val / part) + 1) % npart;
+  jd = tjd_start;
+  while (n < nmax) {
+    target = k * part;
+    jd += swe_degnorm(target - val) / speed;
+    if (panch_cross(&jd, target, ptype, iflag, &val, &speed, serr) == ERR)
+      return ERR;
+    if (jd > tjd_end)
+      break;
+    tret[n] = jd;
+    iret[n] = k + 1;
+    n++;
+    val = target;
+    k = (k + 1) % npart;
+  }
+  return n;
+}
+
+/* element in effect at tjd and its end, from a transition table */
+static void panch_lookup(double tjd, double *tret, int32 *iret, int32 n, int32 npart, double *elem, double *tend)
+{
+  int32 lo = 0, hi = n, mid;
+  while (lo < hi) {	/* first transition after tjd */
+    mid = (lo + hi) / 2;
+    if (tret[mid] <= tjd)
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+  if (lo >= n) {
+    *elem = 0;
+    *tend = 0;
+  } else {
+    *elem = (iret[lo] == 1) ? npart : iret[lo] - 1;
+    *tend = tret[lo];
+  }
+}
+
+/*
+ * computes the panchang for ndays days and nloc locations
+ * tjd_start	0h UT of the first day
+ * geopos	nloc locations, geogr. longitude, latitude, height (3 doubles each)
+ * iflag	ephemeris flag
+ * dpan		return array, 9 doubles per location and day,
+ *		index (iloc * ndays + iday) * 9:
+ *		[0] sunrise (UT), 0 if the Sun does not rise on that day;
+ *		    the elements below then refer to local midnight
+ *		[1] tithi at sunrise, [2] its end (UT)
+ *		[3] nakshatra at sunrise, [4] its end
+ *		[5] yoga at sunrise, [6] its end
+ *		[7] karana at sunrise, [8] its end
+ * The transitions are computed only once for the whole period and are
+ * shared by all locations; per location and day, only the sunrise is
+ * searched. Sunrise is the rising of the disc center without refraction
+ * (SE_BIT_HINDU_RISING).
+ */
+int32 CALL_CONV swe_panchang(double tjd_start, int32 ndays, double *geopos, int32 nloc, int32 iflag, double *dpan, char *serr)
+{
+  static const int32 ptypes[4] = {SE_PANCH_TITHI, SE_PANCH_NAKSHATRA, SE_PANCH_YOGA, SE_PANCH_KARANA};
+  static const int32 nparts[4] = {30, 27, 27, 60};
+  int32 i, iloc, iday, retc, n, nmax, ntr[4];
+  double *tret[4], t0, tend, trise, *dp, *tp;
+  int32 *iret[4], *ip;
+  char serr2[AS_MAXCH];
+  if (ndays <= 0 || nloc <= 0)
+    return OK;
+  iflag &= SEFLG_EPHMASK;
+  for (i = 0; i < 4; i++) {
+    tret[i] = NULL;
+    iret[i] = NULL;
+  }
+  /* transition tables; an initial size of 2.2 karanas per day
+   * usually suffices, a table that fills up is enlarged and the
+   * search continues after its last transition */
+  retc = OK;
+  tend = tjd_start + ndays + 3;
+  for (i = 0; i < 4 && retc == OK; i++) {
+    nmax = (int32) ((ndays + 4) * 2.2) + 10;
+    ntr[i] = 0;
+    t0 = tjd_start - 1.5;
+    for (;;) {
+      tp = (double *) realloc(tret[i], nmax * sizeof(double));
+      if (tp != NULL)
+	tret[i] = tp;
+      ip = (int32 *) realloc(iret[i], nmax * sizeof(int32));
+      if (ip != NULL)
+	iret[i] = ip;
+      if (tp == NULL || ip == NULL) {
+	if (serr != NULL)
+	  strcpy(serr, "swe_panchang(): out of memory");
+	retc = ERR;
+	break;
+      }
+      n = swe_panchang_transits(t0, tend, ptypes[i], iflag, tret[i] + ntr[i], iret[i] + ntr[i], nmax - ntr[i], serr);
+      if (n == ERR) {
+	retc = ERR;
+	break;
+      }
+      ntr[i] += n;
+      if (ntr[i] < nmax)
+	break;
+      /* elements last at least several hours */
+      t0 = tret[i][ntr[i] - 1] + 0.01;
+      nmax *= 2;
+    }
+  }
+  for (iloc = 0; iloc < nloc && retc == OK; iloc++) {
+    for (iday = 0; iday < ndays; iday++) {
+      dp = dpan + (iloc * ndays + iday) * 9;
+      t0 = tjd_start + iday - geopos[3 * iloc] / 360.0;
+      retc = swe_rise_trans(t0, SE_SUN, NULL, iflag, SE_CALC_RISE | SE_BIT_HINDU_RISING, geopos + 3 * iloc, 0, 0, &trise, serr2);
+      if (retc == ERR) {
+	if (serr != NULL)
+	  strcpy(serr, serr2);
+	break;
+      }
+      if (retc == -2) {	/* polar day or night */
+	dp[0] = 0;
+	trise = t0;
+      } else {
+	dp[0] = trise;
+      }
+      retc = OK;
+      for (i = 0; i < 4; i++)
+	panch_lookup(trise, tret[i], iret[i], ntr[i], nparts[i], &dp[1 + 2 * i], &dp[2 + 2 * i]);
+    }
+  }
+  for (i = 0; i < 4; i++) {
+    if (tret[i] != NULL)
+      free(tret[i]);
+    if (iret[i] != NULL)
+      free(iret[i]);
+  }
+  return retc;
+}
+
+/*************************************************
+ * true perigees and apogees of the Moon
+ *
+ * The extrema of the geocentric distance are bracketed by sign changes
+ * of the radial velocity (xx[5] with SEFLG_SPEED), sampled in steps of
+ * two days (extrema are at least 12 days apart), and then refined by
+ * regula falsi (Illinois variant) on the radial velocity.
+ *
+ * tjd_start, tjd_end	time range (UT)
+ * iflag	ephemeris flag; SEFLG_TRUEPOS may be added for geometric
+ *		distances
+ * dtsyz	tolerance in days for coincidence with new or full moon
+ * dret		return array, 6 doubles per extremum:
+ *		[0] time (UT)
+ *		[1] distance in km
+ *		[2] SE_MOON_PERIGEE or SE_MOON_APOGEE, with SE_MOON_AT_NEW or
+ *		    SE_MOON_AT_FULL added if the nearest syzygy is less
+ *		    than dtsyz days away
+ *		[3] time of nearest new or full moon (UT)
+ *		[4] distance of the Moon at that syzygy in km
+ *		[5] elongation Moon - Sun at the extremum
+ * nmax		capacity of dret in extrema
+ * returns the total number of extrema found, or ERR. If it is greater
+ * than nmax, only the nmax earliest ones are stored in dret.
+ *************************************************/
+int32 CALL_CONV swe_moon_extremes(double tjd_start, double tjd_end, int32 iflag, double dtsyz, double *dret, int32 nmax, char *serr)
+{
+  int32 n = 0, ntot = 0, side = 0, i;
+  double t0, t1, t, f0, f1, f, x[6], xs[6], val, speed, target, *dp;
+  iflag = (iflag & (SEFLG_EPHMASK | SEFLG_TRUEPOS)) | SEFLG_SPEED;
+  t0 = tjd_start;
+  if (swe_calc_ut(t0, SE_MOON, iflag, x, serr) < 0)
+    return ERR;
+  f0 = x[5];
+  for (; t0 < tjd_end; t0 = t1, f0 = f1) {
+    t1 = t0 + 2;
+    if (swe_calc_ut(t1, SE_MOON, iflag, x, serr) < 0)
+      return ERR;
+    f1 = x[5];
+    if ((f0 < 0 && f1 >= 0) || (f0 > 0 && f1 <= 0)) {
+      /* refine root of radial velocity between t0 and t1 */
+      double a = t0, b = t1, fa = f0, fb = f1;
+      side = 0;
+      t = a;
+      for (i = 0; i < 50; i++) {
+	t = (a * fb - b * fa) / (fb - fa);
+	if (swe_calc_ut(t, SE_MOON, iflag, x, serr) < 0)
+	  return ERR;
+	f = x[5];
+	if (fabs(b - a) < 1e-7 || f == 0)
+	  break;
+	if ((f < 0) == (fb < 0)) {
+	  b = t; fb = f;
+	  if (side == -1) fa /= 2;
+	  side = -1;
+	} else {
+	  a = t; fa = f;
+	  if (side == 1) fb /= 2;
+	  side = 1;
+	}
+	if (fabs(b - a) < 1e-7)
+	  break;
+      }
+      if (t > tjd_end)
+	break;
+      /* extrema are found in time order; count the ones beyond nmax */
+      if (ntot++ >= nmax)
+	continue;
+      dp = dret + 6 * n;
+      dp[0] = t;
+      dp[1] = x[2] * AUNIT / 1000.0;
+      dp[2] = (f0 < 0) ? SE_MOON_PERIGEE : SE_MOON_APOGEE;
+      /* nearest syzygy */
+      if (panch_value(t, SE_PANCH_TITHI, iflag & SEFLG_EPHMASK, &val, &speed, serr) == ERR)
+	return ERR;
+      dp[5] = val;
+      target = (val < 90 || val >= 270) ? 0 : 180;
+      t += swe_difdeg2n(target, val) / speed;
+      if (panch_cross(&t, target, SE_PANCH_TITHI, iflag & SEFLG_EPHMASK, &val, &speed, serr) == ERR)
+	return ERR;
+      dp[3] = t;
+      if (swe_calc_ut(t, SE_MOON, iflag, xs, serr) < 0)
+	return ERR;
+      dp[4] = xs[2] * AUNIT / 1000.0;
+      if (fabs(dp[3] - dp[0]) < dtsyz)
+	dp[2] += (target == 0) ? SE_MOON_AT_NEW : SE_MOON_AT_FULL;
+      n++;
+    }
+  }
+  return ntot;
+}
+
+/*************************************************
+ * declination events: out of bounds, parallels, contraparallels
+ *
+ * For a list of bodies, finds the times when
+ * - a body's declination crosses +- the true obliquity of date
+ *   (SE_DECL_OOB_BEGIN, SE_DECL_OOB_END),
+ * - two declinations become equal (SE_DECL_PARALLEL),
+ * - two declinations become opposite (SE_DECL_CONTRAPARALLEL).
+ * All bodies and the obliquity are computed once per time step and
+ * shared by all conditions. A condition is searched within a step if
+ * it changes sign, or if its speed (from the declination speeds)
+ * changes sign while it moves towards zero; in the latter case the
+ * extremum is located and two events are found if it lies beyond
+ * zero. Events are refined with Newton's method, using the speeds.
+ *
+ * tjd_start, tjd_end	time range (UT)
+ * ipl, nbody	list of planets
+ * iflag	ephemeris flag
+ * step		time step in days; must be short enough that a condition
+ *		has at most one extremum within one step (1 day is safe
+ *		for the Moon)
+ * evmask	events to search, combination of the SE_DECL_* bits, 0 = all
+ * dret		return array, 5 doubles per event, sorted by time:
+ *		[0] time (UT)
+ *		[1] event type SE_DECL_*
+ *		[2] index of first body in ipl
+ *		[3] index of second body, -1 for out-of-bounds events
+ *		[4] declination of first body at the event
+ * nmax		capacity of dret in events
+ * returns the total number of events found, or ERR. If it is greater
+ * than nmax, only the nmax earliest ones are stored in dret.
+ *************************************************/
+#define DECL_MAXBODY	30
+
+/* condition g of event ev and its speed gd; the obliquity
+ * changes so slowly that its speed is neglected */
+static int32 decl_func(double tjd_ut, int32 ev, int32 ipi, int32 ipj, int32 iflag, double *g, double *gd, double *de, char *serr)
+{
+  double x[6], xj[6];
+  if (swe_calc_ut(tjd_ut, ipi, iflag, x, serr) < 0)
+    return ERR;
+  *de = x[1];
+  if (ev & (SE_DECL_OOB_BEGIN | SE_DECL_OOB_END)) {
+    if (swe_calc_ut(tjd_ut, SE_ECL_NUT, iflag & SEFLG_EPHMASK, xj, serr) < 0)
+      return ERR;
+    *g = fabs(x[1]) - xj[0];
+    *gd = (x[1] < 0) ? -x[4] : x[4];
+  } else {
+    if (swe_calc_ut(tjd_ut, ipj, iflag, xj, serr) < 0)
+      return ERR;
+    *g = (ev == SE_DECL_PARALLEL) ? x[1] - xj[1] : x[1] + xj[1];
+    *gd = (ev == SE_DECL_PARALLEL) ? x[4] - xj[4] : x[4] + xj[4];
+  }
+  return OK;
+}
+
+/* Newton's method between a and b, g changes sign; steps that leave
+ * the bracket are replaced by bisection */
+static int32 decl_refine(double a, double b, double ga, double gb, int32 ev, int32 ipi, int32 ipj, int32 iflag, double *tret, double *de, char *serr)
+{
+  int32 i;
+  double t, tn, g, gd;
+  t = (a * gb - b * ga) / (gb - ga);
+  for (i = 0; i < 30; i++) {
+    if (decl_func(t, ev, ipi, ipj, iflag, &g, &gd, de, serr) == ERR)
+      return ERR;
+    if (g == 0)
+      break;
+    if ((g < 0) == (gb < 0))
+      b = t;
+    else
+      a = t;
+    tn = (gd != 0) ? t - g / gd : a;
+    if (fabs(tn - t) < 1e-8 || b - a < 1e-8) {
+      t = tn;
+      break;
+    }
+    if (tn <= a || tn >= b)
+      tn = (a + b) / 2;
+    t = tn;
+  }
+  *tret = t;
+  return OK;
+}
+
+/* extremum of g between a and b, where its speed gd changes sign,
+ * with Illinois regula falsi; returns time and value of g */
+static int32 decl_extremum(double a, double b, double gda, double gdb, int32 ev, int32 ipi, int32 ipj, int32 iflag, double *tret, double *gret, char *serr)
+{
+  int32 i, side = 0;
+  double t = a, gd, de;
+  for (i = 0; i < 40; i++) {
+    t = (a * gdb - b * gda) / (gdb - gda);
+    if (decl_func(t, ev, ipi, ipj, iflag, gret, &gd, &de, serr) == ERR)
+      return ERR;
+    if (gd == 0 || fabs(b - a) < 1e-6)
+      break;
+    if ((gd < 0) == (gdb < 0)) {
+      b = t; gdb = gd;
+      if (side == -1) gda /= 2;
+      side = -1;
+    } else {
+      a = t; gda = gd;
+      if (side == 1) gdb /= 2;
+      side = 1;
+    }
+  }
+  *tret = t;
+  return OK;
+}
+
+/* function for sorting event records by time (first element) with qsort();
+ * events at the same time are ordered by the next two elements */
+static int event_time_compare(const void *ev1, const void *ev2)
+{
+  const double *e1 = (const double *) ev1;
+  const double *e2 = (const double *) ev2;
+  int i;
+  for (i = 0; i < 3; i++) {
+    if (e1[i] < e2[i]) return -1;
+    if (e1[i] > e2[i]) return 1;
+  }
+  return 0;
+}
+
+/* collects the nmax earliest of a stream of event records of nd doubles,
+ * time first; nfound is the number of events found before this one.
+ * While dret is not full, records are added; then the stored records
+ * form a heap with the latest one at the top, which an earlier event
+ * replaces. Sort the min(nfound, nmax) records with event_time_compare()
+ * at the end. */
+static void event_collect(double *ev, int32 nd, double *dret, int32 nmax, int32 nfound)
+{
+  int32 i, j;
+  if (nfound < nmax) {
+    /* add at the bottom and move up past earlier records */
+    for (i = nfound; i > 0 && dret[nd * ((i - 1) / 2)] < ev[0]; i = j) {
+      j = (i - 1) / 2;
+      memcpy((void *) (dret + nd * i), (void *) (dret + nd * j), nd * sizeof(double));
+    }
+  } else {
+    if (nmax <= 0 || ev[0] >= dret[0])
+      return;
+    /* replace the top and move down past later records */
+    for (i = 0; (j = 2 * i + 1) < nmax; i = j) {
+      if (j + 1 < nmax && dret[nd * (j + 1)] > dret[nd * j])
+	j++;
+      if (dret[nd * j] <= ev[0])
+	break;
+      memcpy((void *) (dret + nd * i), (void *) (dret + nd * j), nd * sizeof(double));
+    }
+  }
+  memcpy((void *) (dret + nd * i), (void *) ev, nd * sizeof(double));
+}
+
+int32 CALL_CONV swe_decl_events(double tjd_start, double tjd_end, int32 *ipl, int32 nbody, int32 iflag, double step, int32 evmask, double *dret, int32 nmax, char *serr)
+{
+  int32 i, j, k, m, nint, ntot = 0, ev;
+  double t0, t1, eps0, eps1, de0[DECL_MAXBODY], de1[DECL_MAXBODY], x[6];
+  double dd0[DECL_MAXBODY], dd1[DECL_MAXBODY];
+  double g0, g1, gd0, gd1, tm, gm, t, de, evrec[5];
+  double ta[2], tb[2], ga[2], gb[2];
+  if (nbody > DECL_MAXBODY) {
+    if (serr != NULL)
+      sprintf(serr, "swe_decl_events(): too many bodies (max. %d)", DECL_MAXBODY);
+    return ERR;
+  }
+  if (evmask == 0)
+    evmask = SE_DECL_OOB_BEGIN | SE_DECL_OOB_END | SE_DECL_PARALLEL | SE_DECL_CONTRAPARALLEL;
+  if (step <= 0)
+    step = 1;
+  iflag = (iflag & SEFLG_EPHMASK) | SEFLG_EQUATORIAL | SEFLG_SPEED;
+  if (swe_calc_ut(tjd_start, SE_ECL_NUT, iflag & SEFLG_EPHMASK, x, serr) < 0)
+    return ERR;
+  eps0 = x[0];
+  for (i = 0; i < nbody; i++) {
+    if (swe_calc_ut(tjd_start, ipl[i], iflag, x, serr) < 0)
+      return ERR;
+    de0[i] = x[1];
+    dd0[i] = x[4];
+  }
+  for (t0 = tjd_start; t0 < tjd_end; t0 = t1) {
+    t1 = t0 + step;
+    if (t1 > tjd_end)
+      t1 = tjd_end;
+    if (swe_calc_ut(t1, SE_ECL_NUT, iflag & SEFLG_EPHMASK, x, serr) < 0)
+      return ERR;
+    eps1 = x[0];
+    for (i = 0; i < nbody; i++) {
+      if (swe_calc_ut(t1, ipl[i], iflag, x, serr) < 0)
+	return ERR;
+      de1[i] = x[1];
+      dd1[i] = x[4];
+    }
+    for (i = 0; i < nbody; i++) {
+      for (j = i; j < nbody; j++) {
+	for (k = 0; k < 3; k++) {
+	  if (k == 0) {
+	    if (j != i || !(evmask & (SE_DECL_OOB_BEGIN | SE_DECL_OOB_END)))
+	      continue;
+	    ev = SE_DECL_OOB_BEGIN | SE_DECL_OOB_END;
+	    g0 = fabs(de0[i]) - eps0;
+	    g1 = fabs(de1[i]) - eps1;
+	    gd0 = (de0[i] < 0) ? -dd0[i] : dd0[i];
+	    gd1 = (de1[i] < 0) ? -dd1[i] : dd1[i];
+	  } else {
+	    if (j == i)
+	      continue;
+	    ev = (k == 1) ? SE_DECL_PARALLEL : SE_DECL_CONTRAPARALLEL;
+	    if (!(evmask & ev))
+	      continue;
+	    g0 = (k == 1) ? de0[i] - de0[j] : de0[i] + de0[j];
+	    g1 = (k == 1) ? de1[i] - de1[j] : de1[i] + de1[j];
+	    gd0 = (k == 1) ? dd0[i] - dd0[j] : dd0[i] + dd0[j];
+	    gd1 = (k == 1) ? dd1[i] - dd1[j] : dd1[i] + dd1[j];
+	  }
+	  nint = 0;
+	  if ((g0 < 0) != (g1 < 0)) {
+	    ta[0] = t0; tb[0] = t1; ga[0] = g0; gb[0] = g1;
+	    nint = 1;
+	  /* g approaches zero and turns back within the step, and
+	   * could reach zero at its speeds: two events if the extremum
+	   * lies beyond zero */
+	  } else if ((gd0 < 0) != (gd1 < 0) && (g0 < 0) == (gd0 > 0)
+	      && fabs(g0) < (fabs(gd0) + fabs(gd1)) * (t1 - t0)) {
+	    if (decl_extremum(t0, t1, gd0, gd1, ev, ipl[i], ipl[j], iflag, &tm, &gm, serr) == ERR)
+	      return ERR;
+	    if ((gm < 0) != (g0 < 0)) {
+	      ta[0] = t0; tb[0] = tm; ga[0] = g0; gb[0] = gm;
+	      ta[1] = tm; tb[1] = t1; ga[1] = gm; gb[1] = g1;
+	      nint = 2;
+	    }
+	  }
+	  for (m = 0; m < nint; m++) {
+	    if (k == 0) {
+	      ev = (gb[m] > 0) ? SE_DECL_OOB_BEGIN : SE_DECL_OOB_END;
+	      if (!(evmask & ev))
+		continue;
+	    }
+	    if (decl_refine(ta[m], tb[m], ga[m], gb[m], ev, ipl[i], ipl[j], iflag, &t, &de, serr) == ERR)
+	      return ERR;
+	    evrec[0] = t;
+	    evrec[1] = ev;
+	    evrec[2] = i;
+	    evrec[3] = (k == 0) ? -1 : j;
+	    evrec[4] = de;
+	    event_collect(evrec, 5, dret, nmax, ntot++);
+	  }
+	}
+      }
+    }
+    eps0 = eps1;
+    for (i = 0; i < nbody; i++) {
+      de0[i] = de1[i];
+      dd0[i] = dd1[i];
+    }
+  }
+  qsort((void *) dret, (size_t) (ntot < nmax ? ntot : nmax), 5 * sizeof(double), event_time_compare);
+  return ntot;
+}
+
+/*************************************************
+ * conjunctions of planets with fixed stars
+ *
+ * All stars of sefstars.txt up to a given magnitude are computed
+ * exactly at the boundaries of yearly windows only. Inside a window,
+ * their longitudes are interpolated linearly (precession, proper motion
+ * and nutation vary slowly; the annual aberration of up to 20" is
+ * covered by a tolerance), and the stars are sorted by longitude.
+ * Each planet's path is then stepped through the window, and only the
+ * stars whose longitude lies within the longitude range swept by the
+ * planet during a step are tested. Candidate crossings are refined with
+ * exact positions. The cost is proportional to the number of planet
+ * steps plus the number of conjunctions found.
+ *
+ * tjd_start, tjd_end	time range (UT)
+ * ipl, nbody	list of planets
+ * iflag	ephemeris flag
+ * maxmag	only stars with magnitude <= maxmag are considered;
+ *		entries without magnitude (reference points) are skipped
+ * latorb	if > 0, conjunctions with a difference in ecliptic latitude
+ *		of more than latorb degrees are discarded
+ * dret		return array, 5 doubles per conjunction, sorted by time:
+ *		[0] time (UT)
+ *		[1] index of planet in ipl
+ *		[2] sequential star number, can be used as star name
+ *		    in swe_fixstar2()
+ *		[3] ecliptic longitude of the conjunction
+ *		[4] latitude of planet minus latitude of star
+ * nmax		capacity of dret in conjunctions
+ * returns the total number of conjunctions found, or ERR. If it is
+ * greater than nmax, only the nmax earliest ones are stored in dret.
+ *************************************************/
+#define FSC_WINDOW	365.25
+#define FSC_TOL		0.02	/* tolerance for interpolated star longitudes */
+
+struct fsc_star {
+  int32 istar;		/* index in swed.fixed_stars */
+  double lon0, dlon;	/* longitude at window start, change over window */
+  double lonm;		/* longitude at window middle, sort key */
+};
+
+static int fsc_star_compare(const void *s1, const void *s2)
+{
+  const struct fsc_star *f1 = (const struct fsc_star *) s1;
+  const struct fsc_star *f2 = (const struct fsc_star *) s2;
+  if (f1->lonm < f2->lonm) return -1;
+  if (f1->lonm > f2->lonm) return 1;
+  return 0;
+}
+
+/* planet minus star in longitude, -180..180, exact positions */
+static int32 fsc_diff(double tjd_ut, int32 ipl, struct fixed_star *stp, int32 iflag, double *dif, double *xp, double *xs, char *serr)
+{
+  char sname[AS_MAXCH];
+  if (swe_calc_ut(tjd_ut, ipl, iflag, xp, serr) < 0)
+    return ERR;
+  if (fixstar_calc_from_struct(stp, tjd_ut + swe_deltat_ex(tjd_ut, iflag, NULL), iflag, sname, xs, serr) == ERR)
+    return ERR;
+  *dif = swe_difdeg2n(xp[0], xs[0]);
+  return OK;
+}
+
+int32 CALL_CONV swe_fixstar_conjunctions(double tjd_start, double tjd_end, int32 *ipl, int32 nbody, int32 iflag, double maxmag, double latorb, double *dret, int32 nmax, char *serr)
+{
+  int32 i, k, nst = 0, ntot = 0, side, retc = OK;
+  int32 lo, hi, mid, jst, jj;
+  double tw0, tw1, t0, t1, t, step, x[6], xp[6], xs[6], lp0, lp1, lmin, lmax, dl;
+  double f0, f1, fa, fb, f, a, b, ls0, ls1, ev[5];
+  struct fsc_star *st;
+  struct fixed_star *stp;
+  char sname[AS_MAXCH];
+  if (load_all_fixed_stars(serr) == ERR)
+    return ERR;
+  iflag &= SEFLG_EPHMASK;
+  st = (struct fsc_star *) malloc(swed.n_fixstars_real * sizeof(struct fsc_star));
+  if (st == NULL) {
+    if (serr != NULL)
+      strcpy(serr, "swe_fixstar_conjunctions(): out of memory");
+    return ERR;
+  }
+  for (i = 0; i < swed.n_fixstars_real; i++) {
+    /* reference points (galactic poles, zero points) have magnitude 0 */
+    if (swed.fixed_stars[i].mag <= maxmag && swed.fixed_stars[i].mag != 0)
+      st[nst++].istar = i;
+  }
+  for (tw0 = tjd_start; tw0 < tjd_end && retc == OK; tw0 = tw1) {
+    tw1 = tw0 + FSC_WINDOW;
+    if (tw1 > tjd_end)
+      tw1 = tjd_end;
+    /* star positions at window boundaries, sorted by longitude */
+    for (i = 0; i < nst; i++) {
+      stp = &swed.fixed_stars[st[i].istar];
+      if (fixstar_calc_from_struct(stp, tw0 + swe_deltat_ex(tw0, iflag, NULL), iflag, sname, x, serr) == ERR) {
+	retc = ERR;
+	break;
+      }
+      st[i].lon0 = x[0];
+      if (fixstar_calc_from_struct(stp, tw1 + swe_deltat_ex(tw1, iflag, NULL), iflag, sname, x, serr) == ERR) {
+	retc = ERR;
+	break;
+      }
+      st[i].dlon = swe_difdeg2n(x[0], st[i].lon0);
+      st[i].lonm = swe_degnorm(st[i].lon0 + st[i].dlon / 2);
+    }
+    if (retc == ERR)
+      break;
+    qsort((void *) st, (size_t) nst, sizeof(struct fsc_star), fsc_star_compare);
+    for (k = 0; k < nbody && retc == OK; k++) {
+      /* one step per day; the Moon moves 13 degrees, so that no star
+       * can be crossed twice within a step */
+      step = 1;
+      t0 = tw0;
+      if (swe_calc_ut(t0, ipl[k], iflag, x, serr) < 0) {
+	retc = ERR;
+	break;
+      }
+      lp0 = x[0];
+      while (t0 < tw1 && retc == OK) {
+	t1 = t0 + step;
+	if (t1 > tw1)
+	  t1 = tw1;
+	if (swe_calc_ut(t1, ipl[k], iflag, x, serr) < 0) {
+	  retc = ERR;
+	  break;
+	}
+	lp1 = x[0];
+	/* longitude range swept by the planet during the step */
+	dl = swe_difdeg2n(lp1, lp0);
+	lmin = swe_degnorm((dl >= 0 ? lp0 : lp1) - FSC_TOL);
+	lmax = lmin + fabs(dl) + 2 * FSC_TOL;
+	/* first star with lonm >= lmin */
+	lo = 0; hi = nst;
+	while (lo < hi) {
+	  mid = (lo + hi) / 2;
+	  if (st[mid].lonm < lmin)
+	    lo = mid + 1;
+	  else
+	    hi = mid;
+	}
+	for (jj = 0; jj < nst; jj++) {
+	  jst = (lo + jj) % nst;
+	  if (swe_degnorm(st[jst].lonm - lmin) > lmax - lmin)
+	    break;
+	  /* interpolated star longitudes at step boundaries */
+	  ls0 = st[jst].lon0 + st[jst].dlon * (t0 - tw0) / (tw1 - tw0);
+	  ls1 = st[jst].lon0 + st[jst].dlon * (t1 - tw0) / (tw1 - tw0);
+	  f0 = swe_difdeg2n(lp0, ls0);
+	  f1 = swe_difdeg2n(lp1, ls1);
+	  if (fabs(f0) > 90 || (f0 < -FSC_TOL && f1 < -FSC_TOL) || (f0 > FSC_TOL && f1 > FSC_TOL))
+	    continue;
+	  /* exact differences; refine by Illinois regula falsi */
+	  stp = &swed.fixed_stars[st[jst].istar];
+	  if (fsc_diff(t0, ipl[k], stp, iflag, &fa, xp, xs, serr) == ERR
+	    || fsc_diff(t1, ipl[k], stp, iflag, &fb, xp, xs, serr) == ERR) {
+	    retc = ERR;
+	    break;
+	  }
+	  if ((fa < 0) == (fb < 0) || fa == 0)
+	    continue;
+	  a = t0; b = t1; side = 0;
+	  for (i = 0; i < 60; i++) {
+	    t = (a * fb - b * fa) / (fb - fa);
+	    if (fsc_diff(t, ipl[k], stp, iflag, &f, xp, xs, serr) == ERR) {
+	      retc = ERR;
+	      break;
+	    }
+	    if (f == 0 || fabs(b - a) < 1e-7)
+	      break;
+	    if ((f < 0) == (fb < 0)) {
+	      b = t; fb = f;
+	      if (side == -1) fa /= 2;
+	      side = -1;
+	    } else {
+	      a = t; fa = f;
+	      if (side == 1) fb /= 2;
+	      side = 1;
+	    }
+	  }
+	  if (retc == ERR)
+	    break;
+	  if (latorb > 0 && fabs(xp[1] - xs[1]) > latorb)
+	    continue;
+	  ev[0] = t;
+	  ev[1] = k;
+	  ev[2] = st[jst].istar + 1;
+	  ev[3] = xs[0];
+	  ev[4] = xp[1] - xs[1];
+	  event_collect(ev, 5, dret, nmax, ntot++);
+	}
+	t0 = t1;
+	lp0 = lp1;
+      }
+    }
+  }
+  free(st);
+  if (retc == ERR)
+    return ERR;
+  qsort((void *) dret, (size_t) (ntot < nmax ? ntot : nmax), 5 * sizeof(double), event_time_compare);
+  return ntot;
+}
+
+/* fits one segment t0..t1 on ncoe Chebyshev nodes; returns the maximum
+ * error in *err (angles in degrees, distance relative, converted to 
+ * degrees), checked at the segment ends and at CHEB_NCHECK points per 
+ * node */
+#define CHEB_NCHECK	3
+static int32 cheb_fit_segment(double t0, double t1, int32 ipl, int32 iflag, int32 ncoe, double *coef, double *err, char *serr)
+{
+  int32 i, j, k;
+  double tm = (t0 + t1) / 2, hh = (t1 - t0) / 2;
+  double x[6], f[SE_CHEB_MAXCOE][3], d, lon0 = 0;
+  for (k = ncoe - 1; k >= 0; k--) {	/* increasing time */
+    if (swe_calc_ut(tm + hh * cos(PI * (k + 0.5) / ncoe), ipl, iflag, x, serr) == ERR)
+      return ERR;
+    /* longitude continuous within segment */
+    if (k < ncoe - 1)
+      x[0] = lon0 + swe_difdeg2n(x[0], lon0);
+    lon0 = x[0];
+    for (i = 0; i < 3; i++)
+      f[k][i] = x[i];
+  }
+  for (i = 0; i < 3; i++) {
+    for (j = 0; j < ncoe; j++) {
+      d = 0;
+      for (k = 0; k < ncoe; k++)
+	d += f[k][i] * cos(PI * j * (k + 0.5) / ncoe);
+      coef[i * ncoe + j] = d * 2.0 / ncoe;
+    }
+  }
+  *err = 0;
+  for (k = 0; k <= CHEB_NCHECK * ncoe + 1; k++) {
+    double xk;
+    if (k == 0 || k == CHEB_NCHECK * ncoe + 1)
+      xk = (k == 0) ? 1 : -1;
+    else
+      xk = cos(PI * (k - 0.5) / (CHEB_NCHECK * ncoe));
+    if (swe_calc_ut(tm + hh * xk, ipl, iflag, x, serr) == ERR)
+      return ERR;
+    d = fabs(swe_difdeg2n(swi_echeb(xk, coef, ncoe), x[0]));
+    if (d > *err) *err = d;
+    d = fabs(swi_echeb(xk, coef + ncoe, ncoe) - x[1]);
+    if (d > *err) *err = d;
+    if (x[2] > 0) {
+      d = fabs(swi_echeb(xk, coef + 2 * ncoe, ncoe) - x[2]) / x[2] * RADTODEG;
+      if (d > *err) *err = d;
+    }
+  }
+  return OK;
+}
+
+/* Fits positions of a body by piecewise Chebyshev polynomials, so that
+ * a client can evaluate them at any instant without further calls.
+ * tjd_start, tjd_end	time range, UT
+ * ipl, iflag		as with swe_calc_ut(); positions include aberration,
+ *			nutation etc. according to iflag. Speed flags are
+ *			ignored, speeds are the derivatives of the polynomials.
+ *			SEFLG_XYZ and SEFLG_RADIANS are not supported.
+ * tol			maximum error of longitude and latitude, degrees;
+ *			the distance gets the same relative error (tol in radians).
+ *			The error is checked at a finite number of points; 
+ *			a planet passing behind the Sun, where light deflection
+ *			changes within hours, may exceed it by about 1".
+ * ncoe			coefficients per coordinate, 2 .. SE_CHEB_MAXCOE
+ * dseg			SE_CHEB_SEGSIZE(ncoe) doubles per segment: t0, t1 (UT),
+ *			then ncoe coefficients each for longitude, latitude and 
+ *			distance. With x = 2 * (t - t0) / (t1 - t0) - 1, a 
+ *			coordinate is c[0] / 2 + sum(c[j] * T_j(x)), as computed 
+ *			by swi_echeb(). Longitude is continuous within a segment 
+ *			and must be normalized to 0..360 after evaluation.
+ * nmax			maximum number of segments in dseg
+ * returns number of segments, or ERR
+ */
+int32 CALL_CONV swe_cheb_fit(double tjd_start, double tjd_end, int32 ipl, int32 iflag, double tol, int32 ncoe, double *dseg, int32 nmax, char *serr)
+{
+  int32 n = 0;
+  double t0, t1, h, err;
+  double *dp;
+  if (ncoe < 2 || ncoe > SE_CHEB_MAXCOE || tjd_end <= tjd_start || tol <= 0) {
+    if (serr != NULL)
+      sprintf(serr, "swe_cheb_fit: invalid arguments (ncoe must be 2..%d, tol > 0)", SE_CHEB_MAXCOE);
+    return ERR;
+  }
+  if (iflag & (SEFLG_XYZ | SEFLG_RADIANS)) {
+    if (serr != NULL)
+      strcpy(serr, "swe_cheb_fit: SEFLG_XYZ and SEFLG_RADIANS are not supported");
+    return ERR;
+  }
+  iflag &= ~(SEFLG_SPEED | SEFLG_SPEED3);
+  t0 = tjd_start;
+  h = 16;
+  while (t0 < tjd_end) {
+    if (n >= nmax) {
+      if (serr != NULL)
+	sprintf(serr, "swe_cheb_fit: more than %d segments required; increase ncoe or tol", nmax);
+      return ERR;
+    }
+    dp = dseg + n * SE_CHEB_SEGSIZE(ncoe);
+    /* shrink the segment until the fit is good enough */
+    for (;;) {
+      t1 = t0 + h;
+      if (t1 > tjd_end) 
+	t1 = tjd_end;
+      if (cheb_fit_segment(t0, t1, ipl, iflag, ncoe, dp + 2, &err, serr) == ERR)
+	return ERR;
+      if (err <= tol)
+	break;
+      h /= 2;
+      if (h < 1.0 / 1440) {
+	if (serr != NULL)
+	  strcpy(serr, "swe_cheb_fit: tolerance cannot be reached; increase ncoe or tol");
+	return ERR;
+      }
+    }
+    dp[0] = t0;
+    dp[1] = t1;
+    n++;
+    t0 = t1;
+    /* try a longer segment next, if this one was easily good enough */
+    if (err < tol / 4)
+      h *= 2;
+  }
+  return n;
+}
+
+/* Secular perturbations for minor planets computed from the element
+ * catalogue SE_ASTELEMFILE (see swemplan.c).
+ * mode		0 = two-body orbits (default), 
+ *		SE_ASTEL_SECULAR = with secular motion of perihelion
+ *		and node caused by the planets
+ */
+void CALL_CONV swe_set_ast_elem_mode(int32 mode)
+{
+  swi_ast_elem_set_mode(mode);
+}
+
+/* Earth, Sun and coordinate frame for positions from the element
+ * catalogue, computed once for any number of objects */
+struct ast_el_frame {
+  double tjd;
+  int32 iflag;
+  double xsun[6], xobs[6];
+  double m[3][3];	/* equator J2000 -> wanted coordinate system */
+};
+
+static int ast_el_frame_init(double tjd_ut, int32 iflag, struct ast_el_frame *f, char *serr)
+{
+  int32 i, j, k, epheflag;
+  double eps, dpsi, deps, d, v[3], xearth[6], xmoon[6];
+  if (iflag & (SEFLG_TOPOCTR | SEFLG_SIDEREAL)) {
+    if (serr != NULL)
+      strcpy(serr, "element catalogue: SEFLG_TOPOCTR and SEFLG_SIDEREAL are not supported");
+    return ERR;
+  }
+  epheflag = iflag & SEFLG_EPHMASK;
+  if (epheflag == 0 || epheflag == SEFLG_JPLEPH)
+    epheflag = SEFLG_SWIEPH;
+  iflag = (iflag & ~SEFLG_EPHMASK) | epheflag;
+  if (iflag & SEFLG_HELCTR)
+    iflag |= SEFLG_NOABERR;
+  f->iflag = iflag;
+  f->tjd = tjd_ut + swe_deltat_ex(tjd_ut, iflag, serr);
+  /* earth and sun; the speed of the earth is needed for aberration */
+  if (main_planet_bary(f->tjd, SEI_EARTH, epheflag, iflag | SEFLG_SPEED, NO_SAVE, xearth, xearth, f->xsun, xmoon, serr) != OK)
+    return ERR;
+  for (i = 0; i <= 5; i++)
+    f->xobs[i] = (iflag & SEFLG_HELCTR) ? f->xsun[i] : xearth[i];
+  /* rotation matrix from equator J2000 to the wanted coordinate system,
+   * built from the unit vectors */
+  swi_check_ecliptic(f->tjd, iflag);
+  swi_check_nutation(f->tjd, iflag);
+  eps = (iflag & SEFLG_J2000) ? swed.oec2000.eps : swed.oec.eps;
+  dpsi = deps = 0;
+  if (!(iflag & SEFLG_NONUT) && !(iflag & SEFLG_J2000)) {
+    dpsi = swed.nut.nutlo[0];
+    deps = swed.nut.nutlo[1];
+  }
+  for (k = 0; k < 3; k++) {
+    v[0] = v[1] = v[2] = 0;
+    v[k] = 1;
+    if (!(iflag & SEFLG_J2000))
+      swi_precess(v, f->tjd, iflag, J2000_TO_J);
+    swi_coortrf(v, v, eps);
+    /* nutation in longitude */
+    d = v[0] * cos(dpsi) - v[1] * sin(dpsi);
+    v[1] = v[0] * sin(dpsi) + v[1] * cos(dpsi);
+    v[0] = d;
+    if (iflag & SEFLG_EQUATORIAL)
+      swi_coortrf(v, v, -(eps + deps));
+    for (j = 0; j < 3; j++)
+      f->m[j][k] = v[j];
+  }
+  return OK;
+}
+
+/* position of catalogue object i, polar, in the frame f */
+static void ast_el_position(struct ast_el_frame *f, int32 i, double *xret)
+{
+  int j;
+  double xp[6], x[3], v[3], dt, r, d;
+  swi_ast_elem_helio(i, f->tjd, xp);
+  for (j = 0; j <= 2; j++)
+    x[j] = xp[j] + f->xsun[j] - f->xobs[j];
+  if (!(f->iflag & SEFLG_TRUEPOS)) {
+    /* light-time, one step */
+    dt = sqrt(square_sum(x)) * AUNIT / CLIGHT / 86400.0;
+    for (j = 0; j <= 2; j++)
+      x[j] -= dt * xp[j+3];
+  }
+  r = sqrt(square_sum(x));
+  if (!(f->iflag & SEFLG_TRUEPOS) && !(f->iflag & SEFLG_NOABERR)) {
+    /* aberration, first order: u' = u + v/c - u (u v/c) */
+    for (j = 0, d = 0; j <= 2; j++) {
+      v[j] = f->xobs[j+3] * AUNIT / CLIGHT / 86400.0;
+      d += x[j] / r * v[j];
+    }
+    for (j = 0; j <= 2; j++)
+      x[j] += r * v[j] - x[j] * d;
+  }
+  for (j = 0; j <= 2; j++)
+    v[j] = f->m[j][0] * x[0] + f->m[j][1] * x[1] + f->m[j][2] * x[2];
+  swi_cartpol(v, xret);
+  xret[2] = r;
+  if (!(f->iflag & SEFLG_RADIANS)) {
+    xret[0] *= RADTODEG;
+    xret[1] *= RADTODEG;
+  }
+}
+
+/* Positions of many numbered minor planets from the element catalogue
+ * SE_ASTELEMFILE, e.g. for all objects of the MPC orbit database at once.
+ * Earth, Sun, precession and nutation are computed only once for all 
+ * objects; each object costs one Kepler equation. Light-time is corrected
+ * by a single step, aberration to first order, light deflection is 
+ * neglected. The error against swe_calc_ut() with the same elements is
+ * below 0.5", except for objects close to the Sun.
+ * The elements are osculating at their epoch, and the planetary
+ * perturbations are neglected. Against a numerical ephemeris, the
+ * error of main-belt objects is below 0.2' within 100 days of the
+ * epoch, about 1' (up to 4') after one year, 4' (up to 11') after two
+ * years and 20' (up to 1.5 degrees) after five years; SE_ASTEL_SECULAR
+ * hardly changes this. Use a catalogue whose epoch is within a few
+ * months of the dates computed; the MPC publishes new elements about
+ * every 200 days.
+ * tjd_ut	time, UT
+ * iflag	ephemeris flag, SEFLG_HELCTR, SEFLG_TRUEPOS, SEFLG_NOABERR,
+ *		SEFLG_J2000, SEFLG_NONUT, SEFLG_EQUATORIAL, SEFLG_RADIANS;
+ *		SEFLG_TOPOCTR and SEFLG_SIDEREAL are not supported, 
+ *		speed is not computed.
+ * first	index of first object in the catalogue (0 = lowest number)
+ * count	number of objects; if <= 0, nothing is computed and the
+ *		size of the catalogue is returned
+ * xret		3 doubles per object: longitude, latitude, distance
+ *		(or right ascension, declination, distance)
+ * anum		MPC numbers of the objects, count int32, or NULL
+ * returns number of objects computed, or ERR
+ */
+int32 CALL_CONV swe_calc_ast_elements(double tjd_ut, int32 iflag, int32 first, int32 count, double *xret, int32 *anum, char *serr)
+{
+  int32 i, n;
+  struct ast_el_frame f;
+  swi_init_swed_if_start();
+  if (!swed.ephe_path_is_set && !swed.jpl_file_is_open)
+    swe_set_ephe_path(NULL);
+  if ((n = swi_ast_elem_load(serr)) == ERR)
+    return ERR;
+  if (count <= 0)
+    return n;
+  if (first < 0 || first >= n) {
+    if (serr != NULL)
+      sprintf(serr, "swe_calc_ast_elements: first = %d, catalogue has %d objects", first, n);
+    return ERR;
+  }
+  if (first + count > n)
+    count = n - first;
+  if (ast_el_frame_init(tjd_ut, iflag, &f, serr) != OK)
+    return ERR;
+  for (i = 0; i < count; i++) {
+    ast_el_position(&f, first + i, xret + 3 * i);
+    if (anum != NULL)
+      anum[i] = swi_ast_elem_number(first + i);
+  }
+  return count;
+}
+
+/*************************************************
+ * minor planets near given points of the ecliptic
+ *
+ * For a time bucket of AST_INDEX_DAYS, all objects of the element 
+ * catalogue are computed at the beginning and the end of the bucket,
+ * and each object is entered in the 1-degree longitude bins covered
+ * between these two positions, plus a margin for retrograde loops.
+ * The index is built on the first query in a bucket and kept for
+ * further queries in the same bucket. A query interpolates the 
+ * longitudes of the objects in the bins around the target points and
+ * computes exact positions only of those that may be within the orb,
+ * typically 1 percent of the catalogue for an orb of 1 degree. Objects that move
+ * more than AST_INDEX_FAST degrees within the bucket (close approaches
+ * to the earth) are candidates in every bin.
+ *************************************************/
+#define AST_INDEX_DAYS	8.0
+#define AST_INDEX_NBIN	360
+#define AST_INDEX_FAST	30.0
+
+static TLS struct {
+  AS_BOOL valid;
+  char path[AS_MAXCH];	/* ephemeris path of the catalogue */
+  int32 n;		/* catalogue size */
+  int32 iflag;
+  int32 mode;		/* swe_set_ast_elem_mode() */
+  double tbucket;	/* start of bucket, UT */
+  int32 bin[AST_INDEX_NBIN + 1];	/* first entry of each bin in id[] */
+  int32 *id;		/* catalogue indices, by bins */
+  float *lon;		/* longitude at tbucket and change over the bucket */
+  int32 *stamp;		/* last query point that tested an object */
+  int32 qstamp;
+} astidx = {FALSE, "", 0, 0, 0, 0, {0}, NULL, NULL, NULL, 0};
+
+static void ast_index_free(void)
+{
+  if (astidx.id != NULL)
+    free(astidx.id);
+  if (astidx.stamp != NULL)
+    free(astidx.stamp);
+  if (astidx.lon != NULL)
+    free(astidx.lon);
+  astidx.lon = NULL;
+  astidx.id = NULL;
+  astidx.stamp = NULL;
+  astidx.qstamp = 0;
+  astidx.valid = FALSE;
+}
+
+/* deviation from linear motion within a bucket, degrees */
+#define AST_INDEX_MARGIN(dlon)	(0.2 + 0.25 * fabs(dlon))
+
+/* counts object i in the bins it covers, or enters it, if id != NULL */
+static void ast_index_bins(double lon0, double dlon, int32 i, int32 *cnt, int32 *id)
+{
+  double lmin, margin;
+  int32 b, b0, nb;
+  if (fabs(dlon) > AST_INDEX_FAST) {
+    b0 = 0;
+    nb = AST_INDEX_NBIN;
+  } else {
+    margin = AST_INDEX_MARGIN(dlon);
+    lmin = swe_degnorm(lon0 + (dlon < 0 ? dlon : 0) - margin);
+    b0 = (int32) lmin;
+    nb = (int32) (lmin + fabs(dlon) + 2 * margin) - b0 + 1;
+  }
+  for (b = b0; b < b0 + nb; b++) {
+    if (id == NULL)
+      cnt[b % AST_INDEX_NBIN]++;
+    else
+      id[cnt[b % AST_INDEX_NBIN]++] = i;
+  }
+}
+
+static int32 ast_index_build(double tbucket, int32 iflag, int32 n, char *serr)
+{
+  int32 i, b, cnt[AST_INDEX_NBIN];
+  double x0[3], x1[3];
+  float *lon;
+  struct ast_el_frame f0, f1;
+  ast_index_free();
+  if (ast_el_frame_init(tbucket, iflag, &f0, serr) != OK
+    || ast_el_frame_init(tbucket + AST_INDEX_DAYS, iflag, &f1, serr) != OK)
+    return ERR;
+  lon = astidx.lon = (float *) malloc((size_t) n * 2 * sizeof(float));
+  astidx.stamp = (int32 *) calloc((size_t) n, sizeof(int32));
+  if (lon == NULL || astidx.stamp == NULL) 
+    goto out_of_memory;
+  memset((void *) cnt, 0, sizeof(cnt));
+  for (i = 0; i < n; i++) {
+    ast_el_position(&f0, i, x0);
+    ast_el_position(&f1, i, x1);
+    lon[2 * i] = (float) x0[0];
+    lon[2 * i + 1] = (float) swe_difdeg2n(x1[0], x0[0]);
+    ast_index_bins(lon[2 * i], lon[2 * i + 1], i, cnt, NULL);
+  }
+  astidx.bin[0] = 0;
+  for (b = 0; b < AST_INDEX_NBIN; b++) {
+    astidx.bin[b + 1] = astidx.bin[b] + cnt[b];
+    cnt[b] = astidx.bin[b];
+  }
+  if ((astidx.id = (int32 *) malloc((size_t) astidx.bin[AST_INDEX_NBIN] * sizeof(int32))) == NULL)
+    goto out_of_memory;
+  for (i = 0; i < n; i++)
+    ast_index_bins(lon[2 * i], lon[2 * i + 1], i, cnt, astidx.id);
+  strcpy(astidx.path, swed.ephepath);
+  astidx.n = n;
+  astidx.iflag = iflag;
+  astidx.mode = swi_ast_elem_get_mode();
+  astidx.tbucket = tbucket;
+  astidx.valid = TRUE;
+  return OK;
+out_of_memory:
+  ast_index_free();
+  if (serr != NULL)
+    strcpy(serr, "swe_ast_elem_near: out of memory for longitude index");
+  return ERR;
+}
+
+static int ast_near_compare(const void *a, const void *b)
+{
+  const double *d1 = (const double *) a;
+  const double *d2 = (const double *) b;
+  if (d1[1] != d2[1]) return (d1[1] < d2[1]) ? -1 : 1;
+  if (fabs(d1[5]) != fabs(d2[5])) return (fabs(d1[5]) < fabs(d2[5])) ? -1 : 1;
+  return 0;
+}
+
+/* Minor planets of the element catalogue SE_ASTELEMFILE whose ecliptic
+ * longitude is within orb of one of the given points, e.g. of the 
+ * planets and angles of a birth chart.
+ * tjd_ut	time, UT
+ * iflag	ephemeris flag, SEFLG_TRUEPOS, SEFLG_NOABERR, SEFLG_NONUT,
+ *		SEFLG_J2000, SEFLG_HELCTR (as with swe_calc_ast_elements(),
+ *		but no SEFLG_EQUATORIAL and SEFLG_RADIANS)
+ * xlon		ecliptic longitudes of the target points, degrees
+ * npoints	number of target points
+ * orb		maximum difference in longitude, 0 .. 30 degrees
+ * dret		return array, 6 doubles per match, sorted by target point
+ *		and distance from it:
+ *		[0] MPC number of the minor planet
+ *		[1] index of the target point in xlon
+ *		[2] longitude, [3] latitude, [4] distance of the minor planet
+ *		[5] longitude of minor planet minus target point
+ * nmax		capacity of dret in matches
+ * returns the total number of matches, or ERR. If it is greater than
+ * nmax, only nmax matches are stored in dret; call again with a
+ * larger array to have all of them.
+ */
+int32 CALL_CONV swe_ast_elem_near(double tjd_ut, int32 iflag, double *xlon, int32 npoints, double orb, double *dret, int32 nmax, char *serr)
+{
+  int32 i, j, k, b, b0, b1, n, id, nm = 0, ntot = 0;
+  double tbucket, frac, x[3], d, dlon, *dp;
+  struct ast_el_frame f;
+  swi_init_swed_if_start();
+  if (!swed.ephe_path_is_set && !swed.jpl_file_is_open)
+    swe_set_ephe_path(NULL);
+  if (orb <= 0 || orb > AST_INDEX_FAST || npoints <= 0) {
+    if (serr != NULL)
+      sprintf(serr, "swe_ast_elem_near: invalid arguments (orb must be 0..%.0f)", AST_INDEX_FAST);
+    return ERR;
+  }
+  if (iflag & (SEFLG_EQUATORIAL | SEFLG_RADIANS | SEFLG_XYZ)) {
+    if (serr != NULL)
+      strcpy(serr, "swe_ast_elem_near: ecliptic longitudes in degrees only");
+    return ERR;
+  }
+  iflag &= ~(SEFLG_SPEED | SEFLG_SPEED3);
+  if ((n = swi_ast_elem_load(serr)) == ERR)
+    return ERR;
+  tbucket = J2000 + floor((tjd_ut - J2000) / AST_INDEX_DAYS) * AST_INDEX_DAYS;
+  if (!astidx.valid || astidx.tbucket != tbucket || astidx.iflag != iflag 
+    || astidx.mode != swi_ast_elem_get_mode() || astidx.n != n || strcmp(astidx.path, swed.ephepath) != 0) {
+    if (ast_index_build(tbucket, iflag, n, serr) != OK)
+      return ERR;
+  }
+  if (ast_el_frame_init(tjd_ut, iflag, &f, serr) != OK)
+    return ERR;
+  frac = (tjd_ut - tbucket) / AST_INDEX_DAYS;
+  for (i = 0; i < npoints; i++) {
+    if (++astidx.qstamp == 0x7fffffff) {
+      memset((void *) astidx.stamp, 0, (size_t) n * sizeof(int32));
+      astidx.qstamp = 1;
+    }
+    b0 = (int32) floor(swe_degnorm(xlon[i]) - orb);
+    b1 = (int32) floor(swe_degnorm(xlon[i]) + orb);
+    for (b = b0; b <= b1; b++) {
+      k = (b + AST_INDEX_NBIN) % AST_INDEX_NBIN;
+      for (j = astidx.bin[k]; j < astidx.bin[k + 1]; j++) {
+        /* objects in several bins are tested once per point */
+	id = astidx.id[j];
+	if (astidx.stamp[id] == astidx.qstamp)
+	  continue;
+	astidx.stamp[id] = astidx.qstamp;
+	/* interpolated longitude too far from the point */
+	dlon = astidx.lon[2 * id + 1];
+	if (fabs(dlon) <= AST_INDEX_FAST
+	  && fabs(swe_difdeg2n(astidx.lon[2 * id] + frac * dlon, xlon[i])) > orb + AST_INDEX_MARGIN(dlon))
+	  continue;
+	ast_el_position(&f, id, x);
+	d = swe_difdeg2n(x[0], xlon[i]);
+	if (fabs(d) > orb)
+	  continue;
+	if (ntot++ >= nmax)
+	  continue;
+	dp = dret + 6 * nm;
+	dp[0] = swi_ast_elem_number(id);
+	dp[1] = i;
+	dp[2] = x[0];
+	dp[3] = x[1];
+	dp[4] = x[2];
+	dp[5] = d;
+	nm++;
+      }
+    }
+  }
+  qsort((void *) dret, (size_t) nm, 6 * sizeof(double), ast_near_compare);
+  return ntot;
+}
+
+/* heap memory held by the library's tables and caches, in bytes:
+ * dstat[SE_MEM_SEGMENTS]	Chebyshev coefficients of the open files and
+ *				of the asteroid cache
+ * dstat[SE_MEM_FILECACHE]	remote block cache and index of the packed
+ *				archive
+ * dstat[SE_MEM_ASTELEM]	minor planet element catalogue and its
+ *				longitude index
+ * dstat[SE_MEM_STARS]		fixed star table
+ * dstat[SE_MEM_NUTATION]	nutation table of SEFLG_JPLHOR
+ * dstat[SE_MEM_ECLDB]		eclipse database
+ * The JPL ephemeris buffers are not included.
+ * returns the sum
+ */
+int32 CALL_CONV swe_get_memory_stats(double *dstat)
+{
+  int32 i;
+  double sum = 0;
+  struct plan_data *pdp;
+  for (i = 0; i < SE_MEM_NSTAT; i++)
+    dstat[i] = 0;
+  for (i = 0; i < SEI_NPLANETS + AST_CACHE_SIZE; i++) {
+    if (i < SEI_NPLANETS)
+      pdp = &swed.pldat[i];
+    else if (astc[i - SEI_NPLANETS].ibdy != 0)
+      pdp = &astc[i - SEI_NPLANETS].pd;
+    else
+      continue;
+    if (pdp->segp != NULL)
+      dstat[SE_MEM_SEGMENTS] += (double) pdp->ncoe * 3 * 8;
+    if (pdp->refep != NULL)
+      dstat[SE_MEM_SEGMENTS] += (double) pdp->ncoe * 2 * 8;
+  }
+  if (remote.blocks != NULL) {
+    dstat[SE_MEM_FILECACHE] = (double) remote.nblocks * sizeof(struct remote_block);
+    for (i = 0; i < remote.nblocks; i++)
+      if (remote.blocks[i].data != NULL)
+        dstat[SE_MEM_FILECACHE] += remote.block_size;
+  }
+  if (pack.ent != NULL)
+    dstat[SE_MEM_FILECACHE] += (double) pack.nent * sizeof(struct pack_entry);
+  dstat[SE_MEM_ASTELEM] = swi_ast_elem_bytes();
+  if (astidx.id != NULL)
+    dstat[SE_MEM_ASTELEM] += (double) astidx.bin[AST_INDEX_NBIN] * sizeof(int32);
+  if (astidx.lon != NULL)
+    dstat[SE_MEM_ASTELEM] += (double) astidx.n * (2 * sizeof(float) + sizeof(int32));
+  if (swed.fixed_stars != NULL)
+    dstat[SE_MEM_STARS] = (double) swed.n_fixstars_records * sizeof(struct fixed_star);
+  if (swed.eop_data != NULL)
+    dstat[SE_MEM_NUTATION] = swed.eop_data_size;
+  dstat[SE_MEM_ECLDB] = swi_ecl_db_bytes();
+  for (i = 0; i < SE_MEM_NSTAT; i++)
+    sum += dstat[i];
+  return (int32) sum;
+}
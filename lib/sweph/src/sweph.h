@@ -673,6 +673,19 @@ extern int swi_intp_apsides(double J, double *pol, int ipli);
 extern int swi_moshplan(double tjd, int ipli, AS_BOOL do_save, double *xpret, double *xeret, char *serr);
 extern int swi_moshplan2(double J, int iplm, double *pobj);
 extern int swi_osc_el_plan(double tjd, double *xp, int ipl, int ipli, double *xearth, double *xsun, char *serr);
+extern int swi_osc_el_ast(double tjd, double *xp, int astno, int ipli, double *xsun, char *serr);
+extern int32 swi_ast_elem_load(char *serr);
+extern int32 swi_ast_elem_find(int32 astno);
+extern int32 swi_ast_elem_number(int32 i);
+extern void swi_ast_elem_helio(int32 i, double tjd, double *xp);
+extern void swi_ast_elem_set_mode(int32 mode);
+extern int32 swi_ast_elem_get_mode(void);
+extern void swi_ast_elem_free(void);
+extern double swi_ast_elem_bytes(void);
+extern void swi_ecl_db_free(void);
+extern double swi_ecl_db_bytes(void);
+extern void swi_eop_get(int32 i0, int32 i1, double *dpsi, double *deps);
+extern void load_dpsi_deps(void);
 extern FILE *swi_fopen(int ifno, char *fname, char *ephepath, char *serr);
 extern int32 swi_init_swed_if_start(void);
 extern int32 swi_set_tid_acc(double tjd_ut, int32 iflag, int32 denum, char *serr);
@@ -818,8 +831,10 @@ struct swe_data {
   char saved_planet_name[80];
   //double dpsi[36525];  /* works for 100 years after 1962 */
   //double deps[36525];
-  double *dpsi;
-  double *deps;
+  unsigned char *eop_data;	/* dpsi, deps, encoded, see load_dpsi_deps() */
+  int32 eop_ndays;
+  int32 eop_blkdays;
+  int32 eop_data_size;
   int32 timeout;
   int32 astro_models[SEI_NMODELS];
   AS_BOOL do_interpolate_nut;
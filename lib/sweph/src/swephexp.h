@@ -387,6 +387,9 @@ extern "C" {
 #define SE_STARFILE     "sefstars.txt"
 #define SE_ASTNAMFILE   "seasnam.txt"
 #define SE_FICTFILE     "seorbel.txt"
+#define SE_ASTPACKFILE  "seastpak.bin"
+#define SE_ASTELEMFILE  "seastel.bin"
+#define SE_ECLDBFILE    "seecldb.bin"
 
 /*
  * ephemeris path
@@ -425,6 +428,67 @@ extern "C" {
 					 * e.g. 13.9999999 will be rounded
 					 * to 13d59'59" (or 13d59' or 13d) */
 
+/* for swe_primary_directions() and swe_primary_directions_dates() */
+#define SE_PD_MUNDANE		0
+#define SE_PD_ZODIACAL		1
+#define SE_PD_KEY_PTOLEMY	0
+#define SE_PD_KEY_NAIBOD	1
+#define SE_PD_KEY_SOLAR_ARC	2
+#define SE_PD_ARC_UNDEFINED	999.0
+
+/* for swe_panchang_transits() */
+#define SE_PANCH_TITHI		1
+#define SE_PANCH_NAKSHATRA	2
+#define SE_PANCH_YOGA		3
+#define SE_PANCH_KARANA		4
+
+/* for swe_moon_extremes() */
+#define SE_MOON_PERIGEE		1
+#define SE_MOON_APOGEE		2
+#define SE_MOON_AT_NEW		4
+#define SE_MOON_AT_FULL		8
+
+/* for swe_decl_events() */
+#define SE_DECL_OOB_BEGIN	1
+#define SE_DECL_OOB_END		2
+#define SE_DECL_PARALLEL	4
+#define SE_DECL_CONTRAPARALLEL	8
+
+/* for swe_set_ephe_remote() and swe_get_ephe_remote_stats() */
+typedef int32 (*SWE_REMOTE_READ)(const char *url, double offset, int32 nbytes, char *buf, double *fsize);
+#define SE_REMOTE_STAT_REQUESTS	0
+#define SE_REMOTE_STAT_BYTES	1
+#define SE_REMOTE_STAT_HITS	2
+#define SE_REMOTE_STAT_MISSES	3
+#define SE_REMOTE_STAT_CACHED	4
+#define SE_REMOTE_STAT_PREFETCH	5
+#define SE_REMOTE_STAT_PREFETCH_HITS	6
+#define SE_REMOTE_NSTAT		7
+
+/* for swe_get_memory_stats() */
+#define SE_MEM_SEGMENTS		0
+#define SE_MEM_FILECACHE	1
+#define SE_MEM_ASTELEM		2
+#define SE_MEM_STARS		3
+#define SE_MEM_NUTATION		4
+#define SE_MEM_ECLDB		5
+#define SE_MEM_NSTAT		6
+
+/* for swe_eclipse_db_when() and swe_eclipse_db_saros() */
+#define SE_ECLDB_SOLAR		0
+#define SE_ECLDB_LUNAR		1
+
+/* for swe_cheb_fit() */
+#define SE_CHEB_MAXCOE		32
+#define SE_CHEB_SEGSIZE(ncoe)	(2 + 3 * (ncoe))
+
+/* for swe_set_ast_elem_mode() */
+#define SE_ASTEL_SECULAR	1	/* secular perturbations by the planets */
+
+/* for swe_set_light_time_mode() */
+#define SE_LTIME_ITERATE	0	/* iterate, recompute all bodies (default) */
+#define SE_LTIME_ONESTEP	1	/* solve directly, same Chebyshev segment */
+
 /* for heliacal functions */
 #define SE_HELIACAL_RISING		1
 #define SE_HELIACAL_SETTING		2
@@ -681,6 +745,9 @@ extern HANDLE dllhandle;        // set by swedllst::DllMain,
 ext_def(int32) swe_heliacal_ut(double tjdstart_ut, double *geopos, double *datm, double *dobs, char *ObjectName, int32 TypeEvent, int32 iflag, double *dret, char *serr);
 ext_def(int32) swe_heliacal_pheno_ut(double tjd_ut, double *geopos, double *datm, double *dobs, char *ObjectName, int32 TypeEvent, int32 helflag, double *darr, char *serr);
 ext_def(int32) swe_vis_limit_mag(double tjdut, double *geopos, double *datm, double *dobs, char *ObjectName, int32 helflag, double *dret, char *serr);
+ext_def(int32) swe_heliacal_crescent_grid(double tjd_ut, double *dgrid, int32 nlat, int32 nlon, int32 helflag, double *qgrid, int32 *cgrid, double *dret, char *serr);
+ext_def(int32) swe_sky_brightness_grid(double tjdut, double *dgeo, double *datm, double *dobs, int32 helflag, double *dgrid, int32 nalt, int32 nazi, float *bgrid, float *mgrid, double *dret, char *serr);
+ext_def(int32) swe_vis_limit_mag_series(double tjd_start, double tstep, int32 nstep, double *dgeo, double *datm, double *dobs, int32 helflag, double alt, double azi, float *bret, float *mret, char *serr);
 
 /* the following are secret, for Victor Reijs' */
 ext_def(int32) swe_heliacal_angle(double tjdut, double *dgeo, double *datm, double *dobs, int32 helflag, double mag, double azi_obj, double azi_sun, double azi_moon, double alt_moon, double *dret, char *serr);
@@ -717,6 +784,16 @@ ext_def(double) swe_mooncross_node(double jd_et, int32 flag, double *xlon, doubl
 ext_def(double) swe_mooncross_node_ut(double jd_ut, int32 flag, double *xlon, double *xlat, char *serr);
 ext_def(int32) swe_helio_cross(int32 ipl, double x2cross, double jd_et, int32 iflag, int32 dir, double *jd_cross, char *serr);
 ext_def(int32) swe_helio_cross_ut(int32 ipl, double x2cross, double jd_ut, int32 iflag, int32 dir, double *jd_cross, char *serr);
+ext_def(int32) swe_panchang_transits(double tjd_start, double tjd_end, int32 ptype, int32 iflag, double *tret, int32 *iret, int32 nmax, char *serr);
+ext_def(int32) swe_panchang(double tjd_start, int32 ndays, double *geopos, int32 nloc, int32 iflag, double *dpan, char *serr);
+ext_def(int32) swe_moon_extremes(double tjd_start, double tjd_end, int32 iflag, double dtsyz, double *dret, int32 nmax, char *serr);
+ext_def(int32) swe_decl_events(double tjd_start, double tjd_end, int32 *ipl, int32 nbody, int32 iflag, double step, int32 evmask, double *dret, int32 nmax, char *serr);
+ext_def(int32) swe_fixstar_conjunctions(double tjd_start, double tjd_end, int32 *ipl, int32 nbody, int32 iflag, double maxmag, double latorb, double *dret, int32 nmax, char *serr);
+ext_def(int32) swe_cheb_fit(double tjd_start, double tjd_end, int32 ipl, int32 iflag, double tol, int32 ncoe, double *dseg, int32 nmax, char *serr);
+ext_def(int32) swe_calc_ast_elements(double tjd_ut, int32 iflag, int32 first, int32 count, double *xret, int32 *anum, char *serr);
+ext_def(int32) swe_ast_elem_near(double tjd_ut, int32 iflag, double *xlon, int32 npoints, double orb, double *dret, int32 nmax, char *serr);
+ext_def(void) swe_set_ast_elem_mode(int32 mode);
+ext_def(void) swe_set_light_time_mode(int32 mode);
 
 /* fixed stars */
 ext_def( int32 ) swe_fixstar(
@@ -748,6 +825,17 @@ ext_def( void ) swe_set_ephe_path(const char *path);
 /* set file name of JPL file */
 ext_def( void ) swe_set_jpl_file(const char *fname);
 
+/* set remote source of ephemeris files, read by blocks */
+ext_def( int32 ) swe_set_ephe_remote(char *url, int32 block_size, int32 cache_blocks, SWE_REMOTE_READ reader, char *serr);
+ext_def( int32 ) swe_get_ephe_remote_stats(double *dstat);
+
+/* prefetch of ephemeris segments */
+ext_def( void ) swe_set_ephe_prefetch(int32 nseg);
+ext_def( int32 ) swe_ephe_prefetch(double tjd_start, double tjd_end, int32 *ipl, int32 nbody, int32 iflag, char *serr);
+
+/* memory held by tables and caches */
+ext_def( int32 ) swe_get_memory_stats(double *dstat);
+
 /* get planet name */
 ext_def( char *) swe_get_planet_name(int ipl, char *spname);
 
@@ -837,6 +925,14 @@ ext_def( int ) swe_houses_armc_ex2(
 ext_def(double) swe_house_pos(
 	double armc, double geolat, double eps, int hsys, double *xpin, char *serr);
 
+ext_def(int32) swe_primary_directions(
+	double armc, double geolat, double eps, int hsys, int32 pdflag,
+	double *xprom, int32 npro, double *xsig, int32 nsig, double *dasp, int32 nasp,
+	double *darc, char *serr);
+
+ext_def(int32) swe_primary_directions_dates(
+	double tjd_ut, int32 iflag, int32 key, double *darc, int32 narc, double *dtjd, char *serr);
+
 ext_def(const char *) swe_house_name(int hsys);
 
 
@@ -846,6 +942,8 @@ ext_def(const char *) swe_house_name(int hsys);
  ****************************/
 
 ext_def(int32) swe_gauquelin_sector(double t_ut, int32 ipl, char *starname, int32 iflag, int32 imeth, double *geopos, double atpress, double attemp, double *dgsect, char *serr);
+ext_def(int32) swe_acg_lines(double tjd_ut, int32 ipl, char *starname, int32 iflag, double dhor, double lat_max, double max_step, int32 npmax, double *dret, double *xasc, int32 *nasc, double *xdsc, int32 *ndsc, char *serr);
+ext_def(int32) swe_parans(double tjd_ut, int32 nbody, int32 *ipl, char **starname, int32 iflag, double dhor, double *dlat, int32 nlat, double orb, int32 evmask, double *dpar, int32 npmax, char *serr);
 
 /* computes geographic location and attributes of solar 
  * eclipse at a given tjd */
@@ -884,6 +982,12 @@ ext_def (int32) swe_lun_eclipse_when(double tjd_start, int32 ifl, int32 ifltype,
 ext_def (int32) swe_lun_eclipse_when_loc(double tjd_start, int32 ifl, 
      double *geopos, double *tret, double *attr, int32 backward, char *serr);
 
+/* eclipses from the eclipse database SE_ECLDBFILE */
+ext_def (int32) swe_eclipse_db_range(double *tjd_start, double *tjd_end, char *serr);
+ext_def (int32) swe_eclipse_db_when(double tjd_start, int32 ikind, int32 ifltype,
+     double *tret, double *attr, int32 backward, char *serr);
+ext_def (int32) swe_eclipse_db_saros(int32 ikind, int32 saros, double *tret, int32 nmax, char *serr);
+
 /* planetary phenomena */
 ext_def (int32) swe_pheno(double tjd, int32 ipl, int32 iflag, double *attr, char *serr);
  
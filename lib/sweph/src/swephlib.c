@@ -2001,28 +2001,29 @@ static int calc_nutation_woolard(double J, double *nutlo)
   return OK;
 }
 
-static double bessel(double *v, int n, double t)
+/* v holds the entries i0.. of a table of n entries */
+static double bessel(double *v, int i0, int n, double t)
 {
   int i, iy, k;
   double ans, p, B, d[6];
   if (t <= 0) {
-    ans = v[0]; 
+    ans = v[0 - i0]; 
     goto done;
   } 
   if (t >= n - 1) {
-    ans = v[n - 1]; 
+    ans = v[n - 1 - i0]; 
     goto done;
   }
   p = floor(t);
   iy = (int) t;
   /* Zeroth order estimate is value at start of year */
-  ans = v[iy];
+  ans = v[iy - i0];
   k = iy + 1;
   if (k >= n)
     goto done;
   /* The fraction of tabulation interval */
   p = t - p;
-  ans += p * (v[k] - v[iy]);
+  ans += p * (v[k - i0] - v[iy - i0]);
   if( (iy - 1 < 0) || (iy + 2 >= n) )
     goto done; /* can't do second differences */
   /* Make table of first differences */
@@ -2031,7 +2032,7 @@ static double bessel(double *v, int n, double t)
     if((k < 0) || (k + 1 >= n)) 
       d[i] = 0;
     else
-      d[i] = v[k+1] - v[k];
+      d[i] = v[k + 1 - i0] - v[k - i0];
     k += 1;
   }
   /* Compute second differences */
@@ -2068,8 +2069,8 @@ done:
 
 static int calc_nutation(double J, int32 iflag, double *nutlo)
 {
-  int n;
-  double dpsi, deps, J2;
+  int n, iy, i0, i1;
+  double dpsi, deps, J2, t, vpsi[6], veps[6];
   int nut_model = swed.astro_models[SE_MODEL_NUT];
   int jplhora_model = swed.astro_models[SE_MODEL_JPLHORA_MODE];
   AS_BOOL is_jplhor = FALSE;
@@ -2083,13 +2084,19 @@ static int calc_nutation(double J, int32 iflag, double *nutlo)
     is_jplhor = TRUE;
   if (is_jplhor) {
     calc_nutation_iau1980(J, nutlo);
-    if (iflag & SEFLG_JPLHOR) {
+    if ((iflag & SEFLG_JPLHOR) && swed.eop_data != NULL) {
       n = (int) (swed.eop_tjd_end - swed.eop_tjd_beg + 0.000001);
       J2 = J;
       if (J < swed.eop_tjd_beg_horizons)
 	J2 = swed.eop_tjd_beg_horizons;
-      dpsi = bessel(swed.dpsi, n + 1, J2 - swed.eop_tjd_beg);
-      deps = bessel(swed.deps, n + 1, J2 - swed.eop_tjd_beg);
+      /* only the days used by the interpolation are decoded */
+      t = J2 - swed.eop_tjd_beg;
+      iy = (t <= 0) ? 0 : (t >= n) ? n : (int) t;
+      i0 = (iy >= 2) ? iy - 2 : 0;
+      i1 = (iy + 3 <= n) ? iy + 3 : n;
+      swi_eop_get(i0, i1, vpsi, veps);
+      dpsi = bessel(vpsi, i0, n + 1, t);
+      deps = bessel(veps, i0, n + 1, t);
       nutlo[0] += dpsi / 3600.0 * DEGTORAD;
       nutlo[1] += deps / 3600.0 * DEGTORAD;
 #if 0
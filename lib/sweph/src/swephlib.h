@@ -74,6 +74,8 @@
  * rename it as eop_finals.txt */
 #define DPSI_DEPS_IAU1980_FILE_EOPC04   "eop_1962_today.txt"
 #define DPSI_DEPS_IAU1980_FILE_FINALS   "eop_finals.txt"
+/* both files converted by sweeop.c, read instead of them if present */
+#define DPSI_DEPS_IAU1980_FILE_BIN      "seeop.bin"
 #define DPSI_DEPS_IAU1980_TJD0_HORIZONS  2437684.5 
 #define HORIZONS_TJD0_DPSI_DEPS_IAU1980  2437684.5 
 #define DPSI_IAU1980_TJD0	(64.284 / 1000.0)  // arcsec
@@ -83,7 +85,8 @@
  * in agreement with IERS Conventions 1996 (1992), p. 22. 
  * Call swe_calc_ut() with iflag|SEFLG_JPLHOR.  
  * This options works only, if the files DPSI_DEPS_IAU1980_FILE_EOPC04 
- * and DPSI_DEPS_IAU1980_FILE_FINALS are in the ephemeris path.
+ * and DPSI_DEPS_IAU1980_FILE_FINALS, or DPSI_DEPS_IAU1980_FILE_BIN,
+ * are in the ephemeris path.
  *
  * If the software does not find the earth orientation files 
  * in the ephemeris path, then SEFLG_JPLHOR will run as 
@@ -16,6 +16,10 @@ app.use('/local-package', express.static(path.join(__dirname, 'public/local-pack
 // Serve npm package files
 app.use('/npm-package', express.static(path.join(__dirname, 'public/npm-package')));
 
+// Serve ephemeris files for setRemoteEphemeris('/eph', ...); express.static
+// answers Range requests with 206 Partial Content
+app.use('/eph', express.static(path.join(__dirname, '../lib/src/eph')));
+
 // Serve specific files with correct MIME types
 app.get('/astro-sweph/astro.wasm', (req, res) => {
     res.setHeader('Content-Type', 'application/wasm');
@@ -51,10 +55,15 @@ app.get('/npm-package', (req, res) => {
     res.sendFile(path.join(__dirname, 'public', 'npm-package-test.html'));
 });
 
-app.listen(PORT, () => {
-    console.log(`Test server running at http://localhost:${PORT}`);
-    console.log('Available test pages:');
-    console.log('  - http://localhost:3000/local-dev (uses parent dist/ files)');
-    console.log('  - http://localhost:3000/local-package (uses copied files)');
-    console.log('  - http://localhost:3000/npm-package (uses installed npm package)');
-}); 
\ No newline at end of file
+// Listen only when started as a program; test-range.js requires the app
+if (require.main === module) {
+    app.listen(PORT, () => {
+        console.log(`Test server running at http://localhost:${PORT}`);
+        console.log('Available test pages:');
+        console.log('  - http://localhost:3000/local-dev (uses parent dist/ files)');
+        console.log('  - http://localhost:3000/local-package (uses copied files)');
+        console.log('  - http://localhost:3000/npm-package (uses installed npm package)');
+    });
+}
+
+module.exports = app;
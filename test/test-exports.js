@@ -0,0 +1,116 @@
+/**
+ * Checks of the functions exported by lib/src/astro.c
+ *
+ * Runs in Node.js against the installed module js/astro-embedded.js
+ * (cd lib/src && make embedded && make install), or against the module
+ * named by the environment variable ASTRO_MODULE. Like swecheck in
+ * lib/sweph/src, it prints the failed checks (all of them with -v) and
+ * exits with their number.
+ *
+ *   node test-exports.js [-v]
+ */
+const path = require('path');
+
+const verbose = process.argv.includes('-v');
+let ncheck = 0;
+let nfail = 0;
+
+// Records the result of a check; the message is printed for failed
+// checks, and in verbose mode for all of them
+function check(ok, name, msg) {
+    ncheck++;
+    if (!ok) nfail++;
+    if (!ok || verbose) {
+        console.log(`${(ok ? 'ok' : 'FAILED').padEnd(6)} ${name.padEnd(28)} ${msg}`);
+    }
+}
+
+// Calls an export that returns a JSON string, and releases the string
+function call(Module, name, types, args) {
+    const ptr = Module.ccall(name, 'number', types, args);
+    if (!ptr) return null;
+    const text = Module.UTF8ToString(ptr);
+    Module._freeMemory(ptr);
+    return JSON.parse(text);
+}
+
+// Modules built before a function was added do not export it
+function exported(Module, name) {
+    if (typeof Module['_' + name] === 'function') return true;
+    check(false, name, 'not exported, rebuild the module');
+    return false;
+}
+
+function numbers(n) {
+    return new Array(n).fill('number');
+}
+
+// A whole night at 10-minute steps, at the new moon of 2024 March 10
+// in Zurich: twilight, a dark sky near magnitude 6.8, and dawn
+function checkLimitingMagnitudeNight(Module) {
+    if (!exported(Module, 'getLimitingMagnitudeCurve')) return;
+    const r = call(Module, 'getLimitingMagnitudeCurve', numbers(13),
+        [2024, 3, 10, 18, 0, 0, 8.55, 47.38, 90, 0, 10, 72, 0]);
+    const v = r.values;
+    check(!r.error && v.length === 72 && v.every(x => x.limiting_magnitude !== undefined),
+        'limiting magnitude night', `${v.length} values`);
+    const mag = v.map(x => x.limiting_magnitude);
+    check(mag[0] < 4 && Math.abs(mag[36] - 6.79) < 0.05 && mag[71] < 0,
+        'limiting magnitude dark sky', `${mag[0]} at dusk, ${mag[36]} at midnight, ${mag[71]} at dawn`);
+}
+
+// A result string counts as live until it is released with freeMemory();
+// the counters then return to where they were before the call
+function checkHeapStats(Module) {
+    if (!exported(Module, 'getHeapStats') || !exported(Module, 'getWheelLayout')) return;
+    const s0 = call(Module, 'getHeapStats', [], []);
+    const ptr = Module.ccall('getWheelLayout', 'number', ['string', 'number', 'number'], ['10,20,30', 5, 0]);
+    const s1 = call(Module, 'getHeapStats', [], []);
+    Module._freeMemory(ptr);
+    const s2 = call(Module, 'getHeapStats', [], []);
+    check(ptr && s1.results_live === s0.results_live + 1 && s1.results_bytes > s0.results_bytes
+        && s1.peak_results_bytes >= s1.results_bytes,
+        'heap stats live result', `${s1.results_live} live, ${s1.results_bytes - s0.results_bytes} bytes more`);
+    check(s2.results_live === s0.results_live && s2.results_bytes === s0.results_bytes
+        && s2.frees > s1.frees && s2.allocations > s1.allocations,
+        'heap stats freed result', `${s2.results_live} live, ${s2.results_bytes} bytes, as before the call`);
+}
+
+// Display angles for a chart wheel: `lon` in input order and the expected
+// angles, worked out by hand from the sweep in wheel_layout()
+function checkWheel(Module, name, lon, width, angles, clusters, maxOffset) {
+    const r = call(Module, 'getWheelLayout', ['string', 'number', 'number'], [lon, width, 0]);
+    const got = r.items.map(x => x[1]);
+    check(!r.error && r.clusters === clusters && Math.abs(r.max_offset - maxOffset) < 1e-4
+        && got.length === angles.length && got.every((a, i) => Math.abs(a - angles[i]) < 1e-4),
+        name, `${r.clusters} clusters, max. offset ${r.max_offset}, angles ${got.join(' ')}`);
+}
+
+function checkWheelLayout(Module) {
+    if (!exported(Module, 'getWheelLayout')) return;
+    // the largest gap is after 180; 358, 359, 1 and 2 merge into one
+    // cluster centred on 0 degrees, 4 degrees wide per glyph
+    checkWheel(Module, 'wheel layout wrap', '359,1,180,2,358', 4,
+        [358, 2, 180, 6, 354], 2, 4);
+    // 300..302 merge and cascade into 240, then take in 0 (360); the
+    // cluster 240..360 then overlaps 60 (420) across 0 degrees, which is
+    // moved to the end of the sweep and merged: 240..60 centred on 320.5
+    checkWheel(Module, 'wheel layout merge', '0,60,120,180,240,300,301,302', 40,
+        [20.5, 60.5, 120, 180, 220.5, 260.5, 300.5, 340.5], 3, 39.5);
+}
+
+function loadModule() {
+    const Module = require(process.env.ASTRO_MODULE || path.join(__dirname, '../js/astro-embedded.js'));
+    return new Promise((resolve) => {
+        if (Module.calledRun) resolve(Module);
+        else Module.onRuntimeInitialized = () => resolve(Module);
+    });
+}
+
+loadModule().then((Module) => {
+    checkLimitingMagnitudeNight(Module);
+    checkHeapStats(Module);
+    checkWheelLayout(Module);
+    console.log(`${ncheck} checks, ${nfail} failed`);
+    process.exit(nfail);
+});
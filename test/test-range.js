@@ -0,0 +1,72 @@
+/**
+ * Checks that test/server.js answers the Range requests with which
+ * setRemoteEphemeris() reads ephemeris files (see remote_range_read() in
+ * lib/src/astro.c): 206 Partial Content with the requested bytes and the
+ * file size in Content-Range, a short last block at the end of a file,
+ * and 404 for a missing file. Prints the failed checks (all of them with
+ * -v) and exits with their number.
+ *
+ *   node test-range.js [-v]
+ */
+const fs = require('fs');
+const http = require('http');
+const path = require('path');
+const app = require('./server');
+
+const verbose = process.argv.includes('-v');
+const ephFile = 'sepl_18.se1';
+const blockSize = 65536;
+let ncheck = 0;
+let nfail = 0;
+
+function check(ok, name, msg) {
+    ncheck++;
+    if (!ok) nfail++;
+    if (!ok || verbose) {
+        console.log(`${(ok ? 'ok' : 'FAILED').padEnd(6)} ${name.padEnd(28)} ${msg}`);
+    }
+}
+
+// GET with an optional Range header, as the worker's synchronous XHR sends it
+function get(port, file, range) {
+    const headers = range ? { Range: `bytes=${range[0]}-${range[1]}` } : {};
+    return new Promise((resolve, reject) => {
+        http.get({ port, path: `/eph/${file}`, headers }, (res) => {
+            const chunks = [];
+            res.on('data', (chunk) => chunks.push(chunk));
+            res.on('end', () => resolve({ status: res.statusCode, headers: res.headers, body: Buffer.concat(chunks) }));
+        }).on('error', reject);
+    });
+}
+
+// Requests one block of the file and compares it with the file on disk
+async function checkBlock(port, data, iblock) {
+    const offset = iblock * blockSize;
+    const r = await get(port, ephFile, [offset, offset + blockSize - 1]);
+    const expected = data.subarray(offset, offset + blockSize);
+    const name = `range block ${iblock}`;
+    check(r.status === 206, name, `status ${r.status}`);
+    check(r.headers['content-range'] === `bytes ${offset}-${offset + expected.length - 1}/${data.length}`,
+        `${name} content-range`, `${r.headers['content-range']}`);
+    check(r.body.equals(expected), `${name} bytes`, `${r.body.length} bytes, ${expected.length} expected`);
+}
+
+async function main(port) {
+    const data = fs.readFileSync(path.join(__dirname, '../lib/src/eph', ephFile));
+    await checkBlock(port, data, 0);
+    await checkBlock(port, data, 3);
+    // the last block is shorter than the range requested
+    await checkBlock(port, data, Math.floor(data.length / blockSize));
+    const r = await get(port, 'de431.eph', [0, blockSize - 1]);
+    check(r.status === 404, 'range missing file', `status ${r.status}`);
+}
+
+const server = app.listen(0, () => {
+    main(server.address().port).catch((error) => {
+        check(false, 'range requests', error.message);
+    }).then(() => {
+        server.close();
+        console.log(`${ncheck} checks, ${nfail} failed`);
+        process.exit(nfail);
+    });
+});
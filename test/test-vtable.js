@@ -0,0 +1,53 @@
+/**
+ * Checks of the row window of the virtual tables in js/calculate.js
+ * (see mountVirtualTable()): which rows are rendered at a given scroll
+ * position. calculate.js is a browser script; it is loaded here with
+ * stubs for jQuery and the document. Prints the failed checks (all of
+ * them with -v) and exits with their number.
+ *
+ *   node test-vtable.js [-v]
+ */
+const fs = require('fs');
+const path = require('path');
+const vm = require('vm');
+
+const verbose = process.argv.includes('-v');
+let ncheck = 0;
+let nfail = 0;
+
+function check(ok, name, msg) {
+    ncheck++;
+    if (!ok) nfail++;
+    if (!ok || verbose) {
+        console.log(`${(ok ? 'ok' : 'FAILED').padEnd(6)} ${name.padEnd(28)} ${msg}`);
+    }
+}
+
+function loadCalculate() {
+    const context = { $: () => ({ ready() {} }), document: {} };
+    vm.createContext(context);
+    vm.runInContext(fs.readFileSync(path.join(__dirname, '../js/calculate.js'), 'utf8'), context);
+    return context;
+}
+
+// Rows are 24 px high and the viewport shows 20 of them, so a pool of 21
+// rows covers a partly scrolled row at the top and the bottom
+function checkWindow(calc, name, scrollTop, rowCount, first, count) {
+    const w = calc.virtualRowWindow(scrollTop, rowCount);
+    check(w.first === first && w.count === count,
+        name, `scrollTop ${scrollTop} of ${rowCount} rows: rows ${w.first} to ${w.first + w.count - 1}`);
+}
+
+const calc = loadCalculate();
+check(calc.VTABLE_ROW_HEIGHT === 24 && calc.VTABLE_MAX_ROWS === 20,
+    'row height and viewport', `${calc.VTABLE_ROW_HEIGHT} px, ${calc.VTABLE_MAX_ROWS} rows`);
+checkWindow(calc, 'window top', 0, 500, 0, 21);
+checkWindow(calc, 'window partial row', 100 * 24 + 5, 500, 100, 21);
+// the largest scrollTop is (500 - 20) * 24; the pool then ends at row 499
+checkWindow(calc, 'window bottom', 480 * 24, 500, 479, 21);
+checkWindow(calc, 'window overscroll end', 480 * 24 + 40, 500, 479, 21);
+checkWindow(calc, 'window overscroll top', -30, 500, 0, 21);
+checkWindow(calc, 'window short table', 50, 5, 0, 5);
+checkWindow(calc, 'window empty table', 0, 0, 0, 0);
+console.log(`${ncheck} checks, ${nfail} failed`);
+process.exit(nfail);